@@ -4,10 +4,12 @@
 #include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
 #include "model.cpp"
 
 using namespace vespalib::eval;
 using namespace vespalib::eval::gbdt;
+using vespalib::BenchmarkTimer;
 
 template <typename T>
 void estimate_cost(size_t num_params, const char *label, const T &impl) {
@@ -23,6 +25,16 @@ void estimate_cost(size_t num_params, const char *label, const T &impl) {
             label, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
 }
 
+void estimate_many_cost(size_t num_params, const FastForest &forest) {
+    constexpr size_t num_docs = 64;
+    auto ctx = forest.create_context();
+    std::vector<float> params(num_params * num_docs, 0.5);
+    std::vector<double> result(num_docs);
+    double us = BenchmarkTimer::benchmark([&](){ forest.eval_many(*ctx, &params[0], num_docs, &result[0]); }, 5.0) * 1000.0 * 1000.0;
+    fprintf(stderr, "[%12s] (per 100 eval): [medium values, %zu docs at a time] %6.3f ms\n",
+            forest.impl_name().c_str(), num_docs, (us / num_docs / 10.0));
+}
+
 void run_fast_forest_bench() {
     for (size_t tree_size: std::vector<size_t>({8,16,32,64,128,256})) {
         for (size_t num_trees: std::vector<size_t>({100, 500, 2500, 5000, 10000})) {
@@ -36,6 +48,7 @@ void run_fast_forest_bench() {
                             auto forest = FastForest::try_convert(*function, min_bits, 64);
                             if (forest) {
                                 estimate_cost(function->num_params(), forest->impl_name().c_str(), *forest);
+                                estimate_many_cost(function->num_params(), *forest);
                             }
                             if (min_bits > 64) {
                                 break;
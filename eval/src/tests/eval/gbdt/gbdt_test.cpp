@@ -407,6 +407,38 @@ TEST("require that fast forest evaluation is correct for all tree size categorie
     }
 }
 
+TEST("require that fast forest evaluation of many documents gives the same results as one at a time") {
+    for (size_t tree_size: std::vector<size_t>({7,15,30,61,127})) {
+        auto function = Function::parse(Model().max_features(35).less_percent(100).invert_percent(50).make_forest(127, tree_size));
+        auto forest = FastForest::try_convert(*function);
+        if ((tree_size <= 64) || is_little_endian()) {
+            ASSERT_TRUE(forest);
+            TEST_STATE(forest->impl_name().c_str());
+            size_t num_params = function->num_params();
+            for (size_t num_docs: std::vector<size_t>({1, 16, 37})) {
+                std::vector<std::vector<double>> doc_params;
+                std::vector<float> params(num_params * num_docs);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    doc_params.emplace_back();
+                    for (size_t param = 0; param < num_params; ++param) {
+                        double value = (((doc + param) % 7) == 0)
+                                       ? std::numeric_limits<double>::quiet_NaN()
+                                       : double(((doc * 13) + (param * 7)) % 11) / 10.0;
+                        doc_params.back().push_back(value);
+                        params[(param * num_docs) + doc] = value;
+                    }
+                }
+                auto ctx = forest->create_context();
+                std::vector<double> result(num_docs, 0.0);
+                forest->eval_many(*ctx, &params[0], num_docs, &result[0]);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    EXPECT_EQUAL(result[doc], eval_ff(*forest, *ctx, doc_params[doc]));
+                }
+            }
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that GDBT expressions can be detected") {
@@ -0,0 +1,123 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/eval/eval/llvm/object_cache.h>
+#include <vespa/vespalib/io/fileutil.h>
+#include <cstdio>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+
+const vespalib::string cache_dir("object_cache_test_dir");
+
+struct Fixture {
+    ObjectCache::Stats before;
+    Fixture() : before() {
+        vespalib::rmdir(cache_dir, true);
+        ObjectCache::set_directory(cache_dir, 1024 * 1024);
+        before = ObjectCache::get_stats();
+    }
+    ~Fixture() {
+        ObjectCache::set_directory("", 0);
+        vespalib::rmdir(cache_dir, true);
+    }
+    size_t hits() const { return ObjectCache::get_stats().hits - before.hits; }
+    size_t misses() const { return ObjectCache::get_stats().misses - before.misses; }
+    size_t stored() const { return ObjectCache::get_stats().stored - before.stored; }
+    size_t num_files() const { return vespalib::listDirectory(cache_dir).size(); }
+};
+
+double eval_array(const vespalib::string &expr, const std::vector<double> &params) {
+    CompiledFunction cf(*Function::parse(expr), PassParams::ARRAY, gbdt::Optimize::none);
+    return cf.get_function()(&params[0]);
+}
+
+void overwrite_files(const vespalib::string &content) {
+    for (const auto &name: vespalib::listDirectory(cache_dir)) {
+        FILE *file = fopen((cache_dir + "/" + name).c_str(), "wb");
+        ASSERT_TRUE(file != nullptr);
+        fwrite(content.data(), 1, content.size(), file);
+        fclose(file);
+    }
+}
+
+void corrupt_last_byte() {
+    for (const auto &name: vespalib::listDirectory(cache_dir)) {
+        FILE *file = fopen((cache_dir + "/" + name).c_str(), "r+b");
+        ASSERT_TRUE(file != nullptr);
+        ASSERT_EQUAL(fseek(file, -1, SEEK_END), 0);
+        int byte = fgetc(file);
+        ASSERT_EQUAL(fseek(file, -1, SEEK_END), 0);
+        fputc(byte ^ 0xff, file);
+        fclose(file);
+    }
+}
+
+TEST_F("require that the cache is disabled by default", Fixture) {
+    ObjectCache::set_directory("", 0);
+    EXPECT_EQUAL(ObjectCache::get_directory(), "");
+    EXPECT_EQUAL(eval_array("a+b", {1.0, 2.0}), 3.0);
+    EXPECT_EQUAL(f1.misses(), 0u);
+    EXPECT_EQUAL(f1.stored(), 0u);
+}
+
+TEST_F("require that compiled objects are stored and reused", Fixture) {
+    EXPECT_EQUAL(ObjectCache::get_directory(), cache_dir);
+    EXPECT_EQUAL(eval_array("a+b*c", {1.0, 2.0, 3.0}), 7.0);
+    EXPECT_EQUAL(f1.misses(), 1u);
+    EXPECT_EQUAL(f1.stored(), 1u);
+    EXPECT_EQUAL(f1.num_files(), 1u);
+    EXPECT_EQUAL(eval_array("a+b*c", {3.0, 2.0, 1.0}), 5.0);
+    EXPECT_EQUAL(f1.hits(), 1u);
+    EXPECT_EQUAL(f1.stored(), 1u);
+    EXPECT_EQUAL(eval_array("a*b+c", {1.0, 2.0, 3.0}), 5.0);
+    EXPECT_EQUAL(f1.misses(), 2u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+}
+
+TEST_F("require that pass params affect the cache key", Fixture) {
+    auto fun = Function::parse("a+b");
+    CompiledFunction array(*fun, PassParams::ARRAY);
+    CompiledFunction separate(*fun, PassParams::SEPARATE);
+    EXPECT_EQUAL(f1.misses(), 2u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+    EXPECT_EQUAL(separate.get_function<2>()(1.0, 2.0), 3.0);
+}
+
+TEST_F("require that invalid cache files are replaced by compiling", Fixture) {
+    EXPECT_EQUAL(eval_array("a-b", {5.0, 2.0}), 3.0);
+    TEST_DO(overwrite_files("not an object file"));
+    EXPECT_EQUAL(eval_array("a-b", {5.0, 3.0}), 2.0);
+    EXPECT_EQUAL(f1.hits(), 0u);
+    EXPECT_EQUAL(f1.misses(), 2u);
+    EXPECT_EQUAL(f1.stored(), 2u);
+    EXPECT_EQUAL(eval_array("a-b", {5.0, 4.0}), 1.0);
+    EXPECT_EQUAL(f1.hits(), 1u);
+}
+
+TEST_F("require that cache files with corrupt object code are replaced by compiling", Fixture) {
+    EXPECT_EQUAL(eval_array("a/b", {6.0, 2.0}), 3.0);
+    TEST_DO(corrupt_last_byte());
+    EXPECT_EQUAL(eval_array("a/b", {6.0, 3.0}), 2.0);
+    EXPECT_EQUAL(f1.hits(), 0u);
+    EXPECT_EQUAL(f1.misses(), 2u);
+    EXPECT_EQUAL(f1.stored(), 2u);
+}
+
+TEST_F("require that functions with injected in-process state are not cached", Fixture) {
+    EXPECT_EQUAL(eval_array("if(a in [1,2,3,4,5,6,7,8,9,10],1,0)", {7.0}), 1.0);
+    EXPECT_EQUAL(f1.hits() + f1.misses(), 0u);
+    EXPECT_EQUAL(f1.num_files(), 0u);
+}
+
+TEST_F("require that the cache can be pruned", Fixture) {
+    EXPECT_EQUAL(eval_array("a+1", {1.0}), 2.0);
+    EXPECT_EQUAL(eval_array("a+2", {1.0}), 3.0);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+    EXPECT_EQUAL(ObjectCache::prune(cache_dir, 1024 * 1024), 0u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+    EXPECT_EQUAL(ObjectCache::prune(cache_dir, 0), 2u);
+    EXPECT_EQUAL(f1.num_files(), 0u);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
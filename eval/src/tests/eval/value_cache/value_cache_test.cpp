@@ -4,6 +4,8 @@
 #include <vespa/eval/eval/value_cache/constant_value.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/value_type.h>
+#include <vespa/vespalib/util/gate.h>
+#include <atomic>
 
 using namespace vespalib::eval;
 
@@ -64,4 +66,43 @@ TEST_FF("require that type spec is part of cache key", MyFactory(), ConstantValu
     EXPECT_EQUAL(3u, f1.create_cnt);
 }
 
+struct MyBlockingFactory : ConstantValueFactory {
+    mutable vespalib::Gate entered;
+    mutable vespalib::Gate release;
+    mutable std::atomic<size_t> create_cnt = 0;
+    mutable std::atomic<bool> timed_out = false;
+    ConstantValue::UP create(const vespalib::string &path, const vespalib::string &) const override {
+        ++create_cnt;
+        if (path == "1") {
+            entered.countDown();
+            if (!release.await(60000)) {
+                timed_out = true;
+            }
+        }
+        return std::make_unique<MyValue>(double(atoi(path.c_str())));
+    }
+};
+
+TEST_MT_FF("require that values are created without holding the cache lock", 3, MyBlockingFactory(), ConstantValueCache(f1)) {
+    if (thread_id == 0) {
+        auto res = f2.create("1", "type");
+        EXPECT_EQUAL(1.0, res->value().as_double());
+        TEST_BARRIER();
+    } else if (thread_id == 1) {
+        f1.entered.await();
+        auto res = f2.create("2", "type");
+        EXPECT_EQUAL(2.0, res->value().as_double());
+        f1.release.countDown();
+        TEST_BARRIER();
+    } else {
+        f1.entered.await();
+        // waits for the value being created by thread 0
+        auto res = f2.create("1", "type");
+        EXPECT_EQUAL(1.0, res->value().as_double());
+        TEST_BARRIER();
+    }
+    EXPECT_FALSE(f1.timed_out);
+    EXPECT_EQUAL(2u, f1.create_cnt.load());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
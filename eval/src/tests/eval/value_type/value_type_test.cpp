@@ -4,6 +4,7 @@
 #include <vespa/eval/eval/value_type_spec.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/test/insertion_operators.h>
+#include <limits>
 #include <ostream>
 
 using namespace vespalib::eval;
@@ -137,6 +138,8 @@ TEST("require that value type can make spec") {
     EXPECT_EQUAL("tensor<float>(x{})", ValueType::tensor_type({{"x"}}, CellType::FLOAT).to_spec());
     EXPECT_EQUAL("tensor<float>(y[10])", ValueType::tensor_type({{"y", 10}}, CellType::FLOAT).to_spec());
     EXPECT_EQUAL("tensor<float>(x{},y[10],z[5])", ValueType::tensor_type({{"x"}, {"y", 10}, {"z", 5}}, CellType::FLOAT).to_spec());
+    EXPECT_EQUAL("tensor<int8>(y[10])", ValueType::tensor_type({{"y", 10}}, CellType::INT8).to_spec());
+    EXPECT_EQUAL("tensor<bfloat16>(y[10])", ValueType::tensor_type({{"y", 10}}, CellType::BFLOAT16).to_spec());
 }
 
 //-----------------------------------------------------------------------------
@@ -149,6 +152,8 @@ TEST("require that value type spec can be parsed") {
     EXPECT_EQUAL(ValueType::tensor_type({{"x"}, {"y", 10}, {"z", 5}}), ValueType::from_spec("tensor(x{},y[10],z[5])"));
     EXPECT_EQUAL(ValueType::tensor_type({{"y", 10}}), ValueType::from_spec("tensor<double>(y[10])"));
     EXPECT_EQUAL(ValueType::tensor_type({{"y", 10}}, CellType::FLOAT), ValueType::from_spec("tensor<float>(y[10])"));
+    EXPECT_EQUAL(ValueType::tensor_type({{"y", 10}}, CellType::INT8), ValueType::from_spec("tensor<int8>(y[10])"));
+    EXPECT_EQUAL(ValueType::tensor_type({{"y", 10}}, CellType::BFLOAT16), ValueType::from_spec("tensor<bfloat16>(y[10])"));
 }
 
 TEST("require that value type spec can be parsed with extra whitespace") {
@@ -376,11 +381,52 @@ TEST("require that cell type is handled correctly for join") {
     TEST_DO(verify_join(type("tensor<float>(x{})"), type("double"), type("tensor<float>(x{})")));
 }
 
+TEST("require that compact cell types are joined as float") {
+    TEST_DO(verify_join(type("tensor<int8>(x[3])"), type("tensor<int8>(x[3])"), type("tensor<float>(x[3])")));
+    TEST_DO(verify_join(type("tensor<int8>(x[3])"), type("tensor<bfloat16>(x[3])"), type("tensor<float>(x[3])")));
+    TEST_DO(verify_join(type("tensor<bfloat16>(x[3])"), type("tensor<float>(x[3])"), type("tensor<float>(x[3])")));
+    TEST_DO(verify_join(type("tensor<bfloat16>(x[3])"), type("double"), type("tensor<float>(x[3])")));
+    TEST_DO(verify_join(type("tensor<int8>(x[3])"), type("tensor(x[3])"), type("tensor(x[3])")));
+}
+
+TEST("require that compact cell types can be decayed to float") {
+    EXPECT_EQUAL(type("tensor<int8>(x[3],y{})").decay_cell_type(), type("tensor<float>(x[3],y{})"));
+    EXPECT_EQUAL(type("tensor<bfloat16>(x[3])").decay_cell_type(), type("tensor<float>(x[3])"));
+    EXPECT_EQUAL(type("tensor<float>(x[3])").decay_cell_type(), type("tensor<float>(x[3])"));
+    EXPECT_EQUAL(type("tensor(x[3])").decay_cell_type(), type("tensor(x[3])"));
+    EXPECT_EQUAL(type("double").decay_cell_type(), type("double"));
+    EXPECT_TRUE(ValueType::is_compact_cell_type(CellType::INT8));
+    EXPECT_TRUE(ValueType::is_compact_cell_type(CellType::BFLOAT16));
+    EXPECT_FALSE(ValueType::is_compact_cell_type(CellType::FLOAT));
+    EXPECT_FALSE(ValueType::is_compact_cell_type(CellType::DOUBLE));
+}
+
 void verify_not_joinable(const ValueType &a, const ValueType &b) {
     EXPECT_TRUE(ValueType::join(a, b).is_error());
     EXPECT_TRUE(ValueType::join(b, a).is_error());
 }
 
+TEST("require that compact cell types are decayed by reduce, rename and merge") {
+    EXPECT_EQUAL(type("tensor<int8>(x[3],y[2])").reduce({"x"}), type("tensor<float>(y[2])"));
+    EXPECT_EQUAL(type("tensor<bfloat16>(x[3],y[2])").reduce({"y"}), type("tensor<float>(x[3])"));
+    EXPECT_EQUAL(type("tensor<int8>(x[3])").reduce({}), type("double"));
+    EXPECT_EQUAL(type("tensor<int8>(x[3])").rename({"x"}, {"y"}), type("tensor<float>(y[3])"));
+    EXPECT_EQUAL(ValueType::merge(type("tensor<int8>(x{})"), type("tensor<int8>(x{})")), type("tensor<float>(x{})"));
+}
+
+TEST("require that cells are converted to int8 with rounding and saturation") {
+    EXPECT_EQUAL(int(convert_cell<int8_t>(3.4)), 3);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(3.6)), 4);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(-3.6)), -4);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(127.4)), 127);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(1000.0)), 127);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(-1000.0)), -128);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(std::numeric_limits<double>::infinity())), 127);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(-std::numeric_limits<double>::infinity())), -128);
+    EXPECT_EQUAL(int(convert_cell<int8_t>(std::numeric_limits<double>::quiet_NaN())), 0);
+    EXPECT_EQUAL(convert_cell<float>(2.5), 2.5f);
+}
+
 TEST("require that mapped and indexed dimensions are not joinable") {
     verify_not_joinable(type("tensor(x[10])"), type("tensor(x{})"));
 }
@@ -0,0 +1,112 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/eval/simple_tensor.h>
+#include <vespa/eval/eval/simple_tensor_engine.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/dense/dense_fused_function.h>
+#include <vespa/eval/eval/test/eval_fixture.h>
+#include <vespa/eval/eval/test/tensor_model.hpp>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+using namespace vespalib::eval::tensor_function;
+using namespace vespalib::tensor;
+
+const TensorEngine &prod_engine = DefaultTensorEngine::ref();
+
+double gen_half(size_t seq) { return (0.5 * seq) - 3.0; }
+
+EvalFixture::ParamRepo make_params() {
+    return EvalFixture::ParamRepo()
+        .add("a", spec(1.5))
+        .add("mixed", spec({x({"a"}),y(3)}, N()))
+        .add_vector("x", 5)
+        .add_vector("y", 3)
+        .add_matrix("x", 5, "y", 3)
+        .add_matrix("x", 5, "y", 3, gen_half)
+        .add_matrix("x", 16, "y", 20)
+        .add_matrix("x", 16, "y", 20, gen_half);
+}
+EvalFixture::ParamRepo param_repo = make_params();
+
+void verify_optimized(const vespalib::string &expr, size_t num_ops, size_t num_inputs, std::optional<Aggr> aggr = std::nullopt) {
+    EvalFixture slow_fixture(prod_engine, expr, param_repo, false);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQ(fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQ(fixture.result(), slow_fixture.result());
+    auto info = fixture.find_all<DenseFusedFunction>();
+    ASSERT_EQ(info.size(), 1u);
+    EXPECT_TRUE(info[0]->result_is_mutable());
+    EXPECT_EQ(info[0]->num_ops(), num_ops);
+    EXPECT_EQ(info[0]->aggr(), aggr);
+    std::vector<TensorFunction::Child::CREF> children;
+    info[0]->push_children(children);
+    EXPECT_EQ(children.size(), num_inputs);
+}
+
+void verify_not_optimized(const vespalib::string &expr) {
+    EvalFixture slow_fixture(prod_engine, expr, param_repo, false);
+    EvalFixture fixture(prod_engine, expr, param_repo, true);
+    EXPECT_EQ(fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQ(fixture.result(), slow_fixture.result());
+    auto info = fixture.find_all<DenseFusedFunction>();
+    EXPECT_TRUE(info.empty());
+}
+
+TEST(FusedTest, map_of_join_is_fused) {
+    verify_optimized("map(join(x5y3,x5y3$2,f(a,b)(a+b)),f(x)(x*3))", 2, 2);
+    verify_optimized("join(map(x5y3,f(x)(x-1)),x5y3$2,f(a,b)(a*b))", 2, 2);
+}
+
+TEST(FusedTest, float_cells_are_fused) {
+    verify_optimized("map(join(x5y3f,x5y3f$2,f(a,b)(a*b)),f(x)(x+0.1))", 2, 2);
+    verify_optimized("map(join(x5y3f,x5y3$2,f(a,b)(a-b)),f(x)(x*0.3))", 2, 2);
+}
+
+TEST(FusedTest, numbers_are_broadcast) {
+    verify_optimized("join(map(x5y3,f(x)(x+1)),a,f(x,y)(x*y))", 2, 2);
+    verify_optimized("join(a,join(x5y3,x5y3$2,f(x,y)(x-y)),f(x,y)(x/y))", 2, 3);
+    verify_optimized("join(reduce(x5,sum),join(x5y3,x5y3$2,f(x,y)(x-y)),f(x,y)(x+y))", 2, 3);
+}
+
+TEST(FusedTest, chains_are_fused_into_a_single_function) {
+    verify_optimized("join(map(join(x5y3,x5y3$2,f(a,b)(a+b)),f(x)(x*2)),map(x5y3$2,f(x)(x-1)),f(a,b)(a*b))", 4, 3);
+    verify_optimized("map(map(map(x5y3,f(x)(x+1)),f(x)(x*x)),f(x)(x-7))", 3, 1);
+}
+
+TEST(FusedTest, reduce_of_all_dimensions_is_fused) {
+    verify_optimized("reduce(map(join(x5y3,x5y3$2,f(a,b)(a-b)),f(x)(x*x)),sum)", 3, 2, Aggr::SUM);
+    verify_optimized("reduce(join(x5y3,x5y3$2,f(a,b)(a+b)),max,x,y)", 2, 2, Aggr::MAX);
+    verify_optimized("reduce(map(x5y3f,f(x)(x*0.1)),min)", 2, 1, Aggr::MIN);
+    verify_optimized("reduce(map(x5y3,f(x)(x/8)),prod)", 2, 1, Aggr::PROD);
+    verify_optimized("reduce(map(x5y3,f(x)(x+1)),avg)", 2, 1, Aggr::AVG);
+    verify_optimized("reduce(map(x5y3,f(x)(x+1)),count)", 2, 1, Aggr::COUNT);
+}
+
+TEST(FusedTest, cells_are_calculated_in_several_blocks) {
+    verify_optimized("map(join(x16y20,x16y20$2,f(a,b)(a*b)),f(x)(x-1))", 2, 2);
+    verify_optimized("map(join(x16y20f,x16y20$2,f(a,b)(a*b)),f(x)(x-1))", 2, 2);
+    verify_optimized("reduce(join(x16y20,x16y20$2,f(a,b)(a-b)),sum)", 2, 2, Aggr::SUM);
+}
+
+TEST(FusedTest, single_operations_are_not_fused) {
+    verify_not_optimized("map(x5y3,f(x)(x+1))");
+    verify_not_optimized("join(x5y3,x5y3$2,f(a,b)(a+b))");
+    verify_not_optimized("reduce(x5y3,sum)");
+}
+
+TEST(FusedTest, operations_with_different_dimensions_are_not_fused) {
+    verify_not_optimized("map(join(x5,y3,f(a,b)(a+b)),f(x)(x*3))");
+    verify_not_optimized("map(join(x5y3,y3,f(a,b)(a+b)),f(x)(x*3))");
+    verify_not_optimized("reduce(map(x5y3,f(x)(x+1)),sum,x)");
+}
+
+TEST(FusedTest, non_dense_operations_are_not_fused) {
+    verify_not_optimized("map(map(mixed,f(x)(x+1)),f(x)(x*3))");
+    verify_not_optimized("map(map(a,f(x)(x+1)),f(x)(x*3))");
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
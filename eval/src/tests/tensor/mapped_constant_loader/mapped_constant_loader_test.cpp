@@ -0,0 +1,142 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/mapped_constant_loader.h>
+#include <vespa/eval/tensor/dense/mapped_dense_tensor.h>
+#include <vespa/vespalib/io/fileutil.h>
+#include <cstdio>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::tensor;
+
+const TensorEngine &engine = DefaultTensorEngine::ref();
+const vespalib::string cache_dir("mapped_constant_loader_test_dir");
+const vespalib::string source_file("mapped_constant_loader_test_source");
+
+TensorSpec make_dense(const vespalib::string &type) {
+    return TensorSpec(type)
+        .add({{"x", 0}, {"y", 0}}, 1.0)
+        .add({{"x", 0}, {"y", 1}}, 2.0)
+        .add({{"x", 1}, {"y", 0}}, 3.0)
+        .add({{"x", 1}, {"y", 1}}, 4.0)
+        .add({{"x", 2}, {"y", 0}}, 5.0)
+        .add({{"x", 2}, {"y", 1}}, 6.0);
+}
+
+TensorSpec make_sparse() {
+    return TensorSpec("tensor(x{})").add({{"x", "a"}}, 1.0).add({{"x", "b"}}, 2.0);
+}
+
+// creates constants from specs, ignoring the path
+struct MySpecFactory : ConstantValueFactory {
+    mutable size_t num_created = 0;
+    ConstantValue::UP create(const vespalib::string &, const vespalib::string &type) const override {
+        ++num_created;
+        if (ValueType::from_spec(type).is_dense()) {
+            return std::make_unique<SimpleConstantValue>(engine.from_spec(make_dense(type)));
+        }
+        return std::make_unique<SimpleConstantValue>(engine.from_spec(make_sparse()));
+    }
+};
+
+void write_file(const vespalib::string &name, const vespalib::string &content) {
+    FILE *file = fopen(name.c_str(), "wb");
+    ASSERT_TRUE(file != nullptr);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+}
+
+struct Fixture {
+    MySpecFactory factory;
+    MappedConstantLoader loader;
+    Fixture() : factory(), loader(factory, cache_dir) {
+        vespalib::rmdir(cache_dir, true);
+        vespalib::mkdir(cache_dir, true);
+        write_file(source_file, "original constant");
+    }
+    ~Fixture() {
+        vespalib::rmdir(cache_dir, true);
+        vespalib::unlink(source_file);
+    }
+    size_t num_files() const { return vespalib::listDirectory(cache_dir).size(); }
+};
+
+bool is_mapped(const ConstantValue &constant) {
+    return (dynamic_cast<const MappedDenseTensor *>(&constant.value()) != nullptr);
+}
+
+TEST("require that dense tensors can be saved and loaded") {
+    vespalib::string file_name = cache_dir + ".tmp";
+    for (const char *type: {"tensor(x[3],y[2])", "tensor<float>(x[3],y[2])"}) {
+        auto tensor = engine.from_spec(make_dense(type));
+        auto &dense = dynamic_cast<const DenseTensorView &>(*tensor);
+        EXPECT_TRUE(MappedDenseTensor::save(file_name, dense));
+        auto mapped = MappedDenseTensor::load(file_name);
+        ASSERT_TRUE(mapped);
+        EXPECT_EQUAL(mapped->type(), ValueType::from_spec(type));
+        EXPECT_EQUAL((size_t(mapped->cellsRef().data) % 4096), 0u);
+        EXPECT_EQUAL(engine.to_spec(*mapped), make_dense(type));
+    }
+    vespalib::unlink(file_name);
+}
+
+TEST("require that invalid files are not loaded") {
+    vespalib::string file_name = cache_dir + ".tmp";
+    EXPECT_FALSE(MappedDenseTensor::load(file_name));
+    TEST_DO(write_file(file_name, "not a tensor"));
+    EXPECT_FALSE(MappedDenseTensor::load(file_name));
+    vespalib::unlink(file_name);
+}
+
+TEST_F("require that dense constants are converted once and then mapped", Fixture) {
+    auto first = f1.loader.create(source_file, "tensor(x[3],y[2])");
+    EXPECT_TRUE(is_mapped(*first));
+    EXPECT_EQUAL(f1.factory.num_created, 1u);
+    EXPECT_EQUAL(f1.num_files(), 1u);
+    auto second = f1.loader.create(source_file, "tensor(x[3],y[2])");
+    EXPECT_TRUE(is_mapped(*second));
+    EXPECT_EQUAL(f1.factory.num_created, 1u);
+    EXPECT_EQUAL(engine.to_spec(second->value()), make_dense("tensor(x[3],y[2])"));
+    auto third = f1.loader.create(source_file, "tensor<float>(x[3],y[2])");
+    EXPECT_TRUE(is_mapped(*third));
+    EXPECT_EQUAL(f1.factory.num_created, 2u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+}
+
+TEST_F("require that changed source files are converted again", Fixture) {
+    auto first = f1.loader.create(source_file, "tensor(x[3],y[2])");
+    TEST_DO(write_file(source_file, "changed constant with another size"));
+    auto second = f1.loader.create(source_file, "tensor(x[3],y[2])");
+    EXPECT_TRUE(is_mapped(*second));
+    EXPECT_EQUAL(f1.factory.num_created, 2u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+}
+
+TEST_F("require that sparse constants are not mapped", Fixture) {
+    auto constant = f1.loader.create(source_file, "tensor(x{})");
+    EXPECT_FALSE(is_mapped(*constant));
+    EXPECT_EQUAL(engine.to_spec(constant->value()), make_sparse());
+    EXPECT_EQUAL(f1.num_files(), 0u);
+}
+
+TEST_F("require that constants are created directly when files cannot be stored", Fixture) {
+    MappedConstantLoader loader(f1.factory, cache_dir + "/no/such/dir");
+    auto constant = loader.create(source_file, "tensor(x[3],y[2])");
+    EXPECT_FALSE(is_mapped(*constant));
+    EXPECT_EQUAL(engine.to_spec(constant->value()), make_dense("tensor(x[3],y[2])"));
+}
+
+TEST_F("require that converted files can be pruned", Fixture) {
+    auto first = f1.loader.create(source_file, "tensor(x[3],y[2])");
+    auto second = f1.loader.create(source_file, "tensor<float>(x[3],y[2])");
+    EXPECT_EQUAL(f1.num_files(), 2u);
+    EXPECT_EQUAL(MappedConstantLoader::prune(cache_dir, 1024 * 1024), 0u);
+    EXPECT_EQUAL(f1.num_files(), 2u);
+    EXPECT_EQUAL(MappedConstantLoader::prune(cache_dir, 0), 2u);
+    EXPECT_EQUAL(f1.num_files(), 0u);
+    EXPECT_EQUAL(engine.to_spec(first->value()), make_dense("tensor(x[3],y[2])"));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,93 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/simple_tensor_engine.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/sparse/sparse_tensor.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::operation;
+using namespace vespalib::tensor;
+
+using join_fun_t = TensorEngine::join_fun_t;
+
+const TensorEngine &prod_engine = DefaultTensorEngine::ref();
+const TensorEngine &ref_engine = SimpleTensorEngine::ref();
+
+// all combinations of num_labels labels for the given dimensions
+TensorSpec make_spec(const vespalib::string &type, const std::vector<vespalib::string> &dims,
+                     size_t num_labels, double seed)
+{
+    TensorSpec spec(type);
+    size_t num_cells = 1;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        num_cells *= num_labels;
+    }
+    for (size_t cell = 0; cell < num_cells; ++cell) {
+        TensorSpec::Address addr;
+        size_t rest = cell;
+        for (const auto &dim: dims) {
+            addr.emplace(dim, make_string("l%zu", rest % num_labels));
+            rest /= num_labels;
+        }
+        spec.add(addr, seed + cell);
+    }
+    return spec;
+}
+
+void verify_join(const TensorSpec &a, const TensorSpec &b, join_fun_t function) {
+    Stash stash;
+    auto lhs = prod_engine.from_spec(a);
+    auto rhs = prod_engine.from_spec(b);
+    const Value &result = prod_engine.join(*lhs, *rhs, function, stash);
+    EXPECT_TRUE(dynamic_cast<const SparseTensor *>(&result) != nullptr);
+    auto ref_lhs = ref_engine.from_spec(a);
+    auto ref_rhs = ref_engine.from_spec(b);
+    const Value &expect = ref_engine.join(*ref_lhs, *ref_rhs, function, stash);
+    EXPECT_EQUAL(prod_engine.to_spec(result), ref_engine.to_spec(expect));
+}
+
+void verify_all(const TensorSpec &a, const TensorSpec &b) {
+    TEST_DO(verify_join(a, b, Mul::f));
+    TEST_DO(verify_join(a, b, Sub::f));
+    TEST_DO(verify_join(b, a, Sub::f));
+    TEST_DO(verify_join(a, b, Div::f));
+}
+
+TEST("require that tensors with the same dimensions are joined on matching cells") {
+    auto small = make_spec("tensor(x{},y{})", {"x", "y"}, 3, 1.0);
+    auto large = make_spec("tensor(x{},y{})", {"x", "y"}, 5, 2.0);
+    TEST_DO(verify_all(small, large));
+    TEST_DO(verify_all(small, small));
+}
+
+TEST("require that tensors with partially overlapping dimensions are joined on common labels") {
+    auto xy = make_spec("tensor(x{},y{})", {"x", "y"}, 4, 1.0);
+    auto yz = make_spec("tensor(y{},z{})", {"y", "z"}, 3, 3.0);
+    auto y = make_spec("tensor(y{})", {"y"}, 6, 5.0);
+    auto xyz = make_spec("tensor(x{},y{},z{})", {"x", "y", "z"}, 3, 7.0);
+    TEST_DO(verify_all(xy, yz));
+    TEST_DO(verify_all(xy, y));
+    TEST_DO(verify_all(xyz, yz));
+    TEST_DO(verify_all(xyz, xy));
+}
+
+TEST("require that tensors without common dimensions are joined on all combinations") {
+    auto x = make_spec("tensor(x{})", {"x"}, 4, 1.0);
+    auto yz = make_spec("tensor(y{},z{})", {"y", "z"}, 3, 2.0);
+    TEST_DO(verify_all(x, yz));
+}
+
+TEST("require that empty tensors give empty results") {
+    auto xy = make_spec("tensor(x{},y{})", {"x", "y"}, 3, 1.0);
+    auto empty_xy = make_spec("tensor(x{},y{})", {"x", "y"}, 0, 1.0);
+    auto empty_y = make_spec("tensor(y{})", {"y"}, 0, 1.0);
+    TEST_DO(verify_all(xy, empty_xy));
+    TEST_DO(verify_all(xy, empty_y));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,237 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/node_types.h>
+#include <vespa/eval/eval/interpreted_function.h>
+#include <vespa/eval/eval/make_tensor_function.h>
+#include <vespa/eval/eval/simple_tensor_engine.h>
+#include <vespa/eval/eval/test/tensor_model.hpp>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/stash.h>
+#include <map>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+using vespalib::make_string_short::fmt;
+using vespalib::tensor::DefaultTensorEngine;
+
+double budget = 0.25;
+
+//-----------------------------------------------------------------------------
+
+// the different ways a tensor function can be evaluated
+struct Impl {
+    const char *name;
+    const TensorEngine &engine;
+    bool optimize;
+};
+
+const std::vector<Impl> impls = {
+    {"simple",    SimpleTensorEngine::ref(),  false},
+    {"default",   DefaultTensorEngine::ref(), false},
+    {"optimized", DefaultTensorEngine::ref(), true}
+};
+
+//-----------------------------------------------------------------------------
+
+using ParamRepo = std::map<vespalib::string,TensorSpec>;
+
+std::vector<vespalib::string> make_labels(size_t n) {
+    std::vector<vespalib::string> labels;
+    for (size_t i = 0; i < n; ++i) {
+        labels.push_back(fmt("l%zu", i));
+    }
+    return labels;
+}
+
+// small integers, stored exactly in all cell types
+struct SmallInts : Sequence {
+    double operator[](size_t i) const override { return double(int(i % 17) - 8); }
+};
+
+// d: dense, s: sparse, m: mixed (mapped x, indexed y)
+// f: float cells, i: int8 cells, b: bfloat16 cells
+ParamRepo make_params(size_t n) {
+    N seq;
+    Div16 seq2(seq);
+    SmallInts small;
+    Sub2 small2(small);
+    auto keys = make_labels(n);
+    ParamRepo repo;
+    repo.emplace("number", spec(2.5));
+    repo.emplace("dx",     spec({x(n)}, seq));
+    repo.emplace("dx2",    spec({x(n)}, seq2));
+    repo.emplace("dy",     spec({y(n)}, seq));
+    repo.emplace("dyf",    spec(float_cells({y(n)}), seq));
+    repo.emplace("dxy",    spec({x(n),y(n)}, seq));
+    repo.emplace("dxy2",   spec({x(n),y(n)}, seq2));
+    repo.emplace("dxyf",   spec(float_cells({x(n),y(n)}), seq));
+    repo.emplace("dxyf2",  spec(float_cells({x(n),y(n)}), seq2));
+    repo.emplace("dyz",    spec({y(n),z(n)}, seq2));
+    repo.emplace("dyzf",   spec(float_cells({y(n),z(n)}), seq2));
+    repo.emplace("sxy",    spec({x(keys),y(keys)}, seq));
+    repo.emplace("sxy2",   spec({x(keys),y(keys)}, seq2));
+    repo.emplace("syz",    spec({y(keys),z(keys)}, seq2));
+    repo.emplace("mxy",    spec({x(keys),y(n)}, seq));
+    repo.emplace("mxy2",   spec({x(keys),y(n)}, seq2));
+    repo.emplace("mxyf",   spec(float_cells({x(keys),y(n)}), seq));
+    repo.emplace("dxi",    spec(int8_cells({x(n)}), small));
+    repo.emplace("dxi2",   spec(int8_cells({x(n)}), small2));
+    repo.emplace("dxb",    spec(bfloat16_cells({x(n)}), small));
+    repo.emplace("dxb2",   spec(bfloat16_cells({x(n)}), small2));
+    repo.emplace("dxys",   spec({x(n),y(n)}, small));
+    repo.emplace("dxyi",   spec(int8_cells({x(n),y(n)}), small));
+    repo.emplace("dxyi2",  spec(int8_cells({x(n),y(n)}), small2));
+    repo.emplace("dxyb",   spec(bfloat16_cells({x(n),y(n)}), small));
+    repo.emplace("dxyb2",  spec(bfloat16_cells({x(n),y(n)}), small2));
+    repo.emplace("dyzb",   spec(bfloat16_cells({y(n),z(n)}), small2));
+    return repo;
+}
+
+struct Case {
+    vespalib::string kind;
+    vespalib::string expr;
+};
+
+std::vector<Case> make_cases(size_t n) {
+    return {
+        {"join",       "dxy*dxy2"},
+        {"join",       "dxyf*dxyf2"},
+        {"join",       "dx*dy"},
+        {"join",       "dxy*dyz"},
+        {"join",       "number*dxy"},
+        {"join",       "sxy*sxy2"},
+        {"join",       "sxy*syz"},
+        {"join",       "mxy*mxy2"},
+        {"join",       "mxy*dy"},
+        {"join",       "mxyf*dyf"},
+        {"join",       "dxyi*dxyi2"},
+        {"join",       "dxyb*dxyb2"},
+        {"join",       "dxyi*dxys"},
+        {"join",       "number*dxyb"},
+        {"map",        "map(dxy,f(a)(a*2))"},
+        {"map",        "map(sxy,f(a)(a*2))"},
+        {"map",        "map(mxy,f(a)(a*2))"},
+        {"map",        "map(dxyi,f(a)(a*2))"},
+        {"map",        "map(dxyb,f(a)(a*2))"},
+        {"merge",      "merge(dxy,dxy2,f(a,b)(a+b))"},
+        {"merge",      "merge(sxy,sxy2,f(a,b)(a+b))"},
+        {"merge",      "merge(mxy,mxy2,f(a,b)(a+b))"},
+        {"reduce",     "reduce(dxy,sum)"},
+        {"reduce",     "reduce(dxy,sum,x)"},
+        {"reduce",     "reduce(dxy,sum,y)"},
+        {"reduce",     "reduce(dxyf,max,y)"},
+        {"reduce",     "reduce(dxyi,sum,y)"},
+        {"reduce",     "reduce(dxyb,max,y)"},
+        {"reduce",     "reduce(sxy,sum)"},
+        {"reduce",     "reduce(sxy,sum,y)"},
+        {"reduce",     "reduce(mxy,sum,x)"},
+        {"reduce",     "reduce(mxy,sum,y)"},
+        {"rename",     "rename(dxy,x,a)"},
+        {"rename",     "rename(dxy,(x,y),(y,x))"},
+        {"rename",     "rename(dxyi,x,a)"},
+        {"rename",     "rename(sxy,x,a)"},
+        {"rename",     "rename(mxy,x,a)"},
+        {"concat",     "concat(dxy,dxy2,x)"},
+        {"concat",     "concat(dxy,dxy2,z)"},
+        {"concat",     "concat(dxyf,dxy,x)"},
+        {"concat",     "concat(dxyi,dxyb,x)"},
+        {"peek",       "dxy{x:3,y:5}"},
+        {"peek",       "dxy{x:3}"},
+        {"peek",       "sxy{x:l3,y:l5}"},
+        {"peek",       "sxy{x:l3}"},
+        {"peek",       "mxy{x:l3}"},
+        {"lambda",     fmt("tensor(x[%zu],y[%zu])(x*y+number)", n, n)},
+        {"lambda",     fmt("tensor(y[%zu],x[%zu])(dxy{x:(x),y:(y)})", n, n)},
+        {"lambda",     fmt("tensor(x[%zu])(dxy{x:(x),y:(x)}+number)", n)},
+        {"dot",        "reduce(dx*dx2,sum)"},
+        {"dot",        "reduce(dxi*dxi2,sum)"},
+        {"dot",        "reduce(dxb*dxb2,sum)"},
+        {"xw_product", "reduce(dy*dyz,sum,y)"},
+        {"xw_product", "reduce(dyf*dyzf,sum,y)"},
+        {"matmul",     "reduce(dxy*dyz,sum,y)"},
+        {"matmul",     "reduce(dxyf*dyzf,sum,y)"},
+        {"matmul",     "reduce(dxyb*dyzb,sum,y)"},
+        {"fused",      "reduce(map(dxy*dxy2,f(a)(a*a)),sum)"}
+    };
+}
+
+//-----------------------------------------------------------------------------
+
+struct Result {
+    TensorSpec value;
+    double ops_per_sec;
+    Result(TensorSpec value_in, double ops_per_sec_in)
+        : value(std::move(value_in)), ops_per_sec(ops_per_sec_in) {}
+};
+
+Result eval_and_measure(const Impl &impl, const Function &function, const NodeTypes &types, const ParamRepo &repo) {
+    Stash stash;
+    const TensorFunction &plain_fun = make_tensor_function(impl.engine, function.root(), types, stash);
+    const TensorFunction &fun = impl.optimize ? impl.engine.optimize(plain_fun, stash) : plain_fun;
+    InterpretedFunction ifun(impl.engine, fun);
+    InterpretedFunction::Context ctx(ifun);
+    std::vector<Value::UP> values;
+    std::vector<Value::CREF> refs;
+    for (size_t i = 0; i < function.num_params(); ++i) {
+        values.push_back(impl.engine.from_spec(repo.find(function.param_name(i))->second));
+        refs.emplace_back(*values.back());
+    }
+    SimpleObjectParams params(refs);
+    TensorSpec value = impl.engine.to_spec(ifun.eval(ctx, params));
+    double seconds = BenchmarkTimer::benchmark([&](){ ifun.eval(ctx, params); }, budget);
+    return Result(std::move(value), 1.0 / seconds);
+}
+
+void benchmark_case(const Case &c, const ParamRepo &repo) {
+    auto function = Function::parse(c.expr);
+    ASSERT_TRUE(!function->has_error());
+    std::vector<ValueType> param_types;
+    for (size_t i = 0; i < function->num_params(); ++i) {
+        auto pos = repo.find(function->param_name(i));
+        ASSERT_TRUE(pos != repo.end());
+        param_types.push_back(ValueType::from_spec(pos->second.type()));
+    }
+    NodeTypes types(*function, param_types);
+    ASSERT_TRUE(types.errors().empty());
+    std::vector<Result> results;
+    for (const Impl &impl: impls) {
+        results.push_back(eval_and_measure(impl, *function, types, repo));
+        EXPECT_EQUAL(results.back().value, results.front().value);
+    }
+    fprintf(stderr, "%-10s %-40s", c.kind.c_str(), c.expr.c_str());
+    for (const Result &result: results) {
+        fprintf(stderr, " %12.0f", result.ops_per_sec);
+    }
+    fprintf(stderr, "\n");
+}
+
+void benchmark_all(size_t n) {
+    ParamRepo repo = make_params(n);
+    fprintf(stderr, "--- size %zu (ops/sec) ---\n", n);
+    fprintf(stderr, "%-10s %-40s", "kind", "expression");
+    for (const Impl &impl: impls) {
+        fprintf(stderr, " %12s", impl.name);
+    }
+    fprintf(stderr, "\n");
+    for (const Case &c: make_cases(n)) {
+        TEST_STATE(c.expr.c_str());
+        benchmark_case(c, repo);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+TEST("benchmark tensor functions with small tensors") {
+    benchmark_all(16);
+}
+
+TEST("benchmark tensor functions with large tensors") {
+    benchmark_all(64);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,6 +8,7 @@
 #include <vespa/eval/tensor/serialization/sparse_binary_format.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/objects/hexdump.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <ostream>
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 
@@ -218,4 +219,48 @@ TEST("test float cells for dense tensor") {
                               .add({{"x", 2}, {"y", 4}}, 3)));
 }
 
+TEST("test int8 cells for dense tensor") {
+    TEST_DO(verify_serialized({0x06, 0x03, 0x01, 0x01, 0x78, 0x03,
+                               0x01, 0xfe, 0x03 },
+                              TensorSpec("tensor<int8>(x[3])")
+                              .add({{"x", 0}}, 1)
+                              .add({{"x", 1}}, -2)
+                              .add({{"x", 2}}, 3)));
+}
+
+TEST("test bfloat16 cells for dense tensor") {
+    TEST_DO(verify_serialized({0x06, 0x02, 0x01, 0x01, 0x78, 0x02,
+                               0x3f, 0x80, 0xc0, 0x20 },
+                              TensorSpec("tensor<bfloat16>(x[2])")
+                              .add({{"x", 0}}, 1.0)
+                              .add({{"x", 1}}, -2.5)));
+}
+
+TEST("test dense tensors with more cells than converted at a time") {
+    auto &engine = DefaultTensorEngine::ref();
+    for (const char *type: {"tensor(x[1000])", "tensor<float>(x[1000])",
+                            "tensor<bfloat16>(x[1000])", "tensor<int8>(x[1000])"})
+    {
+        TensorSpec spec(type);
+        for (size_t i = 0; i < 1000; ++i) {
+            spec.add({{"x", i}}, double(i % 100) - 50.0);
+        }
+        auto value = engine.from_spec(spec);
+        nbostream stream;
+        engine.encode(*value, stream);
+        auto decoded = engine.decode(stream);
+        EXPECT_EQUAL(0u, stream.size());
+        EXPECT_EQUAL(engine.to_spec(*decoded), spec);
+    }
+}
+
+TEST("test that truncated dense tensors are not decoded") {
+    ExpBuffer data({0x06, 0x01, 0x01, 0x01, 0x78, 0x02,
+                    0x3f, 0x80, 0x00, 0x00,
+                    0x40, 0x00, 0x00 });
+    nbostream input(&data[0], data.size());
+    EXPECT_EXCEPTION(TypedBinaryFormat::deserialize(input), vespalib::IllegalStateException,
+                     "Stream too short for 2 dense tensor cells");
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
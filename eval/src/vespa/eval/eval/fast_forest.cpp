@@ -8,6 +8,7 @@
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <arpa/inet.h>
 
 namespace vespalib::eval::gbdt {
@@ -143,10 +144,15 @@ template <> vespalib::string fixed_impl_name<uint64_t>() { return "ff-fixed<64>"
 template <typename T>
 constexpr size_t max_leafs() { return (sizeof(T) * bits_per_byte); }
 
+// number of documents evaluated side by side by eval_many; all
+// per-document loops have this fixed trip count to be vectorized
+constexpr size_t num_lanes = 16;
+
 template <typename T>
 struct FixedContext : FastForest::Context {
     std::vector<T> masks;
-    FixedContext(size_t num_trees) : masks(num_trees) {}
+    std::vector<T> lane_masks; // [tree][lane], allocated on first eval_many
+    FixedContext(size_t num_trees) : masks(num_trees), lane_masks() {}
 };
 
 template <typename T>
@@ -197,9 +203,16 @@ struct FixedForest : FastForest {
     static void apply_masks(T *ctx_masks, const DMask *pos, const DMask *end);
     double get_result(const T *ctx_masks) const;
 
+    static void apply_lane_masks(T *lane_masks, const Mask *pos, const Mask *end,
+                                 const float *features, float max_feature);
+    static void apply_lane_masks(T *lane_masks, const DMask *pos, const DMask *end,
+                                 const float *features);
+    void get_lane_results(const T *lane_masks, double *result, size_t num_docs) const;
+
     vespalib::string impl_name() const override { return fixed_impl_name<T>(); }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_many(Context &context, const float *params, size_t num_docs, double *result) const override;
 };
 
 template <typename T>
@@ -306,6 +319,59 @@ FixedForest<T>::get_result(const T *ctx_masks) const
     return (result1 + result2);
 }
 
+template <typename T>
+void
+FixedForest<T>::apply_lane_masks(T *lane_masks, const Mask *pos, const Mask *end,
+                                 const float *features, float max_feature)
+{
+    // masks are sorted on value; stop when no lane passes the split
+    for (; (pos < end) && !(max_feature < pos->value); ++pos) {
+        T *dst = lane_masks + (pos->tree * num_lanes);
+        const float value = pos->value;
+        const T bits = pos->bits;
+        // NaN lanes never pass; they are handled by the default masks
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+            dst[lane] &= (features[lane] >= value) ? bits : T(~T(0));
+        }
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::apply_lane_masks(T *lane_masks, const DMask *pos, const DMask *end,
+                                 const float *features)
+{
+    for (; pos < end; ++pos) {
+        T *dst = lane_masks + (pos->tree * num_lanes);
+        const T bits = pos->bits;
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+            dst[lane] &= std::isnan(features[lane]) ? bits : T(~T(0));
+        }
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::get_lane_results(const T *lane_masks, double *result, size_t num_docs) const
+{
+    // leafs are summed in the same order as get_result to produce
+    // exactly the same results as eval
+    double result1[num_lanes] = {};
+    double result2[num_lanes] = {};
+    const float *leafs = &_padded_leafs[0];
+    size_t leaf_cnt = _max_leafs;
+    size_t unrolled_trees = (_num_trees & ~size_t(3));
+    for (size_t tree = 0; tree < _num_trees; ++tree, lane_masks += num_lanes, leafs += leaf_cnt) {
+        double *dst = ((tree < unrolled_trees) && ((tree & 1) == 1)) ? result2 : result1;
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+            dst[lane] += leafs[get_lsb(lane_masks[lane])];
+        }
+    }
+    for (size_t lane = 0; lane < num_docs; ++lane) {
+        result[lane] = (result1[lane] + result2[lane]);
+    }
+}
+
 template <typename T>
 FastForest::Context::UP
 FixedForest<T>::create_context() const
@@ -335,13 +401,58 @@ FixedForest<T>::eval(Context &context, const float *params) const
     return get_result(ctx_masks);
 }
 
+template <typename T>
+void
+FixedForest<T>::eval_many(Context &context, const float *params, size_t num_docs, double *result) const
+{
+    auto &ctx = static_cast<FixedContext<T>&>(context);
+    ctx.lane_masks.resize(_num_trees * num_lanes);
+    T *lane_masks = &ctx.lane_masks[0];
+    float features[num_lanes];
+    for (size_t first = 0; first < num_docs; first += num_lanes) {
+        size_t cnt = std::min(num_lanes, num_docs - first);
+        memset(lane_masks, 0xff, _num_trees * num_lanes * sizeof(T));
+        const Mask *mask_pos = &_masks[0];
+        for (size_t param = 0; param < _mask_sizes.size(); ++param) {
+            const float *column = params + (param * num_docs) + first;
+            float max_feature = -std::numeric_limits<float>::infinity();
+            bool has_value = false;
+            bool has_nan = false;
+            for (size_t lane = 0; lane < num_lanes; ++lane) {
+                // unused lanes repeat the first document
+                float feature = column[(lane < cnt) ? lane : 0];
+                features[lane] = feature;
+                if (std::isnan(feature)) {
+                    has_nan = true;
+                } else {
+                    has_value = true;
+                    max_feature = std::max(max_feature, feature);
+                }
+            }
+            uint32_t size = _mask_sizes[param];
+            if (has_value) {
+                apply_lane_masks(lane_masks, mask_pos, mask_pos + size, features, max_feature);
+            }
+            if (has_nan) {
+                apply_lane_masks(lane_masks,
+                                 &_default_masks[_default_offsets[param]],
+                                 &_default_masks[_default_offsets[param + 1]],
+                                 features);
+            }
+            mask_pos += size;
+        }
+        get_lane_results(lane_masks, result + first, cnt);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // implementation using multiple words for each tree
 //-----------------------------------------------------------------------------
 
 struct MultiWordContext : FastForest::Context {
     std::vector<uint32_t> words;
-    MultiWordContext(size_t size) : words(size) {}
+    std::vector<float> params;
+    MultiWordContext(size_t size, size_t num_params) : words(size), params(num_params) {}
 };
 
 struct MultiWordForest : FastForest {
@@ -440,6 +551,7 @@ struct MultiWordForest : FastForest {
     vespalib::string impl_name() const override { return "ff-multiword"; }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_many(Context &context, const float *params, size_t num_docs, double *result) const override;
 };
 
 MultiWordForest::MultiWordForest(const State &state)
@@ -591,7 +703,7 @@ MultiWordForest::get_result(const uint32_t *ctx_words) const
 FastForest::Context::UP
 MultiWordForest::create_context() const
 {
-    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size());
+    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size(), _mask_sizes.size());
 }
 
 double
@@ -620,6 +732,19 @@ MultiWordForest::eval(Context &context, const float *params) const
     return get_result(ctx_words);
 }
 
+void
+MultiWordForest::eval_many(Context &context, const float *params, size_t num_docs, double *result) const
+{
+    // large trees are dominated by the per-tree mask words; evaluate one document at a time
+    auto &doc_params = static_cast<MultiWordContext&>(context).params;
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        for (size_t param = 0; param < doc_params.size(); ++param) {
+            doc_params[param] = params[(param * num_docs) + doc];
+        }
+        result[doc] = eval(context, doc_params.data());
+    }
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -17,6 +17,11 @@ namespace vespalib::eval::gbdt {
  * Comparisons must be on the form 'feature < const' or '!(feature >=
  * const)'. The inverted form is used to signal that the true branch
  * should be selected when the feature value is missing (NaN).
+ *
+ * The forest can also be evaluated for several documents at once
+ * (eval_many). Parameters are then passed column-wise, which lets
+ * implementations compare the feature values of many documents
+ * against each split threshold in a single vectorizable loop.
  **/
 class FastForest
 {
@@ -36,6 +41,8 @@ public:
     virtual vespalib::string impl_name() const = 0;
     virtual Context::UP create_context() const = 0;
     virtual double eval(Context &context, const float *params) const = 0;
+    // params[(p * num_docs) + d] is parameter p for document d
+    virtual void eval_many(Context &context, const float *params, size_t num_docs, double *result) const = 0;
     double estimate_cost_us(const std::vector<double> &params, double budget = 5.0) const;
 };
 
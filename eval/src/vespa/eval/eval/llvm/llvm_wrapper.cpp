@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include "llvm_wrapper.h"
+#include "object_cache.h"
 #include <vespa/eval/eval/node_visitor.h>
 #include <vespa/eval/eval/node_traverser.h>
 #include <llvm/IR/Verifier.h>
@@ -9,6 +10,7 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/Analysis/Passes.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/Transforms/Scalar.h>
@@ -713,9 +715,20 @@ LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
     if (dumpStream) {
         _module->print(*dumpStream, nullptr);
     }
+    // injected addresses of forests and plugin state are only valid in this process
+    std::unique_ptr<llvm::ObjectCache> object_cache;
+    if (_forests.empty() && _plugin_state.empty()) {
+        object_cache = ObjectCache::make(*_module);
+    }
     _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
     assert(_engine && "llvm jit not available for your platform");
+    if (object_cache) {
+        _engine->setObjectCache(object_cache.get());
+    }
     _engine->finalizeObject();
+    if (object_cache) {
+        _engine->setObjectCache(nullptr);
+    }
 }
 
 void *
@@ -0,0 +1,268 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "object_cache.h"
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/sha1.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#include <utime.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.eval.llvm.object_cache");
+
+namespace vespalib::eval {
+
+namespace {
+
+constexpr char file_magic[8] = {'V','E','V','A','L','O','B','J'};
+constexpr size_t digest_size = 20;
+const vespalib::string file_suffix(".o");
+
+std::mutex dir_lock;
+vespalib::string cache_dir;
+
+std::atomic<size_t> num_hits(0);
+std::atomic<size_t> num_misses(0);
+std::atomic<size_t> num_stored(0);
+
+// everything besides the module itself that affects the generated code
+vespalib::string make_target_info() {
+    std::vector<std::string> features;
+    llvm::StringMap<bool> host_features;
+    if (llvm::sys::getHostCPUFeatures(host_features)) {
+        for (const auto &entry: host_features) {
+            if (entry.getValue()) {
+                features.push_back(entry.getKey().str());
+            }
+        }
+    }
+    std::sort(features.begin(), features.end());
+    vespalib::string info = make_string("format:2;llvm:%s;cpu:%s;features:",
+                                        LLVM_VERSION_STRING, llvm::sys::getHostCPUName().str().c_str());
+    for (size_t i = 0; i < features.size(); ++i) {
+        if (i > 0) {
+            info.append(",");
+        }
+        info.append(features[i]);
+    }
+    return info;
+}
+
+const vespalib::string &target_info() {
+    static const vespalib::string info = make_target_info();
+    return info;
+}
+
+vespalib::string to_hex(const char *data, size_t size) {
+    vespalib::string result;
+    for (size_t i = 0; i < size; ++i) {
+        result.append(make_string("%02x", (unsigned char)data[i]));
+    }
+    return result;
+}
+
+bool read_file(const vespalib::string &name, std::vector<char> &data) {
+    FILE *file = fopen(name.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = (fseek(file, 0, SEEK_END) == 0);
+    long size = ok ? ftell(file) : -1;
+    ok = ok && (size >= 0) && (fseek(file, 0, SEEK_SET) == 0);
+    if (ok) {
+        data.resize(size);
+        ok = (fread(data.data(), 1, data.size(), file) == data.size());
+    }
+    fclose(file);
+    return ok;
+}
+
+bool write_file(const vespalib::string &name, const std::vector<llvm::StringRef> &parts) {
+    FILE *file = fopen(name.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = true;
+    for (const auto &part: parts) {
+        ok = ok && (fwrite(part.data(), 1, part.size(), file) == part.size());
+    }
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+struct DiskObjectCache : llvm::ObjectCache {
+    vespalib::string file_name;
+    char digest[digest_size];
+
+    DiskObjectCache(const vespalib::string &dir, const llvm::Module &module);
+    bool check_header(const std::vector<char> &data, size_t &obj_offset) const;
+    void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef obj) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
+};
+
+DiskObjectCache::DiskObjectCache(const vespalib::string &dir, const llvm::Module &module)
+    : file_name(),
+      digest()
+{
+    std::string ir;
+    llvm::raw_string_ostream ir_stream(ir);
+    module.print(ir_stream, nullptr);
+    ir_stream.flush();
+    Sha1 sha1;
+    sha1.process(target_info().data(), target_info().size());
+    sha1.process("\n", 1);
+    sha1.process(ir.data(), ir.size());
+    sha1.get_digest(digest, digest_size);
+    file_name = dir + "/" + to_hex(digest, digest_size) + file_suffix;
+}
+
+// file layout: magic, target info size (uint32_t), target info,
+// digest, object size (uint64_t), object checksum (uint64_t), object
+bool
+DiskObjectCache::check_header(const std::vector<char> &data, size_t &obj_offset) const
+{
+    const vespalib::string &info = target_info();
+    uint32_t info_size = 0;
+    uint64_t obj_size = 0;
+    uint64_t obj_checksum = 0;
+    size_t pos = 0;
+    if ((data.size() < sizeof(file_magic) + sizeof(info_size)) ||
+        (memcmp(data.data(), file_magic, sizeof(file_magic)) != 0))
+    {
+        return false;
+    }
+    pos += sizeof(file_magic);
+    memcpy(&info_size, data.data() + pos, sizeof(info_size));
+    pos += sizeof(info_size);
+    if ((info_size != info.size()) ||
+        (data.size() < pos + info_size + digest_size + sizeof(obj_size) + sizeof(obj_checksum)) ||
+        (memcmp(data.data() + pos, info.data(), info_size) != 0))
+    {
+        return false;
+    }
+    pos += info_size;
+    if (memcmp(data.data() + pos, digest, digest_size) != 0) {
+        return false;
+    }
+    pos += digest_size;
+    memcpy(&obj_size, data.data() + pos, sizeof(obj_size));
+    pos += sizeof(obj_size);
+    memcpy(&obj_checksum, data.data() + pos, sizeof(obj_checksum));
+    pos += sizeof(obj_checksum);
+    if ((obj_size == 0) || (data.size() != pos + obj_size) ||
+        (obj_checksum != uint64_t(hashValue(data.data() + pos, obj_size))))
+    {
+        return false;
+    }
+    obj_offset = pos;
+    return true;
+}
+
+void
+DiskObjectCache::notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef obj)
+{
+    const vespalib::string &info = target_info();
+    uint32_t info_size = info.size();
+    uint64_t obj_size = obj.getBufferSize();
+    uint64_t obj_checksum = hashValue(obj.getBufferStart(), obj_size);
+    // write to a temporary file first to never expose partial files
+    vespalib::string tmp_name = getUniqueTempFileName(file_name);
+    bool ok = write_file(tmp_name, {llvm::StringRef(file_magic, sizeof(file_magic)),
+                                    llvm::StringRef((const char *)&info_size, sizeof(info_size)),
+                                    llvm::StringRef(info.data(), info.size()),
+                                    llvm::StringRef(digest, digest_size),
+                                    llvm::StringRef((const char *)&obj_size, sizeof(obj_size)),
+                                    llvm::StringRef((const char *)&obj_checksum, sizeof(obj_checksum)),
+                                    obj.getBuffer()});
+    if (ok && (::rename(tmp_name.c_str(), file_name.c_str()) == 0)) {
+        ++num_stored;
+    } else {
+        LOG(warning, "could not store compiled object in '%s'", file_name.c_str());
+        ::unlink(tmp_name.c_str());
+    }
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+DiskObjectCache::getObject(const llvm::Module *)
+{
+    std::vector<char> data;
+    size_t obj_offset = 0;
+    if (read_file(file_name, data) && check_header(data, obj_offset)) {
+        ++num_hits;
+        // keep recently used files when pruning
+        utime(file_name.c_str(), nullptr);
+        return llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(data.data() + obj_offset, data.size() - obj_offset),
+                                                    file_name.c_str());
+    }
+    ++num_misses;
+    return std::unique_ptr<llvm::MemoryBuffer>();
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+void
+ObjectCache::set_directory(const vespalib::string &dir, size_t max_bytes)
+{
+    if (!dir.empty()) {
+        try {
+            vespalib::mkdir(dir, true);
+            prune(dir, max_bytes);
+        } catch (const vespalib::IoException &e) {
+            LOG(warning, "compiled object cache disabled: %s", e.getMessage().c_str());
+            std::lock_guard<std::mutex> guard(dir_lock);
+            cache_dir = "";
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> guard(dir_lock);
+    cache_dir = dir;
+}
+
+vespalib::string
+ObjectCache::get_directory()
+{
+    std::lock_guard<std::mutex> guard(dir_lock);
+    return cache_dir;
+}
+
+ObjectCache::Stats
+ObjectCache::get_stats()
+{
+    Stats stats;
+    stats.hits = num_hits.load();
+    stats.misses = num_misses.load();
+    stats.stored = num_stored.load();
+    return stats;
+}
+
+size_t
+ObjectCache::prune(const vespalib::string &dir, size_t max_bytes)
+{
+    return vespalib::pruneDirectory(dir, file_suffix, max_bytes);
+}
+
+std::unique_ptr<llvm::ObjectCache>
+ObjectCache::make(const llvm::Module &module)
+{
+    vespalib::string dir = get_directory();
+    if (dir.empty()) {
+        return std::unique_ptr<llvm::ObjectCache>();
+    }
+    return std::make_unique<DiskObjectCache>(dir, module);
+}
+
+}
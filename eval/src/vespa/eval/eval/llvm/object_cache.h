@@ -0,0 +1,64 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <memory>
+
+namespace llvm {
+class Module;
+class ObjectCache;
+}
+
+namespace vespalib::eval {
+
+/**
+ * Process-wide on-disk cache of machine code generated by LLVM. This
+ * is used to avoid compiling the same ranking expressions (and
+ * de-inlined GBDT forests) over again after a restart or
+ * reconfiguration.
+ *
+ * Cached objects are keyed on a digest of the module IR together with
+ * the LLVM version and the name and features of the host cpu. Each
+ * file also contains the full key and a checksum of the object code,
+ * which are checked when loading; files that do not match are ignored
+ * and the module is compiled as usual (replacing the file). Modules
+ * with the addresses of in-process objects baked into the code are
+ * never cached.
+ *
+ * The cache is disabled until a directory is set.
+ **/
+class ObjectCache
+{
+public:
+    struct Stats {
+        size_t hits;
+        size_t misses;
+        size_t stored;
+        Stats() : hits(0), misses(0), stored(0) {}
+    };
+
+    /**
+     * Start caching objects in the given directory, creating it if
+     * needed. Old files are removed until the total size of the cache
+     * is below max_bytes. An empty directory disables the cache.
+     **/
+    static void set_directory(const vespalib::string &dir, size_t max_bytes);
+    static vespalib::string get_directory();
+    static Stats get_stats();
+
+    /**
+     * Remove the least recently used cached objects until the total
+     * size is below max_bytes. Returns the number of files removed.
+     **/
+    static size_t prune(const vespalib::string &dir, size_t max_bytes);
+
+    /**
+     * Create the cache to be used by the execution engine compiling
+     * the given module, or nullptr if the cache is disabled. Used by
+     * LLVMWrapper.
+     **/
+    static std::unique_ptr<llvm::ObjectCache> make(const llvm::Module &module);
+};
+
+}
@@ -1,7 +1,6 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "constant_value_cache.h"
-#include <cassert>
 
 namespace vespalib {
 namespace eval {
@@ -24,16 +23,32 @@ ConstantValue::UP
 ConstantValueCache::create(const vespalib::string &path, const vespalib::string &type) const
 {
     Cache::Key key = std::make_pair(path, type);
-    std::lock_guard<std::mutex> guard(_cache->lock);
-    auto pos = _cache->cached.find(key);
-    if (pos != _cache->cached.end()) {
+    std::unique_lock<std::mutex> guard(_cache->lock);
+    auto res = _cache->cached.emplace(std::move(key), Cache::Value());
+    auto pos = res.first;
+    if (!res.second) {
         ++(pos->second.num_refs);
+        _cache->cond.wait(guard, [&pos]() { return bool(pos->second.const_value); });
         return std::make_unique<Token>(_cache, pos);
-    } else {
-        auto res = _cache->cached.emplace(std::move(key), _factory.create(path, type));
-        assert(res.second);
-        return std::make_unique<Token>(_cache, res.first);
     }
+    // the token makes sure the entry is released if creation fails
+    auto token = std::make_unique<Token>(_cache, pos);
+    guard.unlock();
+    ConstantValue::UP value;
+    try {
+        value = _factory.create(path, type);
+    } catch (...) {
+        value = std::make_unique<BadConstantValue>();
+        guard.lock();
+        pos->second.const_value = std::move(value);
+        _cache->cond.notify_all();
+        guard.unlock();
+        throw;
+    }
+    guard.lock();
+    pos->second.const_value = std::move(value);
+    _cache->cond.notify_all();
+    return token;
 }
 
 } // namespace vespalib::eval
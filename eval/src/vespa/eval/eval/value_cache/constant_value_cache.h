@@ -4,6 +4,7 @@
 
 #include "constant_value.h"
 
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -15,7 +16,9 @@ namespace eval {
  * A cache enabling clients to share the constant values created by an
  * underlying factory. The returned wrappers are used to ensure
  * appropriate lifetime of created values. Used values are kept in the
- * cache and unused values are evicted from the cache.
+ * cache and unused values are evicted from the cache. The cache is not
+ * locked while the underlying factory creates a value; concurrent
+ * requests for the same value wait for it to be created once.
  **/
 class ConstantValueCache : public ConstantValueFactory
 {
@@ -25,12 +28,12 @@ private:
         using Key = std::pair<vespalib::string, vespalib::string>;
         struct Value {
             size_t num_refs;
-            ConstantValue::UP const_value;
-            Value(ConstantValue::UP const_value_in)
-                : num_refs(1), const_value(std::move(const_value_in)) {}
+            ConstantValue::UP const_value; // nullptr while being created
+            Value() : num_refs(1), const_value() {}
         };
         using Map = std::map<Key,Value>;
         std::mutex lock;
+        std::condition_variable cond;
         Map cached;
     };
 
@@ -23,14 +23,22 @@ CellType unify(CellType b) {
     switch (b) {
     case CellType::DOUBLE: return unify<A,double>();
     case CellType::FLOAT: return unify<A,float>();
+    case CellType::INT8:
+    case CellType::BFLOAT16: break;
     }
     abort();
 }
 
+CellType decay(CellType cell_type) {
+    return ValueType::is_compact_cell_type(cell_type) ? CellType::FLOAT : cell_type;
+}
+
 CellType unify(CellType a, CellType b) {
-    switch (a) {
-    case CellType::DOUBLE: return unify<double>(b);
-    case CellType::FLOAT: return unify<float>(b);
+    switch (decay(a)) {
+    case CellType::DOUBLE: return unify<double>(decay(b));
+    case CellType::FLOAT: return unify<float>(decay(b));
+    case CellType::INT8:
+    case CellType::BFLOAT16: break;
     }
     abort();
 }
@@ -200,6 +208,15 @@ ValueType::dimension_names() const
     return result;
 }
 
+ValueType
+ValueType::decay_cell_type() const
+{
+    if (!is_compact_cell_type(_cell_type)) {
+        return *this;
+    }
+    return ValueType(_type, CellType::FLOAT, std::vector<Dimension>(_dimensions));
+}
+
 ValueType
 ValueType::reduce(const std::vector<vespalib::string> &dimensions_in) const
 {
@@ -220,7 +237,7 @@ ValueType::reduce(const std::vector<vespalib::string> &dimensions_in) const
     if (removed != dimensions_in.size()) {
         return error_type();
     }
-    return tensor_type(std::move(result), _cell_type);
+    return tensor_type(std::move(result), decay(_cell_type));
 }
 
 ValueType
@@ -238,7 +255,7 @@ ValueType::rename(const std::vector<vespalib::string> &from,
     if (!renamer.matched_all()) {
         return error_type();
     }
-    return tensor_type(dim_list, _cell_type);
+    return tensor_type(dim_list, decay(_cell_type));
 }
 
 ValueType
@@ -278,9 +295,9 @@ ValueType::join(const ValueType &lhs, const ValueType &rhs)
     if (lhs.is_error() || rhs.is_error()) {
         return error_type();
     } else if (lhs.is_double()) {
-        return rhs;
+        return rhs.decay_cell_type();
     } else if (rhs.is_double()) {
-        return lhs;
+        return lhs.decay_cell_type();
     }
     MyJoin result(lhs._dimensions, rhs._dimensions);
     if (result.mismatch) {
@@ -298,7 +315,7 @@ ValueType::merge(const ValueType &lhs, const ValueType &rhs)
         return error_type();
     }
     if (lhs.dimensions().empty()) {
-        return lhs;
+        return lhs.decay_cell_type();
     }
     return tensor_type(lhs.dimensions(), unify(lhs._cell_type, rhs._cell_type));
 }
@@ -306,9 +323,9 @@ ValueType::merge(const ValueType &lhs, const ValueType &rhs)
 CellType
 ValueType::unify_cell_types(const ValueType &a, const ValueType &b) {
     if (a.is_double()) {
-        return b.cell_type();
+        return decay(b.cell_type());
     } else if (b.is_double()) {
-        return a.cell_type();
+        return decay(a.cell_type());
     }
     return unify(a.cell_type(), b.cell_type());
 }
@@ -3,8 +3,10 @@
 #pragma once
 
 #include <vespa/vespalib/util/typify.h>
+#include <vespa/vespalib/util/bfloat16.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vector>
+#include <cmath>
 
 namespace vespalib::eval {
 
@@ -17,7 +19,12 @@ class ValueType
 {
 public:
     enum class Type { ERROR, DOUBLE, TENSOR };
-    enum class CellType : char { FLOAT, DOUBLE };
+    /**
+     * INT8 and BFLOAT16 are compact cell types used to store tensors;
+     * computations on such tensors are performed with FLOAT cells
+     * (see decay_cell_type).
+     **/
+    enum class CellType : char { FLOAT, DOUBLE, INT8, BFLOAT16 };
     struct Dimension {
         using size_type = uint32_t;
         static constexpr size_type npos = -1;
@@ -63,6 +70,10 @@ public:
     const std::vector<Dimension> &dimensions() const { return _dimensions; }
     size_t dimension_index(const vespalib::string &name) const;
     std::vector<vespalib::string> dimension_names() const;
+    static bool is_compact_cell_type(CellType cell_type) {
+        return ((cell_type == CellType::INT8) || (cell_type == CellType::BFLOAT16));
+    }
+    ValueType decay_cell_type() const;
     bool operator==(const ValueType &rhs) const {
         return ((_type == rhs._type) &&
                 (_cell_type == rhs._cell_type) &&
@@ -94,16 +105,55 @@ std::ostream &operator<<(std::ostream &os, const ValueType &type);
 template <typename CT> inline bool check_cell_type(ValueType::CellType type);
 template <> inline bool check_cell_type<double>(ValueType::CellType type) { return (type == ValueType::CellType::DOUBLE); }
 template <> inline bool check_cell_type<float>(ValueType::CellType type) { return (type == ValueType::CellType::FLOAT); }
+template <> inline bool check_cell_type<int8_t>(ValueType::CellType type) { return (type == ValueType::CellType::INT8); }
+template <> inline bool check_cell_type<BFloat16>(ValueType::CellType type) { return (type == ValueType::CellType::BFLOAT16); }
 
 template <typename LCT, typename RCT> struct UnifyCellTypes{};
 template <> struct UnifyCellTypes<double, double> { using type = double; };
 template <> struct UnifyCellTypes<double, float>  { using type = double; };
 template <> struct UnifyCellTypes<float,  double> { using type = double; };
 template <> struct UnifyCellTypes<float,  float>  { using type = float; };
+// compact cell types are unified as float
+template <> struct UnifyCellTypes<int8_t,   int8_t>   { using type = float; };
+template <> struct UnifyCellTypes<BFloat16, BFloat16> { using type = float; };
+template <> struct UnifyCellTypes<int8_t,   BFloat16> { using type = float; };
+template <> struct UnifyCellTypes<BFloat16, int8_t>   { using type = float; };
+template <> struct UnifyCellTypes<int8_t,   float>    { using type = float; };
+template <> struct UnifyCellTypes<float,    int8_t>   { using type = float; };
+template <> struct UnifyCellTypes<BFloat16, float>    { using type = float; };
+template <> struct UnifyCellTypes<float,    BFloat16> { using type = float; };
+template <> struct UnifyCellTypes<int8_t,   double>   { using type = double; };
+template <> struct UnifyCellTypes<double,   int8_t>   { using type = double; };
+template <> struct UnifyCellTypes<BFloat16, double>   { using type = double; };
+template <> struct UnifyCellTypes<double,   BFloat16> { using type = double; };
+
+// cell type used for the results of computations on the given cell type
+template <typename CT> struct DecayCellType { using type = CT; };
+template <> struct DecayCellType<int8_t>   { using type = float; };
+template <> struct DecayCellType<BFloat16> { using type = float; };
+
+/**
+ * Convert a computed value to the given cell type. Values stored in
+ * int8 cells are rounded to the nearest integer and saturated to
+ * [-128,127]; NaN is stored as 0.
+ **/
+template <typename CT> inline CT convert_cell(double value) { return CT(value); }
+template <> inline int8_t convert_cell<int8_t>(double value) {
+    if (std::isnan(value)) {
+        return 0;
+    } else if (value <= -128.0) {
+        return -128;
+    } else if (value >= 127.0) {
+        return 127;
+    }
+    return int8_t(std::lrint(value));
+}
 
 template <typename CT> inline ValueType::CellType get_cell_type();
 template <> inline ValueType::CellType get_cell_type<double>() { return ValueType::CellType::DOUBLE; }
 template <> inline ValueType::CellType get_cell_type<float>() { return ValueType::CellType::FLOAT; }
+template <> inline ValueType::CellType get_cell_type<int8_t>() { return ValueType::CellType::INT8; }
+template <> inline ValueType::CellType get_cell_type<BFloat16>() { return ValueType::CellType::BFLOAT16; }
 
 struct TypifyCellType {
     template <typename T> using Result = TypifyResultType<T>;
@@ -111,6 +161,23 @@ struct TypifyCellType {
         switch(value) {
         case ValueType::CellType::DOUBLE: return f(Result<double>());
         case ValueType::CellType::FLOAT:  return f(Result<float>());
+        case ValueType::CellType::INT8:
+        case ValueType::CellType::BFLOAT16: break;
+        }
+        abort();
+    }
+};
+
+// like TypifyCellType, but also resolves compact cell types; use
+// this when cells are only stored, copied or converted.
+struct TypifyAllCellTypes {
+    template <typename T> using Result = TypifyResultType<T>;
+    template <typename F> static decltype(auto) resolve(ValueType::CellType value, F &&f) {
+        switch(value) {
+        case ValueType::CellType::DOUBLE:   return f(Result<double>());
+        case ValueType::CellType::FLOAT:    return f(Result<float>());
+        case ValueType::CellType::INT8:     return f(Result<int8_t>());
+        case ValueType::CellType::BFLOAT16: return f(Result<BFloat16>());
         }
         abort();
     }
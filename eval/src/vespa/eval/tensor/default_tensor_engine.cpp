@@ -21,6 +21,7 @@
 #include "dense/dense_simple_join_function.h"
 #include "dense/dense_number_join_function.h"
 #include "dense/dense_pow_as_map_optimizer.h"
+#include "dense/dense_fused_function.h"
 #include "dense/dense_simple_map_function.h"
 #include "dense/vector_from_doubles_function.h"
 #include "dense/dense_tensor_create_function.h"
@@ -186,7 +187,7 @@ struct CallDenseTensorBuilder {
             if (cell_idx == UNDEFINED_IDX) {
                 bad_spec(spec);
             }
-            builder.insertCell(cell_idx, cell.second);
+            builder.insertCell(cell_idx, cell.second.value);
         }
         return builder.build();
     }
@@ -204,7 +205,7 @@ DefaultTensorEngine::from_spec(const TensorSpec &spec) const
         double value = spec.cells().empty() ? 0.0 : spec.cells().begin()->second.value;
         return std::make_unique<DoubleValue>(value);
     } else if (type.is_dense()) {
-        return typify_invoke<1,MyTypify,CallDenseTensorBuilder>(type.cell_type(), type, spec);
+        return typify_invoke<1,eval::TypifyAllCellTypes,CallDenseTensorBuilder>(type.cell_type(), type, spec);
     } else if (type.is_sparse()) {
         DirectSparseTensorBuilder builder(type);
         SparseTensorAddressBuilder address_builder;
@@ -261,12 +262,34 @@ DefaultTensorEngine::decode(nbostream &input) const
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+bool has_compact_cells(const TensorFunction &expr) {
+    using Child = TensorFunction::Child;
+    Child root(expr);
+    std::vector<Child::CREF> nodes({root});
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const TensorFunction &node = nodes[i].get().get();
+        if (ValueType::is_compact_cell_type(node.result_type().cell_type())) {
+            return true;
+        }
+        node.push_children(nodes);
+    }
+    return false;
+}
+
+}
+
 const TensorFunction &
 DefaultTensorEngine::optimize(const TensorFunction &expr, Stash &stash) const
 {
     using Child = TensorFunction::Child;
     Child root(expr);
     LOG(debug, "tensor function before optimization:\n%s\n", root.get().as_string().c_str());
+    if (has_compact_cells(expr)) {
+        // optimized tensor functions only handle float and double cells
+        return root.get();
+    }
     {
         std::vector<Child::CREF> nodes({root});
         for (size_t i = 0; i < nodes.size(); ++i) {
@@ -297,6 +320,7 @@ DefaultTensorEngine::optimize(const TensorFunction &expr, Stash &stash) const
             child.set(DenseLambdaFunction::optimize(child.get(), stash));
             child.set(DenseFastRenameOptimizer::optimize(child.get(), stash));
             child.set(DensePowAsMapOptimizer::optimize(child.get(), stash));
+            child.set(DenseFusedFunction::optimize(child.get(), stash));
             child.set(DenseSimpleMapFunction::optimize(child.get(), stash));
             child.set(DenseSimpleJoinFunction::optimize(child.get(), stash));
             child.set(DenseNumberJoinFunction::optimize(child.get(), stash));
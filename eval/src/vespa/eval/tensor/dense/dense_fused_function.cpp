@@ -0,0 +1,352 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_fused_function.h"
+#include "dense_tensor_view.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/inline_operation.h>
+#include <vespa/vespalib/util/typify.h>
+#include <algorithm>
+#include <cassert>
+
+namespace vespalib::tensor {
+
+using eval::Aggr;
+using eval::DoubleValue;
+using eval::Value;
+using eval::ValueType;
+using eval::TensorFunction;
+using eval::TensorEngine;
+using eval::TypifyCellType;
+using eval::TypifyAggr;
+using eval::as;
+
+using namespace eval::operation;
+using namespace eval::tensor_function;
+
+using Child = TensorFunction::Child;
+using Step = DenseFusedFunction::Step;
+using Self = DenseFusedFunction::Self;
+using Instruction = eval::InterpretedFunction::Instruction;
+using State = eval::InterpretedFunction::State;
+
+namespace {
+
+// number of cells calculated by each step at a time
+constexpr size_t block_size = 128;
+
+template <typename CT>
+void my_load_cells(const Value &value, size_t offset, double *dst, size_t n) {
+    const CT *src = DenseTensorView::typify_cells<CT>(value).cbegin() + offset;
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+void my_load_number(const Value &value, size_t, double *dst, size_t n) {
+    std::fill(dst, dst + n, value.as_double());
+}
+
+template <typename Fun>
+void my_map_block(double *cells, size_t n, map_fun_t function) {
+    Fun my_fun(function);
+    apply_op1_vec(cells, cells, n, my_fun);
+}
+
+template <typename Fun>
+void my_join_block(double *lhs, const double *rhs, size_t n, join_fun_t function) {
+    Fun my_fun(function);
+    apply_op2_vec_vec(lhs, lhs, rhs, n, my_fun);
+}
+
+// run all steps for n cells starting at offset, returning the result
+const double *calc_block(const Self &self, const State &state, size_t offset, size_t n, double *space) {
+    size_t depth = 0;
+    for (const Step &step: self.steps) {
+        double *top = nullptr;
+        switch (step.kind) {
+        case Step::Kind::INPUT:
+            top = space + (depth++ * block_size);
+            step.load(state.peek(self.num_inputs - 1 - step.input_idx), offset, top, n);
+            break;
+        case Step::Kind::MAP:
+            top = space + ((depth - 1) * block_size);
+            step.map_block(top, n, step.map_fun);
+            break;
+        case Step::Kind::JOIN:
+            top = space + ((--depth - 1) * block_size);
+            step.join_block(top, top + block_size, n, step.join_fun);
+            break;
+        }
+        if (step.to_float) {
+            for (size_t i = 0; i < n; ++i) {
+                top[i] = float(top[i]);
+            }
+        }
+    }
+    assert(depth == 1);
+    return space;
+}
+
+template <typename OCT>
+void my_fused_op(State &state, uint64_t param) {
+    const Self &self = *(const Self *)(param);
+    ArrayRef<OCT> dst_cells = state.stash.create_array<OCT>(self.num_cells);
+    ArrayRef<double> space = state.stash.create_array<double>(self.stack_size * block_size);
+    for (size_t offset = 0; offset < self.num_cells; offset += block_size) {
+        size_t n = std::min(block_size, self.num_cells - offset);
+        const double *src = calc_block(self, state, offset, n, space.begin());
+        OCT *dst = dst_cells.begin() + offset;
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+        }
+    }
+    state.pop_n_push(self.num_inputs, state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
+}
+
+template <typename AGGR>
+void my_fused_reduce_op(State &state, uint64_t param) {
+    const Self &self = *(const Self *)(param);
+    ArrayRef<double> space = state.stash.create_array<double>(self.stack_size * block_size);
+    AGGR aggr;
+    for (size_t offset = 0; offset < self.num_cells; offset += block_size) {
+        size_t n = std::min(block_size, self.num_cells - offset);
+        const double *src = calc_block(self, state, offset, n, space.begin());
+        size_t i = 0;
+        if (offset == 0) {
+            aggr.first(src[i++]);
+        }
+        for (; i < n; ++i) {
+            aggr.next(src[i]);
+        }
+    }
+    state.pop_n_push(self.num_inputs, state.stash.create<DoubleValue>(aggr.result()));
+}
+
+struct MyGetLoad {
+    template <typename R1> static auto invoke() { return my_load_cells<R1>; }
+};
+
+struct MyGetMapBlock {
+    template <typename R1> static auto invoke() { return my_map_block<R1>; }
+};
+
+struct MyGetJoinBlock {
+    template <typename R1> static auto invoke() { return my_join_block<R1>; }
+};
+
+struct MyGetFusedOp {
+    template <typename R1> static auto invoke() { return my_fused_op<R1>; }
+};
+
+struct MyGetFusedReduceOp {
+    template <typename R1> static auto invoke() {
+        return my_fused_reduce_op<typename R1::template templ<double>>;
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+bool is_float(const ValueType &type) {
+    return (type.cell_type() == ValueType::CellType::FLOAT);
+}
+
+// collects the steps and inputs for a tree of map and join operations
+struct ProgramBuilder {
+    const std::vector<ValueType::Dimension> &dims;
+    std::vector<Child> children;
+    std::vector<Step> steps;
+    size_t num_ops;
+
+    explicit ProgramBuilder(const std::vector<ValueType::Dimension> &dims_in)
+        : dims(dims_in), children(), steps(), num_ops(0) {}
+
+    bool is_fused_tensor(const ValueType &type) const {
+        return (type.is_dense() && (type.dimensions() == dims) &&
+                ((type.cell_type() == ValueType::CellType::FLOAT) ||
+                 (type.cell_type() == ValueType::CellType::DOUBLE)));
+    }
+
+    bool add_input(const TensorFunction &node) {
+        Step step(Step::Kind::INPUT);
+        step.input_idx = children.size();
+        if (node.result_type().is_double()) {
+            step.load = my_load_number;
+        } else if (is_fused_tensor(node.result_type())) {
+            step.load = typify_invoke<1,TypifyCellType,MyGetLoad>(node.result_type().cell_type());
+        } else {
+            return false;
+        }
+        children.emplace_back(node);
+        steps.push_back(step);
+        return true;
+    }
+
+    void add_fused(const DenseFusedFunction &fused) {
+        std::vector<Child::CREF> fused_children;
+        fused.push_children(fused_children);
+        size_t input_offset = children.size();
+        for (const Child &child: fused_children) {
+            children.emplace_back(child.get());
+        }
+        for (Step step: fused.steps()) {
+            if (step.kind == Step::Kind::INPUT) {
+                step.input_idx += input_offset;
+            }
+            steps.push_back(step);
+        }
+        num_ops += fused.num_ops();
+    }
+
+    bool add(const TensorFunction &node) {
+        if (!is_fused_tensor(node.result_type())) {
+            return add_input(node);
+        }
+        if (auto fused = as<DenseFusedFunction>(node)) {
+            if (!fused->aggr().has_value()) {
+                add_fused(*fused);
+                return true;
+            }
+        } else if (auto map = as<Map>(node)) {
+            if (!add(map->child())) {
+                return false;
+            }
+            Step step(Step::Kind::MAP);
+            step.map_fun = map->function();
+            step.map_block = typify_invoke<1,TypifyOp1,MyGetMapBlock>(map->function());
+            step.to_float = is_float(node.result_type());
+            steps.push_back(step);
+            ++num_ops;
+            return true;
+        } else if (auto join = as<Join>(node)) {
+            if (!add(join->lhs()) || !add(join->rhs())) {
+                return false;
+            }
+            Step step(Step::Kind::JOIN);
+            step.join_fun = join->function();
+            step.join_block = typify_invoke<1,TypifyOp2,MyGetJoinBlock>(join->function());
+            step.to_float = is_float(node.result_type());
+            steps.push_back(step);
+            ++num_ops;
+            return true;
+        }
+        return add_input(node);
+    }
+};
+
+size_t calc_stack_size(const std::vector<Step> &steps) {
+    size_t depth = 0;
+    size_t max_depth = 0;
+    for (const Step &step: steps) {
+        if (step.kind == Step::Kind::INPUT) {
+            max_depth = std::max(max_depth, ++depth);
+        } else if (step.kind == Step::Kind::JOIN) {
+            --depth;
+        }
+    }
+    assert(depth == 1);
+    return max_depth;
+}
+
+} // namespace vespalib::tensor::<unnamed>
+
+//-----------------------------------------------------------------------------
+
+DenseFusedFunction::Step::Step(Kind kind_in)
+    : kind(kind_in),
+      input_idx(0),
+      load(nullptr),
+      map_fun(nullptr),
+      map_block(nullptr),
+      join_fun(nullptr),
+      join_block(nullptr),
+      to_float(false)
+{
+}
+
+DenseFusedFunction::Self::Self(const ValueType &result_type_in, size_t num_cells_in, size_t num_inputs_in)
+    : result_type(result_type_in),
+      num_cells(num_cells_in),
+      num_inputs(num_inputs_in),
+      stack_size(0),
+      steps()
+{
+}
+
+DenseFusedFunction::Self::~Self() = default;
+
+DenseFusedFunction::DenseFusedFunction(const ValueType &result_type, size_t num_cells,
+                                       std::vector<Child> children, std::vector<Step> steps,
+                                       std::optional<Aggr> aggr)
+    : TensorFunction(),
+      _self(result_type, num_cells, children.size()),
+      _children(std::move(children)),
+      _aggr(aggr)
+{
+    _self.stack_size = calc_stack_size(steps);
+    _self.steps = std::move(steps);
+}
+
+DenseFusedFunction::~DenseFusedFunction() = default;
+
+size_t
+DenseFusedFunction::num_ops() const
+{
+    size_t ops = _aggr.has_value() ? 1 : 0;
+    for (const Step &step: _self.steps) {
+        if (step.kind != Step::Kind::INPUT) {
+            ++ops;
+        }
+    }
+    return ops;
+}
+
+void
+DenseFusedFunction::push_children(std::vector<Child::CREF> &target) const
+{
+    for (const Child &c : _children) {
+        target.emplace_back(c);
+    }
+}
+
+Instruction
+DenseFusedFunction::compile_self(const TensorEngine &, Stash &) const
+{
+    static_assert(sizeof(uint64_t) == sizeof(&_self));
+    if (_aggr.has_value()) {
+        auto op = typify_invoke<1,TypifyAggr,MyGetFusedReduceOp>(_aggr.value());
+        return Instruction(op, (uint64_t)&_self);
+    }
+    auto op = typify_invoke<1,TypifyCellType,MyGetFusedOp>(result_type().cell_type());
+    return Instruction(op, (uint64_t)&_self);
+}
+
+const TensorFunction &
+DenseFusedFunction::optimize(const TensorFunction &expr, Stash &stash)
+{
+    // a single operation is better handled by the specialized functions
+    constexpr size_t min_ops = 2;
+    if (auto reduce = as<Reduce>(expr)) {
+        const ValueType &child_type = reduce->child().result_type();
+        if (expr.result_type().is_double() && child_type.is_dense()) {
+            ProgramBuilder builder(child_type.dimensions());
+            if (builder.add(reduce->child()) && ((builder.num_ops + 1) >= min_ops)) {
+                return stash.create<DenseFusedFunction>(expr.result_type(), child_type.dense_subspace_size(),
+                                                        std::move(builder.children), std::move(builder.steps),
+                                                        reduce->aggr());
+            }
+        }
+    } else if (as<Map>(expr) || as<Join>(expr)) {
+        if (expr.result_type().is_dense()) {
+            ProgramBuilder builder(expr.result_type().dimensions());
+            if (builder.add(expr) && (builder.num_ops >= min_ops)) {
+                return stash.create<DenseFusedFunction>(expr.result_type(), expr.result_type().dense_subspace_size(),
+                                                        std::move(builder.children), std::move(builder.steps),
+                                                        std::nullopt);
+            }
+        }
+    }
+    return expr;
+}
+
+} // namespace vespalib::tensor
@@ -0,0 +1,69 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/eval/aggr.h>
+#include <optional>
+
+namespace vespalib::tensor {
+
+/**
+ * Tensor function evaluating a chain of map and join operations on
+ * dense tensors with the same dimensions in a single pass over the
+ * cells, optionally reducing all dimensions of the result. Numbers
+ * are broadcast to all cells. Cells are calculated in small blocks,
+ * running all operations on each block before moving on to the
+ * next, so no intermediate tensors are created.
+ *
+ * The operations are kept as a postfix program where inputs refer
+ * to the children of this function.
+ **/
+class DenseFusedFunction : public eval::TensorFunction
+{
+public:
+    struct Step {
+        enum class Kind { INPUT, MAP, JOIN };
+        using load_fun_t = void (*)(const eval::Value &value, size_t offset, double *dst, size_t n);
+        using map_block_fun_t = void (*)(double *cells, size_t n, eval::tensor_function::map_fun_t fun);
+        using join_block_fun_t = void (*)(double *lhs, const double *rhs, size_t n, eval::tensor_function::join_fun_t fun);
+        Kind kind;
+        size_t input_idx;
+        load_fun_t load;
+        eval::tensor_function::map_fun_t map_fun;
+        map_block_fun_t map_block;
+        eval::tensor_function::join_fun_t join_fun;
+        join_block_fun_t join_block;
+        // round results to float like an unfused operation with float cells would
+        bool to_float;
+        Step(Kind kind_in);
+    };
+    struct Self {
+        eval::ValueType result_type;
+        size_t num_cells;
+        size_t num_inputs;
+        size_t stack_size;
+        std::vector<Step> steps;
+        Self(const eval::ValueType &result_type_in, size_t num_cells_in, size_t num_inputs_in);
+        ~Self();
+    };
+private:
+    Self _self;
+    std::vector<Child> _children;
+    std::optional<eval::Aggr> _aggr;
+public:
+    DenseFusedFunction(const eval::ValueType &result_type, size_t num_cells,
+                       std::vector<Child> children, std::vector<Step> steps,
+                       std::optional<eval::Aggr> aggr);
+    ~DenseFusedFunction() override;
+    const eval::ValueType &result_type() const override { return _self.result_type; }
+    const std::vector<Step> &steps() const { return _self.steps; }
+    const std::optional<eval::Aggr> &aggr() const { return _aggr; }
+    size_t num_ops() const;
+    void push_children(std::vector<Child::CREF> &children) const override;
+    eval::InterpretedFunction::Instruction compile_self(const eval::TensorEngine &engine, Stash &stash) const override;
+    bool result_is_mutable() const override { return true; }
+    static const eval::TensorFunction &optimize(const eval::TensorFunction &expr, Stash &stash);
+};
+
+} // namespace vespalib::tensor
@@ -5,10 +5,9 @@
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <cassert>
 
-#include <cblas.h>
-
 namespace vespalib::tensor {
 
 using eval::ValueType;
@@ -18,6 +17,7 @@ using eval::as;
 using eval::Aggr;
 using namespace eval::tensor_function;
 using namespace eval::operation;
+using vespalib::hwaccelrated::IAccelrated;
 
 namespace {
 
@@ -52,31 +52,15 @@ void my_matmul_op(eval::InterpretedFunction::State &state, uint64_t param) {
     state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
 }
 
-template <bool lhs_common_inner, bool rhs_common_inner>
-void my_cblas_double_matmul_op(eval::InterpretedFunction::State &state, uint64_t param) {
-    const DenseMatMulFunction::Self &self = *((const DenseMatMulFunction::Self *)(param));
-    auto lhs_cells = DenseTensorView::typify_cells<double>(state.peek(1));
-    auto rhs_cells = DenseTensorView::typify_cells<double>(state.peek(0));
-    auto dst_cells = state.stash.create_array<double>(self.lhs_size * self.rhs_size);
-    cblas_dgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
-                self.lhs_size, self.rhs_size, self.common_size, 1.0,
-                lhs_cells.cbegin(), lhs_common_inner ? self.common_size : self.lhs_size,
-                rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
-                0.0, dst_cells.begin(), self.rhs_size);
-    state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
-}
-
-template <bool lhs_common_inner, bool rhs_common_inner>
-void my_cblas_float_matmul_op(eval::InterpretedFunction::State &state, uint64_t param) {
+template <typename CT, bool lhs_common_inner, bool rhs_common_inner>
+void my_accelerated_matmul_op(eval::InterpretedFunction::State &state, uint64_t param) {
     const DenseMatMulFunction::Self &self = *((const DenseMatMulFunction::Self *)(param));
-    auto lhs_cells = DenseTensorView::typify_cells<float>(state.peek(1));
-    auto rhs_cells = DenseTensorView::typify_cells<float>(state.peek(0));
-    auto dst_cells = state.stash.create_array<float>(self.lhs_size * self.rhs_size);
-    cblas_sgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
-                self.lhs_size, self.rhs_size, self.common_size, 1.0,
-                lhs_cells.cbegin(), lhs_common_inner ? self.common_size : self.lhs_size,
-                rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
-                0.0, dst_cells.begin(), self.rhs_size);
+    auto lhs_cells = DenseTensorView::typify_cells<CT>(state.peek(1));
+    auto rhs_cells = DenseTensorView::typify_cells<CT>(state.peek(0));
+    auto dst_cells = state.stash.create_array<CT>(self.lhs_size * self.rhs_size);
+    IAccelrated::getAccelerator().matMul(lhs_cells.cbegin(), rhs_cells.cbegin(), dst_cells.begin(),
+                                         self.lhs_size, self.common_size, self.rhs_size,
+                                         lhs_common_inner, rhs_common_inner);
     state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
 }
 
@@ -122,9 +106,9 @@ const TensorFunction &create_matmul(const TensorFunction &a, const TensorFunctio
 struct MyGetFun {
     template<typename R1, typename R2, typename R3, typename R4> static auto invoke() {
         if (std::is_same_v<R1,double> && std::is_same_v<R2,double>) {
-            return my_cblas_double_matmul_op<R3::value, R4::value>;
+            return my_accelerated_matmul_op<double, R3::value, R4::value>;
         } else if (std::is_same_v<R1,float> && std::is_same_v<R2,float>) {
-            return my_cblas_float_matmul_op<R3::value, R4::value>;
+            return my_accelerated_matmul_op<float, R3::value, R4::value>;
         } else {
             return my_matmul_op<R1, R2, R3::value, R4::value>;
         }
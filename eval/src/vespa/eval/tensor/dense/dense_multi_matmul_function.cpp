@@ -5,10 +5,9 @@
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <cassert>
 
-#include <cblas.h>
-
 namespace vespalib::tensor {
 
 using eval::ValueType;
@@ -19,32 +18,12 @@ using eval::as;
 using eval::Aggr;
 using namespace eval::tensor_function;
 using namespace eval::operation;
+using vespalib::hwaccelrated::IAccelrated;
 
 namespace {
 
-void my_cblas_double_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
-    using CT = double;
-    const DenseMultiMatMulFunction &self = *((const DenseMultiMatMulFunction *)(param));
-    size_t lhs_block_size = self.lhs_size() * self.common_size();
-    size_t rhs_block_size = self.rhs_size() * self.common_size();
-    size_t dst_block_size = self.lhs_size() * self.rhs_size();
-    size_t num_blocks = self.matmul_cnt();
-    const CT *lhs = DenseTensorView::typify_cells<CT>(state.peek(1)).cbegin();
-    const CT *rhs = DenseTensorView::typify_cells<CT>(state.peek(0)).cbegin();
-    auto dst_cells = state.stash.create_array<CT>(dst_block_size * num_blocks);
-    CT *dst = dst_cells.begin();
-    for (size_t i = 0; i < num_blocks; ++i, lhs += lhs_block_size, rhs += rhs_block_size, dst += dst_block_size) {
-        cblas_dgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
-                    self.lhs_size(), self.rhs_size(), self.common_size(), 1.0,
-                    lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
-                    rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
-                    0.0, dst, self.rhs_size());
-    }
-    state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type(), TypedCells(dst_cells)));
-}
-
-void my_cblas_float_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
-    using CT = float;
+template <typename CT>
+void my_accelerated_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
     const DenseMultiMatMulFunction &self = *((const DenseMultiMatMulFunction *)(param));
     size_t lhs_block_size = self.lhs_size() * self.common_size();
     size_t rhs_block_size = self.rhs_size() * self.common_size();
@@ -54,22 +33,20 @@ void my_cblas_float_multi_matmul_op(InterpretedFunction::State &state, uint64_t
     const CT *rhs = DenseTensorView::typify_cells<CT>(state.peek(0)).cbegin();
     auto dst_cells = state.stash.create_array<CT>(dst_block_size * num_blocks);
     CT *dst = dst_cells.begin();
+    const IAccelrated &accelerator = IAccelrated::getAccelerator();
     for (size_t i = 0; i < num_blocks; ++i, lhs += lhs_block_size, rhs += rhs_block_size, dst += dst_block_size) {
-        cblas_sgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
-                    self.lhs_size(), self.rhs_size(), self.common_size(), 1.0,
-                    lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
-                    rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
-                    0.0, dst, self.rhs_size());
+        accelerator.matMul(lhs, rhs, dst, self.lhs_size(), self.common_size(), self.rhs_size(),
+                           self.lhs_common_inner(), self.rhs_common_inner());
     }
     state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type(), TypedCells(dst_cells)));
 }
 
 InterpretedFunction::op_function my_select(CellType cell_type) {
     if (cell_type == ValueType::CellType::DOUBLE) {
-        return my_cblas_double_multi_matmul_op;
+        return my_accelerated_multi_matmul_op<double>;
     }
     if (cell_type == ValueType::CellType::FLOAT) {
-        return my_cblas_float_multi_matmul_op;
+        return my_accelerated_multi_matmul_op<float>;
     }
     abort();
 }
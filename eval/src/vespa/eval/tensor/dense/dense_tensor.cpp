@@ -72,5 +72,7 @@ DenseTensor<CT>::operator==(const DenseTensor<RCT> &rhs) const
 
 template class DenseTensor<float>;
 template class DenseTensor<double>;
+template class DenseTensor<int8_t>;
+template class DenseTensor<BFloat16>;
 
 }
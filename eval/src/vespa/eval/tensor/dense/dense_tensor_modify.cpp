@@ -25,7 +25,7 @@ DenseTensorModify<CT>::visit(const TensorAddress &address, double value)
     uint32_t idx = DenseTensorAddressMapper::mapAddressToIndex(address, _type);
     if (idx != DenseTensorAddressMapper::BAD_ADDRESS) {
         double nv = _op(_cells[idx], value);
-        _cells[idx] = (CT) nv;
+        _cells[idx] = eval::convert_cell<CT>(nv);
     }
 }
 
@@ -38,5 +38,7 @@ DenseTensorModify<CT>::build()
 
 template class DenseTensorModify<float>;
 template class DenseTensorModify<double>;
+template class DenseTensorModify<int8_t>;
+template class DenseTensorModify<BFloat16>;
 
 } // namespace
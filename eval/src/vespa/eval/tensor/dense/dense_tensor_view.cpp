@@ -194,15 +194,16 @@ DenseTensorView::as_double() const
 struct CallApply {
     template <typename CT>
     static Tensor::UP
-    call(const ConstArrayRef<CT> &oldCells, const eval::ValueType &newType, const CellFunction &func)
+    call(const ConstArrayRef<CT> &oldCells, const eval::ValueType &oldType, const CellFunction &func)
     {
-        std::vector<CT> newCells;
+        using OCT = typename eval::DecayCellType<CT>::type;
+        std::vector<OCT> newCells;
         newCells.reserve(oldCells.size());
         for (const auto &cell : oldCells) {
-            CT nv = func.apply(cell);
+            OCT nv = func.apply(cell);
             newCells.push_back(nv);
         }
-        return std::make_unique<DenseTensor<CT>>(newType, std::move(newCells));
+        return std::make_unique<DenseTensor<OCT>>(oldType.decay_cell_type(), std::move(newCells));
     }
 };
 
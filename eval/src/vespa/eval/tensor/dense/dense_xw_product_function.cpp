@@ -5,10 +5,9 @@
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <cassert>
 
-#include <cblas.h>
-
 namespace vespalib::tensor {
 
 using eval::ValueType;
@@ -18,6 +17,7 @@ using eval::as;
 using eval::Aggr;
 using namespace eval::tensor_function;
 using namespace eval::operation;
+using vespalib::hwaccelrated::IAccelrated;
 
 namespace {
 
@@ -48,31 +48,15 @@ void my_xw_product_op(eval::InterpretedFunction::State &state, uint64_t param) {
     state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
 }
 
-template <bool common_inner>
-void my_cblas_double_xw_product_op(eval::InterpretedFunction::State &state, uint64_t param) {
-    const DenseXWProductFunction::Self &self = *((const DenseXWProductFunction::Self *)(param));
-    auto vector_cells = DenseTensorView::typify_cells<double>(state.peek(1));
-    auto matrix_cells = DenseTensorView::typify_cells<double>(state.peek(0));
-    auto dst_cells = state.stash.create_array<double>(self.result_size);
-    cblas_dgemv(CblasRowMajor, common_inner ? CblasNoTrans : CblasTrans,
-                common_inner ? self.result_size : self.vector_size,
-                common_inner ? self.vector_size : self.result_size,
-                1.0, matrix_cells.cbegin(), common_inner ? self.vector_size : self.result_size, vector_cells.cbegin(), 1,
-                0.0, dst_cells.begin(), 1);
-    state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
-}
-
-template <bool common_inner>
-void my_cblas_float_xw_product_op(eval::InterpretedFunction::State &state, uint64_t param) {
+// the vector is a single row matrix multiplied with the matrix
+template <typename CT, bool common_inner>
+void my_accelerated_xw_product_op(eval::InterpretedFunction::State &state, uint64_t param) {
     const DenseXWProductFunction::Self &self = *((const DenseXWProductFunction::Self *)(param));
-    auto vector_cells = DenseTensorView::typify_cells<float>(state.peek(1));
-    auto matrix_cells = DenseTensorView::typify_cells<float>(state.peek(0));
-    auto dst_cells = state.stash.create_array<float>(self.result_size);
-    cblas_sgemv(CblasRowMajor, common_inner ? CblasNoTrans : CblasTrans,
-                common_inner ? self.result_size : self.vector_size,
-                common_inner ? self.vector_size : self.result_size,
-                1.0, matrix_cells.cbegin(), common_inner ? self.vector_size : self.result_size, vector_cells.cbegin(), 1,
-                0.0, dst_cells.begin(), 1);
+    auto vector_cells = DenseTensorView::typify_cells<CT>(state.peek(1));
+    auto matrix_cells = DenseTensorView::typify_cells<CT>(state.peek(0));
+    auto dst_cells = state.stash.create_array<CT>(self.result_size);
+    IAccelrated::getAccelerator().matMul(vector_cells.cbegin(), matrix_cells.cbegin(), dst_cells.begin(),
+                                         1, self.vector_size, self.result_size, true, common_inner);
     state.pop_pop_push(state.stash.create<DenseTensorView>(self.result_type, TypedCells(dst_cells)));
 }
 
@@ -108,9 +92,9 @@ const TensorFunction &createDenseXWProduct(const ValueType &res, const TensorFun
 struct MyXWProductOp {
     template<typename R1, typename R2, typename R3> static auto invoke() {
         if (std::is_same_v<R1,double> && std::is_same_v<R2,double>) {
-            return my_cblas_double_xw_product_op<R3::value>;
+            return my_accelerated_xw_product_op<double, R3::value>;
         } else if (std::is_same_v<R1,float> && std::is_same_v<R2,float>) {
-            return my_cblas_float_xw_product_op<R3::value>;
+            return my_accelerated_xw_product_op<float, R3::value>;
         } else {
             return my_xw_product_op<R1, R2, R3::value>;
         }
@@ -0,0 +1,96 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mapped_dense_tensor.h"
+#include <vespa/vespalib/io/mapped_file_input.h>
+#include <vespa/vespalib/util/typify.h>
+#include <cstdio>
+#include <cstring>
+
+namespace vespalib::tensor {
+
+using eval::ValueType;
+
+namespace {
+
+// file layout: magic, type spec size (uint32_t), type spec, padding
+// up to the next multiple of 'page_size', cells
+constexpr char file_magic[8] = {'V','D','E','N','S','E','0','1'};
+constexpr size_t page_size = 4096;
+
+struct MyCellSize {
+    template <typename CT> static size_t invoke() { return sizeof(CT); }
+};
+
+size_t cell_size(CellType cell_type) {
+    return typify_invoke<1,eval::TypifyAllCellTypes,MyCellSize>(cell_type);
+}
+
+size_t cells_offset(size_t spec_size) {
+    size_t header_size = sizeof(file_magic) + sizeof(uint32_t) + spec_size;
+    return ((header_size + page_size - 1) / page_size) * page_size;
+}
+
+}
+
+MappedDenseTensor::MappedDenseTensor(eval::ValueType type_in, std::unique_ptr<MappedFileInput> file, size_t offset)
+    : DenseTensorView(_type),
+      _type(std::move(type_in)),
+      _file(std::move(file))
+{
+    initCellsRef(TypedCells(_file->get().data + offset, _type.cell_type(), _type.dense_subspace_size()));
+}
+
+MappedDenseTensor::~MappedDenseTensor() = default;
+
+bool
+MappedDenseTensor::save(const vespalib::string &file_name, const DenseTensorView &tensor)
+{
+    vespalib::string spec = tensor.fast_type().to_spec();
+    uint32_t spec_size = spec.size();
+    size_t offset = cells_offset(spec_size);
+    size_t padding = offset - (sizeof(file_magic) + sizeof(spec_size) + spec_size);
+    std::vector<char> zeros(padding, 0);
+    const TypedCells &cells = tensor.cellsRef();
+    size_t cells_size = cells.size * cell_size(cells.type);
+    FILE *file = fopen(file_name.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = (fwrite(file_magic, 1, sizeof(file_magic), file) == sizeof(file_magic));
+    ok = ok && (fwrite(&spec_size, 1, sizeof(spec_size), file) == sizeof(spec_size));
+    ok = ok && (fwrite(spec.data(), 1, spec.size(), file) == spec.size());
+    ok = ok && (fwrite(zeros.data(), 1, zeros.size(), file) == zeros.size());
+    ok = ok && (fwrite(cells.data, 1, cells_size, file) == cells_size);
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+std::unique_ptr<MappedDenseTensor>
+MappedDenseTensor::load(const vespalib::string &file_name)
+{
+    auto file = std::make_unique<MappedFileInput>(file_name);
+    if (!file->valid()) {
+        return std::unique_ptr<MappedDenseTensor>();
+    }
+    Memory data = file->get();
+    uint32_t spec_size = 0;
+    if ((data.size < sizeof(file_magic) + sizeof(spec_size)) ||
+        (memcmp(data.data, file_magic, sizeof(file_magic)) != 0))
+    {
+        return std::unique_ptr<MappedDenseTensor>();
+    }
+    memcpy(&spec_size, data.data + sizeof(file_magic), sizeof(spec_size));
+    size_t offset = cells_offset(spec_size);
+    if (data.size < offset) {
+        return std::unique_ptr<MappedDenseTensor>();
+    }
+    ValueType type = ValueType::from_spec(vespalib::string(data.data + sizeof(file_magic) + sizeof(spec_size), spec_size));
+    if (!type.is_dense() ||
+        (data.size != offset + type.dense_subspace_size() * cell_size(type.cell_type())))
+    {
+        return std::unique_ptr<MappedDenseTensor>();
+    }
+    return std::make_unique<MappedDenseTensor>(std::move(type), std::move(file), offset);
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "dense_tensor_view.h"
+
+namespace vespalib { class MappedFileInput; }
+
+namespace vespalib::tensor {
+
+/**
+ * A dense tensor where the cells are read directly from a
+ * memory-mapped file in native layout. The file starts with a small
+ * header describing the tensor type, followed by the cells starting
+ * at the next page boundary. Mapped pages are shared with all other
+ * mappings of the same file and may be dropped by the OS when
+ * memory is needed, since they can always be read back from file.
+ */
+class MappedDenseTensor : public DenseTensorView
+{
+private:
+    eval::ValueType _type;
+    std::unique_ptr<MappedFileInput> _file;
+public:
+    MappedDenseTensor(eval::ValueType type_in, std::unique_ptr<MappedFileInput> file, size_t cells_offset);
+    ~MappedDenseTensor() override;
+
+    // write the given tensor to file in the layout expected by 'load'
+    static bool save(const vespalib::string &file_name, const DenseTensorView &tensor);
+
+    // returns an empty pointer if the file does not contain a valid tensor
+    static std::unique_ptr<MappedDenseTensor> load(const vespalib::string &file_name);
+};
+
+}
@@ -19,6 +19,8 @@ struct TypedCells {
 
     explicit TypedCells(ConstArrayRef<double> cells) : data(cells.begin()), type(CellType::DOUBLE), size(cells.size()) {}
     explicit TypedCells(ConstArrayRef<float> cells) : data(cells.begin()), type(CellType::FLOAT), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<int8_t> cells) : data(cells.begin()), type(CellType::INT8), size(cells.size()) {}
+    explicit TypedCells(ConstArrayRef<BFloat16> cells) : data(cells.begin()), type(CellType::BFLOAT16), size(cells.size()) {}
 
     TypedCells() : data(nullptr), type(CellType::DOUBLE), size(0) {}
     TypedCells(const void *dp, CellType ct, size_t sz) : data(dp), type(ct), size(sz) {}
@@ -41,6 +43,14 @@ struct TypedCells {
             const float *p = (const float *)data;
             return p[idx];
         }
+        if (type == CellType::INT8) {
+            const int8_t *p = (const int8_t *)data;
+            return p[idx];
+        }
+        if (type == CellType::BFLOAT16) {
+            const BFloat16 *p = (const BFloat16 *)data;
+            return p[idx].to_float();
+        }
         abort();
     }
 
@@ -52,6 +62,8 @@ decltype(auto) dispatch_0(CellType ct, Args &&...args) {
     switch (ct) {
         case CellType::DOUBLE: return TGT::template call<double>(std::forward<Args>(args)...);
         case CellType::FLOAT:  return TGT::template call<float>(std::forward<Args>(args)...);
+        case CellType::INT8:   return TGT::template call<int8_t>(std::forward<Args>(args)...);
+        case CellType::BFLOAT16: return TGT::template call<BFloat16>(std::forward<Args>(args)...);
     }
     abort();
 }
@@ -61,6 +73,8 @@ decltype(auto) dispatch_1(const TypedCells &a, Args &&...args) {
     switch (a.type) {
         case CellType::DOUBLE: return TGT::call(a.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return TGT::call(a.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::INT8:   return TGT::call(a.unsafe_typify<int8_t>(), std::forward<Args>(args)...);
+        case CellType::BFLOAT16: return TGT::call(a.unsafe_typify<BFloat16>(), std::forward<Args>(args)...);
     }
     abort();
 }
@@ -70,6 +84,8 @@ decltype(auto) dispatch_2(A1 &&a, const TypedCells &b, Args &&...args) {
     switch (b.type) {
         case CellType::DOUBLE: return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<double>(), std::forward<Args>(args)...);
         case CellType::FLOAT:  return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<float>(),  std::forward<Args>(args)...);
+        case CellType::INT8:   return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<int8_t>(), std::forward<Args>(args)...);
+        case CellType::BFLOAT16: return dispatch_1<TGT>(std::forward<A1>(a), b.unsafe_typify<BFloat16>(), std::forward<Args>(args)...);
     }
     abort();
 }
@@ -79,6 +95,8 @@ decltype(auto) select_1(CellType a_type) {
     switch(a_type) {
     case CellType::DOUBLE: return T::template get_fun<double, Args...>();
     case CellType::FLOAT:  return T::template get_fun<float, Args...>();
+    case CellType::INT8:   return T::template get_fun<int8_t, Args...>();
+    case CellType::BFLOAT16: return T::template get_fun<BFloat16, Args...>();
     }
     abort();
 }
@@ -88,6 +106,8 @@ decltype(auto) select_2(CellType a_type, CellType b_type) {
     switch(b_type) {
     case CellType::DOUBLE: return select_1<T, double>(a_type);
     case CellType::FLOAT:  return select_1<T, float>(a_type);
+    case CellType::INT8:   return select_1<T, int8_t>(a_type);
+    case CellType::BFLOAT16: return select_1<T, BFloat16>(a_type);
     }
     abort();
 }
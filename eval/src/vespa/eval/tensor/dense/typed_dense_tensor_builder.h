@@ -29,11 +29,11 @@ private:
 public:
     TypedDenseTensorBuilder(const eval::ValueType &type_in);
     ~TypedDenseTensorBuilder();
-    void insertCell(const Address &address, CT cellValue) {
+    void insertCell(const Address &address, double cellValue) {
         insertCell(calculateCellAddress(address, _type), cellValue);
     }
-    void insertCell(size_t index, CT cellValue) {
-        _cells[index] = cellValue;
+    void insertCell(size_t index, double cellValue) {
+        _cells[index] = eval::convert_cell<CT>(cellValue);
     }
     Tensor::UP build();
 };
@@ -0,0 +1,101 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mapped_constant_loader.h"
+#include <vespa/eval/tensor/dense/mapped_dense_tensor.h>
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/util/sha1.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.tensor.mapped_constant_loader");
+
+namespace vespalib::tensor {
+
+using eval::ConstantValue;
+using eval::SimpleConstantValue;
+using eval::ValueType;
+
+namespace {
+
+const vespalib::string file_suffix(".dense");
+
+vespalib::string make_file_name(const vespalib::string &dir, const vespalib::string &path,
+                                const vespalib::string &type, const struct stat &info)
+{
+    constexpr size_t digest_size = 20;
+    char digest[digest_size];
+    vespalib::string key = make_string("%s\n%s\n%zu\n%ld", path.c_str(), type.c_str(),
+                                       size_t(info.st_size), long(info.st_mtime));
+    Sha1 sha1;
+    sha1.process(key.data(), key.size());
+    sha1.get_digest(digest, digest_size);
+    vespalib::string name = dir + "/";
+    for (size_t i = 0; i < digest_size; ++i) {
+        name.append(make_string("%02x", (unsigned char)digest[i]));
+    }
+    return name + file_suffix;
+}
+
+std::unique_ptr<MappedDenseTensor> load_mapped(const vespalib::string &file_name, const ValueType &type) {
+    auto mapped = MappedDenseTensor::load(file_name);
+    if (mapped && (mapped->fast_type() == type)) {
+        // keep recently used files when pruning
+        utime(file_name.c_str(), nullptr);
+        return mapped;
+    }
+    return std::unique_ptr<MappedDenseTensor>();
+}
+
+}
+
+MappedConstantLoader::MappedConstantLoader(const eval::ConstantValueFactory &factory, const vespalib::string &dir)
+    : _factory(factory),
+      _dir(dir)
+{
+}
+
+MappedConstantLoader::~MappedConstantLoader() = default;
+
+ConstantValue::UP
+MappedConstantLoader::create(const vespalib::string &path, const vespalib::string &type) const
+{
+    ValueType value_type = ValueType::from_spec(type);
+    struct stat info;
+    if (!value_type.is_dense() || (::stat(path.c_str(), &info) != 0)) {
+        return _factory.create(path, type);
+    }
+    vespalib::string file_name = make_file_name(_dir, path, type, info);
+    if (auto mapped = load_mapped(file_name, value_type)) {
+        return std::make_unique<SimpleConstantValue>(std::move(mapped));
+    }
+    auto value = _factory.create(path, type);
+    if (value->type() != value_type) {
+        return value;
+    }
+    const auto *dense = dynamic_cast<const DenseTensorView *>(&value->value());
+    if (dense == nullptr) {
+        return value;
+    }
+    // write to a temporary file first to never expose partial files
+    vespalib::string tmp_name = getUniqueTempFileName(file_name);
+    if (MappedDenseTensor::save(tmp_name, *dense) && (::rename(tmp_name.c_str(), file_name.c_str()) == 0)) {
+        if (auto mapped = load_mapped(file_name, value_type)) {
+            return std::make_unique<SimpleConstantValue>(std::move(mapped));
+        }
+    } else {
+        LOG(warning, "could not store converted constant '%s' in '%s'", path.c_str(), file_name.c_str());
+        ::unlink(tmp_name.c_str());
+    }
+    return value;
+}
+
+size_t
+MappedConstantLoader::prune(const vespalib::string &dir, size_t max_bytes)
+{
+    return vespalib::pruneDirectory(dir, file_suffix, max_bytes);
+}
+
+}
@@ -0,0 +1,35 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/value_cache/constant_value.h>
+#include <vespa/vespalib/stllike/string.h>
+
+namespace vespalib::tensor {
+
+/**
+ * A ConstantValueFactory wrapping another factory, converting dense
+ * constant tensors into files with native cell layout in the given
+ * directory the first time they are loaded. The converted files are
+ * memory-mapped (see MappedDenseTensor), making later loads of the
+ * same constant cheap, also across restarts. Constants that are not
+ * dense tensors are created by the wrapped factory. Converted files
+ * are identified by the path, type, size and modification time of
+ * the original file.
+ **/
+class MappedConstantLoader : public eval::ConstantValueFactory
+{
+private:
+    const eval::ConstantValueFactory &_factory;
+    vespalib::string _dir;
+public:
+    MappedConstantLoader(const eval::ConstantValueFactory &factory, const vespalib::string &dir);
+    ~MappedConstantLoader() override;
+    eval::ConstantValue::UP create(const vespalib::string &path, const vespalib::string &type) const override;
+
+    // remove the least recently used files in 'dir' until the total
+    // size is below 'max_bytes'; returns the number of removed files
+    static size_t prune(const vespalib::string &dir, size_t max_bytes);
+};
+
+}
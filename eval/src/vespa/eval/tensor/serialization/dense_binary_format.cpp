@@ -3,8 +3,11 @@
 #include "dense_binary_format.h"
 #include <vespa/eval/tensor/dense/dense_tensor.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 using vespalib::nbostream;
 using vespalib::eval::ValueType;
@@ -28,11 +31,38 @@ size_t encodeDimensions(nbostream &stream, const eval::ValueType & type) {
     return cellsSize;
 }
 
+// unsigned integer type with the same size as the cell type
+template <typename T> struct CellBits;
+template <> struct CellBits<double> { using type = uint64_t; };
+template <> struct CellBits<float> { using type = uint32_t; };
+template <> struct CellBits<BFloat16> { using type = uint16_t; };
+template <> struct CellBits<int8_t> { using type = uint8_t; };
+
+// convert cells between host and network byte order (same both ways)
+template <typename T>
+void swapCells(const char *src, char *dst, size_t numCells) {
+    using Bits = typename CellBits<T>::type;
+    static_assert(sizeof(Bits) == sizeof(T));
+    for (size_t i = 0; i < numCells; ++i) {
+        Bits bits;
+        memcpy(&bits, src + (i * sizeof(T)), sizeof(T));
+        bits = nbo::n2h(bits);
+        memcpy(dst + (i * sizeof(T)), &bits, sizeof(T));
+    }
+}
+
+// number of cells converted at a time when there is no direct target
+constexpr size_t chunkCells = 256;
+
 template<typename T>
 void encodeCells(nbostream &stream, TypedCells cells) {
     auto arr = cells.typify<T>();
-    for (const auto &value : arr) {
-        stream << value;
+    const char *src = reinterpret_cast<const char *>(arr.begin());
+    char buf[chunkCells * sizeof(T)];
+    for (size_t offset = 0; offset < arr.size(); offset += chunkCells) {
+        size_t n = std::min(chunkCells, arr.size() - offset);
+        swapCells<T>(src + (offset * sizeof(T)), buf, n);
+        stream.write(buf, n * sizeof(T));
     }
 }
 
@@ -50,12 +80,36 @@ size_t decodeDimensions(nbostream & stream, std::vector<Dimension> & dimensions)
     return cellsSize;
 }
 
+// consume all cells from the stream, returning the start of them
+template<typename T>
+const char *takeCells(nbostream &stream, size_t cellsSize) {
+    if (cellsSize > (stream.size() / sizeof(T))) {
+        throw IllegalStateException(make_string("Stream too short for %zu dense tensor cells of %zu bytes, only %zu bytes left",
+                                                cellsSize, sizeof(T), stream.size()));
+    }
+    const char *src = stream.peek();
+    stream.adjustReadPos(cellsSize * sizeof(T));
+    return src;
+}
+
+template<typename T>
+void decodeCells(nbostream &stream, size_t cellsSize, std::vector<T> &cells) {
+    const char *src = takeCells<T>(stream, cellsSize);
+    size_t offset = cells.size();
+    cells.resize(offset + cellsSize);
+    swapCells<T>(src, reinterpret_cast<char *>(cells.data() + offset), cellsSize);
+}
+
 template<typename T, typename V>
 void decodeCells(nbostream &stream, size_t cellsSize, V &cells) {
-    T cellValue = 0.0;
-    for (size_t i = 0; i < cellsSize; ++i) {
-        stream >> cellValue;
-        cells.emplace_back(cellValue);
+    const char *src = takeCells<T>(stream, cellsSize);
+    T buf[chunkCells];
+    for (size_t offset = 0; offset < cellsSize; offset += chunkCells) {
+        size_t n = std::min(chunkCells, cellsSize - offset);
+        swapCells<T>(src + (offset * sizeof(T)), reinterpret_cast<char *>(buf), n);
+        for (size_t i = 0; i < n; ++i) {
+            cells.emplace_back(buf[i]);
+        }
     }
 }
 
@@ -68,6 +122,12 @@ void decodeCells(CellType cell_type, nbostream &stream, size_t cellsSize, V &cel
     case CellType::FLOAT:
         decodeCells<float>(stream, cellsSize, cells);
         break;
+    case CellType::INT8:
+        decodeCells<int8_t>(stream, cellsSize, cells);
+        break;
+    case CellType::BFLOAT16:
+        decodeCells<BFloat16>(stream, cellsSize, cells);
+        break;
     }
 }
 
@@ -86,6 +146,12 @@ DenseBinaryFormat::serialize(nbostream &stream, const DenseTensorView &tensor)
     case CellType::FLOAT:
         encodeCells<float>(stream, cells);
         break;
+    case CellType::INT8:
+        encodeCells<int8_t>(stream, cells);
+        break;
+    case CellType::BFLOAT16:
+        encodeCells<BFloat16>(stream, cells);
+        break;
     }
 }
 
@@ -94,7 +160,6 @@ struct CallDecodeCells {
     static std::unique_ptr<DenseTensorView>
     invoke(nbostream &stream, size_t numCells, ValueType &&newType) {
         std::vector<CT> newCells;
-        newCells.reserve(numCells);
         decodeCells<CT>(stream, numCells, newCells);
         return std::make_unique<DenseTensor<CT>>(std::move(newType), std::move(newCells));
     }
@@ -106,7 +171,7 @@ DenseBinaryFormat::deserialize(nbostream &stream, CellType cell_type)
     std::vector<Dimension> dimensions;
     size_t numCells = decodeDimensions(stream, dimensions);
     ValueType newType = ValueType::tensor_type(std::move(dimensions), cell_type);
-    using MyTypify = eval::TypifyCellType;
+    using MyTypify = eval::TypifyAllCellTypes;
     return typify_invoke<1,MyTypify,CallDecodeCells>(cell_type, stream, numCells, std::move(newType));
 }
 
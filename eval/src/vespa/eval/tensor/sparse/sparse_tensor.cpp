@@ -4,7 +4,6 @@
 #include "sparse_tensor_add.h"
 #include "sparse_tensor_address_builder.h"
 #include "sparse_tensor_apply.hpp"
-#include "sparse_tensor_match.h"
 #include "sparse_tensor_modify.h"
 #include "sparse_tensor_reduce.hpp"
 #include "sparse_tensor_remove.h"
@@ -165,12 +164,8 @@ SparseTensor::join(join_fun_t function, const Tensor &arg) const
         return Tensor::UP();
     }
     if (function == eval::operation::Mul::f) {
-        if (fast_type() == rhs->fast_type()) {
-            return SparseTensorMatch(*this, *rhs).result();
-        } else {
-            return sparse::apply(*this, *rhs, [](double lhsValue, double rhsValue)
-                                 { return lhsValue * rhsValue; });
-        }
+        return sparse::apply(*this, *rhs, [](double lhsValue, double rhsValue)
+                             { return lhsValue * rhsValue; });
     }
     return sparse::apply(*this, *rhs, function);
 }
@@ -4,28 +4,133 @@
 
 #include "sparse_tensor_apply.h"
 #include "sparse_tensor_address_combiner.h"
+#include "sparse_tensor_address_reducer.h"
 #include "direct_sparse_tensor_builder.h"
+#include <vespa/eval/eval/value_type.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
 
 namespace vespalib::tensor::sparse {
 
+namespace apply_detail {
+
+inline std::vector<vespalib::string>
+dimensions_not_in(const eval::ValueType &type, const eval::ValueType &other)
+{
+    std::vector<vespalib::string> result;
+    for (const auto &dim : type.dimensions()) {
+        if (other.dimension_index(dim.name) == eval::ValueType::Dimension::npos) {
+            result.push_back(dim.name);
+        }
+    }
+    return result;
+}
+
+/**
+ * Both tensors have the same dimensions; look up the cells of the
+ * smaller tensor in the larger one.
+ */
+template <typename Function>
+void
+join_same_dimensions(DirectSparseTensorBuilder &builder,
+                     const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
+{
+    if (lhs.cells().size() <= rhs.cells().size()) {
+        builder.reserve(lhs.cells().size()*2);
+        for (const auto &lhsCell : lhs.cells()) {
+            auto rhsItr = rhs.cells().find(lhsCell.first);
+            if (rhsItr != rhs.cells().end()) {
+                builder.insertCell(lhsCell.first, func(lhsCell.second, rhsItr->second));
+            }
+        }
+    } else {
+        builder.reserve(rhs.cells().size()*2);
+        for (const auto &rhsCell : rhs.cells()) {
+            auto lhsItr = lhs.cells().find(rhsCell.first);
+            if (lhsItr != lhs.cells().end()) {
+                builder.insertCell(rhsCell.first, func(lhsItr->second, rhsCell.second));
+            }
+        }
+    }
+}
+
+/**
+ * The tensors have some common dimensions; index the cells of rhs
+ * on their labels for the common dimensions and probe the index
+ * with each cell of lhs.
+ */
+template <typename Function>
+void
+join_overlapping(DirectSparseTensorBuilder &builder, TensorAddressCombiner &addressCombiner,
+                 const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
+{
+    struct IndexedCell {
+        SparseTensorAddressRef address;
+        double value;
+        uint32_t next;
+    };
+    constexpr uint32_t end_of_chain = -1;
+    using Index = hash_map<SparseTensorAddressRef, uint32_t, hash<SparseTensorAddressRef>,
+                           std::equal_to<>, hashtable_base::and_modulator>;
+    TensorAddressReducer lhsKey(lhs.fast_type(), dimensions_not_in(lhs.fast_type(), rhs.fast_type()));
+    TensorAddressReducer rhsKey(rhs.fast_type(), dimensions_not_in(rhs.fast_type(), lhs.fast_type()));
+    Stash keys;
+    Index index(rhs.cells().size()*2);
+    std::vector<IndexedCell> rhsCells;
+    rhsCells.reserve(rhs.cells().size());
+    for (const auto &rhsCell : rhs.cells()) {
+        uint32_t idx = rhsCells.size();
+        rhsKey.reduce(rhsCell.first);
+        auto pos = index.find(rhsKey.getAddressRef());
+        if (pos == index.end()) {
+            index.insert(std::make_pair(SparseTensorAddressRef(rhsKey.getAddressRef(), keys), idx));
+            rhsCells.push_back(IndexedCell{rhsCell.first, rhsCell.second, end_of_chain});
+        } else {
+            rhsCells.push_back(IndexedCell{rhsCell.first, rhsCell.second, pos->second});
+            pos->second = idx;
+        }
+    }
+    builder.reserve(std::max(lhs.cells().size(), rhs.cells().size())*2);
+    for (const auto &lhsCell : lhs.cells()) {
+        lhsKey.reduce(lhsCell.first);
+        auto pos = index.find(lhsKey.getAddressRef());
+        if (pos != index.end()) {
+            for (uint32_t idx = pos->second; idx != end_of_chain; idx = rhsCells[idx].next) {
+                const IndexedCell &rhsCell = rhsCells[idx];
+                bool combineSuccess = addressCombiner.combine(lhsCell.first, rhsCell.address);
+                assert(combineSuccess);
+                (void) combineSuccess;
+                builder.insertCell(addressCombiner.getAddressRef(),
+                                   func(lhsCell.second, rhsCell.value));
+            }
+        }
+    }
+}
+
+}
+
 template <typename Function>
 std::unique_ptr<Tensor>
 apply(const SparseTensor &lhs, const SparseTensor &rhs, Function &&func)
 {
     DirectSparseTensorBuilder builder(lhs.combineDimensionsWith(rhs));
+    if (lhs.fast_type().dimensions() == rhs.fast_type().dimensions()) {
+        apply_detail::join_same_dimensions(builder, lhs, rhs, func);
+        return builder.build();
+    }
     TensorAddressCombiner addressCombiner(lhs.fast_type(), rhs.fast_type());
-    size_t estimatedCells = (lhs.cells().size() * rhs.cells().size());
     if (addressCombiner.numOverlappingDimensions() != 0) {
-        estimatedCells = std::min(lhs.cells().size(), rhs.cells().size());
+        apply_detail::join_overlapping(builder, addressCombiner, lhs, rhs, func);
+        return builder.build();
     }
-    builder.reserve(estimatedCells*2);
+    builder.reserve(lhs.cells().size() * rhs.cells().size() * 2);
     for (const auto &lhsCell : lhs.cells()) {
         for (const auto &rhsCell : rhs.cells()) {
             bool combineSuccess = addressCombiner.combine(lhsCell.first, rhsCell.first);
-            if (combineSuccess) {
-                builder.insertCell(addressCombiner.getAddressRef(),
-                                   func(lhsCell.second, rhsCell.second));
-            }
+            assert(combineSuccess);
+            (void) combineSuccess;
+            builder.insertCell(addressCombiner.getAddressRef(),
+                               func(lhsCell.second, rhsCell.second));
         }
     }
     return builder.build();
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "distance_metric.h"
+#include "vector_quantization.h"
 
 namespace search::attribute {
 
@@ -16,24 +17,29 @@ private:
     uint32_t _neighbors_to_explore_at_insert;
     // This is always the same as in the attribute config, and is duplicated here to simplify usage.
     DistanceMetric _distance_metric;
+    VectorQuantization _quantization;
 
 public:
     HnswIndexParams(uint32_t max_links_per_node_in,
                     uint32_t neighbors_to_explore_at_insert_in,
-                    DistanceMetric distance_metric_in)
+                    DistanceMetric distance_metric_in,
+                    VectorQuantization quantization_in = VectorQuantization::None)
             : _max_links_per_node(max_links_per_node_in),
               _neighbors_to_explore_at_insert(neighbors_to_explore_at_insert_in),
-              _distance_metric(distance_metric_in)
+              _distance_metric(distance_metric_in),
+              _quantization(quantization_in)
     {}
 
     uint32_t max_links_per_node() const { return _max_links_per_node; }
     uint32_t neighbors_to_explore_at_insert() const { return _neighbors_to_explore_at_insert; }
     DistanceMetric distance_metric() const { return _distance_metric; }
+    VectorQuantization quantization() const { return _quantization; }
 
     bool operator==(const HnswIndexParams& rhs) const {
         return (_max_links_per_node == rhs._max_links_per_node &&
                 _neighbors_to_explore_at_insert == rhs._neighbors_to_explore_at_insert &&
-                _distance_metric == rhs._distance_metric);
+                _distance_metric == rhs._distance_metric &&
+                _quantization == rhs._quantization);
     }
 };
 
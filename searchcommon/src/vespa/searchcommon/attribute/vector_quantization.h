@@ -0,0 +1,12 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+namespace search::attribute {
+
+/**
+ * Compression of the vectors used when traversing a nearest neighbor index.
+ */
+enum class VectorQuantization { None, Int8 };
+
+}
@@ -5,14 +5,22 @@ LOG_SETUP("attribute_populator_test");
 
 #include <vespa/document/repo/configbuilder.h>
 #include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <vespa/document/fieldvalue/tensorfieldvalue.h>
+#include <vespa/eval/eval/tensor_spec.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/tensor/tensor.h>
+#include <vespa/searchcore/proton/attribute/attribute_factory.h>
 #include <vespa/searchcore/proton/attribute/attribute_populator.h>
 #include <vespa/searchcore/proton/attribute/attributemanager.h>
 #include <vespa/searchcore/proton/common/hw_info.h>
 #include <vespa/searchcore/proton/test/test.h>
 #include <vespa/vespalib/util/foregroundtaskexecutor.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/hnsw_index.h>
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 
 using document::config_builder::DocumenttypesConfigBuilderHelper;
 using document::config_builder::Struct;
@@ -23,12 +31,19 @@ using namespace search;
 using namespace search::index;
 
 using search::test::DirectoryHandler;
+using search::tensor::DenseTensorAttribute;
+using search::tensor::HnswIndex;
+using vespalib::eval::TensorSpec;
+using vespalib::eval::ValueType;
+using vespalib::tensor::DefaultTensorEngine;
+using vespalib::tensor::Tensor;
 
 using AVBasicType = search::attribute::BasicType;
 using AVConfig = search::attribute::Config;
 
 const vespalib::string TEST_DIR = "testdir";
 const uint64_t CREATE_SERIAL_NUM = 8u;
+const vespalib::string dense_tensor_spec("tensor(x[2])");
 
 std::unique_ptr<const DocumentTypeRepo>
 makeDocTypeRepo()
@@ -37,7 +52,8 @@ makeDocTypeRepo()
     builder.document(-645763131, "searchdocument",
                      Struct("searchdocument.header"),
                      Struct("searchdocument.body").
-                     addField("a1", DataType::T_INT));
+                     addField("a1", DataType::T_INT).
+                     addTensorField("t1", dense_tensor_spec));
     return std::unique_ptr<const DocumentTypeRepo>(new DocumentTypeRepo(builder.config()));
 }
 
@@ -55,6 +71,16 @@ struct DocContext
         doc->setValue("a1", IntFieldValue(fieldValue));
         return doc;
     }
+    std::shared_ptr<Document> create_with_tensor(uint32_t id, double x0, double x1) {
+        auto doc = create(id, 0);
+        auto field_value = doc->getField("t1").createValue();
+        auto &tensor_value = dynamic_cast<TensorFieldValue &>(*field_value);
+        auto tensor = DefaultTensorEngine::ref().from_spec(TensorSpec(dense_tensor_spec).
+                                                           add({{"x", 0}}, x0).add({{"x", 1}}, x1));
+        tensor_value = Tensor::UP(dynamic_cast<Tensor *>(tensor.release()));
+        doc->setValue("t1", *field_value);
+        return doc;
+    }
 };
 
 struct Fixture
@@ -62,6 +88,7 @@ struct Fixture
     DirectoryHandler _testDir;
     DummyFileHeaderContext _fileHeader;
     ForegroundTaskExecutor _attributeFieldWriter;
+    vespalib::ThreadStackExecutor _shared;
     HwInfo                 _hwInfo;
     AttributeManager::SP _mgr;
     std::unique_ptr<AttributePopulator> _pop;
@@ -70,20 +97,33 @@ struct Fixture
         : _testDir(TEST_DIR),
           _fileHeader(),
           _attributeFieldWriter(),
+          _shared(2, 128 * 1024),
           _hwInfo(),
           _mgr(new AttributeManager(TEST_DIR, "test.subdb",
                   TuneFileAttributes(),
-                                    _fileHeader, _attributeFieldWriter, _hwInfo)),
+                                    _fileHeader, _attributeFieldWriter,
+                                    std::make_shared<AttributeFactory>(), _hwInfo, &_shared)),
           _pop(),
           _ctx()
     {
         _mgr->addAttribute({ "a1", AVConfig(AVBasicType::INT32)},
                 CREATE_SERIAL_NUM);
+        AVConfig tensor_cfg(AVBasicType::TENSOR);
+        tensor_cfg.setTensorType(ValueType::from_spec(dense_tensor_spec));
+        tensor_cfg.set_hnsw_index_params(search::attribute::HnswIndexParams(4, 20, search::attribute::DistanceMetric::Euclidean));
+        _mgr->addAttribute({ "t1", tensor_cfg}, CREATE_SERIAL_NUM);
         _pop = std::make_unique<AttributePopulator>(_mgr, 1, "test", CREATE_SERIAL_NUM);
     }
     AttributeGuard::UP getAttr() {
         return _mgr->getAttribute("a1");
     }
+    const HnswIndex &get_hnsw_index() {
+        auto attr = dynamic_cast<const DenseTensorAttribute *>(_mgr->getWritableAttribute("t1"));
+        assert(attr != nullptr);
+        auto index = dynamic_cast<const HnswIndex *>(attr->nearest_neighbor_index());
+        assert(index != nullptr);
+        return *index;
+    }
 };
 
 TEST_F("require that reprocess with document populates attribute", Fixture)
@@ -104,6 +144,18 @@ TEST_F("require that reprocess with document populates attribute", Fixture)
     EXPECT_EQUAL(CREATE_SERIAL_NUM, attr->get()->getStatus().getLastSyncToken());
 }
 
+TEST_F("require that nearest neighbor index is built in bulk when reprocessing is done", Fixture)
+{
+    f._pop->handleExisting(1, f._ctx.create_with_tensor(0, 3, 5));
+    f._pop->handleExisting(2, f._ctx.create_with_tensor(1, 7, 9));
+    const auto &index = f.get_hnsw_index();
+    EXPECT_EQUAL(0u, index.get_entry_docid());
+    f._pop->done();
+    EXPECT_EQUAL(1u, index.get_node(1).level(0).size());
+    EXPECT_EQUAL(1u, index.get_node(2).level(0).size());
+    EXPECT_TRUE(index.check_link_symmetry());
+}
+
 TEST_MAIN()
 {
     vespalib::rmdir(TEST_DIR, true);
@@ -4,6 +4,7 @@
 #include <vespa/config/helper/configgetter.hpp>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/default_tensor_engine.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/test/make_bucket_space.h>
@@ -175,6 +176,7 @@ public:
     bool _mkdirOk;
     matching::QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
     DummyWireService _dummy;
     config::DirSpec _spec;
     DocumentDBConfigHelper _configMgr;
@@ -194,6 +196,7 @@ public:
           _mkdirOk(FastOS_File::MakeDirectory("tmpdb")),
           _queryLimiter(),
           _clock(),
+          _constantValueFactory(vespalib::tensor::DefaultTensorEngine::ref()),
           _dummy(),
           _spec(TEST_PATH("")),
           _configMgr(_spec, getDocTypeName()),
@@ -217,6 +220,7 @@ public:
             LOG_ABORT("should not be reached");
         }
         _ddb.reset(new DocumentDB("tmpdb", _configMgr.getConfig(), "tcp/localhost:9013", _queryLimiter, _clock,
+                                  _constantValueFactory,
                                   DocTypeName(docTypeName), makeBucketSpace(),
 				  *b->getProtonConfigSP(), *this, _summaryExecutor, _summaryExecutor,
                                   _tls, _dummy, _fileHeaderContext, ConfigStore::UP(new MemoryConfigStore),
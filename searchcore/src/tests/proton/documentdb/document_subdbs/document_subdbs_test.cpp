@@ -2,6 +2,8 @@
 
 #include <vespa/config-bucketspaces.h>
 #include <vespa/document/test/make_bucket_space.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/searchcore/proton/attribute/imported_attributes_repo.h>
 #include <vespa/searchcore/proton/bucketdb/bucketdbhandler.h>
 #include <vespa/searchcore/proton/common/hw_info.h>
@@ -216,6 +218,7 @@ struct MySearchableContext
     MyFastAccessContext _fastUpdCtx;
     QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
     SearchableContext _ctx;
     MySearchableContext(IThreadingService &writeService,
                         std::shared_ptr<BucketDBOwner> bucketDB,
@@ -235,7 +238,8 @@ MySearchableContext::MySearchableContext(IThreadingService &writeService,
                                          IBucketDBHandlerInitializer & bucketDBHandlerInitializer)
     : _fastUpdCtx(writeService, bucketDB, bucketDBHandlerInitializer),
       _queryLimiter(), _clock(),
-      _ctx(_fastUpdCtx._ctx, _queryLimiter, _clock, dynamic_cast<vespalib::SyncableThreadExecutor &>(writeService.shared()))
+      _constantValueFactory(vespalib::tensor::DefaultTensorEngine::ref()),
+      _ctx(_fastUpdCtx._ctx, _queryLimiter, _clock, _constantValueFactory, dynamic_cast<vespalib::SyncableThreadExecutor &>(writeService.shared()))
 {}
 MySearchableContext::~MySearchableContext() = default;
 
@@ -5,6 +5,8 @@
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/fastos/file.h>
 #include <vespa/document/test/make_bucket_space.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/searchcore/proton/attribute/flushableattribute.h>
 #include <vespa/searchcore/proton/common/statusreport.h>
 #include <vespa/searchcore/proton/docsummary/summaryflushtarget.h>
@@ -74,6 +76,7 @@ struct Fixture {
     TransLogServer _tls;
     matching::QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
 
     Fixture();
     ~Fixture();
@@ -88,7 +91,8 @@ Fixture::Fixture()
       _fileHeaderContext(),
       _tls("tmp", 9014, ".", _fileHeaderContext),
       _queryLimiter(),
-      _clock()
+      _clock(),
+      _constantValueFactory(vespalib::tensor::DefaultTensorEngine::ref())
 {
     DocumentDBConfig::DocumenttypesConfigSP documenttypesConfig(new DocumenttypesConfig());
     DocumentType docType("typea", 0);
@@ -104,7 +108,8 @@ Fixture::Fixture()
                               tuneFileDocumentDB, HwInfo()));
     mgr.forwardConfig(b);
     mgr.nextGeneration(0ms);
-    _db.reset(new DocumentDB(".", mgr.getConfig(), "tcp/localhost:9014", _queryLimiter, _clock, DocTypeName("typea"),
+    _db.reset(new DocumentDB(".", mgr.getConfig(), "tcp/localhost:9014", _queryLimiter, _clock, _constantValueFactory,
+                             DocTypeName("typea"),
                              makeBucketSpace(),
                              *b->getProtonConfigSP(), _myDBOwner, _summaryExecutor, _summaryExecutor, _tls, _dummy,
                              _fileHeaderContext, ConfigStore::UP(new MemoryConfigStore),
@@ -416,6 +416,7 @@ public:
                            _mcCfg->getLidSpaceCompactionConfig(),
                            _mcCfg->getAttributeUsageFilterConfig(),
                            _mcCfg->getAttributeUsageSampleInterval(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig()));
         _mcCfg = newCfg;
@@ -434,6 +435,7 @@ public:
                            _mcCfg->getLidSpaceCompactionConfig(),
                            _mcCfg->getAttributeUsageFilterConfig(),
                            _mcCfg->getAttributeUsageSampleInterval(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig()));
         _mcCfg = newCfg;
@@ -452,6 +454,7 @@ public:
                            _mcCfg->getLidSpaceCompactionConfig(),
                            _mcCfg->getAttributeUsageFilterConfig(),
                            _mcCfg->getAttributeUsageSampleInterval(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig()));
         _mcCfg = newCfg;
@@ -468,6 +471,7 @@ public:
                            cfg,
                            _mcCfg->getAttributeUsageFilterConfig(),
                            _mcCfg->getAttributeUsageSampleInterval(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig()));
         _mcCfg = newCfg;
@@ -1321,13 +1325,13 @@ TEST_F("require that lid space compaction jobs can be disabled", MaintenanceCont
     f.forwardMaintenanceConfig();
     {
         auto jobs = f._mc.getJobList();
-        EXPECT_EQUAL(6u, jobs.size());
+        EXPECT_EQUAL(7u, jobs.size());
         EXPECT_TRUE(containsJob(jobs, "lid_space_compaction.my_handler"));
     }
     f.setLidSpaceCompactionConfig(DocumentDBLidSpaceCompactionConfig::createDisabled());
     {
         auto jobs = f._mc.getJobList();
-        EXPECT_EQUAL(5u, jobs.size());
+        EXPECT_EQUAL(6u, jobs.size());
         EXPECT_FALSE(containsJob(jobs, "lid_space_compaction.my_handler"));
     }
 }
@@ -1336,12 +1340,21 @@ TEST_F("require that maintenance jobs are run by correct executor", MaintenanceC
 {
     f.injectMaintenanceJobs();
     auto jobs = f._mc.getJobList();
-    EXPECT_EQUAL(5u, jobs.size());
+    EXPECT_EQUAL(6u, jobs.size());
     EXPECT_TRUE(containsJobAndExecutedBy(jobs, "heart_beat", f._threadService));
     EXPECT_TRUE(containsJobAndExecutedBy(jobs, "prune_session_cache", f._genericExecutor));
     EXPECT_TRUE(containsJobAndExecutedBy(jobs, "prune_removed_documents.searchdocument", f._threadService));
     EXPECT_TRUE(containsJobAndExecutedBy(jobs, "move_buckets.searchdocument", f._threadService));
     EXPECT_TRUE(containsJobAndExecutedBy(jobs, "sample_attribute_usage.searchdocument", f._threadService));
+    EXPECT_TRUE(containsJobAndExecutedBy(jobs, "nearest_neighbor_index_maintenance.searchdocument", f._threadService));
+}
+
+TEST_F("require that nearest neighbor index maintenance has its own interval", MaintenanceControllerFixture)
+{
+    f.injectMaintenanceJobs();
+    const auto *job = findJob(f._mc.getJobList(), "nearest_neighbor_index_maintenance.searchdocument");
+    ASSERT_TRUE(job != nullptr);
+    EXPECT_EQUAL(f._mcCfg->getNearestNeighborIndexMaintenanceInterval(), job->getJob().getInterval());
 }
 
 void
@@ -348,6 +348,38 @@ TEST("requireThatFactor is capped at minimum 1%") {
     EXPECT_EQUAL(0.0105, stats.softDoomFactor());
 }
 
+TEST("requireThatHitCostIsSmoothedAndNotAdded") {
+    MatchingStats stats;
+    EXPECT_EQUAL(0.0, stats.hitCost());
+    stats.updateHitCost(0.0, 100);   // no time spent, no sample
+    stats.updateHitCost(1.0, 0);     // no hits, no sample
+    EXPECT_EQUAL(0.0, stats.hitCost());
+    stats.updateHitCost(2.0, 1000);
+    EXPECT_EQUAL(0.002, stats.hitCost());
+    stats.updateHitCost(12.0, 1000);
+    EXPECT_APPROX(0.003, stats.hitCost(), 1e-9);
+    MatchingStats stats2;
+    stats2.add(stats);
+    EXPECT_EQUAL(0.0, stats2.hitCost());  // Not affected by add
+}
+
+TEST("requireThatThreadSelectionIsRecorded") {
+    MatchingStats stats;
+    stats.threadsPerSearch(4).estimatedHits(1000).concurrentQueries(2);
+    MatchingStats stats2;
+    stats2.threadsPerSearch(2).estimatedHits(3000).concurrentQueries(6);
+    MatchingStats total;
+    total.add(stats).add(stats2);
+    EXPECT_EQUAL(2u, total.threadsPerSearchCount());
+    EXPECT_EQUAL(3.0, total.threadsPerSearchAvg());
+    EXPECT_EQUAL(2.0, total.threadsPerSearchMin());
+    EXPECT_EQUAL(4.0, total.threadsPerSearchMax());
+    EXPECT_EQUAL(2000.0, total.estimatedHitsAvg());
+    EXPECT_EQUAL(3000.0, total.estimatedHitsMax());
+    EXPECT_EQUAL(4.0, total.concurrentQueriesAvg());
+    EXPECT_EQUAL(2.0, total.concurrentQueriesMin());
+}
+
 TEST_MAIN() {
     TEST_RUN_ALL();
 }
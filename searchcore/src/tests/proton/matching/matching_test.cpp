@@ -314,7 +314,10 @@ struct MyWorld {
     }
 
     SearchReply::UP performSearch(SearchRequest::SP req, size_t threads) {
-        Matcher::SP matcher = createMatcher();
+        return performSearch(createMatcher(), req, threads);
+    }
+
+    SearchReply::UP performSearch(Matcher::SP matcher, SearchRequest::SP req, size_t threads) {
         SearchSession::OwnershipBundle owned_objects;
         owned_objects.search_handler = std::make_shared<MySearchHandler>(matcher);
         owned_objects.context = std::make_unique<MatchContext>(std::make_unique<MockAttributeContext>(),
@@ -710,6 +713,24 @@ TEST("require that search session can be cached") {
     EXPECT_EQUAL("a", session->getSessionId());
 }
 
+TEST("require that search results are cached per matcher") {
+    MyWorld world;
+    world.basicSetup();
+    world.basicResults();
+    world.sessionManager = std::make_shared<SessionManager>(100, 1000000, vespalib::from_s(60));
+    SearchRequest::SP request = world.createSimpleRequest("f1", "spread");
+    Matcher::SP matcher = world.createMatcher();
+    SearchReply::UP reply1 = world.performSearch(matcher, request, 1);
+    SearchReply::UP reply2 = world.performSearch(matcher, request, 1);
+    EXPECT_EQUAL(1u, world.sessionManager->getResultCache().getStats().numHits);
+    EXPECT_EQUAL(reply1->hits.size(), reply2->hits.size());
+    EXPECT_EQUAL(reply1->totalHitCount, reply2->totalHitCount);
+    // a new matcher (like after a rank profile change) must rank the query again
+    SearchReply::UP reply3 = world.performSearch(world.createMatcher(), request, 1);
+    EXPECT_EQUAL(0u, world.sessionManager->getResultCache().getStats().numHits);
+    EXPECT_EQUAL(reply1->hits.size(), reply3->hits.size());
+}
+
 TEST("require that getSummaryFeatures can use cached query setup") {
     MyWorld world;
     world.basicSetup();
@@ -890,6 +911,60 @@ TEST("require that termwise limit is set correctly for first phase ranking progr
     EXPECT_EQUAL(0.02, world.get_first_phase_termwise_limit());
 }
 
+using HitEstimate = search::queryeval::Blueprint::HitEstimate;
+
+struct ThreadsPerSearchFixture {
+    MyWorld world;
+    Matcher::SP matcher;
+    Properties no_overrides;
+    ThreadsPerSearchFixture() : world(), matcher(), no_overrides() {
+        world.basicSetup();
+        world.set_property(indexproperties::matching::NumThreadsPerSearch::NAME, "16");
+        world.set_property(indexproperties::matching::MinTimePerThread::NAME, "0.01");
+        matcher = world.createMatcher();
+    }
+    size_t threads(uint32_t est_hits, double hit_cost, uint32_t active_queries) const {
+        return matcher->computeNumThreadsPerSearch(HitEstimate(est_hits, false), no_overrides,
+                                                   hit_cost, active_queries);
+    }
+};
+
+TEST_F("require that cheap queries use few threads", ThreadsPerSearchFixture) {
+    // 1000 hits at 1us each is 1ms of work, less than the 10ms minimum per thread
+    EXPECT_EQUAL(1u, f1.threads(1000, 0.000001, 1));
+    // 25ms of work
+    EXPECT_EQUAL(3u, f1.threads(25000, 0.000001, 1));
+}
+
+TEST_F("require that expensive queries use all threads", ThreadsPerSearchFixture) {
+    // 1000 hits at 1ms each is 1s of work
+    EXPECT_EQUAL(16u, f1.threads(1000, 0.001, 1));
+}
+
+TEST_F("require that empty queries use a single thread", ThreadsPerSearchFixture) {
+    EXPECT_EQUAL(1u, f1.matcher->computeNumThreadsPerSearch(HitEstimate(0, true), f1.no_overrides, 0.001, 1));
+}
+
+TEST_F("require that all threads are used before the hit cost is known", ThreadsPerSearchFixture) {
+    EXPECT_EQUAL(16u, f1.threads(1000, 0.0, 1));
+}
+
+TEST_F("require that threads are shared between concurrent queries", ThreadsPerSearchFixture) {
+    EXPECT_EQUAL(16u, f1.threads(1000, 0.001, 1));
+    EXPECT_EQUAL(8u, f1.threads(1000, 0.001, 2));
+    EXPECT_EQUAL(4u, f1.threads(1000, 0.001, 4));
+    EXPECT_EQUAL(2u, f1.threads(1000, 0.001, 10));
+    EXPECT_EQUAL(1u, f1.threads(1000, 0.001, 100));
+    // cheap queries are limited by their own cost first
+    EXPECT_EQUAL(2u, f1.threads(35000, 0.000001, 2));
+}
+
+TEST_F("require that threads are not adapted when min time per thread is not set", ThreadsPerSearchFixture) {
+    Properties overrides;
+    overrides.add(indexproperties::matching::MinTimePerThread::NAME, "0");
+    EXPECT_EQUAL(16u, f1.matcher->computeNumThreadsPerSearch(HitEstimate(1000, false), overrides, 0.000001, 100));
+}
+
 TEST("require that fields are tagged with data type") {
     MyWorld world;
     world.basicSetup();
@@ -0,0 +1,178 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcore/proton/matching/query_result_cache.h>
+#include <vespa/searchlib/common/mapnames.h>
+#include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/searchlib/engine/searchrequest.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace proton::matching;
+using search::MapNames;
+using search::engine::SearchReply;
+using search::engine::SearchRequest;
+
+using namespace std::chrono_literals;
+
+vespalib::steady_time t0 = vespalib::steady_time(100s);
+
+std::unique_ptr<SearchRequest> make_request(const vespalib::string &stack) {
+    auto req = std::make_unique<SearchRequest>();
+    req->ranking = "default";
+    req->stackDump.assign(stack.begin(), stack.end());
+    req->offset = 0;
+    req->maxhits = 10;
+    return req;
+}
+
+vespalib::string make_key(const vespalib::string &stack) {
+    return QueryResultCache::makeKey(*make_request(stack), 1);
+}
+
+SearchReply::UP make_reply(size_t num_hits) {
+    auto reply = std::make_unique<SearchReply>();
+    reply->totalHitCount = num_hits * 10;
+    for (size_t i = 0; i < num_hits; ++i) {
+        reply->hits.emplace_back();
+        reply->hits.back().metric = double(num_hits - i);
+    }
+    return reply;
+}
+
+TEST(QueryResultCacheTest, key_covers_query_window_and_properties)
+{
+    auto a = make_request("foo");
+    auto b = make_request("foo");
+    EXPECT_EQ(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*b, 1));
+    b->offset = 10;
+    EXPECT_NE(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*b, 1));
+    auto c = make_request("bar");
+    EXPECT_NE(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*c, 1));
+    auto d = make_request("foo");
+    d->propertiesMap.lookupCreate(MapNames::RANK).add("x", "1");
+    EXPECT_NE(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*d, 1));
+    auto e = make_request("foo");
+    e->ranking = "other";
+    EXPECT_NE(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*e, 1));
+}
+
+TEST(QueryResultCacheTest, key_covers_matcher_generation)
+{
+    auto a = make_request("foo");
+    EXPECT_EQ(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*a, 1));
+    EXPECT_NE(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*a, 2));
+}
+
+TEST(QueryResultCacheTest, property_order_does_not_affect_key)
+{
+    auto a = make_request("foo");
+    a->propertiesMap.lookupCreate(MapNames::RANK).add("x", "1").add("y", "2");
+    a->propertiesMap.lookupCreate(MapNames::FEATURE).add("z", "3");
+    auto b = make_request("foo");
+    b->propertiesMap.lookupCreate(MapNames::FEATURE).add("z", "3");
+    b->propertiesMap.lookupCreate(MapNames::RANK).add("y", "2").add("x", "1");
+    EXPECT_EQ(QueryResultCache::makeKey(*a, 1), QueryResultCache::makeKey(*b, 1));
+}
+
+TEST(QueryResultCacheTest, traced_and_session_cached_requests_are_not_cacheable)
+{
+    auto a = make_request("foo");
+    a->setTraceLevel(1);
+    EXPECT_TRUE(QueryResultCache::makeKey(*a, 1).empty());
+    auto b = make_request("foo");
+    b->propertiesMap.lookupCreate(MapNames::CACHES).add("query", "true");
+    EXPECT_TRUE(QueryResultCache::makeKey(*b, 1).empty());
+}
+
+TEST(QueryResultCacheTest, cached_reply_is_returned_for_same_generation)
+{
+    QueryResultCache cache(1000000, 10s);
+    EXPECT_TRUE(cache.enabled());
+    auto key = make_key("foo");
+    EXPECT_FALSE(cache.lookup(key, 5, t0));
+    cache.insert(key, *make_reply(3), 5, t0);
+    auto reply = cache.lookup(key, 5, t0 + 1s);
+    ASSERT_TRUE(reply);
+    EXPECT_EQ(reply->totalHitCount, 30u);
+    ASSERT_EQ(reply->hits.size(), 3u);
+    EXPECT_EQ(reply->hits[0].metric, 3.0);
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.numLookups, 2u);
+    EXPECT_EQ(stats.numHits, 1u);
+    EXPECT_EQ(stats.numInserts, 1u);
+    EXPECT_EQ(stats.numCached, 1u);
+    EXPECT_GT(stats.memoryUsage, 0u);
+    EXPECT_EQ(cache.getStats().numLookups, 0u);
+}
+
+TEST(QueryResultCacheTest, entries_are_invalidated_by_new_generation_and_age)
+{
+    QueryResultCache cache(1000000, 10s);
+    auto key = make_key("foo");
+    cache.insert(key, *make_reply(3), 5, t0);
+    EXPECT_FALSE(cache.lookup(key, 6, t0));
+    EXPECT_FALSE(cache.lookup(key, 5, t0));
+    cache.insert(key, *make_reply(3), 5, t0);
+    EXPECT_TRUE(cache.lookup(key, 5, t0 + 10s));
+    EXPECT_FALSE(cache.lookup(key, 5, t0 + 11s));
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.numInvalidated, 2u);
+    EXPECT_EQ(stats.numCached, 0u);
+    EXPECT_EQ(stats.memoryUsage, 0u);
+}
+
+TEST(QueryResultCacheTest, least_recently_used_entries_are_evicted_to_stay_within_memory_limit)
+{
+    auto key1 = make_key("foo");
+    auto key2 = make_key("bar");
+    auto key3 = make_key("baz");
+    size_t entry_size;
+    {
+        QueryResultCache probe(1000000, 10s);
+        probe.insert(key1, *make_reply(100), 1, t0);
+        entry_size = probe.getStats().memoryUsage;
+    }
+    QueryResultCache cache(2 * entry_size + entry_size / 2, 10s);
+    cache.insert(key1, *make_reply(100), 1, t0);
+    cache.insert(key2, *make_reply(100), 1, t0);
+    EXPECT_TRUE(cache.lookup(key1, 1, t0));
+    cache.insert(key3, *make_reply(100), 1, t0);
+    EXPECT_TRUE(cache.lookup(key1, 1, t0));
+    EXPECT_FALSE(cache.lookup(key2, 1, t0));
+    EXPECT_TRUE(cache.lookup(key3, 1, t0));
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.numEvicted, 1u);
+    EXPECT_EQ(stats.numCached, 2u);
+}
+
+TEST(QueryResultCacheTest, replies_larger_than_the_cache_are_not_inserted)
+{
+    QueryResultCache cache(100, 10s);
+    auto key = make_key("foo");
+    cache.insert(key, *make_reply(100), 1, t0);
+    EXPECT_FALSE(cache.lookup(key, 1, t0));
+    EXPECT_EQ(cache.getStats().numInserts, 0u);
+}
+
+TEST(QueryResultCacheTest, clear_drops_all_entries)
+{
+    QueryResultCache cache(1000000, 10s);
+    auto key1 = make_key("foo");
+    auto key2 = make_key("bar");
+    cache.insert(key1, *make_reply(3), 1, t0);
+    cache.insert(key2, *make_reply(3), 1, t0);
+    cache.clear();
+    EXPECT_FALSE(cache.lookup(key1, 1, t0));
+    EXPECT_FALSE(cache.lookup(key2, 1, t0));
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.numInvalidated, 2u);
+    EXPECT_EQ(stats.numCached, 0u);
+    EXPECT_EQ(stats.memoryUsage, 0u);
+}
+
+TEST(QueryResultCacheTest, cache_with_no_memory_is_disabled)
+{
+    QueryResultCache cache(0, 10s);
+    EXPECT_FALSE(cache.enabled());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -9,6 +9,8 @@
 
 namespace search::attribute { class AttributeHeader; }
 
+namespace vespalib { class ThreadExecutor; }
+
 namespace proton {
 
 class AttributeDirectory;
@@ -29,6 +31,7 @@ private:
     const AttributeSpec             _spec;
     const uint64_t                  _currentSerialNum;
     const IAttributeFactory        &_factory;
+    vespalib::ThreadExecutor       *_shared_executor;
     std::unique_ptr<const search::attribute::AttributeHeader> _header;
     bool                            _header_ok;
 
@@ -45,7 +48,8 @@ private:
 
 public:
     AttributeInitializer(const std::shared_ptr<AttributeDirectory> &attrDir, const vespalib::string &documentSubDbName,
-                         const AttributeSpec &spec, uint64_t currentSerialNum, const IAttributeFactory &factory);
+                         const AttributeSpec &spec, uint64_t currentSerialNum, const IAttributeFactory &factory,
+                         vespalib::ThreadExecutor *shared_executor);
     ~AttributeInitializer();
 
     AttributeInitializerResult init() const;
@@ -4,11 +4,14 @@
 #include <vespa/searchcore/proton/common/eventlogger.h>
 #include <vespa/searchlib/common/idestructorcallback.h>
 #include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/vespalib/util/isequencedtaskexecutor.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.attribute.attribute_populator");
 
 using search::IDestructorCallback;
+using search::tensor::DenseTensorAttribute;
 
 namespace proton {
 
@@ -34,6 +37,41 @@ AttributePopulator::nextSerialNum()
     return _currSerialNum++;
 }
 
+void
+AttributePopulator::start_bulk_index_build()
+{
+    auto mgr = _writer.getAttributeManager();
+    auto &field_writer = mgr->getAttributeFieldWriter();
+    for (auto attr : mgr->getWritableAttributes()) {
+        auto dense_attr = dynamic_cast<DenseTensorAttribute *>(attr);
+        if (dense_attr != nullptr && dense_attr->nearest_neighbor_index() != nullptr) {
+            field_writer.execute(field_writer.getExecutorId(attr->getNamePrefix()),
+                                 [dense_attr]() { dense_attr->start_bulk_index_build(); });
+        }
+    }
+    field_writer.sync();
+}
+
+void
+AttributePopulator::complete_bulk_index_build()
+{
+    auto mgr = _writer.getAttributeManager();
+    auto &field_writer = mgr->getAttributeFieldWriter();
+    auto shared_executor = mgr->get_shared_executor();
+    for (auto attr : mgr->getWritableAttributes()) {
+        auto dense_attr = dynamic_cast<DenseTensorAttribute *>(attr);
+        if (dense_attr != nullptr && dense_attr->nearest_neighbor_index() != nullptr) {
+            field_writer.execute(field_writer.getExecutorId(attr->getNamePrefix()),
+                                 [dense_attr, shared_executor]()
+                                 {
+                                     dense_attr->complete_bulk_index_build(shared_executor);
+                                     dense_attr->commit();
+                                 });
+        }
+    }
+    field_writer.sync();
+}
+
 std::vector<vespalib::string>
 AttributePopulator::getNames() const
 {
@@ -59,6 +97,7 @@ AttributePopulator::AttributePopulator(const proton::IAttributeManager::SP &mgr,
     if (LOG_WOULD_LOG(event)) {
         EventLogger::populateAttributeStart(getNames());
     }
+    start_bulk_index_build();
 }
 
 AttributePopulator::~AttributePopulator()
@@ -80,6 +119,7 @@ AttributePopulator::handleExisting(uint32_t lid, const std::shared_ptr<document:
 void
 AttributePopulator::done()
 {
+    complete_bulk_index_build();
     auto mgr = _writer.getAttributeManager();
     auto flushTargets = mgr->getFlushTargets();
     for (const auto &flushTarget : flushTargets) {
@@ -22,6 +22,8 @@ private:
     search::SerialNum nextSerialNum();
 
     std::vector<vespalib::string> getNames() const;
+    void start_bulk_index_build();
+    void complete_bulk_index_build();
 
 public:
     typedef std::shared_ptr<AttributePopulator> SP;
@@ -117,7 +117,7 @@ AttributeManager::internalAddAttribute(const AttributeSpec &spec,
                                        uint64_t serialNum,
                                        const IAttributeFactory &factory)
 {
-    AttributeInitializer initializer(_diskLayout->createAttributeDir(spec.getName()), _documentSubDbName, spec, serialNum, factory);
+    AttributeInitializer initializer(_diskLayout->createAttributeDir(spec.getName()), _documentSubDbName, spec, serialNum, factory, _shared_executor);
     AttributeInitializerResult result = initializer.init();
     if (result) {
         result.getAttribute()->setInterlock(_interlock);
@@ -191,7 +191,7 @@ AttributeManager::addNewAttributes(const Spec &newSpec,
 
         AttributeInitializer::UP initializer =
             std::make_unique<AttributeInitializer>(_diskLayout->createAttributeDir(aspec.getName()), _documentSubDbName,
-                        aspec, newSpec.getCurrentSerialNum(), *_factory);
+                        aspec, newSpec.getCurrentSerialNum(), *_factory, _shared_executor);
         initializerRegistry.add(std::move(initializer));
 
         // TODO: Might want to use hardlinks to make attribute vector
@@ -235,6 +235,7 @@ AttributeManager::AttributeManager(const vespalib::string &baseDir,
       _factory(std::make_shared<AttributeFactory>()),
       _interlock(std::make_shared<search::attribute::Interlock>()),
       _attributeFieldWriter(attributeFieldWriter),
+      _shared_executor(nullptr),
       _hwInfo(hwInfo),
       _importedAttributes()
 {
@@ -247,7 +248,8 @@ AttributeManager::AttributeManager(const vespalib::string &baseDir,
                                    const search::common::FileHeaderContext &fileHeaderContext,
                                    vespalib::ISequencedTaskExecutor &attributeFieldWriter,
                                    const IAttributeFactory::SP &factory,
-                                   const HwInfo &hwInfo)
+                                   const HwInfo &hwInfo,
+                                   vespalib::ThreadExecutor *shared_executor)
     : proton::IAttributeManager(),
       _attributes(),
       _flushables(),
@@ -259,6 +261,7 @@ AttributeManager::AttributeManager(const vespalib::string &baseDir,
       _factory(factory),
       _interlock(std::make_shared<search::attribute::Interlock>()),
       _attributeFieldWriter(attributeFieldWriter),
+      _shared_executor(shared_executor),
       _hwInfo(hwInfo),
       _importedAttributes()
 {
@@ -278,6 +281,7 @@ AttributeManager::AttributeManager(const AttributeManager &currMgr,
       _factory(currMgr._factory),
       _interlock(currMgr._interlock),
       _attributeFieldWriter(currMgr._attributeFieldWriter),
+      _shared_executor(currMgr._shared_executor),
       _hwInfo(currMgr._hwInfo),
       _importedAttributes()
 {
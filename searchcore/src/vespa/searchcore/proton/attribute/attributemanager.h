@@ -78,6 +78,7 @@ private:
     IAttributeFactory::SP _factory;
     std::shared_ptr<search::attribute::Interlock> _interlock;
     vespalib::ISequencedTaskExecutor &_attributeFieldWriter;
+    vespalib::ThreadExecutor *_shared_executor;
     HwInfo _hwInfo;
     std::unique_ptr<ImportedAttributesRepo> _importedAttributes;
 
@@ -112,7 +113,8 @@ public:
                      const search::common::FileHeaderContext & fileHeaderContext,
                      vespalib::ISequencedTaskExecutor &attributeFieldWriter,
                      const IAttributeFactory::SP &factory,
-                     const HwInfo &hwInfo);
+                     const HwInfo &hwInfo,
+                     vespalib::ThreadExecutor *shared_executor = nullptr);
 
     AttributeManager(const AttributeManager &currMgr, const Spec &newSpec,
                      IAttributeInitializerRegistry &initializerRegistry);
@@ -166,6 +168,8 @@ public:
 
     vespalib::ISequencedTaskExecutor &getAttributeFieldWriter() const override;
 
+    vespalib::ThreadExecutor *get_shared_executor() const override { return _shared_executor; }
+
     search::AttributeVector *getWritableAttribute(const vespalib::string &name) const override;
 
     const std::vector<search::AttributeVector *> &getWritableAttributes() const override;
@@ -167,6 +167,12 @@ FilterAttributeManager::getAttributeFieldWriter() const
     return _mgr->getAttributeFieldWriter();
 }
 
+vespalib::ThreadExecutor *
+FilterAttributeManager::get_shared_executor() const
+{
+    return _mgr->get_shared_executor();
+}
+
 
 search::AttributeVector *
 FilterAttributeManager::getWritableAttribute(const vespalib::string &name) const
@@ -12,6 +12,7 @@
 #include <vespa/searchlib/common/serialnumfileheadercontext.h>
 #include <vespa/searchlib/attribute/attributememorysavetarget.h>
 #include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
 #include <vespa/vespalib/util/isequencedtaskexecutor.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <fstream>
@@ -171,7 +172,8 @@ FlushableAttribute::FlushableAttribute(const AttributeVectorSP attr,
     _lastStats.setPathElementsToLog(8);
     auto &config = attr->getConfig();
     if (config.basicType() == search::attribute::BasicType::Type::TENSOR &&
-        config.tensorType().is_tensor() && config.tensorType().is_dense() && config.hnsw_index_params().has_value()) {
+        config.tensorType().is_tensor() && !search::tensor::TensorAttribute::vector_type(config.tensorType()).is_error() &&
+        config.hnsw_index_params().has_value()) {
         _replay_operation_cost = 100.0; // replaying operations to hnsw index is 100 times more expensive than reading from tls
     }
 }
@@ -14,7 +14,10 @@ namespace search { class IDestructorCallback;}
 
 namespace search::attribute { class IAttributeFunctor; }
 
-namespace vespalib { class ISequencedTaskExecutor; }
+namespace vespalib {
+    class ISequencedTaskExecutor;
+    class ThreadExecutor;
+}
 
 namespace proton {
 
@@ -74,6 +77,12 @@ struct IAttributeManager : public search::IAttributeManager
 
     virtual vespalib::ISequencedTaskExecutor &getAttributeFieldWriter() const = 0;
 
+    /**
+     * Returns the executor that can be used to parallelize costly attribute work
+     * (e.g. building nearest neighbor indexes), or nullptr if not available.
+     */
+    virtual vespalib::ThreadExecutor *get_shared_executor() const = 0;
+
     /*
      * Get pointer to named writable attribute.  If attribute isn't
      * found or is an extra attribute then nullptr is returned.
@@ -32,6 +32,12 @@ using search::attribute::AttributeOperation;
 
 namespace {
 
+// trace level needed to profile the iterator tree and rank programs of each match thread
+constexpr uint32_t profile_trace_level = 8;
+
+// only time every n'th seek and unpack of each iterator when profiling
+constexpr uint32_t profile_sample_interval = 16;
+
 struct WaitTimer {
     double &wait_time_s;
     vespalib::Timer wait_time;
@@ -61,6 +67,10 @@ struct FastBlackListingStrategy {
     }
 };
 
+// Number of hits collected before calculating their first phase rank scores in one go,
+// when the rank program supports it (see RankProgram::make_batch_evaluator).
+constexpr size_t rank_batch_size = 64;
+
 LazyValue get_score_feature(const RankProgram &rankProgram) {
     FeatureResolver resolver(rankProgram.get_seeds());
     assert(resolver.num_features() == 1u);
@@ -75,17 +85,47 @@ MatchThread::Context::Context(double rankDropLimit, MatchTools &tools, HitCollec
     : matches(0),
       _matches_limit(tools.match_limiter().sample_hits_per_thread(num_threads)),
       _score_feature(get_score_feature(tools.rank_program())),
+      _batch_evaluator(tools.rank_program().make_batch_evaluator(rank_batch_size)),
+      _batch_docids(),
       _ranking(tools.rank_program()),
       _rankDropLimit(rankDropLimit),
       _hits(hits),
       _doom(tools.getDoom())
 {
+    if (_batch_evaluator) {
+        _batch_docids.reserve(_batch_evaluator->max_batch_size());
+    }
 }
 
 template <bool use_rank_drop_limit>
 void
 MatchThread::Context::rankHit(uint32_t docId) {
-    double score = _score_feature.as_number(docId);
+    if (_batch_evaluator) {
+        _batch_docids.push_back(docId);
+        if (_batch_docids.size() == _batch_evaluator->max_batch_size()) {
+            flushRankBatch<use_rank_drop_limit>();
+        }
+    } else {
+        addRankedHit<use_rank_drop_limit>(docId, _score_feature.as_number(docId));
+    }
+}
+
+template <bool use_rank_drop_limit>
+void
+MatchThread::Context::flushRankBatch() {
+    if (_batch_docids.empty()) {
+        return;
+    }
+    const search::feature_t *scores = _batch_evaluator->evaluate(_batch_docids);
+    for (size_t i = 0; i < _batch_docids.size(); ++i) {
+        addRankedHit<use_rank_drop_limit>(_batch_docids[i], scores[i]);
+    }
+    _batch_docids.clear();
+}
+
+template <bool use_rank_drop_limit>
+void
+MatchThread::Context::addRankedHit(uint32_t docId, double score) {
     // convert NaN and Inf scores to -Inf
     if (__builtin_expect(std::isnan(score) || std::isinf(score), false)) {
         score = -HUGE_VAL;
@@ -175,6 +215,9 @@ MatchThread::inner_match_loop(Context &context, MatchTools &tools, DocidRange &d
             docId = Strategy::seek_next(*search, docId + 1);
         }
     }
+    if (do_rank) {
+        context.flushRankBatch<use_rank_drop_limit>();
+    }
     return docId;
 }
 
@@ -289,6 +332,9 @@ MatchThread::findMatches(MatchTools &tools)
             tools.search().asSlime(inserter);
         }
     }
+    if (match_profile) {
+        tools.give_back_search(match_profile->profile(tools.borrow_search()));
+    }
     HitCollector hits(matchParams.numDocs, matchParams.arraySize);
     trace->addEvent(4, "Start match and first phase rank");
     match_loop_helper(tools, hits);
@@ -418,8 +464,16 @@ MatchThread::MatchThread(size_t thread_id_in,
     match_time_s(0.0),
     wait_time_s(0.0),
     match_with_ranking(mtf.has_first_phase_rank() && mp.save_rank_scores()),
-    trace(std::make_unique<Trace>(relativeTime, traceLevel))
+    trace(std::make_unique<Trace>(relativeTime, traceLevel)),
+    match_profile(),
+    first_phase_profile(),
+    second_phase_profile()
 {
+    if (trace->shouldTrace(profile_trace_level)) {
+        match_profile = std::make_unique<IteratorProfile>(profile_sample_interval);
+        first_phase_profile = std::make_unique<FeatureProfile>();
+        second_phase_profile = std::make_unique<FeatureProfile>();
+    }
 }
 
 void
@@ -429,7 +483,16 @@ MatchThread::run()
     vespalib::Timer match_time(total_time);
     trace->addEvent(4, "Start MatchThread::run");
     MatchTools::UP matchTools = matchToolsFactory.createMatchTools();
+    if (match_profile) {
+        matchTools->enable_profiling(*first_phase_profile, *second_phase_profile);
+    }
     search::ResultSet::UP result = findMatches(*matchTools);
+    if (match_profile) {
+        vespalib::slime::Cursor &profile = trace->createCursor("query_profile");
+        match_profile->report(profile.setObject("match"));
+        first_phase_profile->report(profile.setArray("first_phase"));
+        second_phase_profile->report(profile.setArray("second_phase"));
+    }
     match_time_s = vespalib::to_s(match_time.elapsed());
     resultContext = resultProcessor.createThreadContext(matchTools->getDoom(), thread_id, _distributionKey);
     {
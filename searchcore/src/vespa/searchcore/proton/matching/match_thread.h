@@ -13,7 +13,10 @@
 #include <vespa/searchlib/common/resultset.h>
 #include <vespa/searchlib/common/sortresults.h>
 #include <vespa/searchlib/queryeval/hitcollector.h>
+#include <vespa/searchlib/fef/batch_evaluator.h>
 #include <vespa/searchlib/fef/featureexecutor.h>
+#include <vespa/searchlib/fef/profiled_feature_executor.h>
+#include <vespa/searchlib/queryeval/profiled_iterator.h>
 
 namespace search::engine {
     class Trace;
@@ -41,9 +44,12 @@ public:
     using HitCollector = search::queryeval::HitCollector;
     using RankProgram = search::fef::RankProgram;
     using LazyValue = search::fef::LazyValue;
+    using BatchEvaluator = search::fef::BatchEvaluator;
     using Doom = vespalib::Doom;
     using Trace = search::engine::Trace;
     using RelativeTime = search::engine::RelativeTime;
+    using IteratorProfile = search::queryeval::ProfiledIterator::Profile;
+    using FeatureProfile = search::fef::ProfiledFeatureExecutor::Profile;
 
 private:
     size_t                        thread_id;
@@ -63,6 +69,9 @@ private:
     double                        wait_time_s;
     bool                          match_with_ranking;
     std::unique_ptr<Trace>        trace;
+    std::unique_ptr<IteratorProfile> match_profile;
+    std::unique_ptr<FeatureProfile>  first_phase_profile;
+    std::unique_ptr<FeatureProfile>  second_phase_profile;
 
     class Context {
     public:
@@ -70,6 +79,8 @@ private:
                 uint32_t num_threads) __attribute__((noinline));
         template <bool use_rank_drop_limit>
         void rankHit(uint32_t docId);
+        template <bool use_rank_drop_limit>
+        void flushRankBatch();
         void addHit(uint32_t docId) { _hits.addHit(docId, search::zero_rank_value); }
         bool isBelowLimit() const { return matches < _matches_limit; }
         bool    isAtLimit() const { return matches == _matches_limit; }
@@ -77,8 +88,13 @@ private:
         vespalib::duration timeLeft() const { return _doom.soft_left(); }
         uint32_t        matches;
     private:
+        template <bool use_rank_drop_limit>
+        void addRankedHit(uint32_t docId, double score);
+
         uint32_t        _matches_limit;
         LazyValue       _score_feature;
+        BatchEvaluator::UP    _batch_evaluator;
+        std::vector<uint32_t> _batch_docids;
         RankProgram    &_ranking;
         double          _rankDropLimit;
         HitCollector   &_hits;
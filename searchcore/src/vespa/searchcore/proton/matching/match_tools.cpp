@@ -64,19 +64,64 @@ extractDiversityParams(const RankSetup &rankSetup, const Properties &rankPropert
                            AttributeLimiter::toDiversityCutoffStrategy(DiversityCutoffStrategy::lookup(rankProperties, rankSetup.getDiversityCutoffStrategy())));
 }
 
+/**
+ * Rank programs kept by each thread between queries, to be rebound
+ * to later queries using the same rank profile instead of setting up
+ * new ones (see RankProgram::rebind). Programs are keyed on the
+ * blueprint resolver they were created from, which they keep alive.
+ **/
+class RankProgramCache
+{
+private:
+    static constexpr size_t max_programs = 8;
+    std::vector<RankProgram::UP> _programs; // least recently used first
+
+public:
+    RankProgram::UP take(const BlueprintResolver &resolver) {
+        for (size_t i = _programs.size(); i-- > 0; ) {
+            if (&_programs[i]->resolver() == &resolver) {
+                RankProgram::UP program = std::move(_programs[i]);
+                _programs.erase(_programs.begin() + i);
+                return program;
+            }
+        }
+        return RankProgram::UP();
+    }
+    void give_back(RankProgram::UP program) {
+        if (program && program->can_rebind()) {
+            program->unbind();
+            if (_programs.size() == max_programs) {
+                _programs.erase(_programs.begin());
+            }
+            _programs.push_back(std::move(program));
+        }
+    }
+};
+
+thread_local RankProgramCache rank_program_cache;
+
 } // namespace proton::matching::<unnamed>
 
 void
-MatchTools::setup(search::fef::RankProgram::UP rank_program, double termwise_limit)
+MatchTools::setup(search::fef::RankProgram::UP rank_program, FeatureProfile *profile, double termwise_limit)
 {
     if (_search) {
         _match_data->soft_reset();
     }
-    _rank_program = std::move(rank_program);
+    rank_program_cache.give_back(std::move(_rank_program));
     HandleRecorder recorder;
     {
         HandleRecorder::Binder bind(recorder);
-        _rank_program->setup(*_match_data, _queryEnv, _featureOverrides);
+        if ((profile == nullptr) && (_featureOverrides.numKeys() == 0)) {
+            RankProgram::UP cached = rank_program_cache.take(rank_program->resolver());
+            if (cached && cached->rebind(*_match_data, _queryEnv)) {
+                _rank_program = std::move(cached);
+            }
+        }
+        if (!_rank_program) {
+            _rank_program = std::move(rank_program);
+            _rank_program->setup(*_match_data, _queryEnv, _featureOverrides, profile);
+        }
     }
     bool can_reuse_search = (_search && !_search_has_changed &&
             contains_all(_used_handles, recorder.get_handles()));
@@ -108,11 +153,16 @@ MatchTools::MatchTools(QueryLimiter & queryLimiter,
       _rank_program(),
       _search(),
       _used_handles(),
-      _search_has_changed(false)
+      _search_has_changed(false),
+      _first_phase_profile(nullptr),
+      _second_phase_profile(nullptr)
 {
 }
 
-MatchTools::~MatchTools() = default;
+MatchTools::~MatchTools()
+{
+    rank_program_cache.give_back(std::move(_rank_program));
+}
 
 bool
 MatchTools::has_second_phase_rank() const {
@@ -122,26 +172,26 @@ MatchTools::has_second_phase_rank() const {
 void
 MatchTools::setup_first_phase()
 {
-    setup(_rankSetup.create_first_phase_program(),
+    setup(_rankSetup.create_first_phase_program(), _first_phase_profile,
           TermwiseLimit::lookup(_queryEnv.getProperties(), _rankSetup.get_termwise_limit()));
 }
 
 void
 MatchTools::setup_second_phase()
 {
-    setup(_rankSetup.create_second_phase_program());
+    setup(_rankSetup.create_second_phase_program(), _second_phase_profile);
 }
 
 void
 MatchTools::setup_summary()
 {
-    setup(_rankSetup.create_summary_program());
+    setup(_rankSetup.create_summary_program(), nullptr);
 }
 
 void
 MatchTools::setup_dump()
 {
-    setup(_rankSetup.create_dump_program());
+    setup(_rankSetup.create_dump_program(), nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 #include "handlerecorder.h"
 #include "requestcontext.h"
 #include <vespa/searchcommon/attribute/i_attribute_functor.h>
+#include <vespa/searchlib/fef/profiled_feature_executor.h>
 #include <vespa/searchlib/queryeval/blueprint.h>
 #include <vespa/searchlib/common/idocumentmetastore.h>
 #include <vespa/searchlib/queryeval/idiversifier.h>
@@ -29,6 +30,7 @@ class MatchTools
 {
 private:
     using IRequestContext = search::queryeval::IRequestContext;
+    using FeatureProfile = search::fef::ProfiledFeatureExecutor::Profile;
     QueryLimiter                          &_queryLimiter;
     const vespalib::Doom                  &_doom;
     const Query                           &_query;
@@ -41,7 +43,9 @@ private:
     search::queryeval::SearchIterator::UP  _search;
     HandleRecorder::HandleMap              _used_handles;
     bool                                   _search_has_changed;
-    void setup(std::unique_ptr<search::fef::RankProgram>, double termwise_limit = 1.0);
+    FeatureProfile                        *_first_phase_profile;
+    FeatureProfile                        *_second_phase_profile;
+    void setup(std::unique_ptr<search::fef::RankProgram>, FeatureProfile *profile, double termwise_limit = 1.0);
 public:
     typedef std::unique_ptr<MatchTools> UP;
     MatchTools(const MatchTools &) = delete;
@@ -65,6 +69,15 @@ public:
     search::queryeval::SearchIterator::UP borrow_search() { return std::move(_search); }
     void give_back_search(search::queryeval::SearchIterator::UP search_in) { _search = std::move(search_in); }
     void tag_search_as_changed() { _search_has_changed = true; }
+    /**
+     * Collect profiling information from the feature executors of
+     * the first and second phase rank programs set up after this
+     * call. The profiles must outlive this object.
+     **/
+    void enable_profiling(FeatureProfile &first_phase, FeatureProfile &second_phase) {
+        _first_phase_profile = &first_phase;
+        _second_phase_profile = &second_phase;
+    }
     void setup_first_phase();
     void setup_second_phase();
     void setup_summary();
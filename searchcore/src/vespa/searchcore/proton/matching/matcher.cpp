@@ -63,6 +63,22 @@ size_t numThreads(size_t hits, size_t minHits) {
     return static_cast<size_t>(std::ceil(double(hits) / double(minHits)));
 }
 
+// gives each matcher a unique generation, used to tell results from different rank setups apart
+std::atomic<uint64_t> nextMatcherGeneration(1);
+
+size_t threadsForWork(double work, double minWorkPerThread) {
+    return std::max(size_t(1), static_cast<size_t>(std::ceil(work / minWorkPerThread)));
+}
+
+class ActiveQueryCounter {
+    std::atomic<uint32_t> &_active;
+    uint32_t               _count;
+public:
+    ActiveQueryCounter(std::atomic<uint32_t> &active) : _active(active), _count(++active) {}
+    ~ActiveQueryCounter() { --_active; }
+    uint32_t count() const { return _count; }
+};
+
 class LimitedThreadBundleWrapper final : public vespalib::ThreadBundle
 {
 public:
@@ -106,10 +122,12 @@ Matcher::Matcher(const search::index::Schema &schema, const Properties &props, c
       _viewResolver(ViewResolver::createFromSchema(schema)),
       _statsLock(),
       _stats(),
+      _activeQueries(0),
       _startTime(my_clock::now()),
       _clock(clock),
       _queryLimiter(queryLimiter),
-      _distributionKey(distributionKey)
+      _distributionKey(distributionKey),
+      _generation(nextMatcherGeneration++)
 {
     search::features::setup_search_features(_blueprintFactory);
     search::fef::test::setup_fef_test_plugin(_blueprintFactory);
@@ -127,6 +145,7 @@ Matcher::getStats()
     MatchingStats stats = std::move(_stats);
     _stats = MatchingStats();
     _stats.softDoomFactor(stats.softDoomFactor());
+    _stats.hitCost(stats.hitCost());
     return stats;
 }
 
@@ -160,12 +179,24 @@ Matcher::create_match_tools_factory(const search::engine::Request &request, ISea
 }
 
 size_t
-Matcher::computeNumThreadsPerSearch(Blueprint::HitEstimate hits, const Properties & rankProperties) const {
+Matcher::computeNumThreadsPerSearch(Blueprint::HitEstimate hits, const Properties & rankProperties,
+                                    double hitCost, uint32_t activeQueries) const {
     size_t threads = NumThreadsPerSearch::lookup(rankProperties, _rankSetup->getNumThreadsPerSearch());
     uint32_t minHitsPerThread = MinHitsPerThread::lookup(rankProperties, _rankSetup->getMinHitsPerThread());
     if ((threads > 1) && (minHitsPerThread > 0)) {
         threads = (hits.empty) ? 1 : std::min(threads, numThreads(hits.estHits, minHitsPerThread));
     }
+    double minTimePerThread = MinTimePerThread::lookup(rankProperties, _rankSetup->getMinTimePerThread());
+    if ((threads > 1) && (minTimePerThread > 0.0)) {
+        if (hits.empty) {
+            threads = 1;
+        } else if (hitCost > 0.0) {
+            double estimatedTime = hits.estHits * hitCost;
+            threads = std::min(threads, threadsForWork(estimatedTime, minTimePerThread));
+        }
+        // share the threads with other queries running at the same time
+        threads = std::min(threads, threadsForWork(threads, std::max(activeQueries, 1u)));
+    }
     return threads;
 }
 
@@ -186,6 +217,7 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
                const search::IDocumentMetaStore &metaStore, SearchSession::OwnershipBundle &&owned_objects)
 {
     vespalib::Timer total_matching_time;
+    ActiveQueryCounter activeQueries(_activeQueries);
     MatchingStats my_stats;
     SearchReply::UP reply = std::make_unique<SearchReply>();
     size_t covered = 0;
@@ -209,6 +241,19 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
                 }
             }
         }
+        QueryResultCache &resultCache = sessionMgr.getResultCache();
+        vespalib::string resultCacheKey;
+        uint64_t generation = metaStore.getCurrentGeneration();
+        vespalib::steady_time startTime = _clock.getTimeNS();
+        if (resultCache.enabled()) {
+            resultCacheKey = QueryResultCache::makeKey(request, _generation);
+            if (!resultCacheKey.empty()) {
+                SearchReply::UP cached = resultCache.lookup(resultCacheKey, generation, startTime);
+                if (cached) {
+                    return cached;
+                }
+            }
+        }
         const Properties *feature_overrides = &request.propertiesMap.featureOverrides();
         if (shouldCacheSearchSession) {
             owned_objects.feature_overrides = std::make_unique<Properties>(*feature_overrides);
@@ -233,13 +278,22 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
         ResultProcessor rp(attrContext, metaStore, sessionMgr, groupingContext, sessionId,
                            request.sortSpec, params.offset, params.hits);
 
-        size_t numThreadsPerSearch = computeNumThreadsPerSearch(mtf->estimate(), rankProperties);
+        double hitCost;
+        {
+            std::lock_guard<std::mutex> guard(_statsLock);
+            hitCost = _stats.hitCost();
+        }
+        size_t numThreadsPerSearch = computeNumThreadsPerSearch(mtf->estimate(), rankProperties,
+                                                                hitCost, activeQueries.count());
         LimitedThreadBundleWrapper limitedThreadBundle(threadBundle, numThreadsPerSearch);
         MatchMaster master;
         uint32_t numParts = NumSearchPartitions::lookup(rankProperties, _rankSetup->getNumSearchPartitions());
         ResultProcessor::Result::UP result = master.match(request.trace(), params, limitedThreadBundle, *mtf, rp,
                                                           _distributionKey, numParts);
         my_stats = MatchMaster::getStats(std::move(master));
+        my_stats.threadsPerSearch(numThreadsPerSearch)
+                .estimatedHits(mtf->estimate().estHits)
+                .concurrentQueries(activeQueries.count());
 
         bool wasLimited = mtf->match_limiter().was_limited();
         size_t spaceEstimate = (my_stats.softDoomed())
@@ -286,6 +340,9 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
         LOG(debug, "numThreadsPerSearch = %zu. Configured = %d, estimated hits=%d, totalHits=%" PRIu64 ", rankprofile=%s",
             numThreadsPerSearch, _rankSetup->getNumThreadsPerSearch(), estHits, reply->totalHitCount,
             request.ranking.c_str());
+        if (!resultCacheKey.empty() && !my_stats.softDoomed()) {
+            resultCache.insert(resultCacheKey, *reply, generation, startTime);
+        }
     }
     double querySetupTime = vespalib::to_s(total_matching_time.elapsed()) - my_stats.queryLatencyAvg();
     my_stats.queryCollateralTime(querySetupTime); // TODO: Remove in Vespa 8
@@ -294,6 +351,12 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
         vespalib::duration duration = request.getTimeUsed();
         std::lock_guard<std::mutex> guard(_statsLock);
         _stats.add(my_stats);
+        double activeTime = 0.0;
+        for (size_t i = 0; i < my_stats.getNumPartitions(); ++i) {
+            const auto &partition = my_stats.getPartition(i);
+            activeTime += partition.active_time_avg() * partition.active_time_count();
+        }
+        _stats.updateHitCost(activeTime, my_stats.docsMatched());
         if (my_stats.softDoomed()) {
             double old = _stats.softDoomFactor();
             vespalib::duration overtimeLimit = std::chrono::duration_cast<vespalib::duration>((1.0 - _rankSetup->getSoftTimeoutTailCost()) * request.getTimeout());
@@ -20,6 +20,7 @@
 #include <vespa/vespalib/util/clock.h>
 #include <vespa/vespalib/util/closure.h>
 #include <vespa/vespalib/util/thread_bundle.h>
+#include <atomic>
 #include <mutex>
 
 namespace search::grouping {
@@ -62,13 +63,13 @@ private:
     ViewResolver                  _viewResolver;
     std::mutex                    _statsLock;
     MatchingStats                 _stats;
+    std::atomic<uint32_t>         _activeQueries;
     my_clock::time_point          _startTime;
     const vespalib::Clock        &_clock;
     QueryLimiter                 &_queryLimiter;
     uint32_t                      _distributionKey;
+    uint64_t                      _generation;
 
-    size_t computeNumThreadsPerSearch(search::queryeval::Blueprint::HitEstimate hits,
-                                      const Properties & rankProperties) const;
 public:
     /**
      * Convenience typedefs.
@@ -109,6 +110,16 @@ public:
                                IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
                                const Properties &feature_overrides) const;
 
+    /**
+     * Decide how many threads to use for a query with the given hit
+     * estimate, observed matching cost per hit and number of queries
+     * currently running. This function is exposed for testing
+     * purposes.
+     **/
+    size_t computeNumThreadsPerSearch(search::queryeval::Blueprint::HitEstimate hits,
+                                      const Properties & rankProperties,
+                                      double hitCost, uint32_t activeQueries) const;
+
     /**
      * Perform a search against this matcher.
      *
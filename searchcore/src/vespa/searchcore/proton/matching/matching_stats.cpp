@@ -16,6 +16,7 @@ MatchingStats::Partition &get_writable_partition(std::vector<MatchingStats::Part
 
 constexpr vespalib::duration MIN_TIMEOUT = 1ms;
 constexpr double MAX_CHANGE_FACTOR = 5;
+constexpr double HIT_COST_WEIGHT = 0.1;
 
 } // namespace proton::matching::<unnamed>
 
@@ -29,12 +30,16 @@ MatchingStats::MatchingStats()
       _softDoomed(0),
       _doomOvertime(),
       _softDoomFactor(INITIAL_SOFT_DOOM_FACTOR),
+      _hitCost(0.0),
       _queryCollateralTime(), // TODO: Remove in Vespa 8
       _querySetupTime(),
       _queryLatency(),
       _matchTime(),
       _groupingTime(),
       _rerankTime(),
+      _threadsPerSearch(),
+      _estimatedHits(),
+      _concurrentQueries(),
       _partitions()
 { }
 
@@ -76,6 +81,9 @@ MatchingStats::add(const MatchingStats &rhs)
     _matchTime.add(rhs._matchTime);
     _groupingTime.add(rhs._groupingTime);
     _rerankTime.add(rhs._rerankTime);
+    _threadsPerSearch.add(rhs._threadsPerSearch);
+    _estimatedHits.add(rhs._estimatedHits);
+    _concurrentQueries.add(rhs._concurrentQueries);
     for (size_t id = 0; id < rhs.getNumPartitions(); ++id) {
         get_writable_partition(_partitions, id).add(rhs.getPartition(id));
     }
@@ -103,4 +111,14 @@ MatchingStats::updatesoftDoomFactor(vespalib::duration hardLimit, vespalib::dura
     return *this;
 }
 
+MatchingStats &
+MatchingStats::updateHitCost(double activeTime, size_t docsMatched)
+{
+    if ((docsMatched > 0) && (activeTime > 0.0)) {
+        double sample = activeTime / docsMatched;
+        _hitCost = (_hitCost > 0.0) ? (_hitCost + HIT_COST_WEIGHT * (sample - _hitCost)) : sample;
+    }
+    return *this;
+}
+
 }
@@ -125,12 +125,16 @@ private:
     size_t                 _softDoomed;
     Avg                    _doomOvertime;
     double                 _softDoomFactor;
+    double                 _hitCost;
     Avg                    _queryCollateralTime; // TODO: Remove in Vespa 8
     Avg                    _querySetupTime;
     Avg                    _queryLatency;
     Avg                    _matchTime;
     Avg                    _groupingTime;
     Avg                    _rerankTime;
+    Avg                    _threadsPerSearch;
+    Avg                    _estimatedHits;
+    Avg                    _concurrentQueries;
     std::vector<Partition> _partitions;
 
 public:
@@ -169,6 +173,11 @@ public:
     double softDoomFactor() const { return _softDoomFactor; }
     MatchingStats &updatesoftDoomFactor(vespalib::duration hardLimit, vespalib::duration softLimit, vespalib::duration duration);
 
+    // observed matching time (seconds of thread time) per matched document, 0 if unknown
+    MatchingStats &hitCost(double value) { _hitCost = value; return *this; }
+    double hitCost() const { return _hitCost; }
+    MatchingStats &updateHitCost(double activeTime, size_t docsMatched);
+
     // TODO: Remove in Vespa 8
     MatchingStats &queryCollateralTime(double time_s) { _queryCollateralTime.set(time_s); return *this; }
     double queryCollateralTimeAvg() const { return _queryCollateralTime.avg(); }
@@ -206,6 +215,25 @@ public:
     double rerankTimeMin() const { return _rerankTime.min(); }
     double rerankTimeMax() const { return _rerankTime.max(); }
 
+    // the number of threads selected for each query and the inputs used to select it
+    MatchingStats &threadsPerSearch(size_t value) { _threadsPerSearch.set(value); return *this; }
+    double threadsPerSearchAvg() const { return _threadsPerSearch.avg(); }
+    size_t threadsPerSearchCount() const { return _threadsPerSearch.count(); }
+    double threadsPerSearchMin() const { return _threadsPerSearch.min(); }
+    double threadsPerSearchMax() const { return _threadsPerSearch.max(); }
+
+    MatchingStats &estimatedHits(size_t value) { _estimatedHits.set(value); return *this; }
+    double estimatedHitsAvg() const { return _estimatedHits.avg(); }
+    size_t estimatedHitsCount() const { return _estimatedHits.count(); }
+    double estimatedHitsMin() const { return _estimatedHits.min(); }
+    double estimatedHitsMax() const { return _estimatedHits.max(); }
+
+    MatchingStats &concurrentQueries(size_t value) { _concurrentQueries.set(value); return *this; }
+    double concurrentQueriesAvg() const { return _concurrentQueries.avg(); }
+    size_t concurrentQueriesCount() const { return _concurrentQueries.count(); }
+    double concurrentQueriesMin() const { return _concurrentQueries.min(); }
+    double concurrentQueriesMax() const { return _concurrentQueries.max(); }
+
     // used to merge in stats from each match thread
     MatchingStats &merge_partition(const Partition &partition, size_t id);
     size_t getNumPartitions() const { return _partitions.size(); }
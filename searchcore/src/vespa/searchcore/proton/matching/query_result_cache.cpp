@@ -0,0 +1,164 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "query_result_cache.h"
+#include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/searchlib/engine/searchrequest.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
+
+using search::MapNames;
+using search::fef::IPropertiesVisitor;
+using search::fef::Properties;
+using search::fef::Property;
+
+namespace proton::matching {
+
+namespace {
+
+struct KeyWriter : IPropertiesVisitor {
+    vespalib::nbostream &os;
+    KeyWriter(vespalib::nbostream &os_in) : os(os_in) {}
+    void visitProperty(const Property::Value &key, const Property &values) override {
+        os << key << values.size();
+        for (uint32_t i = 0; i < values.size(); ++i) {
+            os << values.getAt(i);
+        }
+    }
+};
+
+size_t calcMemoryUsage(const vespalib::string &key, const search::engine::SearchReply &reply) {
+    return sizeof(search::engine::SearchReply) + (2 * key.size()) +
+        (reply.hits.size() * sizeof(search::engine::SearchReply::Hit)) +
+        (reply.sortIndex.size() * sizeof(uint32_t)) +
+        reply.sortData.size() + reply.groupResult.size();
+}
+
+} // namespace proton::matching::<unnamed>
+
+QueryResultCache::Entry::Entry(const vespalib::string &key_in, std::unique_ptr<SearchReply> reply_in,
+                               uint64_t generation_in, vespalib::steady_time created_in)
+    : key(key_in),
+      reply(std::move(reply_in)),
+      generation(generation_in),
+      created(created_in),
+      memoryUsage(calcMemoryUsage(key, *reply))
+{
+}
+
+QueryResultCache::Entry::Entry(Entry &&) noexcept = default;
+QueryResultCache::Entry::~Entry() = default;
+
+void
+QueryResultCache::erase(LruList::iterator pos)
+{
+    _memoryUsage -= pos->memoryUsage;
+    _index.erase(pos->key);
+    _lru.erase(pos);
+}
+
+QueryResultCache::QueryResultCache(size_t maxBytes, vespalib::duration maxAge)
+    : _lock(),
+      _maxBytes(maxBytes),
+      _maxAge(maxAge),
+      _lru(),
+      _index(),
+      _memoryUsage(0),
+      _stats()
+{
+}
+
+QueryResultCache::~QueryResultCache() = default;
+
+vespalib::string
+QueryResultCache::makeKey(const SearchRequest &request, uint64_t matcherGeneration)
+{
+    const Properties &cacheProps = request.propertiesMap.cacheProperties();
+    if ((request.getTraceLevel() > 0) ||
+        cacheProps.lookup("query").found() || cacheProps.lookup("grouping").found())
+    {
+        // traces must be produced and sessions must be created by actually running the query
+        return vespalib::string();
+    }
+    vespalib::nbostream os;
+    os << matcherGeneration << request.ranking << request.getStackRef() << request.location << request.sortSpec;
+    os << request.groupSpec << request.offset << request.maxhits;
+    std::vector<std::pair<vespalib::string, const Properties *>> maps;
+    for (const auto &entry: request.propertiesMap) {
+        if (entry.first != MapNames::CACHES) {
+            maps.emplace_back(entry.first, &entry.second);
+        }
+    }
+    std::sort(maps.begin(), maps.end(), [](const auto &a, const auto &b){ return (a.first < b.first); });
+    KeyWriter writer(os);
+    for (const auto &entry: maps) {
+        os << entry.first;
+        entry.second->visitProperties(writer);
+    }
+    return vespalib::string(os.peek(), os.size());
+}
+
+std::unique_ptr<search::engine::SearchReply>
+QueryResultCache::lookup(const vespalib::string &key, uint64_t generation, vespalib::steady_time now)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    ++_stats.numLookups;
+    auto pos = _index.find(key);
+    if (pos == _index.end()) {
+        return std::unique_ptr<SearchReply>();
+    }
+    LruList::iterator entry = pos->second;
+    if ((entry->generation != generation) || ((now - entry->created) > _maxAge)) {
+        ++_stats.numInvalidated;
+        erase(entry);
+        return std::unique_ptr<SearchReply>();
+    }
+    ++_stats.numHits;
+    _lru.splice(_lru.begin(), _lru, entry);
+    return entry->reply->clone();
+}
+
+void
+QueryResultCache::insert(const vespalib::string &key, const SearchReply &reply, uint64_t generation, vespalib::steady_time now)
+{
+    Entry entry(key, reply.clone(), generation, now);
+    if (entry.memoryUsage > _maxBytes) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    auto pos = _index.find(key);
+    if (pos != _index.end()) {
+        erase(pos->second);
+    }
+    while (!_lru.empty() && ((_memoryUsage + entry.memoryUsage) > _maxBytes)) {
+        ++_stats.numEvicted;
+        erase(std::prev(_lru.end()));
+    }
+    _memoryUsage += entry.memoryUsage;
+    _lru.push_front(std::move(entry));
+    _index[key] = _lru.begin();
+    ++_stats.numInserts;
+}
+
+void
+QueryResultCache::clear()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _stats.numInvalidated += _lru.size();
+    _index.clear();
+    _lru.clear();
+    _memoryUsage = 0;
+}
+
+QueryResultCache::Stats
+QueryResultCache::getStats()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    Stats stats = _stats;
+    stats.numCached = _lru.size();
+    stats.memoryUsage = _memoryUsage;
+    _stats = Stats();
+    return stats;
+}
+
+}
@@ -0,0 +1,118 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace search::engine {
+    class SearchRequest;
+    class SearchReply;
+}
+
+namespace proton::matching {
+
+/**
+ * A memory bounded cache of search replies, used to avoid matching
+ * and ranking the same query over and over again. Replies are keyed
+ * on everything in the request that may affect the result (query
+ * stack dump, rank profile, properties, location, sorting, grouping
+ * and the requested hit window) and on the generation of the matcher
+ * producing it, so that a reconfigured rank profile never sees
+ * results ranked by its predecessor.
+ *
+ * Each entry is tagged with the generation of the document meta
+ * store it was produced from and is ignored when the generation has
+ * moved on, i.e. when documents have been fed. Since some changes
+ * (like attribute values from partial updates) become visible to
+ * searches a little after the meta store generation is bumped, entries
+ * also expire after a maximum age. Least recently used entries are
+ * evicted when the cache grows beyond its memory limit.
+ **/
+class QueryResultCache
+{
+public:
+    using SearchRequest = search::engine::SearchRequest;
+    using SearchReply = search::engine::SearchReply;
+
+    struct Stats {
+        Stats()
+            : numLookups(0),
+              numHits(0),
+              numInserts(0),
+              numInvalidated(0),
+              numEvicted(0),
+              numCached(0),
+              memoryUsage(0)
+        {}
+        size_t numLookups;
+        size_t numHits;
+        size_t numInserts;
+        size_t numInvalidated;
+        size_t numEvicted;
+        size_t numCached;
+        size_t memoryUsage;
+    };
+
+private:
+    struct Entry {
+        vespalib::string             key;
+        std::unique_ptr<SearchReply> reply;
+        uint64_t                     generation;
+        vespalib::steady_time        created;
+        size_t                       memoryUsage;
+        Entry(const vespalib::string &key_in, std::unique_ptr<SearchReply> reply_in,
+              uint64_t generation_in, vespalib::steady_time created_in);
+        Entry(Entry &&) noexcept;
+        ~Entry();
+    };
+    using LruList = std::list<Entry>;
+    using Index = vespalib::hash_map<vespalib::string, LruList::iterator>;
+
+    mutable std::mutex _lock;
+    size_t             _maxBytes;
+    vespalib::duration _maxAge;
+    LruList            _lru; // most recently used first
+    Index              _index;
+    size_t             _memoryUsage;
+    Stats              _stats;
+
+    void erase(LruList::iterator pos);
+public:
+    QueryResultCache(size_t maxBytes, vespalib::duration maxAge);
+    ~QueryResultCache();
+
+    bool enabled() const { return (_maxBytes > 0); }
+
+    /**
+     * Create the cache key for a request matched by the matcher with
+     * the given generation. An empty key is returned for requests
+     * that must not be answered from the cache.
+     **/
+    static vespalib::string makeKey(const SearchRequest &request, uint64_t matcherGeneration);
+
+    /**
+     * Obtain a copy of a cached reply that is still valid for the
+     * given generation and time, or nullptr.
+     **/
+    std::unique_ptr<SearchReply> lookup(const vespalib::string &key, uint64_t generation, vespalib::steady_time now);
+    void insert(const vespalib::string &key, const SearchReply &reply, uint64_t generation, vespalib::steady_time now);
+
+    /**
+     * Drop all cached replies. Used when the matchers are replaced,
+     * since entries keyed on the old matchers can no longer be hit.
+     **/
+    void clear();
+
+    /**
+     * Obtain statistics, resetting the counters (but not the number
+     * of cached entries or memory usage).
+     **/
+    Stats getStats();
+};
+
+}
@@ -169,8 +169,14 @@ struct SearchSessionCache : public SessionMap<SearchSession> {
 
 
 SessionManager::SessionManager(uint32_t maxSize)
+    : SessionManager(maxSize, 0, vespalib::duration::zero())
+{
+}
+
+SessionManager::SessionManager(uint32_t maxSize, size_t maxResultCacheBytes, vespalib::duration maxResultCacheAge)
     : _grouping_cache(std::make_unique<GroupingSessionCache>(maxSize)),
-      _search_map(std::make_unique<SearchSessionCache>()) {
+      _search_map(std::make_unique<SearchSessionCache>()),
+      _result_cache(std::make_unique<QueryResultCache>(maxResultCacheBytes, maxResultCacheAge)) {
 }
 
 SessionManager::~SessionManager() { }
@@ -3,6 +3,7 @@
 
 #include "search_session.h"
 #include "isessioncachepruner.h"
+#include "query_result_cache.h"
 #include <vespa/searchcore/grouping/groupingsession.h>
 #include <vespa/searchcore/grouping/sessionid.h>
 #include <vespa/vespalib/stllike/lrucache_map.h>
@@ -44,12 +45,14 @@ public:
 private:
     std::unique_ptr<GroupingSessionCache> _grouping_cache;
     std::unique_ptr<SearchSessionCache> _search_map;
+    std::unique_ptr<QueryResultCache> _result_cache;
 
 public:
     typedef std::unique_ptr<SessionManager> UP;
     typedef std::shared_ptr<SessionManager> SP;
 
     SessionManager(uint32_t maxSizeGrouping);
+    SessionManager(uint32_t maxSizeGrouping, size_t maxResultCacheBytes, vespalib::duration maxResultCacheAge);
     ~SessionManager() override;
 
     void insert(search::grouping::GroupingSession::UP session);
@@ -59,6 +62,8 @@ public:
     void insert(SearchSession::SP session);
     SearchSession::SP pickSearch(const SessionId &id);
     Stats getSearchStats();
+
+    QueryResultCache &getResultCache() { return *_result_cache; }
     size_t getNumSearchSessions() const;
     std::vector<SearchSessionInfo> getSortedSearchSessionInfo() const;
 
@@ -256,6 +256,7 @@ DocumentDBTaggedMetrics::DocumentDBTaggedMetrics(const vespalib::string &docType
       threadingService("threading_service", this),
       matching(this),
       sessionCache(this),
+      queryResultCache(this),
       documents(this),
       totalMemoryUsage(this),
       totalDiskUsage("disk_usage", {}, "The total disk usage (in bytes) for this document db", this),
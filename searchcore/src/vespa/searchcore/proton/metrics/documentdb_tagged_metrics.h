@@ -4,6 +4,7 @@
 #include "attribute_metrics.h"
 #include "memory_usage_metrics.h"
 #include "executor_threading_service_metrics.h"
+#include "query_result_cache_metrics.h"
 #include "sessionmanager_metrics.h"
 #include <vespa/metrics/metricset.h>
 #include <vespa/metrics/valuemetric.h>
@@ -192,6 +193,7 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
     ExecutorThreadingServiceMetrics threadingService;
     MatchingMetrics matching;
     SessionCacheMetrics sessionCache;
+    QueryResultCacheMetrics queryResultCache;
     DocumentsMetrics documents;
     MemoryUsageMetrics totalMemoryUsage;
     metrics::LongValueMetric totalDiskUsage;
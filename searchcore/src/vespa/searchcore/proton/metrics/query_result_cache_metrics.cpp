@@ -0,0 +1,37 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "query_result_cache_metrics.h"
+
+namespace proton {
+
+QueryResultCacheMetrics::QueryResultCacheMetrics(metrics::MetricSet *parent)
+    : metrics::MetricSet("query_result_cache", {}, "Metrics for the query result cache", parent),
+      lookups("lookups", {}, "Number of query result cache lookups", this),
+      hits("hits", {}, "Number of queries answered from the cache", this),
+      hitRate("hit_rate", {}, "Rate of queries answered from the cache", this),
+      inserts("inserts", {}, "Number of query results inserted into the cache", this),
+      invalidations("invalidations", {}, "Number of cached query results dropped because documents changed or they expired", this),
+      evictions("evictions", {}, "Number of cached query results evicted to stay within the memory limit", this),
+      elements("elements", {}, "Number of currently cached query results", this),
+      memoryUsage("memory_usage", {}, "Memory usage (in bytes) of the cached query results", this)
+{
+}
+
+QueryResultCacheMetrics::~QueryResultCacheMetrics() = default;
+
+void
+QueryResultCacheMetrics::update(const proton::matching::QueryResultCache::Stats &stats)
+{
+    lookups.inc(stats.numLookups);
+    hits.inc(stats.numHits);
+    if (stats.numLookups > 0) {
+        hitRate.addTotalValueWithCount(stats.numHits, stats.numLookups);
+    }
+    inserts.inc(stats.numInserts);
+    invalidations.inc(stats.numInvalidated);
+    evictions.inc(stats.numEvicted);
+    elements.set(stats.numCached);
+    memoryUsage.set(stats.memoryUsage);
+}
+
+}
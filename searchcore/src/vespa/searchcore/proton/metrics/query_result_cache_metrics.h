@@ -0,0 +1,31 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/countmetric.h>
+#include <vespa/metrics/metricset.h>
+#include <vespa/metrics/valuemetric.h>
+#include <vespa/searchcore/proton/matching/query_result_cache.h>
+
+namespace proton {
+
+/**
+ * Metrics for the query result cache of a document db.
+ */
+struct QueryResultCacheMetrics : metrics::MetricSet
+{
+    metrics::LongCountMetric   lookups;
+    metrics::LongCountMetric   hits;
+    metrics::LongAverageMetric hitRate;
+    metrics::LongCountMetric   inserts;
+    metrics::LongCountMetric   invalidations;
+    metrics::LongCountMetric   evictions;
+    metrics::LongValueMetric   elements;
+    metrics::LongValueMetric   memoryUsage;
+
+    void update(const proton::matching::QueryResultCache::Stats &stats);
+    QueryResultCacheMetrics(metrics::MetricSet *parent);
+    ~QueryResultCacheMetrics() override;
+};
+
+}
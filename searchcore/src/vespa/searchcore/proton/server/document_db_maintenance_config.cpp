@@ -123,6 +123,7 @@ DocumentDBMaintenanceConfig::DocumentDBMaintenanceConfig()
       _lidSpaceCompaction(),
       _attributeUsageFilterConfig(),
       _attributeUsageSampleInterval(60s),
+      _nearestNeighborIndexMaintenanceInterval(10s),
       _blockableJobConfig(),
       _flushConfig()
 {
@@ -138,6 +139,7 @@ DocumentDBMaintenanceConfig(const DocumentDBPruneRemovedDocumentsConfig &pruneRe
                             const DocumentDBLidSpaceCompactionConfig &lidSpaceCompaction,
                             const AttributeUsageFilterConfig &attributeUsageFilterConfig,
                             vespalib::duration attributeUsageSampleInterval,
+                            vespalib::duration nearestNeighborIndexMaintenanceInterval,
                             const BlockableMaintenanceJobConfig &blockableJobConfig,
                             const DocumentDBFlushConfig &flushConfig)
     : _pruneRemovedDocuments(pruneRemovedDocuments),
@@ -147,6 +149,7 @@ DocumentDBMaintenanceConfig(const DocumentDBPruneRemovedDocumentsConfig &pruneRe
       _lidSpaceCompaction(lidSpaceCompaction),
       _attributeUsageFilterConfig(attributeUsageFilterConfig),
       _attributeUsageSampleInterval(attributeUsageSampleInterval),
+      _nearestNeighborIndexMaintenanceInterval(nearestNeighborIndexMaintenanceInterval),
       _blockableJobConfig(blockableJobConfig),
       _flushConfig(flushConfig)
 {
@@ -163,6 +166,7 @@ operator==(const DocumentDBMaintenanceConfig &rhs) const
         _lidSpaceCompaction == rhs._lidSpaceCompaction &&
         _attributeUsageFilterConfig == rhs._attributeUsageFilterConfig &&
         _attributeUsageSampleInterval == rhs._attributeUsageSampleInterval &&
+        _nearestNeighborIndexMaintenanceInterval == rhs._nearestNeighborIndexMaintenanceInterval &&
         _blockableJobConfig == rhs._blockableJobConfig &&
         _flushConfig == rhs._flushConfig;
 }
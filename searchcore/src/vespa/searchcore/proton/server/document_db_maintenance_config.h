@@ -101,6 +101,7 @@ private:
     DocumentDBLidSpaceCompactionConfig    _lidSpaceCompaction;
     AttributeUsageFilterConfig            _attributeUsageFilterConfig;
     vespalib::duration                    _attributeUsageSampleInterval;
+    vespalib::duration                    _nearestNeighborIndexMaintenanceInterval;
     BlockableMaintenanceJobConfig         _blockableJobConfig;
     DocumentDBFlushConfig                 _flushConfig;
 
@@ -113,6 +114,7 @@ public:
                                 const DocumentDBLidSpaceCompactionConfig &lidSpaceCompaction,
                                 const AttributeUsageFilterConfig &attributeUsageFilterConfig,
                                 vespalib::duration attributeUsageSampleInterval,
+                                vespalib::duration nearestNeighborIndexMaintenanceInterval,
                                 const BlockableMaintenanceJobConfig &blockableJobConfig,
                                 const DocumentDBFlushConfig &flushConfig);
 
@@ -144,6 +146,9 @@ public:
     vespalib::duration getAttributeUsageSampleInterval() const {
         return _attributeUsageSampleInterval;
     }
+    vespalib::duration getNearestNeighborIndexMaintenanceInterval() const {
+        return _nearestNeighborIndexMaintenanceInterval;
+    }
     const BlockableMaintenanceJobConfig &getBlockableJobConfig() const {
         return _blockableJobConfig;
     }
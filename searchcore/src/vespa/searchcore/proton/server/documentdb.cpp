@@ -113,6 +113,7 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
                        const vespalib::string &tlsSpec,
                        matching::QueryLimiter &queryLimiter,
                        const vespalib::Clock &clock,
+                       const vespalib::eval::ConstantValueFactory &constantValueFactory,
                        const DocTypeName &docTypeName,
                        document::BucketSpace bucketSpace,
                        const ProtonConfig &protonCfg,
@@ -155,7 +156,9 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _bucketHandler(_writeService.master()),
       _indexCfg(makeIndexConfig(protonCfg.index)),
       _config_store(std::move(config_store)),
-      _sessionManager(std::make_shared<matching::SessionManager>(protonCfg.grouping.sessionmanager.maxentries)),
+      _sessionManager(std::make_shared<matching::SessionManager>(protonCfg.grouping.sessionmanager.maxentries,
+                                                                 protonCfg.search.resultcache.maxbytes,
+                                                                 vespalib::from_s(protonCfg.search.resultcache.maxage))),
       _metricsWireService(metricsWireService),
       _metricsHook(*this, _docTypeName.getName(), protonCfg.numthreadspersearch),
       _feedView(),
@@ -168,7 +171,7 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _transient_memory_usage_provider(std::make_shared<TransientMemoryUsageProvider>()),
       _feedHandler(_writeService, tlsSpec, docTypeName, _state, *this, _writeFilter, *this, tlsDirectWriter),
       _subDBs(*this, *this, _feedHandler, _docTypeName, _writeService, warmupExecutor, fileHeaderContext,
-              metricsWireService, getMetrics(), queryLimiter, clock, _configMutex, _baseDir,
+              metricsWireService, getMetrics(), queryLimiter, clock, constantValueFactory, _configMutex, _baseDir,
               makeSubDBConfig(protonCfg.distribution,
                               findDocumentDB(protonCfg.documentdb, docTypeName.getName())->allocation,
                               protonCfg.numsearcherthreads),
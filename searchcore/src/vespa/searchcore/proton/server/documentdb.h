@@ -42,6 +42,7 @@ namespace search {
 }
 
 namespace vespa::config::search::core::internal { class InternalProtonType; }
+namespace vespalib::eval { struct ConstantValueFactory; }
 
 namespace proton {
 class AttributeConfigInspector;
@@ -247,6 +248,7 @@ public:
                const vespalib::string &tlsSpec,
                matching::QueryLimiter &queryLimiter,
                const vespalib::Clock &clock,
+               const vespalib::eval::ConstantValueFactory &constantValueFactory,
                const DocTypeName &docTypeName,
                document::BucketSpace bucketSpace,
                const ProtonConfig &protonCfg,
@@ -190,6 +190,8 @@ updateSessionCacheMetrics(DocumentDBTaggedMetrics &metrics, proton::matching::Se
 
     auto groupingStats = sessionManager.getGroupingStats();
     metrics.sessionCache.grouping.update(groupingStats);
+
+    metrics.queryResultCache.update(sessionManager.getResultCache().getStats());
 }
 
 void
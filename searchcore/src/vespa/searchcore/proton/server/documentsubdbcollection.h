@@ -11,6 +11,7 @@
 
 namespace vespalib {
     class Clock;
+    namespace eval { struct ConstantValueFactory; }
     class SyncableThreadExecutor;
     class ThreadStackExecutorBase;
 }
@@ -109,6 +110,7 @@ public:
             DocumentDBTaggedMetrics &metrics,
             matching::QueryLimiter & queryLimiter,
             const vespalib::Clock &clock,
+            const vespalib::eval::ConstantValueFactory &constantValueFactory,
             std::mutex &configMutex,
             const vespalib::string &baseDir,
             const Config & cfg,
@@ -70,7 +70,8 @@ FastAccessDocSubDB::createAttributeManagerInitializer(const DocumentDBConfig &co
                                                _fileHeaderContext,
                                                _writeService.attributeFieldWriter(),
                                                attrFactory,
-                                               _hwInfo);
+                                               _hwInfo,
+                                               &_writeService.shared());
     return std::make_shared<AttributeManagerInitializer>(configSerialNum,
                                                          documentMetaStoreInitTask,
                                                          documentMetaStore,
@@ -6,6 +6,7 @@
 #include "job_tracked_maintenance_job.h"
 #include "lid_space_compaction_job.h"
 #include "maintenance_jobs_injector.h"
+#include "nearest_neighbor_index_maintenance_job.h"
 #include "prune_session_cache_job.h"
 #include "pruneremoveddocumentsjob.h"
 #include "sample_attribute_usage_job.h"
@@ -118,6 +119,11 @@ MaintenanceJobsInjector::injectJobs(MaintenanceController &controller,
                                      fbHandler, jobTrackers.getLidSpaceCompact(),
                                      diskMemUsageNotifier, clusterStateChangedNotifier, calc);
     }
+    controller.registerJobInMasterThread(std::make_unique<NearestNeighborIndexMaintenanceJob>
+                                                 (readyAttributeManager,
+                                                  notReadyAttributeManager,
+                                                  docTypeName,
+                                                  config.getNearestNeighborIndexMaintenanceInterval()));
     injectBucketMoveJob(controller, fbHandler, bucketCreateNotifier, docTypeName, bucketSpace, moveHandler, bucketModifiedHandler,
                         clusterStateChangedNotifier, bucketStateChangedNotifier, calc, jobTrackers,
                         diskMemUsageNotifier, config.getBlockableJobConfig());
@@ -0,0 +1,112 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "nearest_neighbor_index_maintenance_job.h"
+#include "imaintenancejobrunner.h"
+#include <vespa/searchcore/proton/attribute/i_attribute_manager.h>
+#include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
+#include <vespa/vespalib/util/isequencedtaskexecutor.h>
+#include <mutex>
+
+using search::tensor::TensorAttribute;
+
+namespace proton {
+
+/**
+ * Tracks the maintenance steps started by one run of the job. When
+ * the last of them is done and any index has more work to do, the
+ * job is scheduled to run again.
+ */
+class NearestNeighborIndexMaintenanceJob::Progress
+{
+private:
+    std::mutex             _lock;
+    IMaintenanceJobRunner *_runner;
+    uint32_t               _pending;
+    bool                   _more_work;
+
+public:
+    Progress() : _lock(), _runner(nullptr), _pending(0), _more_work(false) {}
+
+    void set_runner(IMaintenanceJobRunner *runner) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _runner = runner;
+    }
+
+    // Returns false if steps from the previous run are still pending
+    bool start() {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_pending > 0) {
+            return false;
+        }
+        _pending = 1; // released by run() when all steps are started
+        _more_work = false;
+        return true;
+    }
+
+    void add_step() {
+        std::lock_guard<std::mutex> guard(_lock);
+        ++_pending;
+    }
+
+    void step_done(bool more_work) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _more_work = _more_work || more_work;
+        if ((--_pending == 0) && _more_work && (_runner != nullptr)) {
+            _runner->run();
+        }
+    }
+};
+
+NearestNeighborIndexMaintenanceJob::
+NearestNeighborIndexMaintenanceJob(IAttributeManagerSP readyAttributeManager,
+                                   IAttributeManagerSP notReadyAttributeManager,
+                                   const vespalib::string &docTypeName,
+                                   vespalib::duration interval)
+    : IMaintenanceJob("nearest_neighbor_index_maintenance." + docTypeName, interval, interval),
+      _readyAttributeManager(std::move(readyAttributeManager)),
+      _notReadyAttributeManager(std::move(notReadyAttributeManager)),
+      _progress(std::make_shared<Progress>())
+{
+}
+
+NearestNeighborIndexMaintenanceJob::~NearestNeighborIndexMaintenanceJob()
+{
+    // steps still running in the attribute writer threads must not reschedule the job
+    _progress->set_runner(nullptr);
+}
+
+void
+NearestNeighborIndexMaintenanceJob::maintain(const IAttributeManagerSP &attributeManager,
+                                             const std::shared_ptr<Progress> &progress)
+{
+    auto &fieldWriter = attributeManager->getAttributeFieldWriter();
+    for (auto attr : attributeManager->getWritableAttributes()) {
+        auto tensorAttr = dynamic_cast<TensorAttribute *>(attr);
+        if (tensorAttr != nullptr && tensorAttr->nearest_neighbor_index() != nullptr) {
+            progress->add_step();
+            fieldWriter.execute(fieldWriter.getExecutorId(attr->getNamePrefix()),
+                                [attributeManager, tensorAttr, progress]()
+                                { progress->step_done(tensorAttr->maintain_nearest_neighbor_index()); });
+        }
+    }
+}
+
+void
+NearestNeighborIndexMaintenanceJob::registerRunner(IMaintenanceJobRunner *runner)
+{
+    _progress->set_runner(runner);
+}
+
+bool
+NearestNeighborIndexMaintenanceJob::run()
+{
+    if (_progress->start()) {
+        maintain(_readyAttributeManager, _progress);
+        maintain(_notReadyAttributeManager, _progress);
+        _progress->step_done(false);
+    }
+    return true;
+}
+
+} // namespace proton
@@ -0,0 +1,42 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "i_maintenance_job.h"
+#include <memory>
+
+namespace proton {
+
+struct IAttributeManager;
+
+/**
+ * Job that incrementally maintains the nearest neighbor indexes of the
+ * tensor attributes in a document db. Each run repairs a slice of the
+ * HNSW graphs degraded by removals and compacts their data stores when
+ * fragmented. The work is done in the attribute writer threads, and its
+ * progress is shown in the state of each attribute. While any index
+ * reports more work, the job is run again as soon as the previous
+ * slices are done instead of waiting for the next interval.
+ */
+class NearestNeighborIndexMaintenanceJob : public IMaintenanceJob
+{
+    using IAttributeManagerSP = std::shared_ptr<IAttributeManager>;
+    class Progress;
+
+    IAttributeManagerSP       _readyAttributeManager;
+    IAttributeManagerSP       _notReadyAttributeManager;
+    std::shared_ptr<Progress> _progress;
+
+    static void maintain(const IAttributeManagerSP &attributeManager, const std::shared_ptr<Progress> &progress);
+public:
+    NearestNeighborIndexMaintenanceJob(IAttributeManagerSP readyAttributeManager,
+                                       IAttributeManagerSP notReadyAttributeManager,
+                                       const vespalib::string &docTypeName,
+                                       vespalib::duration interval);
+    ~NearestNeighborIndexMaintenanceJob() override;
+
+    void registerRunner(IMaintenanceJobRunner *runner) override;
+    bool run() override;
+};
+
+} // namespace proton
@@ -27,6 +27,8 @@
 #include <vespa/document/base/exceptions.h>
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/eval/eval/llvm/object_cache.h>
+#include <vespa/eval/tensor/default_tensor_engine.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/host_name.h>
@@ -191,6 +193,9 @@ Proton::Proton(const config::ConfigUri & configUri,
       _tls(),
       _diskMemUsageSampler(),
       _persistenceEngine(),
+      _constantTensorLoader(vespalib::tensor::DefaultTensorEngine::ref()),
+      _mappedConstantLoader(),
+      _constantValueCache(),
       _documentDBMap(),
       _matchEngine(),
       _summaryEngine(),
@@ -304,6 +309,26 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     const size_t sharedThreads = deriveCompactionCompressionThreads(protonConfig, hwInfo.cpu());
     _sharedExecutor = std::make_shared<vespalib::BlockingThreadStackExecutor>(sharedThreads, 128*1024, sharedThreads*16, proton_shared_executor);
     _compile_cache_executor_binding = vespalib::eval::CompileCache::bind(_sharedExecutor);
+    if (protonConfig.compilecache.maxbytes > 0) {
+        vespalib::eval::ObjectCache::set_directory(protonConfig.basedir + "/compile-cache",
+                                                   protonConfig.compilecache.maxbytes);
+    }
+    if (protonConfig.constantcache.maxbytes > 0) {
+        vespalib::string constantCacheDir = protonConfig.basedir + "/constant-cache";
+        try {
+            vespalib::mkdir(constantCacheDir, true);
+            vespalib::tensor::MappedConstantLoader::prune(constantCacheDir, protonConfig.constantcache.maxbytes);
+            _mappedConstantLoader = std::make_unique<vespalib::tensor::MappedConstantLoader>(_constantTensorLoader,
+                                                                                              constantCacheDir);
+        } catch (const vespalib::IoException &e) {
+            LOG(warning, "Memory-mapped ranking constants disabled: %s", e.getMessage().c_str());
+        }
+    }
+    if (_mappedConstantLoader) {
+        _constantValueCache = std::make_unique<vespalib::eval::ConstantValueCache>(*_mappedConstantLoader);
+    } else {
+        _constantValueCache = std::make_unique<vespalib::eval::ConstantValueCache>(_constantTensorLoader);
+    }
     InitializeThreads initializeThreads;
     if (protonConfig.initialize.threads > 0) {
         initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(protonConfig.initialize.threads, 128 * 1024, initialize_executor);
@@ -573,7 +598,7 @@ Proton::addDocumentDB(const document::DocumentType &docType,
         initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(1, 128 * 1024);
     }
     auto ret = std::make_shared<DocumentDB>(config.basedir + "/documents", documentDBConfig, config.tlsspec,
-                                            _queryLimiter, _clock, docTypeName, bucketSpace, config, *this,
+                                            _queryLimiter, _clock, *_constantValueCache, docTypeName, bucketSpace, config, *this,
                                             *_warmupExecutor, *_sharedExecutor, *_tls->getTransLogServer(),
                                             *_metricsEngine, _fileHeaderContext, std::move(config_store),
                                             initializeThreads, bootstrapConfig->getHwInfo());
@@ -27,6 +27,9 @@
 #include <vespa/vespalib/net/state_explorer.h>
 #include <vespa/vespalib/util/varholder.h>
 #include <vespa/eval/eval/llvm/compile_cache.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
+#include <vespa/eval/eval/value_cache/constant_value_cache.h>
+#include <vespa/eval/tensor/mapped_constant_loader.h>
 #include <mutex>
 #include <shared_mutex>
 
@@ -94,6 +97,9 @@ private:
     TLS::UP                         _tls;
     std::unique_ptr<DiskMemUsageSampler> _diskMemUsageSampler;
     PersistenceEngine::UP           _persistenceEngine;
+    vespalib::eval::ConstantTensorLoader _constantTensorLoader;
+    std::unique_ptr<vespalib::tensor::MappedConstantLoader> _mappedConstantLoader;
+    std::unique_ptr<vespalib::eval::ConstantValueCache> _constantValueCache;
     DocumentDBMap                   _documentDBMap;
     std::unique_ptr<MatchEngine>   _matchEngine;
     std::unique_ptr<SummaryEngine>  _summaryEngine;
@@ -3,6 +3,7 @@
 #include "reconfig_params.h"
 #include "searchable_doc_subdb_configurer.h"
 #include <vespa/searchcore/proton/matching/matcher.h>
+#include <vespa/searchcore/proton/matching/sessionmanager.h>
 #include <vespa/searchcore/proton/attribute/attribute_writer.h>
 #include <vespa/searchcore/proton/attribute/imported_attributes_repo.h>
 #include <vespa/searchcore/proton/common/document_type_inspector.h>
@@ -251,6 +252,8 @@ SearchableDocSubDBConfigurer::reconfigure(const DocumentDBConfig &newConfig,
         IndexSearchable::SP indexSearchable = searchView->getIndexSearchable();
         reconfigureMatchView(matchers, indexSearchable, attrMgr);
         searchView = _searchView.get();
+        // cached results were produced with the old matchers and attributes
+        searchView->getSessionManager()->getResultCache().clear();
         shouldFeedViewChange = true;
     }
 
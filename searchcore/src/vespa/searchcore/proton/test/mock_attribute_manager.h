@@ -58,6 +58,9 @@ public:
     vespalib::ISequencedTaskExecutor &getAttributeFieldWriter() const override {
         HDR_ABORT("should not be reached");
     }
+    vespalib::ThreadExecutor *get_shared_executor() const override {
+        return nullptr;
+    }
     search::AttributeVector *getWritableAttribute(const vespalib::string &) const override {
         return nullptr;
     }
@@ -0,0 +1,573 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/tensor/dense/dense_tensor.h>
+#include <vespa/fastos/app.h>
+#include <vespa/searchlib/attribute/attribute_read_guard.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
+#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/distance_function_factory.h>
+#include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/inv_log_level_generator.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_factory.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/data/slime/json_format.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/text/stringtokenizer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/time.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using search::BitVector;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using search::attribute::DistanceMetric;
+using search::attribute::HnswIndexParams;
+using search::queryeval::NearestNeighborBlueprint;
+using search::tensor::DenseTensorAttribute;
+using search::tensor::DistanceFunction;
+using search::tensor::DocVectorAccess;
+using search::tensor::HnswIndex;
+using search::tensor::HnswNodeidMapping;
+using search::tensor::NearestNeighborIndex;
+using search::tensor::NearestNeighborIndexFactory;
+using vespalib::eval::ValueType;
+using vespalib::slime::Cursor;
+using vespalib::tensor::DenseTensor;
+using vespalib::tensor::TypedCells;
+
+using CellType = ValueType::CellType;
+
+namespace {
+
+/**
+ * Vectors read from a file in the fvecs format, where each vector is
+ * stored as its number of dimensions (int32) followed by the cells (float32).
+ */
+struct VectorSet {
+    uint32_t dims;
+    std::vector<float> cells;
+
+    VectorSet() : dims(0), cells() {}
+    size_t size() const { return (dims > 0) ? (cells.size() / dims) : 0; }
+    const float* get(size_t idx) const { return &cells[idx * dims]; }
+    TypedCells get_cells(size_t idx) const { return TypedCells(get(idx), CellType::FLOAT, dims); }
+};
+
+/**
+ * Reads vectors stored in the fvecs (float32) or ivecs (int32) format, as used by
+ * the standard ANN datasets (e.g. SIFT1M and GIST1M). At most max_vectors are read if non-zero.
+ */
+template <typename T>
+bool
+read_vecs(const vespalib::string& file_name, size_t max_vectors, uint32_t& dims, std::vector<T>& cells)
+{
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open '" << file_name << "'" << std::endl;
+        return false;
+    }
+    dims = 0;
+    cells.clear();
+    int32_t vector_dims;
+    size_t num_vectors = 0;
+    while (((max_vectors == 0) || (num_vectors < max_vectors)) &&
+           file.read(reinterpret_cast<char*>(&vector_dims), sizeof(vector_dims)))
+    {
+        if ((vector_dims <= 0) || ((dims != 0) && (uint32_t(vector_dims) != dims))) {
+            std::cerr << "Unexpected number of dimensions (" << vector_dims << ") for vector " <<
+                      num_vectors << " in '" << file_name << "'" << std::endl;
+            return false;
+        }
+        dims = vector_dims;
+        size_t offset = cells.size();
+        cells.resize(offset + dims);
+        if (!file.read(reinterpret_cast<char*>(&cells[offset]), dims * sizeof(T))) {
+            std::cerr << "Truncated vector " << num_vectors << " in '" << file_name << "'" << std::endl;
+            return false;
+        }
+        ++num_vectors;
+    }
+    return true;
+}
+
+/**
+ * Makes a hnsw index with the given config, which (unlike the default factory)
+ * allows tuning all the parameters of the graph construction.
+ */
+class BenchmarkIndexFactory : public NearestNeighborIndexFactory {
+private:
+    HnswIndex::Config _cfg;
+
+public:
+    BenchmarkIndexFactory(const HnswIndex::Config& cfg) : _cfg(cfg) {}
+
+    std::unique_ptr<NearestNeighborIndex> make(const DocVectorAccess& vectors,
+                                               size_t,
+                                               CellType cell_type,
+                                               const HnswIndexParams& params) const override {
+        return std::make_unique<HnswIndex>(vectors,
+                                           search::tensor::make_distance_function(params.distance_metric(), cell_type),
+                                           std::make_unique<search::tensor::InvLogLevelGenerator>(_cfg.max_links_on_inserts()),
+                                           _cfg);
+    }
+    std::unique_ptr<NearestNeighborIndex> make_multi_vector(const DocVectorAccess&,
+                                                            const HnswNodeidMapping&,
+                                                            size_t,
+                                                            CellType,
+                                                            const HnswIndexParams&) const override {
+        abort();
+    }
+};
+
+using Neighbor = NearestNeighborIndex::Neighbor;
+
+struct NeighborDistanceLess {
+    bool operator()(const Neighbor& lhs, const Neighbor& rhs) const {
+        return lhs.distance < rhs.distance;
+    }
+};
+
+/**
+ * Results of running all queries once for a given filter, exploration and thread count.
+ */
+struct RunResult {
+    double recall;
+    double elapsed_s;
+    std::vector<double> latencies_ms;
+
+    RunResult() : recall(0.0), elapsed_s(0.0), latencies_ms() {}
+    double qps() const { return (elapsed_s > 0.0) ? (latencies_ms.size() / elapsed_s) : 0.0; }
+    double percentile(double p) const {
+        if (latencies_ms.empty()) {
+            return 0.0;
+        }
+        size_t idx = std::min(latencies_ms.size() - 1, size_t(p * latencies_ms.size() / 100.0));
+        return latencies_ms[idx];
+    }
+};
+
+class AnnBenchmarkApp : public FastOS_Application
+{
+private:
+    vespalib::string _base_file;
+    vespalib::string _query_file;
+    vespalib::string _ground_truth_file;
+    size_t _max_docs;
+    size_t _max_queries;
+    uint32_t _k;
+    uint32_t _max_links_per_node;
+    uint32_t _neighbors_to_explore_at_construction;
+    bool _heuristic_select_neighbors;
+    DistanceMetric _distance_metric;
+    std::vector<uint32_t> _explore_additional_hits;
+    std::vector<uint32_t> _thread_counts;
+    std::vector<double> _filter_percents;
+
+    VectorSet _docs;
+    VectorSet _queries;
+    std::vector<std::vector<uint32_t>> _ground_truth;
+    std::shared_ptr<DenseTensorAttribute> _attr;
+    DistanceFunction::UP _distance_func;
+
+    void usage();
+    bool parse_options();
+    bool load_vectors();
+    void build_index(Cursor& result);
+    std::unique_ptr<BitVector> make_filter(double percent) const;
+    std::vector<uint32_t> exact_top_k(const float* query, const BitVector* filter) const;
+    std::vector<std::vector<uint32_t>> exact_results(const BitVector* filter) const;
+    RunResult run_queries(const BitVector* filter, uint32_t explore_k, uint32_t num_threads,
+                          const std::vector<std::vector<uint32_t>>& expected) const;
+    void run_benchmark(Cursor& result);
+
+public:
+    AnnBenchmarkApp();
+    ~AnnBenchmarkApp() override;
+    int Main() override;
+};
+
+template <typename T, typename Convert>
+bool
+parse_list(const char* arg, std::vector<T>& list, Convert convert)
+{
+    list.clear();
+    vespalib::StringTokenizer tokens(arg);
+    tokens.removeEmptyTokens();
+    for (const auto& token : tokens) {
+        list.push_back(convert(vespalib::string(token).c_str()));
+    }
+    return !list.empty();
+}
+
+uint32_t to_uint32(const char* str) { return strtoul(str, nullptr, 0); }
+double to_double(const char* str) { return strtod(str, nullptr); }
+
+AnnBenchmarkApp::AnnBenchmarkApp()
+    : _base_file(),
+      _query_file(),
+      _ground_truth_file(),
+      _max_docs(0),
+      _max_queries(0),
+      _k(10),
+      _max_links_per_node(16),
+      _neighbors_to_explore_at_construction(200),
+      _heuristic_select_neighbors(true),
+      _distance_metric(DistanceMetric::Euclidean),
+      _explore_additional_hits({0, 100}),
+      _thread_counts({1}),
+      _filter_percents({100.0}),
+      _docs(),
+      _queries(),
+      _ground_truth(),
+      _attr(),
+      _distance_func()
+{
+}
+
+AnnBenchmarkApp::~AnnBenchmarkApp() = default;
+
+void
+AnnBenchmarkApp::usage()
+{
+    std::cerr << "usage: vespa-ann-benchmark [options] <base.fvecs> <query.fvecs>" << std::endl;
+    std::cerr << "  -g <file>      ground truth (ivecs) for the unfiltered queries, computed by brute force if not given" << std::endl;
+    std::cerr << "  -n <num>       max number of documents to load (default all)" << std::endl;
+    std::cerr << "  -q <num>       max number of queries to load (default all)" << std::endl;
+    std::cerr << "  -k <num>       number of target hits (default 10)" << std::endl;
+    std::cerr << "  -m <num>       max links per node (default 16), level 0 gets twice as many" << std::endl;
+    std::cerr << "  -c <num>       neighbors to explore at construction (default 200)" << std::endl;
+    std::cerr << "  -s             use simple instead of heuristic neighbor selection" << std::endl;
+    std::cerr << "  -a             use angular instead of euclidean distance" << std::endl;
+    std::cerr << "  -x <list>      explore additional hits when searching (default 0,100)" << std::endl;
+    std::cerr << "  -t <list>      number of query threads (default 1)" << std::endl;
+    std::cerr << "  -f <list>      percent of documents passing the filter (default 100)" << std::endl;
+    std::cerr << "Lists are comma separated. The results are written to stdout as json." << std::endl;
+}
+
+bool
+AnnBenchmarkApp::parse_options()
+{
+    int idx = 1;
+    char opt;
+    const char* arg;
+    bool ok = true;
+    while ((opt = GetOpt("g:n:q:k:m:c:sax:t:f:", arg, idx)) != -1) {
+        switch (opt) {
+        case 'g':
+            _ground_truth_file = arg;
+            break;
+        case 'n':
+            _max_docs = strtoul(arg, nullptr, 0);
+            break;
+        case 'q':
+            _max_queries = strtoul(arg, nullptr, 0);
+            break;
+        case 'k':
+            _k = to_uint32(arg);
+            ok = ok && (_k > 0);
+            break;
+        case 'm':
+            _max_links_per_node = to_uint32(arg);
+            ok = ok && (_max_links_per_node > 0);
+            break;
+        case 'c':
+            _neighbors_to_explore_at_construction = to_uint32(arg);
+            break;
+        case 's':
+            _heuristic_select_neighbors = false;
+            break;
+        case 'a':
+            _distance_metric = DistanceMetric::Angular;
+            break;
+        case 'x':
+            ok = ok && parse_list(arg, _explore_additional_hits, to_uint32);
+            break;
+        case 't':
+            ok = ok && parse_list(arg, _thread_counts, to_uint32);
+            ok = ok && (std::find(_thread_counts.begin(), _thread_counts.end(), 0) == _thread_counts.end());
+            break;
+        case 'f':
+            ok = ok && parse_list(arg, _filter_percents, to_double);
+            break;
+        default:
+            ok = false;
+            break;
+        }
+    }
+    if (!ok || (_argc != (idx + 2))) {
+        return false;
+    }
+    _base_file = _argv[idx];
+    _query_file = _argv[idx + 1];
+    return true;
+}
+
+bool
+AnnBenchmarkApp::load_vectors()
+{
+    if (!read_vecs(_base_file, _max_docs, _docs.dims, _docs.cells) ||
+        !read_vecs(_query_file, _max_queries, _queries.dims, _queries.cells)) {
+        return false;
+    }
+    if ((_docs.size() == 0) || (_queries.size() == 0) || (_docs.dims != _queries.dims)) {
+        std::cerr << "Documents and queries must be non-empty and have the same number of dimensions" << std::endl;
+        return false;
+    }
+    if (!_ground_truth_file.empty()) {
+        uint32_t dims = 0;
+        std::vector<int32_t> ids;
+        if (!read_vecs(_ground_truth_file, _queries.size(), dims, ids)) {
+            return false;
+        }
+        if ((dims < _k) || (ids.size() / dims != _queries.size())) {
+            std::cerr << "Ground truth must have at least " << _k << " neighbors for each query" << std::endl;
+            return false;
+        }
+        _ground_truth.resize(_queries.size());
+        for (size_t i = 0; i < _queries.size(); ++i) {
+            for (uint32_t j = 0; j < _k; ++j) {
+                // Vector i in the base file is stored as docid i + 1.
+                _ground_truth[i].push_back(ids[i * dims + j] + 1);
+            }
+        }
+    }
+    return true;
+}
+
+void
+AnnBenchmarkApp::build_index(Cursor& result)
+{
+    Config cfg(BasicType::TENSOR, CollectionType::SINGLE);
+    cfg.setTensorType(ValueType::from_spec(vespalib::make_string("tensor<float>(x[%u])", _docs.dims)));
+    cfg.set_distance_metric(_distance_metric);
+    cfg.set_hnsw_index_params(HnswIndexParams(_max_links_per_node, _neighbors_to_explore_at_construction, _distance_metric));
+    HnswIndex::Config index_cfg(_max_links_per_node * 2, _max_links_per_node,
+                                _neighbors_to_explore_at_construction, _heuristic_select_neighbors);
+    BenchmarkIndexFactory index_factory(index_cfg);
+    _attr = std::make_shared<DenseTensorAttribute>("ann_benchmark", cfg, index_factory);
+    _attr->addReservedDoc();
+    _distance_func = search::tensor::make_distance_function(_distance_metric, CellType::FLOAT);
+
+    vespalib::Timer timer;
+    for (size_t i = 0; i < _docs.size(); ++i) {
+        uint32_t docid = 0;
+        _attr->addDoc(docid);
+        assert(docid == i + 1);
+        DenseTensor<float> tensor(_attr->getConfig().tensorType(),
+                                  std::vector<float>(_docs.get(i), _docs.get(i) + _docs.dims));
+        _attr->setTensor(docid, tensor);
+        _attr->commit();
+    }
+    double build_s = vespalib::to_s(timer.elapsed());
+    std::cerr << "Built index over " << _docs.size() << " documents in " << build_s << " seconds" << std::endl;
+
+    _attr->commit(true);
+    auto index_memory = _attr->nearest_neighbor_index()->memory_usage();
+    result.setLong("documents", _docs.size());
+    result.setDouble("build_time_s", build_s);
+    result.setDouble("documents_per_s", _docs.size() / build_s);
+    Cursor& memory = result.setObject("memory");
+    memory.setLong("attribute_allocated_bytes", _attr->getStatus().getAllocated());
+    memory.setLong("attribute_used_bytes", _attr->getStatus().getUsed());
+    memory.setLong("index_allocated_bytes", index_memory.allocatedBytes());
+    memory.setLong("index_used_bytes", index_memory.usedBytes());
+}
+
+std::unique_ptr<BitVector>
+AnnBenchmarkApp::make_filter(double percent) const
+{
+    if (percent >= 100.0) {
+        return std::unique_ptr<BitVector>();
+    }
+    std::mt19937 rnd(1234);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    auto filter = BitVector::create(_attr->getCommittedDocIdLimit());
+    for (uint32_t docid = 1; docid < filter->size(); ++docid) {
+        if (dist(rnd) < percent) {
+            filter->setBit(docid);
+        }
+    }
+    filter->invalidateCachedCount();
+    return filter;
+}
+
+std::vector<uint32_t>
+AnnBenchmarkApp::exact_top_k(const float* query, const BitVector* filter) const
+{
+    TypedCells query_cells(query, CellType::FLOAT, _docs.dims);
+    // Max-heap on distance holding the best k hits found so far.
+    std::vector<Neighbor> heap;
+    heap.reserve(_k + 1);
+    for (size_t i = 0; i < _docs.size(); ++i) {
+        uint32_t docid = i + 1;
+        if ((filter != nullptr) && !filter->testBit(docid)) {
+            continue;
+        }
+        double distance = _distance_func->calc(query_cells, _docs.get_cells(i));
+        if ((heap.size() < _k) || (distance < heap.front().distance)) {
+            heap.emplace_back(docid, distance);
+            std::push_heap(heap.begin(), heap.end(), NeighborDistanceLess());
+            if (heap.size() > _k) {
+                std::pop_heap(heap.begin(), heap.end(), NeighborDistanceLess());
+                heap.pop_back();
+            }
+        }
+    }
+    std::vector<uint32_t> result;
+    for (const auto& hit : heap) {
+        result.push_back(hit.docid);
+    }
+    return result;
+}
+
+std::vector<std::vector<uint32_t>>
+AnnBenchmarkApp::exact_results(const BitVector* filter) const
+{
+    if ((filter == nullptr) && !_ground_truth.empty()) {
+        return _ground_truth;
+    }
+    std::vector<std::vector<uint32_t>> result(_queries.size());
+    uint32_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([this, t, num_threads, filter, &result]() {
+            for (size_t q = t; q < _queries.size(); q += num_threads) {
+                result[q] = exact_top_k(_queries.get(q), filter);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return result;
+}
+
+RunResult
+AnnBenchmarkApp::run_queries(const BitVector* filter, uint32_t explore_k, uint32_t num_threads,
+                             const std::vector<std::vector<uint32_t>>& expected) const
+{
+    const NearestNeighborIndex& index = *_attr->nearest_neighbor_index();
+    std::vector<double> latencies_ms(_queries.size());
+    std::vector<size_t> hits_found(_queries.size());
+    auto guard = _attr->makeReadGuard(false);
+    vespalib::Timer timer;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t q = t; q < _queries.size(); q += num_threads) {
+                vespalib::Timer query_timer;
+                auto hits = (filter != nullptr)
+                        ? index.find_top_k_with_filter(_k, _queries.get_cells(q), *filter, explore_k)
+                        : index.find_top_k(_k, _queries.get_cells(q), explore_k);
+                latencies_ms[q] = vespalib::count_us(query_timer.elapsed()) / 1000.0;
+                size_t found = 0;
+                for (const auto& hit : hits) {
+                    const auto& exp = expected[q];
+                    if (std::find(exp.begin(), exp.end(), hit.docid) != exp.end()) {
+                        ++found;
+                    }
+                }
+                hits_found[q] = found;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    RunResult result;
+    result.elapsed_s = vespalib::to_s(timer.elapsed());
+    double recall_sum = 0.0;
+    size_t recall_queries = 0;
+    for (size_t q = 0; q < _queries.size(); ++q) {
+        if (!expected[q].empty()) {
+            recall_sum += double(hits_found[q]) / expected[q].size();
+            ++recall_queries;
+        }
+    }
+    result.recall = (recall_queries > 0) ? (recall_sum / recall_queries) : 1.0;
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    result.latencies_ms = std::move(latencies_ms);
+    return result;
+}
+
+void
+AnnBenchmarkApp::run_benchmark(Cursor& result)
+{
+    Cursor& runs = result.setArray("runs");
+    for (double filter_percent : _filter_percents) {
+        auto filter = make_filter(filter_percent);
+        auto expected = exact_results(filter.get());
+        for (uint32_t explore_additional_hits : _explore_additional_hits) {
+            // same number of candidates to explore as a nearestNeighbor query term
+            uint32_t explore_k = _k + explore_additional_hits;
+            if (filter) {
+                explore_k = NearestNeighborBlueprint::adjust_explore_k(explore_k, filter_percent / 100.0);
+            }
+            for (uint32_t num_threads : _thread_counts) {
+                auto run = run_queries(filter.get(), explore_k, num_threads, expected);
+                std::cerr << "filter=" << filter_percent << "% explore_additional_hits=" << explore_additional_hits <<
+                          " threads=" << num_threads << ": recall@" << _k << "=" << run.recall <<
+                          " qps=" << run.qps() << " p99=" << run.percentile(99.0) << "ms" << std::endl;
+                Cursor& obj = runs.addObject();
+                obj.setDouble("filter_percent", filter_percent);
+                obj.setLong("explore_additional_hits", explore_additional_hits);
+                obj.setLong("explore_k", explore_k);
+                obj.setLong("threads", num_threads);
+                obj.setDouble("recall", run.recall);
+                obj.setDouble("qps", run.qps());
+                Cursor& latency = obj.setObject("latency_ms");
+                latency.setDouble("avg", std::accumulate(run.latencies_ms.begin(), run.latencies_ms.end(), 0.0) /
+                                         run.latencies_ms.size());
+                latency.setDouble("p50", run.percentile(50.0));
+                latency.setDouble("p90", run.percentile(90.0));
+                latency.setDouble("p99", run.percentile(99.0));
+                latency.setDouble("p999", run.percentile(99.9));
+                latency.setDouble("max", run.latencies_ms.back());
+            }
+        }
+    }
+}
+
+int
+AnnBenchmarkApp::Main()
+{
+    if (!parse_options()) {
+        usage();
+        return 1;
+    }
+    if (!load_vectors()) {
+        return 1;
+    }
+    vespalib::Slime slime;
+    Cursor& root = slime.setObject();
+    Cursor& params = root.setObject("params");
+    params.setLong("dimensions", _docs.dims);
+    params.setLong("queries", _queries.size());
+    params.setLong("target_hits", _k);
+    params.setLong("max_links_per_node", _max_links_per_node);
+    params.setLong("neighbors_to_explore_at_construction", _neighbors_to_explore_at_construction);
+    params.setBool("heuristic_select_neighbors", _heuristic_select_neighbors);
+    params.setString("distance_metric", (_distance_metric == DistanceMetric::Angular) ? "angular" : "euclidean");
+    build_index(root.setObject("build"));
+    run_benchmark(root);
+
+    vespalib::SimpleBuffer buf;
+    vespalib::slime::JsonFormat::encode(slime, buf, false);
+    std::cout << buf.get().make_string() << std::endl;
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    AnnBenchmarkApp app;
+    return app.Entry(argc, argv);
+}
@@ -391,6 +391,7 @@ TEST(AttributeBlueprintTest, empty_blueprint_is_created_when_nearest_neighbor_te
     expect_empty_blueprint(make_int_attribute(field)); // attribute is not a tensor
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x{})")); // attribute is not a dense tensor
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2],y[2])")); // tensor type is not of order 1
+    expect_empty_blueprint(make_tensor_attribute(field, "tensor(x{},y[2])")); // mixed tensor without nearest neighbor index
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])")); // query tensor not found
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), sparse_x); // query tensor is not dense
     expect_empty_blueprint(make_tensor_attribute(field, "tensor(x[2])"), dense_y_2); // tensor types are not compatible
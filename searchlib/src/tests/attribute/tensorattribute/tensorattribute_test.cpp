@@ -7,9 +7,12 @@
 #include <vespa/fastos/file.h>
 #include <vespa/searchlib/attribute/attribute_read_guard.h>
 #include <vespa/searchlib/attribute/attributeguard.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
 #include <vespa/searchlib/tensor/default_nearest_neighbor_index_factory.h>
 #include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/distance_function_factory.h>
 #include <vespa/searchlib/tensor/doc_vector_access.h>
 #include <vespa/searchlib/tensor/generic_tensor_attribute.h>
 #include <vespa/searchlib/tensor/hnsw_index.h>
@@ -23,6 +26,8 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/searchlib/util/bufferwriter.h>
 
 #include <vespa/log/log.h>
@@ -67,6 +72,7 @@ static bool operator==(const Tensor &lhs, const Tensor &rhs)
 vespalib::string sparseSpec("tensor(x{},y{})");
 vespalib::string denseSpec("tensor(x[2],y[3])");
 vespalib::string vec_2d_spec("tensor(x[2])");
+vespalib::string mixed_2d_spec("tensor(m{},x[2])");
 
 Tensor::UP createTensor(const TensorSpec &spec) {
     auto value = DefaultTensorEngine::ref().from_spec(spec);
@@ -85,6 +91,17 @@ vec_2d(double x0, double x1)
     return TensorSpec(vec_2d_spec).add({{"x", 0}}, x0).add({{"x", 1}}, x1);
 }
 
+TensorSpec
+mixed_2d(const std::vector<DoubleVector>& vectors)
+{
+    TensorSpec result(mixed_2d_spec);
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        vespalib::string label = vespalib::make_string("%zu", i);
+        result.add({{"m", label}, {"x", 0}}, vectors[i][0]).add({{"m", label}, {"x", 1}}, vectors[i][1]);
+    }
+    return result;
+}
+
 class MockIndexSaver : public NearestNeighborIndexSaver {
 private:
     int _index_value;
@@ -224,6 +241,13 @@ class MockNearestNeighborIndexFactory : public NearestNeighborIndexFactory {
         assert(cell_type == ValueType::CellType::DOUBLE);
         return std::make_unique<MockNearestNeighborIndex>(vectors);
     }
+    std::unique_ptr<NearestNeighborIndex> make_multi_vector(const DocVectorAccess& node_vectors,
+                                                            const search::tensor::HnswNodeidMapping&,
+                                                            size_t vector_size,
+                                                            ValueType::CellType cell_type,
+                                                            const search::attribute::HnswIndexParams& params) const override {
+        return make(node_vectors, vector_size, cell_type, params);
+    }
 };
 
 const vespalib::string test_dir = "test_data/";
@@ -299,7 +323,7 @@ struct Fixture {
             assert(_denseTensors);
             return std::make_shared<DenseTensorAttribute>(_name, _cfg, *_index_factory);
         } else {
-            return std::make_shared<GenericTensorAttribute>(_name, _cfg);
+            return std::make_shared<GenericTensorAttribute>(_name, _cfg, *_index_factory);
         }
     }
 
@@ -311,8 +335,8 @@ struct Fixture {
 
     template <typename IndexType>
     IndexType& get_nearest_neighbor_index() {
-        assert(as_dense_tensor().nearest_neighbor_index() != nullptr);
-        auto index = dynamic_cast<const IndexType*>(as_dense_tensor().nearest_neighbor_index());
+        assert(_tensorAttr->nearest_neighbor_index() != nullptr);
+        auto index = dynamic_cast<const IndexType*>(_tensorAttr->nearest_neighbor_index());
         assert(index != nullptr);
         return *const_cast<IndexType*>(index);
     }
@@ -380,10 +404,10 @@ struct Fixture {
         EXPECT_TRUE(saveok);
     }
 
-    void load() {
+    void load(vespalib::ThreadExecutor *executor = nullptr) {
         _tensorAttr = makeAttr();
         _attr = _tensorAttr;
-        bool loadok = _attr->load();
+        bool loadok = _attr->load(executor);
         EXPECT_TRUE(loadok);
     }
 
@@ -667,6 +691,25 @@ TEST_F("Hnsw index is integrated in dense tensor attribute and can be saved and
     expect_level_0(1, index_b.get_node(2));
 }
 
+TEST_F("Hnsw index is reconstructed in bulk by multiple threads when loaded with an executor", DenseTensorAttributeHnswIndex)
+{
+    // Enough points to move the prepare step of adding documents to the executor threads.
+    constexpr uint32_t num_docs = 2000;
+    for (uint32_t docid = 1; docid <= num_docs; ++docid) {
+        f.set_tensor(docid, vec_2d(docid % 47, docid / 47));
+    }
+    f.save();
+    vespalib::unlink(attr_name + ".nnidx");
+
+    vespalib::ThreadStackExecutor executor(4, 128 * 1024);
+    f.load(&executor);
+    auto &index = f.hnsw_index();
+    for (uint32_t docid = 1; docid <= num_docs; ++docid) {
+        EXPECT_GREATER_EQUAL(index.get_node(docid).size(), 1u);
+    }
+    EXPECT_TRUE(index.check_link_symmetry());
+}
+
 class DenseTensorAttributeMockIndex : public Fixture {
 public:
     DenseTensorAttributeMockIndex() : Fixture(vec_2d_spec, true, true, true) {}
@@ -762,6 +805,41 @@ TEST_F("onLoad() reconstructs nearest neighbor index if save file does not exist
     index.expect_adds({{1, {3, 5}}, {2, {7, 9}}});
 }
 
+TEST_F("onLoad() reconstructs nearest neighbor index using the given executor", DenseTensorAttributeMockIndex)
+{
+    f.set_example_tensors();
+    f.save();
+
+    vespalib::ThreadStackExecutor executor(2, 128 * 1024);
+    f.load(&executor);
+    auto& index = f.mock_index();
+    index.expect_adds({{1, {3, 5}}, {2, {7, 9}}});
+}
+
+TEST_F("Documents are added to nearest neighbor index when bulk index build is completed", DenseTensorAttributeMockIndex)
+{
+    auto& index = f.mock_index();
+    auto& attr = const_cast<DenseTensorAttribute&>(f.as_dense_tensor());
+    attr.start_bulk_index_build();
+    f.set_tensor(1, vec_2d(3, 5));
+    f.set_tensor(2, vec_2d(7, 9));
+    f.set_tensor(3, vec_2d(1, 2));
+    f.clearTensor(2);
+    f.set_tensor(3, vec_2d(2, 1));
+    index.expect_empty_add();
+    index.expect_empty_remove();
+
+    vespalib::ThreadStackExecutor executor(2, 128 * 1024);
+    attr.complete_bulk_index_build(&executor);
+    index.expect_adds({{1, {3, 5}}, {3, {2, 1}}});
+    index.expect_empty_remove();
+    index.clear();
+
+    // Back to normal mode
+    f.set_tensor(4, vec_2d(4, 4));
+    index.expect_add(4, {4, 4});
+}
+
 TEST_F("onLoads() ignores saved nearest neighbor index if not enabled in config", DenseTensorAttributeMockIndex)
 {
     f.save_example_tensors_with_mock_index();
@@ -846,6 +924,9 @@ TEST_F("NN blueprint handles empty filter", NearestNeighborBlueprintFixture)
     bp->set_global_filter(*empty_filter);
     EXPECT_EQUAL(3u, bp->getState().estimate().estHits);
     EXPECT_TRUE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::INDEX_TOP_K);
+    EXPECT_EQUAL(8u, bp->get_explore_k());
+    EXPECT_FALSE(bp->get_global_filter_hit_ratio().has_value());
 }
 
 TEST_F("NN blueprint handles strong filter", NearestNeighborBlueprintFixture)
@@ -858,6 +939,8 @@ TEST_F("NN blueprint handles strong filter", NearestNeighborBlueprintFixture)
     bp->set_global_filter(*strong_filter);
     EXPECT_EQUAL(1u, bp->getState().estimate().estHits);
     EXPECT_TRUE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::EXACT_FALLBACK);
+    EXPECT_APPROX(1.0 / 11, bp->get_global_filter_hit_ratio().value(), 0.0001);
 }
 
 TEST_F("NN blueprint handles weak filter", NearestNeighborBlueprintFixture)
@@ -875,6 +958,104 @@ TEST_F("NN blueprint handles weak filter", NearestNeighborBlueprintFixture)
     bp->set_global_filter(*weak_filter);
     EXPECT_EQUAL(3u, bp->getState().estimate().estHits);
     EXPECT_TRUE(bp->may_approximate());
+    EXPECT_TRUE(bp->get_algorithm() == NearestNeighborBlueprint::Algorithm::EXACT_FALLBACK);
+}
+
+class MixedTensorAttributeHnswIndex : public Fixture {
+public:
+    using Hits = std::vector<std::pair<uint32_t, double>>;
+
+    MixedTensorAttributeHnswIndex() : Fixture(mixed_2d_spec, false, true, false) {}
+
+    std::unique_ptr<DenseTensorView> query_tensor(const TensorSpec &spec) {
+        auto tensor = createTensor(spec);
+        auto result = dynamic_cast<DenseTensorView *>(tensor.get());
+        ASSERT_TRUE(result != nullptr);
+        tensor.release();
+        return std::unique_ptr<DenseTensorView>(result);
+    }
+
+    void expect_top_k(const TensorSpec &query, uint32_t k, const Hits &exp_hits) {
+        auto query_view = query_tensor(query);
+        auto hits = hnsw_index().find_top_k(k, query_view->cellsRef(), 10);
+        ASSERT_EQUAL(exp_hits.size(), hits.size());
+        for (size_t i = 0; i < hits.size(); ++i) {
+            EXPECT_EQUAL(exp_hits[i].first, hits[i].docid);
+            EXPECT_EQUAL(exp_hits[i].second, hits[i].distance);
+        }
+    }
+};
+
+TEST_F("Hnsw index over mixed tensor attribute returns each document once, using its closest subspace", MixedTensorAttributeHnswIndex)
+{
+    EXPECT_TRUE(f.hnsw_index().nodeid_mapping() != nullptr);
+    f.set_tensor(1, mixed_2d({{1, 1}, {5, 5}}));
+    f.set_tensor(2, mixed_2d({{3, 3}}));
+    TEST_DO(f.expect_top_k(vec_2d(5, 4), 2, {{1, 1.0}, {2, 5.0}}));
+    TEST_DO(f.expect_top_k(vec_2d(5, 4), 1, {{1, 1.0}}));
+
+    f.set_tensor(1, mixed_2d({{9, 9}}));
+    TEST_DO(f.expect_top_k(vec_2d(5, 4), 2, {{1, 41.0}, {2, 5.0}}));
+    std::vector<vespalib::tensor::TypedCells> vectors;
+    f._tensorAttr->get_vectors(1, vectors);
+    ASSERT_EQUAL(1u, vectors.size());
+    EXPECT_EQUAL(9.0, vectors[0].get(0));
+
+    f.clearTensor(2);
+    TEST_DO(f.expect_top_k(vec_2d(5, 4), 2, {{1, 41.0}}));
+    f._tensorAttr->get_vectors(2, vectors);
+    EXPECT_EQUAL(0u, vectors.size());
+}
+
+TEST_F("Hnsw index over mixed tensor attribute is rebuilt when loaded", MixedTensorAttributeHnswIndex)
+{
+    f.set_tensor(1, mixed_2d({{1, 1}, {5, 5}}));
+    f.set_tensor(2, mixed_2d({{3, 3}}));
+    f.save();
+    EXPECT_FALSE(vespalib::fileExists(attr_name + ".nnidx"));
+    f.load();
+    TEST_DO(f.expect_top_k(vec_2d(5, 4), 2, {{1, 1.0}, {2, 5.0}}));
+}
+
+TEST_F("NN blueprint matches mixed tensor documents by brute force, using distance to closest subspace", MixedTensorAttributeHnswIndex)
+{
+    f.set_tensor(1, mixed_2d({{1, 1}, {5, 5}}));
+    f.set_tensor(2, mixed_2d({{3, 3}}));
+    f.ensureSpace(3);
+    search::queryeval::FieldSpec field("foo", 0, 0);
+    NearestNeighborBlueprint bp(field, *f._tensorAttr, f.query_tensor(vec_2d(5, 4)), 2, false, 0);
+    search::fef::TermFieldMatchData tfmd;
+    search::fef::TermFieldMatchDataArray tfmda;
+    tfmda.add(&tfmd);
+    auto itr = bp.createLeafSearch(tfmda, false);
+    itr->initRange(1, 4);
+    auto dist_fun = search::tensor::make_distance_function(DistanceMetric::Euclidean, ValueType::CellType::DOUBLE);
+    EXPECT_TRUE(itr->seek(1));
+    itr->unpack(1);
+    EXPECT_EQUAL(dist_fun->to_rawscore(1.0), tfmd.getRawScore());
+    EXPECT_TRUE(itr->seek(2));
+    itr->unpack(2);
+    EXPECT_EQUAL(dist_fun->to_rawscore(5.0), tfmd.getRawScore());
+    EXPECT_FALSE(itr->seek(3));
+}
+
+TEST("NN blueprint raises explore_k for filters, bounded by max adjustment")
+{
+    EXPECT_EQUAL(100u, NearestNeighborBlueprint::adjust_explore_k(100, 1.0));
+    EXPECT_EQUAL(200u, NearestNeighborBlueprint::adjust_explore_k(100, 0.5));
+    EXPECT_EQUAL(1000u, NearestNeighborBlueprint::adjust_explore_k(100, 0.1));
+    EXPECT_EQUAL(2000u, NearestNeighborBlueprint::adjust_explore_k(100, 0.01));
+}
+
+TEST("NN blueprint prefers exact search for restrictive filters")
+{
+    EXPECT_TRUE(NearestNeighborBlueprint::prefer_exact_search(0, 1000000, 110));
+    EXPECT_TRUE(NearestNeighborBlueprint::prefer_exact_search(100, 1000000, 110));
+    EXPECT_TRUE(NearestNeighborBlueprint::prefer_exact_search(10000, 1000000, 110));
+    EXPECT_TRUE(NearestNeighborBlueprint::prefer_exact_search(30000, 1000000, 110));
+    EXPECT_FALSE(NearestNeighborBlueprint::prefer_exact_search(50000, 1000000, 110));
+    EXPECT_FALSE(NearestNeighborBlueprint::prefer_exact_search(200000, 1000000, 110));
+    EXPECT_FALSE(NearestNeighborBlueprint::prefer_exact_search(500000, 1000000, 110));
 }
 
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,6 +8,8 @@
 #include <vespa/searchlib/index/field_length_info.h>
 #include <vespa/searchlib/index/postinglisthandle.h>
 #include <vespa/searchlib/diskindex/zcposoccrandread.h>
+#include <vespa/searchlib/diskindex/zcposting.h>
+#include <vespa/searchlib/diskindex/fileheader.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
 #include <vespa/searchlib/index/schemautil.h>
 #include <vespa/searchlib/diskindex/fieldwriter.h>
@@ -31,6 +33,7 @@ using search::diskindex::FieldReader;
 using search::diskindex::FieldWriter;
 using search::diskindex::PageDict4RandRead;
 using search::diskindex::WordNumMapping;
+using search::diskindex::Zc4PostingSeqRead;
 using search::fakedata::FakeWord;
 using search::fakedata::FakeWordSet;
 using search::fef::TermFieldMatchData;
@@ -146,6 +149,7 @@ public:
 private:
     bool _dynamicK;
     bool _encode_interleaved_features;
+    bool _encode_block_max_weight;
     uint32_t _numWordIds;
     uint32_t _docIdLimit;
     vespalib::string _namepref;
@@ -157,6 +161,7 @@ public:
     WrappedFieldWriter(const vespalib::string &namepref,
                        bool dynamicK,
                        bool encoce_cheap_fatures,
+                       bool encode_block_max_weight,
                        uint32_t numWordIds,
                        uint32_t docIdLimit);
     ~WrappedFieldWriter();
@@ -170,11 +175,13 @@ WrappedFieldWriter::~WrappedFieldWriter() {}
 WrappedFieldWriter::WrappedFieldWriter(const vespalib::string &namepref,
                                        bool dynamicK,
                                        bool encode_interleaved_features,
+                                       bool encode_block_max_weight,
                                        uint32_t numWordIds,
                                        uint32_t docIdLimit)
     : _fieldWriter(),
       _dynamicK(dynamicK),
       _encode_interleaved_features(encode_interleaved_features),
+      _encode_block_max_weight(encode_block_max_weight),
       _numWordIds(numWordIds),
       _docIdLimit(docIdLimit),
       _namepref(dirprefix + namepref),
@@ -194,6 +201,7 @@ WrappedFieldWriter::open()
     DummyFileHeaderContext fileHeaderContext;
     fileHeaderContext.disableFileName();
     _fieldWriter = std::make_unique<FieldWriter>(_docIdLimit, _numWordIds);
+    _fieldWriter->set_encode_block_max_weight(_encode_block_max_weight);
     _fieldWriter->open(_namepref,
                        minSkipDocs, minChunkDocs,
                        _dynamicK, _encode_interleaved_features,
@@ -354,19 +362,21 @@ void
 writeField(FakeWordSet &wordSet,
            uint32_t docIdLimit,
            const std::string &namepref,
-           bool dynamicK, bool encode_interleaved_features)
+           bool dynamicK, bool encode_interleaved_features,
+           bool encode_block_max_weight)
 {
     const char *dynamicKStr = dynamicK ? "true" : "false";
 
     LOG(info,
         "enter writeField, "
-        "namepref=%s, dynamicK=%s, encode_interleaved_features=%s",
+        "namepref=%s, dynamicK=%s, encode_interleaved_features=%s, encode_block_max_weight=%s",
         namepref.c_str(),
         dynamicKStr,
-        bool_to_str(encode_interleaved_features));
+        bool_to_str(encode_interleaved_features),
+        bool_to_str(encode_block_max_weight));
     vespalib::Timer tv;
     WrappedFieldWriter ostate(namepref,
-                              dynamicK, encode_interleaved_features,
+                              dynamicK, encode_interleaved_features, encode_block_max_weight,
                               wordSet.getNumWords(), docIdLimit);
     FieldWriter::remove(dirprefix + namepref);
     ostate.open();
@@ -554,7 +564,7 @@ fusionField(uint32_t numWordIds,
         rawStr,
         dynamicKStr, bool_to_str(encode_interleaved_features));
 
-    WrappedFieldWriter ostate(opref, dynamicK, encode_interleaved_features, numWordIds, docIdLimit);
+    WrappedFieldWriter ostate(opref, dynamicK, encode_interleaved_features, false, numWordIds, docIdLimit);
     WrappedFieldReader istate(ipref, numWordIds, docIdLimit);
 
     vespalib::Timer tv;
@@ -590,14 +600,29 @@ fusionField(uint32_t numWordIds,
 }
 
 
+void
+check_posting_formats(const vespalib::string &file_name_prefix, bool encode_block_max_weight)
+{
+    search::diskindex::FileHeader file_header;
+    bool tasted = file_header.taste(dirprefix + file_name_prefix + "posocc.dat.compressed", TuneFileSeqRead());
+    assert(tasted);
+    (void) tasted;
+    // block max weights are flagged with an extra format, rejected by readers not knowing it
+    assert(file_header.getFormats().size() == (encode_block_max_weight ? 3u : 2u));
+    assert(Zc4PostingSeqRead::hasKnownOptionalFormats(file_header.getFormats()));
+}
+
 void
 testFieldWriterVariant(FakeWordSet &wordSet, uint32_t doc_id_limit,
                        const vespalib::string &file_name_prefix,
                        bool dynamic_k,
                        bool encode_interleaved_features,
+                       bool encode_block_max_weight,
                        bool verbose)
 {
-    writeField(wordSet, doc_id_limit, file_name_prefix, dynamic_k, encode_interleaved_features);
+    writeField(wordSet, doc_id_limit, file_name_prefix, dynamic_k, encode_interleaved_features,
+               encode_block_max_weight);
+    check_posting_formats(file_name_prefix, encode_block_max_weight);
     readField(wordSet, doc_id_limit, file_name_prefix, dynamic_k, encode_interleaved_features, verbose);
     randReadField(wordSet, file_name_prefix, dynamic_k, encode_interleaved_features, verbose);
     fusionField(wordSet.getNumWords(),
@@ -617,15 +642,17 @@ testFieldWriterVariants(FakeWordSet &wordSet,
                         uint32_t docIdLimit, bool verbose)
 {
     disableSkip();
-    testFieldWriterVariant(wordSet, docIdLimit, "new4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "new5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "new4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "new5", false, false, false, verbose);
     enableSkip();
-    testFieldWriterVariant(wordSet, docIdLimit, "newskip4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "newskip5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newskip4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newskip5", false, false, false, verbose);
     enableSkipChunks();
-    testFieldWriterVariant(wordSet, docIdLimit, "newchunk4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "newchunk5", false, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "newchunkcf4", true, true, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newchunk4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newchunk5", false, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newchunkcf4", true, true, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newchunkbmw4", true, false, true, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newchunkcfbmw5", false, true, true, verbose);
 }
 
 
@@ -634,14 +661,14 @@ testFieldWriterVariantsWithHighLids(FakeWordSet &wordSet, uint32_t docIdLimit,
                              bool verbose)
 {
     disableSkip();
-    testFieldWriterVariant(wordSet, docIdLimit, "hlid4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "hlid5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlid4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlid5", false, false, false, verbose);
     enableSkip();
-    testFieldWriterVariant(wordSet, docIdLimit, "hlidskip4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "hlidskip5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlidskip4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlidskip5", false, false, false, verbose);
     enableSkipChunks();
-    testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk4", true, false, verbose);
-    testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk4", true, false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk5", false, false, false, verbose);
 }
 
 int
@@ -0,0 +1,86 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using search::engine::SearchReply;
+using search::engine::SearchRequest;
+using document::GlobalId;
+
+SearchReply::Hit make_hit(const char *gid, search::HitRank metric, uint32_t distribution_key) {
+    SearchReply::Hit hit;
+    hit.gid = GlobalId(gid);
+    hit.metric = metric;
+    hit.setDistributionKey(distribution_key);
+    return hit;
+}
+
+struct SearchReplyTest : ::testing::Test {
+    SearchReply reply;
+    SearchReplyTest() : reply() {
+        reply.valid = true;
+        reply.offset = 5;
+        reply.setDistributionKey(7);
+        reply.totalHitCount = 1000;
+        reply.maxRank = 42.0;
+        reply.hits.push_back(make_hit("aaaaaaaaaaaa", 42.0, 7));
+        reply.hits.push_back(make_hit("bbbbbbbbbbbb", 17.0, 7));
+        reply.sortIndex = {0, 3, 6};
+        reply.sortData = {'a', 'b', 'c', 'd', 'e', 'f'};
+        reply.groupResult.push_back('g');
+        reply.coverage.setActive(2000).setCovered(1500).setSoonActive(2500).degradeMatchPhase();
+        reply.useWideHits = true;
+        reply.propertiesMap.lookupCreate("foo").add("bar", "baz");
+        reply.request = std::make_unique<SearchRequest>();
+    }
+    ~SearchReplyTest() override;
+};
+
+SearchReplyTest::~SearchReplyTest() = default;
+
+TEST_F(SearchReplyTest, require_that_clone_copies_results)
+{
+    SearchReply::UP copy = reply.clone();
+    ASSERT_TRUE(copy);
+    EXPECT_TRUE(copy->valid);
+    EXPECT_EQ(copy->offset, 5u);
+    EXPECT_EQ(copy->getDistributionKey(), 7u);
+    EXPECT_EQ(copy->totalHitCount, 1000u);
+    EXPECT_EQ(copy->maxRank, 42.0);
+    ASSERT_EQ(copy->hits.size(), 2u);
+    EXPECT_EQ(copy->hits[0].gid, GlobalId("aaaaaaaaaaaa"));
+    EXPECT_EQ(copy->hits[0].metric, 42.0);
+    EXPECT_EQ(copy->hits[0].getDistributionKey(), 7u);
+    EXPECT_EQ(copy->hits[1].gid, GlobalId("bbbbbbbbbbbb"));
+    EXPECT_EQ(copy->hits[1].metric, 17.0);
+    EXPECT_EQ(copy->sortIndex, reply.sortIndex);
+    EXPECT_EQ(copy->sortData, reply.sortData);
+    ASSERT_EQ(copy->groupResult.size(), 1u);
+    EXPECT_EQ(copy->groupResult[0], 'g');
+    EXPECT_EQ(copy->coverage.getActive(), 2000u);
+    EXPECT_EQ(copy->coverage.getCovered(), 1500u);
+    EXPECT_EQ(copy->coverage.getSoonActive(), 2500u);
+    EXPECT_TRUE(copy->coverage.wasDegradedByMatchPhase());
+    EXPECT_TRUE(copy->useWideHits);
+    EXPECT_EQ(copy->propertiesMap.size(), 1u);
+}
+
+TEST_F(SearchReplyTest, require_that_clone_does_not_copy_request)
+{
+    SearchReply::UP copy = reply.clone();
+    EXPECT_FALSE(copy->request);
+    EXPECT_TRUE(reply.request);
+}
+
+TEST_F(SearchReplyTest, require_that_clone_is_independent_of_original)
+{
+    SearchReply::UP copy = reply.clone();
+    reply.hits.clear();
+    reply.sortData.clear();
+    reply.totalHitCount = 0;
+    EXPECT_EQ(copy->hits.size(), 2u);
+    EXPECT_EQ(copy->sortData.size(), 6u);
+    EXPECT_EQ(copy->totalHitCount, 1000u);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -311,6 +311,14 @@ TEST("test stuff") {
             p.add("vespa.matching.minhitsperthread", "50");
             EXPECT_EQUAL(matching::MinHitsPerThread::lookup(p), 50u);
         }
+        { // vespa.matching.mintimeperthread
+            EXPECT_EQUAL(matching::MinTimePerThread::NAME, vespalib::string("vespa.matching.mintimeperthread"));
+            EXPECT_EQUAL(matching::MinTimePerThread::DEFAULT_VALUE, 0.0);
+            Properties p;
+            EXPECT_EQUAL(matching::MinTimePerThread::lookup(p), 0.0);
+            p.add("vespa.matching.mintimeperthread", "0.005");
+            EXPECT_EQUAL(matching::MinTimePerThread::lookup(p), 0.005);
+        }
         {
             EXPECT_EQUAL(matching::NumSearchPartitions::NAME, vespalib::string("vespa.matching.numsearchpartitions"));
             EXPECT_EQUAL(matching::NumSearchPartitions::DEFAULT_VALUE, 1u);
@@ -2,6 +2,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/searchlib/features/queryfeature.h>
 #include <vespa/searchlib/features/valuefeature.h>
 #include <vespa/searchlib/features/rankingexpressionfeature.h>
 #include <vespa/searchlib/fef/blueprintfactory.h>
@@ -13,6 +14,8 @@
 #include <vespa/searchlib/fef/test/plugin/double.h>
 #include <vespa/searchlib/fef/rank_program.h>
 #include <vespa/searchlib/fef/test/test_features.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+#include <vespa/vespalib/data/slime/slime.h>
 
 using namespace search::fef;
 using namespace search::fef::test;
@@ -80,6 +83,7 @@ struct Fixture {
         factory.addPrototype(Blueprint::SP(new DocidBlueprint()));
         factory.addPrototype(Blueprint::SP(new DoubleBlueprint()));
         factory.addPrototype(Blueprint::SP(new ImpureValueBlueprint()));
+        factory.addPrototype(Blueprint::SP(new QueryBlueprint()));
         factory.addPrototype(Blueprint::SP(new RankingExpressionBlueprint()));
         factory.addPrototype(Blueprint::SP(new SumBlueprint()));
         factory.addPrototype(Blueprint::SP(new TrackingBlueprint(track_cnt)));        
@@ -117,6 +121,13 @@ struct Fixture {
         program.setup(*match_data, queryEnv, overrides);
         return *this;
     }
+    bool rebind(const vespalib::string &key, double value) {
+        MatchDataLayout mdl;
+        QueryEnvironment queryEnv(&indexEnv);
+        queryEnv.getProperties().add(key, vespalib::make_string("%g", value));
+        match_data = mdl.createMatchData();
+        return program.rebind(*match_data, queryEnv);
+    }
     vespalib::string final_executor_name() const {
         size_t n = program.num_executors();
         ASSERT_TRUE(n > 0);
@@ -136,6 +147,12 @@ struct Fixture {
         }
         return 31212.0;
     }
+    std::vector<double> get_batch(const std::vector<uint32_t> &docids) {
+        auto evaluator = program.make_batch_evaluator(docids.size());
+        ASSERT_TRUE(evaluator.get() != nullptr);
+        const search::feature_t *result = evaluator->evaluate(docids);
+        return std::vector<double>(result, result + docids.size());
+    }
     std::map<vespalib::string, double> all(uint32_t docid = default_docid) {
         auto result = program.get_seeds();
         std::map<vespalib::string, double> result_map;
@@ -257,6 +274,30 @@ TEST_F("require that re-used features are only calculated once", Fixture()) {
     EXPECT_EQUAL(f1.track_cnt, 2u);
 }
 
+TEST_F("require that non-const features can be profiled", Fixture()) {
+    f1.add("mysum(ivalue(1),ivalue(2))");
+    ASSERT_TRUE(f1.resolver->compile());
+    ProfiledFeatureExecutor::Profile profile;
+    MatchDataLayout mdl;
+    QueryEnvironment queryEnv(&f1.indexEnv);
+    f1.match_data = mdl.createMatchData();
+    f1.program.setup(*f1.match_data, queryEnv, f1.overrides, &profile);
+    EXPECT_EQUAL(3.0, f1.get(1));
+    EXPECT_EQUAL(3.0, f1.get(2));
+    vespalib::Slime slime;
+    profile.report(slime.setArray());
+    const auto &arr = slime.get();
+    ASSERT_EQUAL(3u, arr.entries());
+    std::map<vespalib::string, int64_t> counts;
+    for (size_t i = 0; i < arr.entries(); ++i) {
+        counts[arr[i]["name"].asString().make_string()] = arr[i]["count"].asLong();
+        EXPECT_LESS_EQUAL(arr[i]["self_ms"].asDouble(), arr[i]["total_ms"].asDouble());
+    }
+    EXPECT_EQUAL(2, counts["mysum(ivalue(1),ivalue(2))"]);
+    EXPECT_EQUAL(2, counts["ivalue(1)"]);
+    EXPECT_EQUAL(2, counts["ivalue(2)"]);
+}
+
 TEST_F("require that overrides of const features work for multiple documents", Fixture()) {
     f1.add("mysum(value(1),docid)").override("value(1)", 10.0).compile();
     EXPECT_EQUAL(3u, f1.program.num_executors());
@@ -391,4 +432,112 @@ TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
 }
 
+TEST_F("require that batch evaluation calculates scores for a block of documents", Fixture()) {
+    f1.add("mysum(value(10),docid)").compile();
+    EXPECT_EQUAL(std::vector<double>({11.0, 12.0, 13.0, 17.0}), f1.get_batch({1, 2, 3, 7}));
+    EXPECT_EQUAL(f1.get(7), 17.0);
+    EXPECT_EQUAL(std::vector<double>({17.0, 18.0}), f1.get_batch({7, 8}));
+}
+
+TEST_F("require that batch evaluation only calculates each feature once per document", Fixture()) {
+    f1.add("track(mysum(track(ivalue(1)),track(ivalue(1))))").compile();
+    EXPECT_EQUAL(std::vector<double>({2.0, 2.0, 2.0}), f1.get_batch({1, 2, 3}));
+    EXPECT_EQUAL(f1.track_cnt, 6u);
+}
+
+TEST_F("require that batch evaluation handles overridden features", Fixture()) {
+    f1.add("mysum(docid,ivalue(1))").override("ivalue(1)", 10.0).compile();
+    EXPECT_EQUAL(std::vector<double>({11.0, 12.0, 15.0}), f1.get_batch({1, 2, 5}));
+}
+
+TEST_F("require that compiled ranking expressions can be batch evaluated", Fixture()) {
+    f1.lazy_expressions(false).add_expr("rank", "docid*2+ivalue(3)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::CompiledRankingExpressionExecutor");
+    EXPECT_EQUAL(std::vector<double>({5.0, 7.0, 13.0}), f1.get_batch({1, 2, 5}));
+}
+
+TEST_F("require that lazy compiled ranking expressions can be batch evaluated", Fixture()) {
+    f1.lazy_expressions(true).add_expr("rank", "if(docid<2,ivalue(1),docid*2+ivalue(3))").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::LazyCompiledRankingExpressionExecutor");
+    EXPECT_EQUAL(std::vector<double>({1.0, 7.0, 13.0}), f1.get_batch({1, 2, 5}));
+}
+
+TEST_F("require that fast-forest gbdt evaluation can be batch evaluated", Fixture()) {
+    f1.use_fast_forest().add_expr("rank", "if(docid<2,1,2)+if(ivalue(2)<1,10,20)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
+    EXPECT_EQUAL(std::vector<double>({21.0, 22.0, 22.0}), f1.get_batch({1, 2, 5}));
+}
+
+TEST_F("require that batch evaluation is not used for features using match data", Fixture()) {
+    f1.add("mysum(double(docid,docid,docid).0,docid)").compile();
+    EXPECT_TRUE(f1.program.make_batch_evaluator(4).get() == nullptr);
+}
+
+TEST_F("require that batch evaluation is not used for const features", Fixture()) {
+    f1.add("mysum(value(1),value(2))").compile();
+    EXPECT_TRUE(f1.program.make_batch_evaluator(4).get() == nullptr);
+}
+
+TEST_F("require that batch evaluation is not used for object features", Fixture()) {
+    f1.add("box(ivalue(10))").compile();
+    EXPECT_TRUE(f1.program.make_batch_evaluator(4).get() == nullptr);
+}
+
+TEST_F("require that batch evaluation is not used for multiple seeds", Fixture()) {
+    f1.add("docid").add("ivalue(1)").compile();
+    EXPECT_TRUE(f1.program.make_batch_evaluator(4).get() == nullptr);
+}
+
+TEST_F("require that rebound programs pick up new query values", Fixture()) {
+    f1.add("mysum(query(foo),docid)").add("mysum(query(foo),value(1))").compile();
+    EXPECT_EQUAL(1.0, f1.get("mysum(query(foo),docid)"));
+    EXPECT_EQUAL(1.0, f1.get("mysum(query(foo),value(1))"));
+    EXPECT_TRUE(f1.rebind("foo", 10.0));
+    EXPECT_EQUAL(11.0, f1.get("mysum(query(foo),docid)"));
+    EXPECT_EQUAL(11.0, f1.get("mysum(query(foo),value(1))"));
+    f1.program.unbind();
+    EXPECT_TRUE(f1.rebind("foo", 20.0));
+    EXPECT_EQUAL(21.0, f1.get("mysum(query(foo),docid)"));
+    EXPECT_EQUAL(21.0, f1.get("mysum(query(foo),value(1))"));
+}
+
+TEST_F("require that rebound programs keep const features const", Fixture()) {
+    f1.add("mysum(query(foo),value(1))").compile();
+    EXPECT_TRUE(f1.rebind("foo", 5.0));
+    EXPECT_EQUAL(6.0, f1.get());
+    EXPECT_EQUAL(3u, count_features(f1.program));
+    EXPECT_EQUAL(3u, count_const_features(f1.program));
+}
+
+TEST_F("require that rebound programs unbox seeds again", Fixture()) {
+    f1.add("box(query(foo))").add("box(mysum(query(foo),docid))").compile();
+    EXPECT_EQUAL(0.0, f1.get("box(query(foo))"));
+    EXPECT_EQUAL(1.0, f1.get("box(mysum(query(foo),docid))"));
+    EXPECT_TRUE(f1.rebind("foo", 3.0));
+    EXPECT_EQUAL(3.0, f1.get("box(query(foo))"));
+    EXPECT_EQUAL(4.0, f1.get("box(mysum(query(foo),docid))"));
+}
+
+TEST_F("require that only executors unable to rebind are created again", Fixture()) {
+    f1.lazy_expressions(false).add_expr("rank", "query(foo)+docid").compile();
+    const FeatureExecutor *expr = &f1.program.get_executor(f1.program.num_executors() - 1);
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::CompiledRankingExpressionExecutor");
+    EXPECT_TRUE(f1.rebind("foo", 2.0));
+    EXPECT_EQUAL(expr, &f1.program.get_executor(f1.program.num_executors() - 1));
+    EXPECT_EQUAL(3.0, f1.get());
+    EXPECT_EQUAL(std::vector<double>({3.0, 4.0, 7.0}), f1.get_batch({1, 2, 5}));
+}
+
+TEST_F("require that programs with overridden features cannot be rebound", Fixture()) {
+    f1.add("mysum(query(foo),docid)").override("docid", 10.0).compile();
+    EXPECT_FALSE(f1.program.can_rebind());
+    EXPECT_FALSE(f1.rebind("foo", 1.0));
+}
+
+TEST_F("require that programs not set up cannot be rebound", Fixture()) {
+    f1.add("mysum(query(foo),docid)");
+    ASSERT_TRUE(f1.resolver->compile());
+    EXPECT_FALSE(f1.rebind("foo", 1.0));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
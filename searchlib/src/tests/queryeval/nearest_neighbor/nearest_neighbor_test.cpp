@@ -204,6 +204,47 @@ TEST("require that NearestNeighborIterator returns filtered results") {
     TEST_DO(verify_iterator_returns_filtered_results(denseSpecFloat, denseSpecFloat));
 }
 
+void
+verify_iterator_returns_expected_results_spanning_several_blocks(const vespalib::string& attribute_tensor_type_spec,
+                                                                  const vespalib::string& query_tensor_type_spec)
+{
+    Fixture fixture(attribute_tensor_type_spec);
+    fixture.ensureSpace(200);
+    // Documents get closer to the query up to docid 150, and are far away after that.
+    for (uint32_t docid = 1; docid <= 200; ++docid) {
+        double x = (docid <= 150) ? (200.0 - docid) : 1000.0;
+        fixture.setTensor(docid, x, 0.0);
+    }
+    auto nullTensor = createTensor(query_tensor_type_spec, 0.0, 0.0);
+    std::vector<uint32_t> all;
+    for (uint32_t docid = 1; docid <= 150; ++docid) {
+        all.push_back(docid);
+    }
+    SimpleResult expect(all);
+    EXPECT_EQUAL(find_matches<true>(fixture, *nullTensor), expect);
+    EXPECT_EQUAL(find_matches<false>(fixture, *nullTensor), expect);
+
+    std::vector<uint32_t> filtered;
+    for (uint32_t docid = 3; docid <= 200; docid += 3) {
+        filtered.push_back(docid);
+    }
+    fixture.setFilter(filtered);
+    std::vector<uint32_t> filtered_hits;
+    for (uint32_t docid : filtered) {
+        if (docid <= 150) {
+            filtered_hits.push_back(docid);
+        }
+    }
+    SimpleResult filtered_expect(filtered_hits);
+    EXPECT_EQUAL(find_matches<true>(fixture, *nullTensor), filtered_expect);
+    EXPECT_EQUAL(find_matches<false>(fixture, *nullTensor), filtered_expect);
+}
+
+TEST("require that NearestNeighborIterator returns expected results when spanning several blocks") {
+    TEST_DO(verify_iterator_returns_expected_results_spanning_several_blocks(denseSpecDouble, denseSpecDouble));
+    TEST_DO(verify_iterator_returns_expected_results_spanning_several_blocks(denseSpecFloat, denseSpecFloat));
+}
+
 template <bool strict>
 std::vector<feature_t> get_rawscores(Fixture &env, const DenseTensorView &qtv) {
     auto md = MatchData::makeTestInstance(2, 2);
@@ -578,6 +578,88 @@ TEST_FF("require that threshold boosting works as expected", ThresholdBoostFixtu
                  .doc(4).score(4200), f2.result);
 }
 
+/**
+ * Posting list iterator split into blocks of 2 documents, exposing
+ * the max weight of each block (when enabled).
+ **/
+struct BlockMaxSearch : public SearchIterator, public IBlockMaxWeight
+{
+    std::vector<std::pair<uint32_t, int32_t>> docs;
+    TermFieldMatchData &tfmd;
+    MinMaxPostingInfo postingInfo;
+    bool use_block_max;
+    size_t pos;
+    size_t &unpack_cnt;
+    BlockMaxSearch(std::vector<std::pair<uint32_t, int32_t>> docs_in, TermFieldMatchData &tfmd_in,
+                   bool use_block_max_in, size_t &unpack_cnt_in)
+        : docs(std::move(docs_in)), tfmd(tfmd_in), postingInfo(0, 0),
+          use_block_max(use_block_max_in), pos(0), unpack_cnt(unpack_cnt_in)
+    {
+        for (const auto &doc: docs) {
+            postingInfo = MinMaxPostingInfo(0, std::max(postingInfo.getMaxWeight(), doc.second));
+        }
+    }
+    void doSeek(uint32_t docid) override {
+        while ((pos < docs.size()) && (docs[pos].first < docid)) {
+            ++pos;
+        }
+        if (pos < docs.size()) {
+            setDocId(docs[pos].first);
+        } else {
+            setAtEnd();
+        }
+    }
+    void doUnpack(uint32_t docid) override {
+        ++unpack_cnt;
+        tfmd.reset(docid);
+        tfmd.appendPosition(search::fef::TermFieldMatchDataPosition(0, 0, docs[pos].second, 1));
+    }
+    const PostingInfo *getPostingInfo() const override { return &postingInfo; }
+    uint32_t get_block_end() const override {
+        if (!use_block_max) {
+            return getDocId();
+        }
+        return docs[std::min(pos | 1, docs.size() - 1)].first;
+    }
+    int32_t get_block_max_weight() const override {
+        if (!use_block_max) {
+            return std::numeric_limits<int32_t>::max();
+        }
+        size_t first = (pos & ~size_t(1));
+        size_t last = std::min(pos | 1, docs.size() - 1);
+        return std::max(docs[first].second, docs[last].second);
+    }
+};
+
+struct BlockMaxFixture
+{
+    SharedWeakAndPriorityQueue heap;
+    TermFieldMatchData rootMatchData;
+    size_t unpack_cnt;
+    FakeResult result;
+    BlockMaxFixture(bool use_block_max)
+        : heap(1), rootMatchData(), unpack_cnt(0), result()
+    {
+        MatchData::UP childrenMatchData(MatchData::makeTestInstance(1, 1));
+        wand::Terms terms;
+        terms.push_back(wand::Term(new BlockMaxSearch({{1, 1}, {2, 1}, {3, 1}, {4, 1}, {5, 1}, {6, 1}, {7, 100}, {8, 1}},
+                                                      *childrenMatchData->resolveTermField(0), use_block_max, unpack_cnt),
+                                   1, 8, childrenMatchData->resolveTermField(0)));
+        SearchIterator::UP search(ParallelWeakAndSearch::create(terms, MatchParams(heap, 50, 1.0, 1),
+                                                                RankParams(rootMatchData, std::move(childrenMatchData)),
+                                                                true));
+        result = doSearch(*search, rootMatchData);
+    }
+};
+
+TEST_FF("require that block max weights are used to skip posting blocks", BlockMaxFixture(false), BlockMaxFixture(true))
+{
+    EXPECT_EQUAL(FakeResult().doc(7).score(100), f1.result);
+    EXPECT_EQUAL(FakeResult().doc(7).score(100), f2.result);
+    EXPECT_EQUAL(7u, f1.unpack_cnt);
+    EXPECT_EQUAL(1u, f2.unpack_cnt);
+}
+
 TEST_F("require that asString() on blueprint works", BlueprintAsStringFixture)
 {
     Node::UP term = f.spec.createNode(57, 67);
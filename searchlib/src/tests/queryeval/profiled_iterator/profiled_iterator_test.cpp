@@ -0,0 +1,124 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/queryeval/andsearch.h>
+#include <vespa/searchlib/queryeval/orsearch.h>
+#include <vespa/searchlib/queryeval/profiled_iterator.h>
+#include <vespa/searchlib/queryeval/simpleresult.h>
+#include <vespa/searchlib/queryeval/simplesearch.h>
+#include <vespa/searchlib/queryeval/termwise_search.h>
+#include <vespa/searchlib/queryeval/weighted_set_term_search.h>
+#include <vespa/searchlib/fef/matchdata.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace search::queryeval;
+using search::fef::MatchData;
+using search::fef::TermFieldMatchData;
+using vespalib::Slime;
+using vespalib::slime::Inspector;
+
+SearchIterator::UP make_search(bool strict) {
+    return AndSearch::create({std::make_unique<SimpleSearch>(SimpleResult().addHit(2).addHit(4).addHit(8).addHit(16)),
+                              OrSearch::create({std::make_unique<SimpleSearch>(SimpleResult().addHit(4).addHit(10)),
+                                                std::make_unique<SimpleSearch>(SimpleResult().addHit(8).addHit(16).addHit(20))},
+                                               strict)},
+                             strict);
+}
+
+SimpleResult search_and_unpack(SearchIterator &search) {
+    SimpleResult result;
+    search.initRange(1, 100);
+    for (uint32_t docid = 1; docid < 100; ++docid) {
+        if (search.seek(docid)) {
+            search.unpack(docid);
+            result.addHit(docid);
+        }
+    }
+    return result;
+}
+
+const Inspector &report(const ProfiledIterator::Profile &profile, Slime &slime) {
+    profile.report(slime.setObject());
+    return slime.get();
+}
+
+TEST(ProfiledIteratorTest, profiled_iterator_tree_gives_same_result)
+{
+    ProfiledIterator::Profile profile(1);
+    auto search = profile.profile(make_search(true));
+    EXPECT_TRUE(dynamic_cast<ProfiledIterator *>(search.get()) != nullptr);
+    EXPECT_EQ(search_and_unpack(*search), SimpleResult().addHit(4).addHit(8).addHit(16));
+}
+
+TEST(ProfiledIteratorTest, all_iterators_in_the_tree_are_profiled)
+{
+    ProfiledIterator::Profile profile(1);
+    auto search = profile.profile(make_search(true));
+    search_and_unpack(*search);
+    Slime slime;
+    const Inspector &obj = report(profile, slime);
+    EXPECT_EQ(obj["sample_interval"].asLong(), 1);
+    ASSERT_EQ(obj["roots"].entries(), 1u);
+    const Inspector &root = obj["roots"][0];
+    EXPECT_NE(root["type"].asString().make_string().find("AndSearch"), vespalib::string::npos);
+    EXPECT_EQ(root["hits"].asLong(), 3);
+    EXPECT_EQ(root["unpacks"].asLong(), 3);
+    EXPECT_GE(root["seeks"].asLong(), 3);
+    EXPECT_GE(root["seek_ms"].asDouble(), 0.0);
+    ASSERT_EQ(root["children"].entries(), 2u);
+    EXPECT_EQ(root["children"][0]["unpacks"].asLong(), 3);
+    EXPECT_EQ(root["children"][0]["children"].entries(), 0u);
+    const Inspector &child = root["children"][1];
+    EXPECT_NE(child["type"].asString().make_string().find("OrLikeSearch"), vespalib::string::npos);
+    EXPECT_EQ(child["unpacks"].asLong(), 3);
+    ASSERT_EQ(child["children"].entries(), 2u);
+    EXPECT_EQ(child["children"][0]["unpacks"].asLong(), 1);
+    EXPECT_EQ(child["children"][1]["unpacks"].asLong(), 2);
+}
+
+TEST(ProfiledIteratorTest, trees_profiled_more_than_once_share_stats)
+{
+    ProfiledIterator::Profile profile(1);
+    search_and_unpack(*profile.profile(make_search(true)));
+    search_and_unpack(*profile.profile(make_search(true)));
+    Slime slime;
+    const Inspector &obj = report(profile, slime);
+    ASSERT_EQ(obj["roots"].entries(), 1u);
+    EXPECT_EQ(obj["roots"][0]["unpacks"].asLong(), 6);
+    EXPECT_EQ(obj["roots"][0]["children"][1]["children"][1]["unpacks"].asLong(), 4);
+}
+
+TEST(ProfiledIteratorTest, only_some_calls_are_timed_when_sampling)
+{
+    ProfiledIterator::Profile profile(1000);
+    auto search = profile.profile(make_search(false));
+    EXPECT_EQ(search_and_unpack(*search), SimpleResult().addHit(4).addHit(8).addHit(16));
+    Slime slime;
+    const Inspector &root = report(profile, slime)["roots"][0];
+    EXPECT_EQ(root["unpacks"].asLong(), 3);
+    EXPECT_GT(root["seeks"].asLong(), 1);
+    EXPECT_GE(root["seek_ms"].asDouble(), 0.0);
+}
+
+TEST(ProfiledIteratorTest, children_of_termwise_and_weighted_set_iterators_are_profiled)
+{
+    TermFieldMatchData tfmd;
+    std::vector<SearchIterator *> wset_children({new SimpleSearch(SimpleResult().addHit(4).addHit(10)),
+                                                 new SimpleSearch(SimpleResult().addHit(8).addHit(16).addHit(20))});
+    auto wset = WeightedSetTermSearch::create(wset_children, tfmd, {1, 2}, MatchData::UP(nullptr));
+    auto search = make_termwise(AndSearch::create({std::make_unique<SimpleSearch>(SimpleResult().addHit(2).addHit(4).addHit(8).addHit(16)),
+                                                   std::move(wset)}, true), true);
+    ProfiledIterator::Profile profile(1);
+    EXPECT_EQ(search_and_unpack(*profile.profile(std::move(search))), SimpleResult().addHit(4).addHit(8).addHit(16));
+    Slime slime;
+    const Inspector &root = report(profile, slime)["roots"][0];
+    EXPECT_NE(root["type"].asString().make_string().find("TermwiseSearch"), vespalib::string::npos);
+    EXPECT_EQ(root["hits"].asLong(), 3);
+    ASSERT_EQ(root["children"].entries(), 1u);
+    ASSERT_EQ(root["children"][0]["children"].entries(), 2u);
+    const Inspector &child = root["children"][0]["children"][1];
+    EXPECT_NE(child["type"].asString().make_string().find("WeightedSetTermSearch"), vespalib::string::npos);
+    EXPECT_EQ(child["children"].entries(), 2u);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -73,6 +73,91 @@ TEST(DistanceFunctionsTest, gives_expected_score)
     EXPECT_LT(a44, 0.000001);
 }
 
+TEST(DistanceFunctionsTest, int8_cells_give_expected_score)
+{
+    auto ct = vespalib::eval::ValueType::CellType::INT8;
+
+    auto euclid = make_distance_function(DistanceMetric::Euclidean, ct);
+    auto angular = make_distance_function(DistanceMetric::Angular, ct);
+
+    std::vector<int8_t> p1{100, 0, 0};
+    std::vector<int8_t> p2{0, -3, 4};
+    std::vector<int8_t> p3{2, 2, 0};
+    std::vector<int8_t> p4{-7, 0, 0};
+    TypedCells t1(p1), t2(p2), t3(p3), t4(p4);
+
+    EXPECT_EQ(euclid->calc(t1, t2), 10025.0);
+    EXPECT_EQ(euclid->calc(t2, t3), 45.0);
+    EXPECT_EQ(euclid->calc_with_limit(t2, t3, 1000.0), 45.0);
+    EXPECT_EQ(euclid->calc(t1, t1), 0.0);
+
+    EXPECT_EQ(angular->calc(t1, t2), 1.0);
+    EXPECT_EQ(angular->calc(t1, t4), 2.0);
+    double a13 = angular->calc(t1, t3);
+    EXPECT_GT(a13, 0.999999 - M_SQRT1_2);
+    EXPECT_LT(a13, 1.000001 - M_SQRT1_2);
+    double a33 = angular->calc(t3, t3);
+    EXPECT_GE(a33, 0.0);
+    EXPECT_LT(a33, 0.000001);
+}
+
+TEST(DistanceFunctionsTest, bfloat16_cells_give_expected_score)
+{
+    using vespalib::BFloat16;
+    auto ct = vespalib::eval::ValueType::CellType::BFLOAT16;
+
+    auto euclid = make_distance_function(DistanceMetric::Euclidean, ct);
+    auto angular = make_distance_function(DistanceMetric::Angular, ct);
+
+    std::vector<BFloat16> p1{1.0f, 0.0f, 0.0f};
+    std::vector<BFloat16> p2{0.0f, 1.0f, 0.0f};
+    std::vector<BFloat16> p3{0.5f, 0.5f, 0.0f};
+    std::vector<BFloat16> p4{0.0f, -1.0f, 0.0f};
+    TypedCells t1(p1), t2(p2), t3(p3), t4(p4);
+
+    EXPECT_EQ(euclid->calc(t1, t2), 2.0);
+    EXPECT_EQ(euclid->calc(t1, t3), 0.5);
+    EXPECT_EQ(euclid->calc_with_limit(t1, t3, 1.0), 0.5);
+
+    EXPECT_EQ(angular->calc(t1, t2), 1.0);
+    EXPECT_EQ(angular->calc(t1, t3), 0.5);
+    EXPECT_EQ(angular->calc(t2, t4), 2.0);
+}
+
+void verify_calc_many(DistanceMetric metric, vespalib::eval::ValueType::CellType ct)
+{
+    auto dist_fun = make_distance_function(metric, ct);
+    std::vector<float> lhs_f{0.6, 0.8, 0.0};
+    std::vector<double> lhs_d{0.6, 0.8, 0.0};
+    std::vector<std::vector<float>> rhs_f;
+    std::vector<std::vector<double>> rhs_d;
+    for (size_t i = 0; i < 40; ++i) {
+        double x = (i % 7) * 0.1;
+        double y = (i % 5) * 0.2;
+        rhs_f.push_back({float(x), float(y), float(1.0 - x)});
+        rhs_d.push_back({x, y, 1.0 - x});
+    }
+    bool use_float = (ct == vespalib::eval::ValueType::CellType::FLOAT);
+    TypedCells lhs = use_float ? TypedCells(lhs_f) : TypedCells(lhs_d);
+    std::vector<TypedCells> rhs;
+    for (size_t i = 0; i < rhs_d.size(); ++i) {
+        rhs.push_back(use_float ? TypedCells(rhs_f[i]) : TypedCells(rhs_d[i]));
+    }
+    std::vector<double> result(rhs.size());
+    dist_fun->calc_many(lhs, rhs.data(), rhs.size(), result.data());
+    for (size_t i = 0; i < rhs.size(); ++i) {
+        EXPECT_DOUBLE_EQ(dist_fun->calc(lhs, rhs[i]), result[i]);
+    }
+}
+
+TEST(DistanceFunctionsTest, calc_many_gives_same_distances_as_calc)
+{
+    for (auto ct : {vespalib::eval::ValueType::CellType::FLOAT, vespalib::eval::ValueType::CellType::DOUBLE}) {
+        verify_calc_many(DistanceMetric::Euclidean, ct);
+        verify_calc_many(DistanceMetric::Angular, ct);
+    }
+}
+
 TEST(GeoDegreesTest, gives_expected_score)
 {
     auto ct = vespalib::eval::ValueType::CellType::DOUBLE;
@@ -5,6 +5,7 @@
 #include <vespa/searchlib/tensor/distance_functions.h>
 #include <vespa/searchlib/tensor/doc_vector_access.h>
 #include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/hnsw_nodeid_mapping.h>
 #include <vespa/searchlib/tensor/random_level_generator.h>
 #include <vespa/searchlib/tensor/inv_log_level_generator.h>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -21,6 +22,7 @@ using namespace search::tensor;
 using namespace vespalib::slime;
 using vespalib::Slime;
 using search::BitVector;
+using search::attribute::DistanceMetric;
 
 
 template <typename FloatType>
@@ -77,12 +79,18 @@ public:
 
     ~HnswIndexTest() {}
 
-    void init(bool heuristic_select_neighbors) {
+    void init(bool heuristic_select_neighbors, bool quantized_vectors = false,
+              const HnswNodeidMapping* nodeid_mapping = nullptr) {
         auto generator = std::make_unique<LevelGenerator>();
         level_generator = generator.get();
+        std::unique_ptr<QuantizedVectorStore> quantized;
+        if (quantized_vectors) {
+            quantized = std::make_unique<QuantizedVectorStore>(2, DistanceMetric::Euclidean);
+        }
         index = std::make_unique<HnswIndex>(vectors, std::make_unique<FloatSqEuclideanDistance>(),
                                             std::move(generator),
-                                            HnswIndex::Config(5, 2, 10, heuristic_select_neighbors));
+                                            HnswIndex::Config(5, 2, 10, heuristic_select_neighbors),
+                                            std::move(quantized), nodeid_mapping);
     }
     void add_document(uint32_t docid, uint32_t max_level = 0) {
         level_generator->level = max_level;
@@ -366,6 +374,105 @@ TEST_F(HnswIndexTest, 2d_vectors_inserted_in_hierarchic_graph_with_heuristic_sel
     }
 }
 
+TEST_F(HnswIndexTest, quantized_vectors_are_used_for_search_and_hits_are_reranked)
+{
+    init(true, true);
+    ASSERT_TRUE(index->quantized_vectors() != nullptr);
+    for (uint32_t docid = 1; docid < 10; ++docid) {
+        add_document(docid);
+    }
+    auto qv = vectors.get_vector(5);
+    auto hits = index->find_top_k(3, qv, 10);
+    ASSERT_EQ(3, hits.size());
+    EXPECT_EQ(5, hits[0].docid);
+    EXPECT_EQ(6, hits[1].docid);
+    EXPECT_EQ(9, hits[2].docid);
+    // Distances are exact after re-ranking
+    EXPECT_DOUBLE_EQ(0.0, hits[0].distance);
+    EXPECT_DOUBLE_EQ(2.0, hits[1].distance);
+    EXPECT_DOUBLE_EQ(20.0, hits[2].distance);
+
+    remove_document(6);
+    hits = index->find_top_k(3, qv, 10);
+    ASSERT_EQ(3, hits.size());
+    EXPECT_EQ(2, hits[0].docid);
+    EXPECT_EQ(5, hits[1].docid);
+    EXPECT_EQ(9, hits[2].docid);
+    EXPECT_DOUBLE_EQ(26.0, hits[0].distance);
+}
+
+TEST_F(HnswIndexTest, documents_with_several_nodes_are_returned_once_with_distance_of_closest_node)
+{
+    HnswNodeidMapping mapping;
+    init(true, false, &mapping);
+    // Node ids are allocated in sequence, and the vectors of the nodes are given by the fixture.
+    auto ids = mapping.allocate_ids(10, 2);
+    EXPECT_EQ(std::vector<uint32_t>({1, 2}), std::vector<uint32_t>(ids.begin(), ids.end()));
+    mapping.allocate_ids(11, 3);
+    mapping.allocate_ids(12, 2);
+    EXPECT_EQ(11, mapping.get_docid(4));
+    for (uint32_t nodeid = 1; nodeid <= 7; ++nodeid) {
+        add_document(nodeid);
+    }
+    auto qv = vectors.get_vector(1);
+    auto hits = index->find_top_k(2, qv, 10);
+    ASSERT_EQ(2, hits.size());
+    EXPECT_EQ(10, hits[0].docid);
+    EXPECT_EQ(11, hits[1].docid);
+    EXPECT_DOUBLE_EQ(0.0, hits[0].distance);
+    EXPECT_DOUBLE_EQ(1.0, hits[1].distance);
+
+    hits = index->find_top_k(5, qv, 10);
+    ASSERT_EQ(3, hits.size());
+    EXPECT_EQ(12, hits[2].docid);
+    EXPECT_DOUBLE_EQ(10.0, hits[2].distance);
+
+    auto filter = BitVector::create(13);
+    filter->setBit(11);
+    filter->setBit(12);
+    hits = index->find_top_k_with_filter(2, qv, *filter, 10);
+    ASSERT_EQ(2, hits.size());
+    EXPECT_EQ(11, hits[0].docid);
+    EXPECT_EQ(12, hits[1].docid);
+
+    for (uint32_t nodeid : mapping.get_ids(11)) {
+        remove_document(nodeid);
+    }
+    mapping.free_ids(11);
+    EXPECT_EQ(0, mapping.get_docid(4));
+    hits = index->find_top_k(3, qv, 10);
+    ASSERT_EQ(2, hits.size());
+    EXPECT_EQ(10, hits[0].docid);
+    EXPECT_EQ(12, hits[1].docid);
+}
+
+TEST(HnswNodeidMappingTest, freed_node_ids_are_reused_after_hold_lists_are_trimmed)
+{
+    HnswNodeidMapping mapping;
+    auto ids = mapping.allocate_ids(5, 2);
+    EXPECT_EQ(std::vector<uint32_t>({1, 2}), std::vector<uint32_t>(ids.begin(), ids.end()));
+    mapping.free_ids(5);
+    EXPECT_EQ(0, mapping.get_ids(5).size());
+    mapping.transfer_hold_lists(1);
+    ids = mapping.allocate_ids(6, 1);
+    EXPECT_EQ(3, ids[0]);
+    mapping.trim_hold_lists(2);
+    ids = mapping.allocate_ids(7, 2);
+    EXPECT_EQ(std::vector<uint32_t>({2, 1}), std::vector<uint32_t>(ids.begin(), ids.end()));
+    EXPECT_EQ(7, mapping.get_docid(1));
+    EXPECT_EQ(6, mapping.get_docid(3));
+    EXPECT_EQ(4, mapping.nodeid_limit());
+}
+
+TEST_F(HnswIndexTest, quantized_vectors_use_memory)
+{
+    init(false, false);
+    auto plain_usage = memory_usage();
+    init(false, true);
+    auto quantized_usage = memory_usage();
+    EXPECT_GT(quantized_usage.allocatedBytes(), plain_usage.allocatedBytes());
+}
+
 TEST_F(HnswIndexTest, manual_insert)
 {
     init(false);
@@ -444,6 +551,90 @@ TEST_F(HnswIndexTest, memory_is_put_on_hold_while_read_guard_is_held)
     EXPECT_EQ(0, mem.allocatedBytesOnHold());
 }
 
+TEST_F(HnswIndexTest, poorly_connected_nodes_are_repaired_incrementally)
+{
+    init(false);
+
+    std::vector<uint32_t> nbl;
+    HnswNode empty{nbl};
+    index->set_node(1, empty);
+    std::vector<uint32_t> one{1};
+    HnswNode two{one};
+    index->set_node(2, two);
+    HnswNode three{{1,2}};
+    index->set_node(3, three);
+    index->set_node(4, empty);
+    EXPECT_EQ(3, index->count_reachable_nodes());
+
+    EXPECT_TRUE(index->repair_graph(2));
+    EXPECT_EQ(0, index->maintenance_stats().nodes_repaired);
+    EXPECT_FALSE(index->repair_graph(2));
+    commit();
+    const auto& stats = index->maintenance_stats();
+    EXPECT_EQ(4, stats.nodes_checked);
+    EXPECT_EQ(1, stats.nodes_repaired);
+    EXPECT_EQ(1, stats.repair_passes);
+    EXPECT_EQ(0, stats.repair_cursor);
+
+    expect_level_0(4, {1,3});
+    expect_level_0(1, {2,3,4});
+    EXPECT_TRUE(index->check_link_symmetry());
+    EXPECT_EQ(4, index->count_reachable_nodes());
+}
+
+TEST_F(HnswIndexTest, maintenance_progress_is_shown_in_state)
+{
+    init(false);
+    add_document(1);
+    add_document(2);
+    EXPECT_FALSE(index->maintain());
+    commit();
+    Slime actualSlime;
+    SlimeInserter inserter(actualSlime);
+    index->get_state(inserter);
+    const auto& root = actualSlime.get();
+    EXPECT_EQ(2, root["maintenance"]["nodes_checked"].asLong());
+    EXPECT_EQ(1, root["maintenance"]["repair_passes"].asLong());
+    EXPECT_EQ(0, root["maintenance"]["compactions"].asLong());
+}
+
+TEST(HnswGraphTest, compaction_moves_link_arrays_to_new_buffers)
+{
+    using V = std::vector<uint32_t>;
+    HnswGraph graph;
+    GenerationHandler gen_handler;
+    auto commit = [&]() {
+        graph.nodes.transferHoldLists(gen_handler.getCurrentGeneration());
+        graph.links.transferHoldLists(gen_handler.getCurrentGeneration());
+        gen_handler.incGeneration();
+        gen_handler.updateFirstUsedGeneration();
+        graph.nodes.trimHoldLists(gen_handler.getFirstUsedGeneration());
+        graph.links.trimHoldLists(gen_handler.getFirstUsedGeneration());
+    };
+    for (uint32_t docid = 1; docid < 1000; ++docid) {
+        graph.make_node_for_document(docid, 1);
+        graph.set_link_array(docid, 0, V{docid - 1});
+    }
+    // Most single link arrays are replaced by larger arrays, leaving the first buffer mostly dead.
+    for (uint32_t docid = 1; docid < 1000; ++docid) {
+        if (docid % 4 != 0) {
+            graph.set_link_array(docid, 0, V{docid - 1, docid + 1});
+        }
+    }
+    commit();
+    auto before = graph.links.getMemoryUsage();
+    graph.compact_link_arrays();
+    graph.compact_level_arrays();
+    commit();
+    auto after = graph.links.getMemoryUsage();
+    EXPECT_LT(after.deadBytes(), before.deadBytes());
+    for (uint32_t docid = 1; docid < 1000; ++docid) {
+        auto links = graph.get_link_array(docid, 0);
+        V exp_links = (docid % 4 != 0) ? V{docid - 1, docid + 1} : V{docid - 1};
+        EXPECT_EQ(exp_links, V(links.begin(), links.end()));
+    }
+}
+
 TEST_F(HnswIndexTest, shrink_called_simple)
 {
     init(false);
@@ -3,6 +3,7 @@
 #include <vespa/searchlib/tensor/hnsw_graph.h>
 #include <vespa/searchlib/tensor/hnsw_index_saver.h>
 #include <vespa/searchlib/tensor/hnsw_index_loader.h>
+#include <vespa/searchlib/tensor/mapped_hnsw_graph.h>
 #include <vespa/searchlib/util/bufferwriter.h>
 #include <vespa/searchlib/util/fileutil.h>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -72,13 +73,15 @@ public:
     HnswGraph original;
     HnswGraph copy;
 
+    std::vector<char> mapped_data;
+    std::unique_ptr<LoadedBuffer> mapped_buffer;
+
     void expect_empty_d(uint32_t docid) const {
-        EXPECT_FALSE(copy.node_refs[docid].load_acquire().valid());
+        EXPECT_FALSE(copy.has_node(docid));
     }
 
     void expect_level_0(uint32_t docid, const V& exp_links) const {
-        auto levels = copy.get_level_array(docid);
-        EXPECT_GE(levels.size(), 1);
+        EXPECT_GE(copy.num_levels(docid), 1);
         auto links = copy.get_link_array(docid, 0);
         EXPECT_EQ(exp_links.size(), links.size());
         for (size_t i = 0; i < exp_links.size() && i < links.size(); ++i) {
@@ -87,8 +90,7 @@ public:
     }
 
     void expect_level_1(uint32_t docid, const V& exp_links) const {
-        auto levels = copy.get_level_array(docid);
-        EXPECT_EQ(2, levels.size());
+        EXPECT_EQ(2, copy.num_levels(docid));
         auto links = copy.get_link_array(docid, 1);
         EXPECT_EQ(exp_links.size(), links.size());
         for (size_t i = 0; i < exp_links.size() && i < links.size(); ++i) {
@@ -105,7 +107,15 @@ public:
     void load_copy(std::vector<char> data) {
         HnswIndexLoader loader(copy);
         LoadedBuffer buffer(&data[0], data.size());
-        loader.load(buffer);
+        EXPECT_TRUE(loader.load(buffer));
+    }
+    void map_copy(std::vector<char> data) {
+        mapped_data = std::move(data);
+        mapped_buffer = std::make_unique<LoadedBuffer>(&mapped_data[0], mapped_data.size());
+        ASSERT_TRUE(MappedHnswGraph::is_flat_format(*mapped_buffer));
+        auto mapped = std::make_shared<MappedHnswGraph>(*mapped_buffer);
+        ASSERT_TRUE(mapped->valid());
+        copy.set_mapped(std::move(mapped));
     }
 
     void expect_copy_as_populated() const {
@@ -148,4 +158,70 @@ TEST_F(CopyGraphTest, later_changes_ignored)
     expect_copy_as_populated();
 }
 
+TEST_F(CopyGraphTest, serves_graph_from_mapped_buffer)
+{
+    populate(original);
+    auto data = save_original();
+    map_copy(data);
+    expect_copy_as_populated();
+    EXPECT_TRUE(copy.is_mapped_node(1));
+    EXPECT_FALSE(copy.node_refs[1].load_acquire().valid());
+}
+
+TEST_F(CopyGraphTest, mapped_nodes_are_copied_when_changed)
+{
+    populate(original);
+    map_copy(save_original());
+    copy.set_link_array(4, 1, V{7});
+    EXPECT_FALSE(copy.is_mapped_node(4));
+    EXPECT_TRUE(copy.node_refs[4].load_acquire().valid());
+    expect_level_0(4, {1, 2, 6});
+    expect_level_1(4, {7});
+    copy.remove_node_for_document(6);
+    copy.remove_node_for_document(2);
+    expect_empty_d(6);
+    expect_empty_d(2);
+    EXPECT_TRUE(copy.is_mapped_node(1));
+    expect_level_0(1, {2, 4, 6});
+    copy.make_node_for_document(2, 1);
+    copy.set_link_array(2, 0, V{1});
+    expect_level_0(2, {1});
+}
+
+TEST_F(CopyGraphTest, saves_graph_with_mapped_nodes)
+{
+    populate(original);
+    map_copy(save_original());
+    copy.set_link_array(6, 0, V{1, 2});
+    HnswIndexSaver saver(copy);
+    VectorBufferWriter vector_writer;
+    saver.save(vector_writer);
+    HnswGraph reloaded;
+    HnswIndexLoader loader(reloaded);
+    LoadedBuffer buffer(&vector_writer.output[0], vector_writer.output.size());
+    ASSERT_TRUE(loader.load(buffer));
+    EXPECT_EQ(2, reloaded.get_entry_node().docid);
+    auto links = reloaded.get_link_array(6, 0);
+    EXPECT_EQ(V({1, 2}), V(links.begin(), links.end()));
+    links = reloaded.get_link_array(2, 1);
+    EXPECT_EQ(V({4}), V(links.begin(), links.end()));
+}
+
+TEST_F(CopyGraphTest, loads_legacy_format)
+{
+    // entry docid, entry level, num nodes, and for each node: num levels, and for each level: num links + links
+    V legacy = {2, 1, 7,
+                0,
+                1, 3, 2, 4, 6,
+                2, 3, 1, 4, 6, 1, 4,
+                0,
+                2, 3, 1, 2, 6, 1, 2,
+                0,
+                1, 3, 1, 2, 4};
+    std::vector<char> data(legacy.size() * sizeof(uint32_t));
+    memcpy(&data[0], &legacy[0], data.size());
+    load_copy(data);
+    expect_copy_as_populated();
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
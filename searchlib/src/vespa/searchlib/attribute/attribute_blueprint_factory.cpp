@@ -30,7 +30,7 @@
 #include <vespa/searchlib/queryeval/wand/parallel_weak_and_search.h>
 #include <vespa/searchlib/queryeval/weighted_set_term_blueprint.h>
 #include <vespa/searchlib/queryeval/weighted_set_term_search.h>
-#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
 #include <vespa/vespalib/util/regexp.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <sstream>
@@ -74,7 +74,7 @@ using search::queryeval::SearchIterator;
 using search::queryeval::Searchable;
 using search::queryeval::SimpleLeafBlueprint;
 using search::queryeval::WeightedSetTermBlueprint;
-using search::tensor::DenseTensorAttribute;
+using search::tensor::TensorAttribute;
 using vespalib::geo::ZCurve;
 using vespalib::make_string;
 using vespalib::string;
@@ -627,14 +627,19 @@ public:
         if (_attr.asTensorAttribute() == nullptr) {
             return fail_nearest_neighbor_term(n, "Attribute is not a tensor");
         }
-        const auto* dense_attr_tensor = dynamic_cast<const DenseTensorAttribute*>(_attr.asTensorAttribute());
-        if (dense_attr_tensor == nullptr) {
-            return fail_nearest_neighbor_term(n, make_string("Attribute is not a dense tensor (type=%s)",
+        const auto* attr_tensor = dynamic_cast<const TensorAttribute*>(_attr.asTensorAttribute());
+        if (attr_tensor == nullptr) {
+            return fail_nearest_neighbor_term(n, make_string("Attribute is not a tensor attribute (type=%s)",
                                                              _attr.asTensorAttribute()->getTensorType().to_spec().c_str()));
         }
-        if (dense_attr_tensor->getTensorType().dimensions().size() != 1) {
-            return fail_nearest_neighbor_term(n, make_string("Attribute tensor type (%s) is not of order 1",
-                                                             dense_attr_tensor->getTensorType().to_spec().c_str()));
+        const auto& attr_tensor_type = attr_tensor->getTensorType();
+        if (!attr_tensor_type.is_dense() && (attr_tensor->nearest_neighbor_index() == nullptr)) {
+            return fail_nearest_neighbor_term(n, make_string("Attribute is not a dense tensor (type=%s), and has no nearest neighbor index",
+                                                             attr_tensor_type.to_spec().c_str()));
+        }
+        if (TensorAttribute::vector_type(attr_tensor_type).is_error()) {
+            return fail_nearest_neighbor_term(n, make_string("Attribute tensor type (%s) is neither of order 1 nor has one mapped and one indexed dimension",
+                                                             attr_tensor_type.to_spec().c_str()));
         }
         auto query_tensor = getRequestContext().get_query_tensor(n.get_query_tensor_name());
         if (query_tensor.get() == nullptr) {
@@ -645,13 +650,13 @@ public:
             return fail_nearest_neighbor_term(n, make_string("Query tensor is not a dense tensor (type=%s)",
                                                              query_tensor->type().to_spec().c_str()));
         }
-        if (!is_compatible_for_nearest_neighbor(dense_attr_tensor->getTensorType(), dense_query_tensor->type())) {
+        if (!is_compatible_for_nearest_neighbor(TensorAttribute::vector_type(attr_tensor_type), dense_query_tensor->type())) {
             return fail_nearest_neighbor_term(n, make_string("Attribute tensor type (%s) and query tensor type (%s) are not compatible",
-                                                             dense_attr_tensor->getTensorType().to_spec().c_str(), dense_query_tensor->type().to_spec().c_str()));
+                                                             attr_tensor_type.to_spec().c_str(), dense_query_tensor->type().to_spec().c_str()));
         }
         std::unique_ptr<DenseTensorView> dense_query_tensor_up(dense_query_tensor);
         query_tensor.release();
-        setResult(std::make_unique<queryeval::NearestNeighborBlueprint>(_field, *dense_attr_tensor,
+        setResult(std::make_unique<queryeval::NearestNeighborBlueprint>(_field, *attr_tensor,
                                                                         std::move(dense_query_tensor_up),
                                                                         n.get_target_num_hits(),
                                                                         n.get_allow_approximate(),
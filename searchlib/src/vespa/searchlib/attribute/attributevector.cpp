@@ -372,8 +372,13 @@ AttributeVector::isEnumeratedSaveFormat() const
 
 bool
 AttributeVector::load() {
+    return load(nullptr);
+}
+
+bool
+AttributeVector::load(vespalib::ThreadExecutor *executor) {
     assert(!_loaded);
-    bool loaded = onLoad();
+    bool loaded = onLoad(executor);
     if (loaded) {
         commit();
     }
@@ -382,6 +387,7 @@ AttributeVector::load() {
 }
 
 bool AttributeVector::onLoad() { return false; }
+bool AttributeVector::onLoad(vespalib::ThreadExecutor *) { return onLoad(); }
 int32_t AttributeVector::getWeight(DocId, uint32_t) const { return 1; }
 
 bool AttributeVector::findEnum(const char *, EnumHandle &) const { return false; }
@@ -37,6 +37,7 @@ namespace document {
 
 namespace vespalib {
     class GenericHeader;
+    class ThreadExecutor;
 }
 
 namespace search {
@@ -447,6 +448,11 @@ public:
 
     bool isEnumeratedSaveFormat() const;
     bool load();
+    /**
+     * Loads this attribute vector, allowing the given executor (if not nullptr)
+     * to be used to parallelize costly parts of the load (e.g. building a nearest neighbor index).
+     */
+    bool load(vespalib::ThreadExecutor *executor);
     void commit(bool forceStatUpdate = false);
     void commit(uint64_t firstSyncToken, uint64_t lastSyncToken);
     void setCreateSerialNum(uint64_t createSerialNum);
@@ -570,6 +576,7 @@ private:
     virtual bool applyWeight(DocId doc, const FieldValue& fv, const document::AssignValueUpdate& wAdjust);
     virtual void onSave(IAttributeSaveTarget & saveTarget);
     virtual bool onLoad();
+    virtual bool onLoad(vespalib::ThreadExecutor *executor);
 
 
     BaseName                              _baseFileName;
@@ -88,9 +88,12 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     }
     retval.set_distance_metric(dm);
     if (cfg.index.hnsw.enabled) {
+        using CfgQuantization = AttributesConfig::Attribute::Index::Hnsw::Quantization;
+        VectorQuantization quantization = (cfg.index.hnsw.quantization == CfgQuantization::INT8)
+                                          ? VectorQuantization::Int8 : VectorQuantization::None;
         retval.set_hnsw_index_params(HnswIndexParams(cfg.index.hnsw.maxlinkspernode,
                                                      cfg.index.hnsw.neighborstoexploreatinsert,
-                                                     dm));
+                                                     dm, quantization));
     }
     if (retval.basicType().type() == BasicType::Type::TENSOR) {
         if (!cfg.tensortype.empty()) {
@@ -4,6 +4,7 @@
 
 #include "i_document_weight_attribute.h"
 #include <vespa/searchlib/queryeval/begin_and_end_id.h>
+#include <limits>
 
 namespace search {
 
@@ -38,9 +39,17 @@ public:
         return _children[ref].getData();
     }
 
+    // btree posting lists have no block level weight information
+    uint32_t get_block_end(uint16_t ref) const { return get_docid(ref); }
+    int32_t get_block_max_weight(uint16_t) const { return std::numeric_limits<int32_t>::max(); }
+
     std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id);
     void or_hits_into(BitVector &result, uint32_t begin_id);
 
+    // posting list iterators are not search iterators, nothing to transform
+    template <typename F>
+    void transform_children(const F &) {}
+
     size_t size() const { return _children.size(); }
     void initRange(uint32_t begin, uint32_t end) {
         (void) end;
@@ -86,7 +86,7 @@ makePosOccRead(const vespalib::string &name,
     if (fileHeader.taste(name, tuneFileRead)) {
         if (fileHeader.getVersion() == 1 &&
             fileHeader.getBigEndian() &&
-            fileHeader.getFormats().size() == 2 &&
+            Zc4PostingSeqRead::hasKnownOptionalFormats(fileHeader.getFormats()) &&
             fileHeader.getFormats()[0] ==
             Zc4PosOccSeqRead::getIdentifier(true) &&
             fileHeader.getFormats()[1] ==
@@ -94,7 +94,7 @@ makePosOccRead(const vespalib::string &name,
             posOccRead = std::make_unique<ZcPosOccSeqRead>(posOccCountRead);
         } else if (fileHeader.getVersion() == 1 &&
                    fileHeader.getBigEndian() &&
-                   fileHeader.getFormats().size() == 2 &&
+                   Zc4PostingSeqRead::hasKnownOptionalFormats(fileHeader.getFormats()) &&
                    fileHeader.getFormats()[0] ==
                    Zc4PosOccSeqRead::getIdentifier(false) &&
                    fileHeader.getFormats()[1] ==
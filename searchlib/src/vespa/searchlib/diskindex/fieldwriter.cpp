@@ -27,7 +27,8 @@ FieldWriter::FieldWriter(uint32_t docIdLimit, uint64_t numWordIds)
       _numWordIds(numWordIds),
       _prefix(),
       _compactWordNum(0),
-      _word()
+      _word(),
+      _encode_block_max_weight(false)
 {
 }
 
@@ -65,6 +66,9 @@ FieldWriter::open(const vespalib::string &prefix,
     if (encode_interleaved_features) {
         params.set("interleaved_features", encode_interleaved_features);
     }
+    if (_encode_block_max_weight) {
+        params.set("block_max_weight", _encode_block_max_weight);
+    }
     
     _dictFile = std::make_unique<PageDict4FileSeqWrite>();
     _dictFile->setParams(countParams);
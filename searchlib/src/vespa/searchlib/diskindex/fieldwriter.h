@@ -43,6 +43,7 @@ private:
     vespalib::string _prefix;
     uint64_t _compactWordNum;
     vespalib::string _word;
+    bool _encode_block_max_weight;
 
     void flush();
 
@@ -67,6 +68,14 @@ public:
 
     uint64_t getSparseWordNum() const { return _wordNum; }
 
+    /**
+     * Store the max element weight of each L1 skip block in the
+     * posting lists (must be set before open). Files written with
+     * this are tagged with an extra format and cannot be read by
+     * older versions.
+     **/
+    void set_encode_block_max_weight(bool value) { _encode_block_max_weight = value; }
+
     bool open(const vespalib::string &prefix, uint32_t minSkipDocs, uint32_t minChunkDocs,
               bool dynamicKPosOccFormat,
               bool encode_interleaved_features,
@@ -3,6 +3,7 @@
 #include "zc4_posting_reader_base.h"
 #include "zc4_posting_header.h"
 #include <vespa/searchlib/index/docidandfeatures.h>
+#include <limits>
 
 namespace search::diskindex {
 
@@ -71,7 +72,8 @@ Zc4PostingReaderBase::NoSkip::check_not_end(uint32_t last_doc_id)
 
 Zc4PostingReaderBase::L1Skip::L1Skip()
     : NoSkipBase(),
-      _l1_skip_pos(0)
+      _l1_skip_pos(0),
+      _block_max_weight(std::numeric_limits<int32_t>::max())
 {
 }
 
@@ -80,6 +82,7 @@ Zc4PostingReaderBase::L1Skip::setup(DecodeContext &decode_context, uint32_t size
 {
     NoSkipBase::setup(decode_context, size, doc_id);
     _l1_skip_pos = 0;
+    _block_max_weight = std::numeric_limits<int32_t>::max();
     if (size != 0) {
         next_skip_entry();
     } else {
@@ -108,6 +111,12 @@ Zc4PostingReaderBase::L1Skip::next_skip_entry()
     _doc_id += (_zc_buf.decode() + 1);
 }
 
+void
+Zc4PostingReaderBase::L1Skip::read_block_max_weight()
+{
+    _block_max_weight = ZcBuf::zigzag_decode(_zc_buf.decode());
+}
+
 Zc4PostingReaderBase::L2Skip::L2Skip()
     : L1Skip(),
       _l2_skip_pos(0)
@@ -218,6 +227,9 @@ Zc4PostingReaderBase::read_common_word_doc_id(DecodeContext64Base &decode_contex
             _l2_skip.next_skip_entry();
         }
         _l1_skip.next_skip_entry();
+        if (_posting_params._encode_block_max_weight) {
+            _l1_skip.read_block_max_weight();
+        }
     }
     _no_skip.read(_posting_params._encode_interleaved_features);
     if (_residue == 1) {
@@ -250,6 +262,9 @@ Zc4PostingReaderBase::read_word_start_with_skip(DecodeContext64Base &decode_cont
     uint32_t prev_doc_id = _no_skip.get_doc_id();
     _no_skip.setup(decode_context, header._doc_ids_size, prev_doc_id);
     _l1_skip.setup(decode_context, header._l1_skip_size, prev_doc_id, _last_doc_id);
+    if (_posting_params._encode_block_max_weight && (header._l1_skip_size != 0)) {
+        _l1_skip.read_block_max_weight();
+    }
     _l2_skip.setup(decode_context, header._l2_skip_size, prev_doc_id, _last_doc_id);
     _l3_skip.setup(decode_context, header._l3_skip_size, prev_doc_id, _last_doc_id);
     _l4_skip.setup(decode_context, header._l4_skip_size, prev_doc_id, _last_doc_id);
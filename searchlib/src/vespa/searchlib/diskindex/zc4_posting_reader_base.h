@@ -56,12 +56,15 @@ protected:
     class L1Skip : public NoSkipBase {
     protected:
         uint32_t _l1_skip_pos;
+        int32_t  _block_max_weight;
     public:
         L1Skip();
         void setup(DecodeContext &decode_context, uint32_t size, uint32_t doc_id, uint32_t last_doc_id);
         void check(const NoSkipBase &no_skip, bool top_level, bool decode_features);
         void next_skip_entry();
+        void read_block_max_weight();
         uint32_t get_l1_skip_pos() const { return _l1_skip_pos; }
+        int32_t get_block_max_weight() const { return _block_max_weight; }
     };
     class L2Skip : public L1Skip
     {
@@ -3,6 +3,8 @@
 #include "zc4_posting_writer.h"
 #include <vespa/searchlib/index/docidandfeatures.h>
 #include <vespa/searchlib/index/postinglistcounts.h>
+#include <algorithm>
+#include <limits>
 
 using search::index::DocIdAndFeatures;
 using search::index::PostingListCounts;
@@ -10,6 +12,23 @@ using search::index::PostingListParams;
 
 namespace search::diskindex {
 
+namespace {
+
+int32_t
+calc_max_element_weight(const DocIdAndFeatures &features)
+{
+    if (features.elements().empty()) {
+        return 1;
+    }
+    int32_t max_element_weight = std::numeric_limits<int32_t>::min();
+    for (const auto &element : features.elements()) {
+        max_element_weight = std::max(max_element_weight, element.getWeight());
+    }
+    return max_element_weight;
+}
+
+}
+
 template <bool bigEndian>
 Zc4PostingWriter<bigEndian>::Zc4PostingWriter(PostingListCounts &counts)
     : Zc4PostingWriterBase(counts),
@@ -150,10 +169,10 @@ Zc4PostingWriter<bigEndian>::write_docid_and_features(const DocIdAndFeatures &fe
         uint64_t featureSize = writeOffset - _featureOffset;
         assert(static_cast<uint32_t>(featureSize) == featureSize);
         _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(),
-                             static_cast<uint32_t>(featureSize));
+                             static_cast<uint32_t>(featureSize), calc_max_element_weight(features));
         _featureOffset = writeOffset;
     } else {
-        _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(), 0);
+        _docIds.emplace_back(features.doc_id(), features.field_length(), features.num_occs(), 0, 1);
     }
 }
 
@@ -2,6 +2,8 @@
 
 #include "zc4_posting_writer_base.h"
 #include <vespa/searchlib/index/postinglistcounts.h>
+#include <algorithm>
+#include <limits>
 
 using search::index::PostingListCounts;
 using search::index::PostingListParams;
@@ -36,14 +38,19 @@ class L1SkipEncoder : public DocIdEncoder {
 protected:
     uint32_t _stride_check;
     uint32_t _l1_skip_pos;
+    int32_t _block_max_weight;
     const bool _encode_features;
+    const bool _encode_block_max_weight;
 
+    void encode_block_max_weight(ZcBuf &zc_buf);
 public:
-    L1SkipEncoder(bool encode_features)
+    L1SkipEncoder(bool encode_features, bool encode_block_max_weight)
         : DocIdEncoder(),
           _stride_check(0u),
           _l1_skip_pos(0u),
-          _encode_features(encode_features)
+          _block_max_weight(std::numeric_limits<int32_t>::min()),
+          _encode_features(encode_features),
+          _encode_block_max_weight(encode_block_max_weight)
     {
     }
 
@@ -52,6 +59,9 @@ public:
     bool should_write_skip(uint32_t stride) { return ++_stride_check >= stride; }
     void dec_stride_check() { --_stride_check; }
     void write_partial_skip(ZcBuf &zc_buf, uint32_t doc_id);
+    void add_to_block(const DocIdAndFeatureSize &doc_id_and_feature_size) {
+        _block_max_weight = std::max(_block_max_weight, doc_id_and_feature_size._max_element_weight);
+    }
     uint32_t get_l1_skip_pos() const { return _l1_skip_pos; }
 };
 
@@ -61,7 +71,7 @@ protected:
 
 public:
     L2SkipEncoder(bool encode_features)
-        : L1SkipEncoder(encode_features),
+        : L1SkipEncoder(encode_features, false),
           _l2_skip_pos(0u)
     {
     }
@@ -114,6 +124,13 @@ DocIdEncoder::write(ZcBuf &zc_buf, const DocIdAndFeatureSize &doc_id_and_feature
     _doc_id_pos = zc_buf.size();
 }
 
+void
+L1SkipEncoder::encode_block_max_weight(ZcBuf &zc_buf)
+{
+    zc_buf.encode(ZcBuf::zigzag_encode(_block_max_weight));
+    _block_max_weight = std::numeric_limits<int32_t>::min();
+}
+
 void
 L1SkipEncoder::encode_skip(ZcBuf &zc_buf, const DocIdEncoder &doc_id_encoder)
 {
@@ -123,6 +140,10 @@ L1SkipEncoder::encode_skip(ZcBuf &zc_buf, const DocIdEncoder &doc_id_encoder)
     assert(static_cast<int32_t>(doc_id_delta) > 0);
     zc_buf.encode(doc_id_delta - 1);
     _doc_id = doc_id_encoder.get_doc_id();
+    if (_encode_block_max_weight) {
+        // max element weight for documents since previous skip entry
+        encode_block_max_weight(zc_buf);
+    }
     // doc id pos
     zc_buf.encode(doc_id_encoder.get_doc_id_pos() - _doc_id_pos - 1);
     _doc_id_pos = doc_id_encoder.get_doc_id_pos();
@@ -145,6 +166,9 @@ L1SkipEncoder::write_partial_skip(ZcBuf &zc_buf, uint32_t doc_id)
 {
     if (zc_buf.size() > 0) {
         zc_buf.encode(doc_id - _doc_id - 1);
+        if (_encode_block_max_weight) {
+            encode_block_max_weight(zc_buf);
+        }
     }
 }
 
@@ -206,6 +230,7 @@ Zc4PostingWriterBase::Zc4PostingWriterBase(PostingListCounts &counts)
       _writePos(0),
       _dynamicK(false),
       _encode_interleaved_features(false),
+      _encode_block_max_weight(false),
       _zcDocIds(),
       _l1Skip(),
       _l2Skip(),
@@ -238,7 +263,7 @@ void
 Zc4PostingWriterBase::calc_skip_info(bool encode_features)
 {
     DocIdEncoder doc_id_encoder;
-    L1SkipEncoder l1_skip_encoder(encode_features);
+    L1SkipEncoder l1_skip_encoder(encode_features, _encode_block_max_weight);
     L2SkipEncoder l2_skip_encoder(encode_features);
     L3SkipEncoder l3_skip_encoder(encode_features);
     L4SkipEncoder l4_skip_encoder(encode_features);
@@ -265,6 +290,7 @@ Zc4PostingWriterBase::calc_skip_info(bool encode_features)
             }
         }
         doc_id_encoder.write(_zcDocIds, doc_id_and_feature_size, _encode_interleaved_features);
+        l1_skip_encoder.add_to_block(doc_id_and_feature_size);
     }
     // Extra partial entries for skip tables to simplify iterator during search
     l1_skip_encoder.write_partial_skip(_l1Skip, doc_id_encoder.get_doc_id());
@@ -290,6 +316,7 @@ Zc4PostingWriterBase::set_posting_list_params(const PostingListParams &params)
     params.get("minChunkDocs", _minChunkDocs);
     params.get("minSkipDocs", _minSkipDocs);
     params.get("interleaved_features", _encode_interleaved_features);
+    params.get("block_max_weight", _encode_block_max_weight);
 }
 
 }
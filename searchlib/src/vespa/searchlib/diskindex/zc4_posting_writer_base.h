@@ -24,11 +24,13 @@ public:
         uint32_t _field_length;
         uint32_t _num_occs;
         uint32_t _features_size;
-        DocIdAndFeatureSize(uint32_t doc_id, uint32_t field_length, uint32_t num_occs, uint32_t features_size)
+        int32_t  _max_element_weight;
+        DocIdAndFeatureSize(uint32_t doc_id, uint32_t field_length, uint32_t num_occs, uint32_t features_size, int32_t max_element_weight)
             : _doc_id(doc_id),
               _field_length(field_length),
               _num_occs(num_occs),
-              _features_size(features_size)
+              _features_size(features_size),
+              _max_element_weight(max_element_weight)
         {
         }
     };
@@ -44,6 +46,7 @@ protected:
     uint64_t _writePos; // Bit position for start of current word
     bool _dynamicK;     // Caclulate EG compression parameters ?
     bool _encode_interleaved_features;
+    bool _encode_block_max_weight; // Store max element weight for each L1 skip block ?
     ZcBuf _zcDocIds;    // Document id deltas
     ZcBuf _l1Skip;      // L1 skip info
     ZcBuf _l2Skip;      // L2 skip info
@@ -73,8 +76,10 @@ public:
     uint64_t get_num_words() const { return _numWords; }
     bool get_dynamic_k() const { return _dynamicK; }
     bool get_encode_interleaved_features() const { return _encode_interleaved_features; }
+    bool get_encode_block_max_weight() const { return _encode_block_max_weight; }
     void set_dynamic_k(bool dynamicK) { _dynamicK = dynamicK; }
     void set_encode_interleaved_features(bool encode_interleaved_features) { _encode_interleaved_features = encode_interleaved_features; }
+    void set_encode_block_max_weight(bool encode_block_max_weight) { _encode_block_max_weight = encode_block_max_weight; }
     void set_posting_list_params(const index::PostingListParams &params);
 };
 
@@ -80,6 +80,14 @@ public:
         _valI = valI;
         return res;
     }
+
+    // Map signed values (e.g. weights) to unsigned values suitable for zc encoding
+    static uint32_t zigzag_encode(int32_t num) {
+        return (static_cast<uint32_t>(num) << 1) ^ static_cast<uint32_t>(num >> 31);
+    }
+    static int32_t zigzag_decode(uint32_t num) {
+        return static_cast<int32_t>((num >> 1) ^ (0u - (num & 1)));
+    }
 };
 
 }
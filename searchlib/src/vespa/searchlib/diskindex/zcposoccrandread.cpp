@@ -2,6 +2,7 @@
 
 #include "zcposoccrandread.h"
 #include "zcposocciterators.h"
+#include "zcposting.h"
 #include <vespa/vespalib/data/fileheader.h>
 #include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/fastos/file.h>
@@ -201,7 +202,7 @@ ZcPosOccRandRead::readHeader(const vespalib::string &identifier)
     assert(header.hasTag("fileBitSize"));
     assert(header.hasTag("format.0"));
     assert(header.hasTag("format.1"));
-    assert(!header.hasTag("format.2"));
+    assert(!header.hasTag("format.3"));
     assert(header.hasTag("numWords"));
     assert(header.hasTag("minChunkDocs"));
     assert(header.hasTag("docIdLimit"));
@@ -217,6 +218,10 @@ ZcPosOccRandRead::readHeader(const vespalib::string &identifier)
     if (header.hasTag(interleaved_features) && (header.getTag(interleaved_features).asInteger() != 0)) {
         _posting_params._encode_interleaved_features = true;
     }
+    if (header.hasTag("format.2")) {
+        assert(header.getTag("format.2").asString() == Zc4PostingSeqRead::getBlockMaxWeightIdentifier());
+        _posting_params._encode_block_max_weight = true;
+    }
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
     // Align on 64-bit unit
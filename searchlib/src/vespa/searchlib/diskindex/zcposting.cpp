@@ -17,6 +17,8 @@ vespalib::string myId5("Zc.5");
 vespalib::string myId4("Zc.4");
 vespalib::string emptyId;
 vespalib::string interleaved_features("interleaved_features");
+vespalib::string block_max_weight("block_max_weight");
+vespalib::string blockMaxWeightId("Zc.BlockMaxWeight.1");
 
 }
 
@@ -124,6 +126,7 @@ Zc4PostingSeqRead::getParams(PostingListParams &params)
     }
     params.set("minSkipDocs", _reader.get_posting_params()._min_skip_docs);
     params.set(interleaved_features, _reader.get_posting_params()._encode_interleaved_features);
+    params.set(block_max_weight, _reader.get_posting_params()._encode_block_max_weight);
 }
 
 
@@ -148,7 +151,7 @@ Zc4PostingSeqRead::readHeader()
     assert(header.hasTag("fileBitSize"));
     assert(header.hasTag("format.0"));
     assert(header.hasTag("format.1"));
-    assert(!header.hasTag("format.2"));
+    assert(!header.hasTag("format.3"));
     assert(header.hasTag("numWords"));
     assert(header.hasTag("minChunkDocs"));
     assert(header.hasTag("docIdLimit"));
@@ -170,6 +173,10 @@ Zc4PostingSeqRead::readHeader()
     if (header.hasTag(interleaved_features) && (header.getTag(interleaved_features).asInteger() != 0)) {
        posting_params._encode_interleaved_features = true;
     }
+    if (header.hasTag("format.2")) {
+        assert(header.getTag("format.2").asString() == blockMaxWeightId);
+        posting_params._encode_block_max_weight = true;
+    }
     assert(header.getTag("endian").asString() == "big");
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
@@ -187,6 +194,21 @@ Zc4PostingSeqRead::getIdentifier(bool dynamic_k)
 }
 
 
+const vespalib::string &
+Zc4PostingSeqRead::getBlockMaxWeightIdentifier()
+{
+    return blockMaxWeightId;
+}
+
+
+bool
+Zc4PostingSeqRead::hasKnownOptionalFormats(const std::vector<vespalib::string> &formats)
+{
+    return ((formats.size() == 2) ||
+            ((formats.size() == 3) && (formats[2] == blockMaxWeightId)));
+}
+
+
 Zc4PostingSeqWrite::
 Zc4PostingSeqWrite(PostingListCountFileSeqWrite *countFile)
     : PostingListFileSeqWrite(),
@@ -239,6 +261,10 @@ Zc4PostingSeqWrite::makeHeader(const FileHeaderContext &fileHeaderContext)
     header.putTag(Tag("format.0", myId));
     header.putTag(Tag("format.1", f.getIdentifier()));
     header.putTag(Tag("interleaved_features", _writer.get_encode_interleaved_features() ? 1 : 0));
+    if (_writer.get_encode_block_max_weight()) {
+        // Older readers reject files with an unknown format.2 instead of misreading the skip info
+        header.putTag(Tag("format.2", blockMaxWeightId));
+    }
     header.putTag(Tag("numWords", 0));
     header.putTag(Tag("minChunkDocs", _writer.get_min_chunk_docs()));
     header.putTag(Tag("docIdLimit", _writer.get_docid_limit()));
@@ -359,6 +385,7 @@ getParams(PostingListParams &params)
     }
     params.set("minSkipDocs", _writer.get_min_skip_docs());
     params.set(interleaved_features, _writer.get_encode_interleaved_features());
+    params.set(block_max_weight, _writer.get_encode_block_max_weight());
 }
 
 
@@ -46,6 +46,16 @@ public:
     void readWordStart();
     void readHeader();
     static const vespalib::string &getIdentifier(bool dynamic_k);
+    /**
+     * Identifier stored as format.2 in files with a max element
+     * weight for each L1 skip block.
+     **/
+    static const vespalib::string &getBlockMaxWeightIdentifier();
+    /**
+     * Check that any formats after the posting list format and the
+     * feature format are optional formats understood by this reader.
+     **/
+    static bool hasKnownOptionalFormats(const std::vector<vespalib::string> &formats);
 };
 
 
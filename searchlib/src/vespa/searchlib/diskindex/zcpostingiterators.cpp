@@ -4,6 +4,7 @@
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/searchlib/bitcompression/posocccompression.h>
+#include <limits>
 
 namespace search::diskindex {
 
@@ -189,7 +190,8 @@ ZcRareWordPostingIterator<bigEndian, dynamic_k>::readWordStart(uint32_t docIdLim
 
 ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
                                              bool decode_normal_features, bool decode_interleaved_features,
-                                             bool unpack_normal_features, bool unpack_interleaved_features)
+                                             bool unpack_normal_features, bool unpack_interleaved_features,
+                                             bool decode_block_max_weight)
     : ZcIteratorBase(matchData, start, docIdLimit),
       _valI(nullptr),
       _valIBase(nullptr),
@@ -205,9 +207,11 @@ ZcPostingIteratorBase::ZcPostingIteratorBase(const TermFieldMatchDataArray &matc
       _decode_interleaved_features(decode_interleaved_features),
       _unpack_normal_features(unpack_normal_features),
       _unpack_interleaved_features(unpack_interleaved_features),
+      _decode_block_max_weight(decode_block_max_weight),
       _chunkNo(0),
       _field_length(0),
-      _num_occs(0)
+      _num_occs(0),
+      _block_max_weight(std::numeric_limits<int32_t>::max())
 {
 }
 
@@ -219,10 +223,12 @@ ZcPostingIterator(uint32_t minChunkDocs,
                   const search::fef::TermFieldMatchDataArray &matchData,
                   Position start, uint32_t docIdLimit,
                   bool decode_normal_features, bool decode_interleaved_features,
-                  bool unpack_normal_features, bool unpack_interleaved_features)
+                  bool unpack_normal_features, bool unpack_interleaved_features,
+                  bool decode_block_max_weight)
     : ZcPostingIteratorBase(matchData, start, docIdLimit,
                             decode_normal_features, decode_interleaved_features,
-                            unpack_normal_features, unpack_interleaved_features),
+                            unpack_normal_features, unpack_interleaved_features,
+                            decode_block_max_weight),
       _decodeContext(nullptr),
       _minChunkDocs(minChunkDocs),
       _docIdK(0),
@@ -311,6 +317,11 @@ ZcPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
     _valIBase = _valI = bcompr;
     bcompr += docIdsSize;
     _l1.setup(prevDocId, _chunk._lastDocId, bcompr, l1SkipSize);
+    if (l1SkipSize != 0) {
+        decodeBlockMaxWeight();
+    } else {
+        _block_max_weight = std::numeric_limits<int32_t>::max();
+    }
     _l2.setup(prevDocId, _chunk._lastDocId, bcompr, l2SkipSize);
     _l3.setup(prevDocId, _chunk._lastDocId, bcompr, l3SkipSize);
     _l4.setup(prevDocId, _chunk._lastDocId, bcompr, l4SkipSize);
@@ -385,7 +396,7 @@ ZcPostingIteratorBase::doL4SkipSeek(uint32_t docId)
     _l2._valI = _l3._l2Pos = _l4._l2Pos;
     _l3._valI = _l4._l3Pos;
     nextDocId(lastL4SkipDocId);
-    _l1.nextDocId();
+    nextL1SkipDocId();
     _l2.nextDocId();
     _l3.nextDocId();
 #if DEBUG_ZCPOSTING_PRINTF
@@ -434,7 +445,7 @@ ZcPostingIteratorBase::doL3SkipSeek(uint32_t docId)
     _l1._valI = _l2._l1Pos = _l3._l1Pos;
     _l2._valI = _l3._l2Pos;
     nextDocId(lastL3SkipDocId);
-    _l1.nextDocId();
+    nextL1SkipDocId();
     _l2.nextDocId();
 #if DEBUG_ZCPOSTING_PRINTF
     printf("L3Seek, docId %d docIdPos %d"
@@ -478,7 +489,7 @@ ZcPostingIteratorBase::doL2SkipSeek(uint32_t docId)
     _l1._skipDocId = lastL2SkipDocId;
     _l1._valI = _l2._l1Pos;
     nextDocId(lastL2SkipDocId);
-    _l1.nextDocId();
+    nextL1SkipDocId();
 #if DEBUG_ZCPOSTING_PRINTF
     printf("L2Seek, docId %d docIdPos %d L1SkipPos %d, nextDocId %d\n",
            lastL2SkipDocId,
@@ -504,7 +515,7 @@ ZcPostingIteratorBase::doL1SkipSeek(uint32_t docId)
     do {
         lastL1SkipDocId = _l1._skipDocId;
         _l1.decodeSkipEntry(_decode_normal_features);
-        _l1.nextDocId();
+        nextL1SkipDocId();
 #if DEBUG_ZCPOSTING_PRINTF
         printf("L1Decode docId %d, docIdPos %d, L1SkipPos %d, nextDocId %d\n",
                lastL1SkipDocId,
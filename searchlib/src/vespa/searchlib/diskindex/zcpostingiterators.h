@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include "zcbuf.h"
 #include <vespa/searchlib/index/postinglistfile.h>
 #include <vespa/searchlib/bitcompression/compression.h>
+#include <vespa/searchlib/queryeval/iblockmaxweight.h>
 #include <vespa/searchlib/queryeval/iterators.h>
 #include <vespa/fastos/dynamiclibrary.h>
 
@@ -135,7 +137,8 @@ public:
     void readWordStart(uint32_t docIdLimit) override;
 };
 
-class ZcPostingIteratorBase : public ZcIteratorBase
+class ZcPostingIteratorBase : public ZcIteratorBase,
+                              public queryeval::IBlockMaxWeight
 {
 protected:
     const uint8_t *_valI;     // docid deltas
@@ -279,9 +282,11 @@ protected:
     bool     _decode_interleaved_features;
     bool     _unpack_normal_features;
     bool     _unpack_interleaved_features;
+    bool     _decode_block_max_weight;
     uint32_t _chunkNo;
     uint32_t _field_length;
     uint32_t _num_occs;
+    int32_t  _block_max_weight; // max element weight in current L1 skip block
 
     void nextDocId(uint32_t prevDocId) {
         uint32_t docId = prevDocId + 1;
@@ -292,6 +297,17 @@ protected:
             ZCDECODE(_valI, _num_occs = 1 +);
         }
     }
+    void decodeBlockMaxWeight() {
+        if (_decode_block_max_weight) {
+            uint32_t block_max_weight;
+            ZCDECODE(_l1._valI, block_max_weight =);
+            _block_max_weight = ZcBuf::zigzag_decode(block_max_weight);
+        }
+    }
+    void nextL1SkipDocId() {
+        _l1.nextDocId();
+        decodeBlockMaxWeight();
+    }
     virtual void featureSeek(uint64_t offset) = 0;
     VESPA_DLL_LOCAL void doChunkSkipSeek(uint32_t docId);
     VESPA_DLL_LOCAL void doL4SkipSeek(uint32_t docId);
@@ -302,7 +318,13 @@ protected:
 public:
     ZcPostingIteratorBase(const fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
                           bool decode_normal_features, bool decode_interleaved_features,
-                          bool unpack_normal_features, bool unpack_interleaved_features);
+                          bool unpack_normal_features, bool unpack_interleaved_features,
+                          bool decode_block_max_weight);
+    uint32_t get_block_end() const override { return _l1._skipDocId; }
+    int32_t get_block_max_weight() const override {
+        // match data reports weight 1 when normal features are not unpacked
+        return (_decode_normal_features && _unpack_normal_features) ? _block_max_weight : 1;
+    }
 };
 
 template <bool bigEndian>
@@ -331,7 +353,8 @@ public:
     ZcPostingIterator(uint32_t minChunkDocs, bool dynamicK, const PostingListCounts &counts,
                       const search::fef::TermFieldMatchDataArray &matchData, Position start, uint32_t docIdLimit,
                       bool decode_normal_features, bool decode_interleaved_features,
-                      bool unpack_normal_features, bool unpack_interleaved_features);
+                      bool unpack_normal_features, bool unpack_interleaved_features,
+                      bool decode_block_max_weight);
 
 
     void doUnpack(uint32_t docId) override;
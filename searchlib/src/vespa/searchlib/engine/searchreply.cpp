@@ -33,8 +33,15 @@ SearchReply::SearchReply(const SearchReply &rhs) :
     coverage     (rhs.coverage),
     useWideHits  (rhs.useWideHits),
     hits         (rhs.hits),
+    propertiesMap(rhs.propertiesMap),
     request() // NB not copied
 { }
 
+SearchReply::UP
+SearchReply::clone() const
+{
+    return UP(new SearchReply(*this));
+}
+
 }
 
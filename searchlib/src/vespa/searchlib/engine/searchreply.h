@@ -84,11 +84,21 @@ public:
     PropertiesMap         propertiesMap;
 
     SearchRequest::UP     request;
+private:
+    SearchReply(const SearchReply &rhs);
+    SearchReply &operator=(const SearchReply &rhs) = delete;
+public:
 
     SearchReply();
     ~SearchReply();
-    SearchReply(const SearchReply &rhs); // for test only
-    
+
+    /**
+     * Create a copy of this reply, including hits, sort data,
+     * grouping result, coverage and properties. The request the
+     * reply was produced for is not copied.
+     **/
+    UP clone() const;
+
     void setDistributionKey(uint32_t key) { _distributionKey = key; }
     uint32_t getDistributionKey() const { return _distributionKey; }
 };
@@ -14,6 +14,7 @@
 #include <vespa/searchlib/attribute/singlenumericattribute.h>
 #include <vespa/searchlib/attribute/multinumericattribute.h>
 #include <vespa/searchlib/attribute/singleboolattribute.h>
+#include <algorithm>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.attributefeature");
@@ -117,7 +118,11 @@ public:
         o[2].as_number = 0;  // contains
         o[3].as_number = 1;  // count
     }
+    bool uses_match_data() override { return false; }
+    bool supports_batch() override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(vespalib::ConstArrayRef<uint32_t> docids,
+                       const feature_t *const *inputs, feature_t *const *outputs) override;
 };
 
 class BoolAttributeExecutor final : public fef::FeatureExecutor {
@@ -127,6 +132,7 @@ public:
     BoolAttributeExecutor(const SingleBoolAttribute & attribute)
         : _attribute(attribute)
     {}
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docId) override {
         outputs().set_number(0, _attribute.getFloat(docId));
     }
@@ -142,6 +148,7 @@ private:
     uint32_t  _idx;
 public:
     MultiAttributeExecutor(const T & attribute, uint32_t idx) : _attribute(attribute), _idx(idx) { }
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docId) override;
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
@@ -158,6 +165,7 @@ private:
 
 public:
     CountOnlyAttributeExecutor(const attribute::IAttributeVector & attribute) : _attribute(attribute) { }
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docId) override;
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
@@ -187,6 +195,7 @@ public:
      * @param idx       The index used for an array attribute.
      */
     AttributeExecutor(const attribute::IAttributeVector * attribute, uint32_t idx);
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docId) override;
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
@@ -219,6 +228,7 @@ public:
      * @param useKey   Whether we should consider the key.
      */
     WeightedSetAttributeExecutor(const attribute::IAttributeVector * attribute, T key, bool useKey);
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docId) override;
 };
 
@@ -234,6 +244,22 @@ SingleAttributeExecutor<T>::execute(uint32_t docId)
                      : util::getAsFeature(v);
 }
 
+template <typename T>
+void
+SingleAttributeExecutor<T>::execute_batch(vespalib::ConstArrayRef<uint32_t> docids,
+                                          const feature_t *const *, feature_t *const *outputs_in)
+{
+    for (size_t i = 0; i < docids.size(); ++i) {
+        typename T::LoadedValueType v = _attribute.getFast(docids[i]);
+        outputs_in[0][i] = __builtin_expect(attribute::isUndefined(v), false)
+                           ? attribute::getUndefined<feature_t>()
+                           : util::getAsFeature(v);
+    }
+    std::fill_n(outputs_in[1], docids.size(), 0.0); // weight
+    std::fill_n(outputs_in[2], docids.size(), 0.0); // contains
+    std::fill_n(outputs_in[3], docids.size(), 1.0); // count
+}
+
 template <typename T>
 void
 MultiAttributeExecutor<T>::execute(uint32_t docId)
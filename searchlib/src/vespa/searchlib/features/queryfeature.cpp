@@ -2,7 +2,6 @@
 
 #include "queryfeature.h"
 #include "utils.h"
-#include "valuefeature.h"
 #include "constant_tensor_executor.h"
 
 #include <vespa/document/datatype/tensor_data_type.h>
@@ -54,6 +53,41 @@ feature_t asFeature(const vespalib::string &str) {
     return val;
 }
 
+feature_t lookupNumber(const IQueryEnvironment &env, const vespalib::string &key,
+                       const vespalib::string &key2, feature_t defaultValue)
+{
+    Property p = env.getProperties().lookup(key);
+    if (!p.found()) {
+        p = env.getProperties().lookup(key2);
+    }
+    return p.found() ? asFeature(p.get()) : defaultValue;
+}
+
+/**
+ * Outputs a number looked up in the query properties. The value is
+ * looked up again when rebound to another query.
+ **/
+class QueryValueExecutor : public FeatureExecutor
+{
+private:
+    const vespalib::string &_key;
+    const vespalib::string &_key2;
+    feature_t               _defaultValue;
+    feature_t               _value;
+
+public:
+    QueryValueExecutor(const IQueryEnvironment &env, const vespalib::string &key,
+                       const vespalib::string &key2, feature_t defaultValue)
+        : _key(key), _key2(key2), _defaultValue(defaultValue),
+          _value(lookupNumber(env, key, key2, defaultValue)) {}
+    bool isPure() override { return true; }
+    bool rebind(const IQueryEnvironment &env) override {
+        _value = lookupNumber(env, _key, _key2, _defaultValue);
+        return true;
+    }
+    void execute(uint32_t) override { outputs().set_number(0, _value); }
+};
+
 } // namespace search::features::<unnamed>
 
 QueryBlueprint::QueryBlueprint() :
@@ -140,16 +174,7 @@ QueryBlueprint::createExecutor(const IQueryEnvironment &env, vespalib::Stash &st
     if (_valueType.is_tensor()) {
         return createTensorExecutor(env, _key, _valueType, stash);
     } else {
-        std::vector<feature_t> values;
-        Property p = env.getProperties().lookup(_key);
-        if (!p.found()) {
-            p = env.getProperties().lookup(_key2);
-        }
-        if (p.found()) {
-            return stash.create<SingleValueExecutor>(asFeature(p.get()));
-        } else {
-            return stash.create<SingleValueExecutor>(_defaultValue);
-        }
+        return stash.create<QueryValueExecutor>(env, _key, _key2, _defaultValue);
     }
 }
 
@@ -52,11 +52,16 @@ private:
     const FastForest &_forest;
     FastForest::Context::UP _ctx;
     ArrayRef<float> _params;
+    std::vector<float> _batch_params;
 
 public:
     FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest);
     bool isPure() override { return true; }
+    bool rebind(const fef::IQueryEnvironment &) override { return true; }
+    bool supports_batch() override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                       feature_t *const *outputs_in) override;
 };
 
 //-----------------------------------------------------------------------------
@@ -74,7 +79,11 @@ private:
 public:
     CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function);
     bool isPure() override { return true; }
+    bool rebind(const fef::IQueryEnvironment &) override { return true; }
+    bool supports_batch() override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                       feature_t *const *outputs_in) override;
 };
 
 //-----------------------------------------------------------------------------
@@ -91,7 +100,11 @@ private:
 public:
     LazyCompiledRankingExpressionExecutor(const CompiledFunction &compiled_function);
     bool isPure() override { return true; }
+    bool rebind(const fef::IQueryEnvironment &) override { return true; }
+    bool supports_batch() override { return true; }
     void execute(uint32_t docId) override;
+    void execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                       feature_t *const *outputs_in) override;
 };
 
 //-----------------------------------------------------------------------------
@@ -124,6 +137,7 @@ public:
     InterpretedRankingExpressionExecutor(const InterpretedFunction &function,
                                          ConstArrayRef<char> input_is_object);
     bool isPure() override { return true; }
+    bool rebind(const fef::IQueryEnvironment &) override { return true; }
     void execute(uint32_t docId) override;
 };
 
@@ -132,7 +146,8 @@ public:
 FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest)
     : _forest(forest),
       _ctx(_forest.create_context()),
-      _params(param_space)
+      _params(param_space),
+      _batch_params()
 {
 }
 
@@ -152,6 +167,22 @@ FastForestExecutor::execute(uint32_t)
     outputs().set_number(0, _forest.eval(*_ctx, &_params[0]));
 }
 
+void
+FastForestExecutor::execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                                  feature_t *const *outputs_in)
+{
+    size_t num_docs = docids.size();
+    _batch_params.resize(_params.size() * num_docs);
+    float *dst = _batch_params.data();
+    for (size_t i = 0; i < _params.size(); ++i) {
+        const feature_t *src = inputs_in[i];
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            *dst++ = src[doc];
+        }
+    }
+    _forest.eval_many(*_ctx, _batch_params.data(), num_docs, outputs_in[0]);
+}
+
 //-----------------------------------------------------------------------------
 
 CompiledRankingExpressionExecutor::CompiledRankingExpressionExecutor(const CompiledFunction &compiled_function)
@@ -176,6 +207,18 @@ CompiledRankingExpressionExecutor::execute(uint32_t)
     outputs().set_number(0, _ranking_function(&_params[0]));
 }
 
+void
+CompiledRankingExpressionExecutor::execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                                                 feature_t *const *outputs_in)
+{
+    for (size_t doc = 0; doc < docids.size(); ++doc) {
+        for (size_t i = 0; i < _params.size(); ++i) {
+            _params[i] = inputs_in[i][doc];
+        }
+        outputs_in[0][doc] = _ranking_function(&_params[0]);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 namespace {
@@ -184,6 +227,15 @@ using Context = fef::FeatureExecutor::Inputs;
 double resolve_input(void *ctx, size_t idx) { return ((const Context *)(ctx))->get_number(idx); }
 Context *make_ctx(const Context &inputs) { return const_cast<Context *>(&inputs); }
 
+struct BatchContext {
+    const feature_t *const *inputs;
+    size_t doc;
+};
+double resolve_batch_input(void *ctx, size_t idx) {
+    const BatchContext *batch_ctx = (const BatchContext *)(ctx);
+    return batch_ctx->inputs[idx][batch_ctx->doc];
+}
+
 }
 
 LazyCompiledRankingExpressionExecutor::LazyCompiledRankingExpressionExecutor(const CompiledFunction &compiled_function)
@@ -197,6 +249,16 @@ LazyCompiledRankingExpressionExecutor::execute(uint32_t)
     outputs().set_number(0, _ranking_function(resolve_input, make_ctx(inputs())));
 }
 
+void
+LazyCompiledRankingExpressionExecutor::execute_batch(ConstArrayRef<uint32_t> docids, const feature_t *const *inputs_in,
+                                                     feature_t *const *outputs_in)
+{
+    BatchContext ctx{inputs_in, 0};
+    for (; ctx.doc < docids.size(); ++ctx.doc) {
+        outputs_in[0][ctx.doc] = _ranking_function(resolve_batch_input, &ctx);
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 InterpretedRankingExpressionExecutor::InterpretedRankingExpressionExecutor(const InterpretedFunction &function,
@@ -0,0 +1,71 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batch_evaluator.h"
+#include <cassert>
+
+namespace search::fef {
+
+BatchEvaluator::Step::Step(FeatureExecutor &executor_in)
+    : executor(&executor_in),
+      batch(executor_in.supports_batch()),
+      inputs(),
+      outputs(),
+      input_slots(),
+      input_executors()
+{
+}
+
+BatchEvaluator::Step::Step(Step &&) noexcept = default;
+BatchEvaluator::Step::~Step() = default;
+
+void
+BatchEvaluator::run_per_document(const Step &step, vespalib::ConstArrayRef<uint32_t> docids)
+{
+    auto &outputs = step.executor->outputs();
+    for (size_t i = 0; i < docids.size(); ++i) {
+        uint32_t docid = docids[i];
+        for (size_t input_idx = 0; input_idx < step.input_slots.size(); ++input_idx) {
+            if (step.input_slots[input_idx] != nullptr) {
+                step.input_slots[input_idx]->as_number = step.inputs[input_idx][i];
+                step.input_executors[input_idx]->mark_executed(docid);
+            }
+        }
+        step.executor->force_execute(docid);
+        for (size_t output_idx = 0; output_idx < step.outputs.size(); ++output_idx) {
+            if (step.outputs[output_idx] != nullptr) {
+                step.outputs[output_idx][i] = outputs.get_number(output_idx);
+            }
+        }
+    }
+}
+
+BatchEvaluator::BatchEvaluator(size_t max_batch_size)
+    : _max_batch_size(max_batch_size),
+      _column_space(),
+      _steps(),
+      _result(nullptr)
+{
+    assert(max_batch_size > 0);
+}
+
+BatchEvaluator::~BatchEvaluator() = default;
+
+const feature_t *
+BatchEvaluator::evaluate(vespalib::ConstArrayRef<uint32_t> docids)
+{
+    assert(docids.size() <= _max_batch_size);
+    for (const auto &step: _steps) {
+        if (step.batch) {
+            step.executor->execute_batch(docids, step.inputs.data(), step.outputs.data());
+        } else {
+            run_per_document(step, docids);
+        }
+    }
+    // The output values of the executors are now out of sync with what they were executed for.
+    for (const auto &step: _steps) {
+        step.executor->clear_executed();
+    }
+    return _result;
+}
+
+}
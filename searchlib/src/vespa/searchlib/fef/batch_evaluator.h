@@ -0,0 +1,85 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "featureexecutor.h"
+#include <vespa/vespalib/util/arrayref.h>
+#include <memory>
+#include <vector>
+
+namespace search::fef {
+
+/**
+ * Calculates a number feature of a rank program for a block of
+ * documents at a time. The executors needed to calculate the feature
+ * are run one after another, each over the whole block, with
+ * intermediate feature values stored column-wise. This avoids the
+ * lazy per document evaluation of inputs done by LazyValue, and lets
+ * executors supporting it calculate the whole block in a single call
+ * (see FeatureExecutor::execute_batch). Other executors are run once
+ * per document with their inputs put in place from the columns.
+ *
+ * Only features not depending on term match data can be calculated
+ * this way, since match data is only available for one document at a
+ * time. Use RankProgram::make_batch_evaluator to create one.
+ **/
+class BatchEvaluator
+{
+public:
+    using UP = std::unique_ptr<BatchEvaluator>;
+
+    /**
+     * An executor to run, with its input and output columns. Columns
+     * are nullptr for object values.
+     **/
+    struct Step {
+        FeatureExecutor                 *executor;
+        bool                             batch;
+        std::vector<const feature_t *>   inputs;
+        std::vector<feature_t *>         outputs;
+        // where the executor reads non-const input values, with the executors producing them
+        std::vector<NumberOrObject *>    input_slots;
+        std::vector<FeatureExecutor *>   input_executors;
+        Step(FeatureExecutor &executor_in);
+        Step(Step &&) noexcept;
+        ~Step();
+    };
+
+private:
+    size_t                 _max_batch_size;
+    std::vector<feature_t> _column_space;
+    std::vector<Step>      _steps;
+    const feature_t       *_result;
+
+    void run_per_document(const Step &step, vespalib::ConstArrayRef<uint32_t> docids);
+
+public:
+    BatchEvaluator(size_t max_batch_size);
+    ~BatchEvaluator();
+
+    size_t max_batch_size() const { return _max_batch_size; }
+
+    /**
+     * Allocate a new column for feature values, returning its
+     * index. Columns must be allocated before they are resolved.
+     **/
+    size_t add_column() {
+        size_t idx = _column_space.size() / _max_batch_size;
+        _column_space.resize(_column_space.size() + _max_batch_size, 0.0);
+        return idx;
+    }
+    feature_t *resolve_column(size_t idx) { return &_column_space[idx * _max_batch_size]; }
+
+    void add_step(Step step) { _steps.push_back(std::move(step)); }
+    void set_result(const feature_t *result) { _result = result; }
+    size_t num_steps() const { return _steps.size(); }
+
+    /**
+     * Calculate the feature for the given documents (at most
+     * max_batch_size). The value for docids[i] is found at index i
+     * of the returned column, which is valid until the next call.
+     **/
+    const feature_t *evaluate(vespalib::ConstArrayRef<uint32_t> docids);
+};
+
+}
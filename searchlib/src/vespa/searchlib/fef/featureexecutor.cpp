@@ -2,6 +2,7 @@
 
 #include "featureexecutor.h"
 #include <vespa/vespalib/util/classname.h>
+#include <cstdlib>
 
 namespace search::fef {
 
@@ -20,6 +21,30 @@ FeatureExecutor::isPure()
     return false;
 }
 
+bool
+FeatureExecutor::uses_match_data()
+{
+    return !isPure();
+}
+
+bool
+FeatureExecutor::supports_batch()
+{
+    return false;
+}
+
+void
+FeatureExecutor::execute_batch(vespalib::ConstArrayRef<uint32_t>, const feature_t *const *, feature_t *const *)
+{
+    abort(); // only called for executors supporting it
+}
+
+bool
+FeatureExecutor::rebind(const IQueryEnvironment &)
+{
+    return false;
+}
+
 void
 FeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue>)
 {
@@ -10,6 +10,7 @@
 namespace search::fef {
 
 class FeatureExecutor;
+class IQueryEnvironment;
 
 /**
  * A LazyValue is a reference to a value that can be calculated by a
@@ -150,6 +151,59 @@ public:
      **/
     virtual bool isPure();
 
+    /**
+     * Check if the output feature values of this feature executor
+     * depend on the term match data unpacked for the document being
+     * evaluated. Only executors not using match data can be evaluated
+     * for a block of documents at a time (see BatchEvaluator), since
+     * match data is only available for one document at a time. This
+     * method returns false for pure executors and true otherwise by
+     * default. Executors that only depend on the document id and
+     * their inputs (like attribute lookups) should return false. It is
+     * always safe to let this method return true.
+     *
+     * @return true if this feature executor uses match data
+     **/
+    virtual bool uses_match_data();
+
+    /**
+     * Check if this feature executor can calculate its outputs for a
+     * block of documents in a single call to execute_batch.
+     *
+     * @return true if execute_batch is implemented
+     **/
+    virtual bool supports_batch();
+
+    /**
+     * Execute this feature executor for a block of documents, with
+     * input and output feature values stored column-wise: the number
+     * value of input i for docids[j] is found in inputs[i][j], and the
+     * number value of output i for docids[j] should be written to
+     * outputs[i][j]. inputs[i] is nullptr for object inputs. Only
+     * called for executors supporting it that do not use match data.
+     *
+     * @param docids the local document ids being evaluated
+     * @param inputs input feature value columns
+     * @param outputs output feature value columns
+     **/
+    virtual void execute_batch(vespalib::ConstArrayRef<uint32_t> docids,
+                               const feature_t *const *inputs,
+                               feature_t *const *outputs);
+
+    /**
+     * Bind this executor to the environment of another query, making
+     * it possible to reuse a rank program set up for an earlier query
+     * (see RankProgram::rebind). Executors keeping state taken from
+     * the query environment must refresh it here. This method is
+     * implemented to return false by default, telling the rank
+     * program that this executor must be created again for each
+     * query. It is always safe to return false.
+     *
+     * @return true if this executor can be used with the given query
+     * @param queryEnv the environment of the next query
+     **/
+    virtual bool rebind(const IQueryEnvironment &queryEnv);
+
     /**
      * Make sure this executor has been executed for the given
      * document.
@@ -158,11 +212,36 @@ public:
      **/
     void lazy_execute(uint32_t docid) {
         if (_inputs.get_docid() != docid) {
-            _inputs.set_docid(docid);
-            execute(docid);
+            force_execute(docid);
         }
     }
 
+    /**
+     * Execute this executor for the given document, even if it has
+     * already been executed for it.
+     *
+     * @param docid the local document id being evaluated
+     **/
+    void force_execute(uint32_t docid) {
+        _inputs.set_docid(docid);
+        execute(docid);
+    }
+
+    /**
+     * Mark this executor as executed for the given document without
+     * executing it. Used when the output feature values for the
+     * document have been put in place by someone else.
+     *
+     * @param docid the local document id the outputs belong to
+     **/
+    void mark_executed(uint32_t docid) { _inputs.set_docid(docid); }
+
+    /**
+     * Forget which document this executor was last executed for,
+     * making sure it is executed again on the next lazy_execute.
+     **/
+    void clear_executed() { _inputs.set_docid(-1); }
+
     /**
      * Virtual destructor to allow subclassing.
      **/
@@ -30,6 +30,12 @@ FeatureOverrider::isPure()
     return _executor.isPure();
 }
 
+bool
+FeatureOverrider::uses_match_data()
+{
+    return _executor.uses_match_data();
+}
+
 void
 FeatureOverrider::execute(uint32_t docId)
 {
@@ -274,6 +274,21 @@ MinHitsPerThread::lookup(const Properties &props, uint32_t defaultValue)
     return lookupUint32(props, NAME, defaultValue);
 }
 
+const vespalib::string MinTimePerThread::NAME("vespa.matching.mintimeperthread");
+const double MinTimePerThread::DEFAULT_VALUE(0.0);
+
+double
+MinTimePerThread::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+double
+MinTimePerThread::lookup(const Properties &props, double defaultValue)
+{
+    return lookupDouble(props, NAME, defaultValue);
+}
+
 } // namespace matching
 
 namespace softtimeout {
@@ -194,6 +194,19 @@ namespace matching {
         static uint32_t lookup(const Properties &props);
         static uint32_t lookup(const Properties &props, uint32_t defaultValue);
     };
+    /**
+     * Property for the minimum estimated matching time (in seconds)
+     * worth giving to a single search thread. When set, the number of
+     * threads used by a query is adapted to its estimated hits, the
+     * observed matching cost per hit for the rank profile and the
+     * number of queries running concurrently. 0 disables adaptation.
+     **/
+    struct MinTimePerThread {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+        static double lookup(const Properties &props, double defaultValue);
+    };
     /**
      * Property for the number of partitions inside the docid space.
      * A partition is a unit of work for the search threads.
@@ -0,0 +1,103 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "profiled_feature_executor.h"
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/stash.h>
+#include <algorithm>
+
+using vespalib::slime::Cursor;
+
+namespace search::fef {
+
+ProfiledFeatureExecutor::Profile::Profile()
+    : _nodes(),
+      _index(),
+      _input_time(vespalib::duration::zero())
+{
+}
+
+ProfiledFeatureExecutor::Profile::~Profile() = default;
+
+FeatureExecutor &
+ProfiledFeatureExecutor::Profile::wrap(FeatureExecutor &executor, const vespalib::string &name, vespalib::Stash &stash)
+{
+    auto pos = _index.find(name);
+    if (pos == _index.end()) {
+        pos = _index.insert(std::make_pair(name, _nodes.size())).first;
+        _nodes.emplace_back(name);
+    }
+    return stash.create<ProfiledFeatureExecutor>(executor, _nodes[pos->second].stats, _input_time);
+}
+
+void
+ProfiledFeatureExecutor::Profile::report(Cursor &arr) const
+{
+    std::vector<const Node *> nodes;
+    for (const Node &node: _nodes) {
+        nodes.push_back(&node);
+    }
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [](const Node *a, const Node *b){ return (a->stats.self_time > b->stats.self_time); });
+    for (const Node *node: nodes) {
+        Cursor &obj = arr.addObject();
+        obj.setString("name", node->name);
+        obj.setLong("count", node->stats.count);
+        obj.setDouble("self_ms", vespalib::count_ns(node->stats.self_time) / 1000000.0);
+        obj.setDouble("total_ms", vespalib::count_ns(node->stats.total_time) / 1000000.0);
+    }
+}
+
+void
+ProfiledFeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue> inputs)
+{
+    _executor.bind_inputs(inputs);
+}
+
+void
+ProfiledFeatureExecutor::handle_bind_outputs(vespalib::ArrayRef<NumberOrObject> outputs)
+{
+    _executor.bind_outputs(outputs);
+}
+
+void
+ProfiledFeatureExecutor::handle_bind_match_data(const MatchData &md)
+{
+    _executor.bind_match_data(md);
+}
+
+ProfiledFeatureExecutor::ProfiledFeatureExecutor(FeatureExecutor &executor, Stats &stats, vespalib::duration &input_time)
+    : _executor(executor),
+      _stats(stats),
+      _input_time(input_time)
+{
+}
+
+bool
+ProfiledFeatureExecutor::isPure()
+{
+    return _executor.isPure();
+}
+
+bool
+ProfiledFeatureExecutor::uses_match_data()
+{
+    return _executor.uses_match_data();
+}
+
+void
+ProfiledFeatureExecutor::execute(uint32_t docId)
+{
+    // inputs are calculated (by other profiled executors) while we are running
+    vespalib::duration outer_input_time = _input_time;
+    _input_time = vespalib::duration::zero();
+    vespalib::Timer timer;
+    _executor.force_execute(docId);
+    vespalib::duration elapsed = timer.elapsed();
+    ++_stats.count;
+    _stats.total_time += elapsed;
+    _stats.self_time += (elapsed - _input_time);
+    _input_time = outer_input_time + elapsed;
+}
+
+}
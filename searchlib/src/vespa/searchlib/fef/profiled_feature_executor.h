@@ -0,0 +1,78 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "featureexecutor.h"
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/time.h>
+#include <deque>
+
+namespace vespalib { class Stash; }
+namespace vespalib::slime { struct Cursor; }
+
+namespace search::fef {
+
+/**
+ * A decorator wrapping a single feature executor, counting how many
+ * times it is executed and measuring the time spent. Since inputs are
+ * calculated lazily, the total time of an executor includes the time
+ * spent calculating its inputs, while the self time does not. Use a
+ * Profile to wrap the executors of a rank program.
+ **/
+class ProfiledFeatureExecutor : public FeatureExecutor
+{
+public:
+    struct Stats {
+        uint64_t           count;
+        vespalib::duration self_time;
+        vespalib::duration total_time;
+        Stats() : count(0), self_time(vespalib::duration::zero()), total_time(vespalib::duration::zero()) {}
+    };
+
+    /**
+     * Profiling information for the feature executors of rank
+     * programs, collected by a single thread. Executors calculating
+     * the same feature share stats.
+     **/
+    class Profile {
+    private:
+        struct Node {
+            vespalib::string name;
+            Stats            stats;
+            Node(const vespalib::string &name_in) : name(name_in), stats() {}
+        };
+        std::deque<Node>                             _nodes; // stable references
+        vespalib::hash_map<vespalib::string, size_t> _index; // name -> node
+        vespalib::duration                           _input_time; // used to calculate self time
+    public:
+        Profile();
+        ~Profile();
+        /**
+         * Wrap an executor calculating the given feature with a
+         * profiled executor allocated in the given stash.
+         **/
+        FeatureExecutor &wrap(FeatureExecutor &executor, const vespalib::string &name, vespalib::Stash &stash);
+        /**
+         * Report the collected information as an array of objects,
+         * one per feature, with the most expensive features first.
+         **/
+        void report(vespalib::slime::Cursor &arr) const;
+    };
+
+private:
+    FeatureExecutor    &_executor;
+    Stats              &_stats;
+    vespalib::duration &_input_time;
+
+    void handle_bind_match_data(const MatchData &md) override;
+    void handle_bind_inputs(vespalib::ConstArrayRef<LazyValue> inputs) override;
+    void handle_bind_outputs(vespalib::ArrayRef<NumberOrObject> outputs) override;
+
+public:
+    ProfiledFeatureExecutor(FeatureExecutor &executor, Stats &stats, vespalib::duration &input_time);
+    bool isPure() override;
+    bool uses_match_data() override;
+    void execute(uint32_t docId) override;
+};
+
+}
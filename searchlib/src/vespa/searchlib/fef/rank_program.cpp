@@ -74,16 +74,21 @@ private:
     Stash &_secondary;
     bool _use_primary;
     Stash::Mark _primary_mark;
+    Stash::Mark _secondary_mark;
 public:
     StashSelector(Stash &primary, Stash &secondary)
         : _primary(primary), _secondary(secondary),
-          _use_primary(true), _primary_mark(primary.mark()) {}
+          _use_primary(true), _primary_mark(primary.mark()),
+          _secondary_mark(secondary.mark()) {}
     Stash &get() const { return _use_primary ? _primary : _secondary; }
     void use_secondary() {
         assert(_use_primary);
         _use_primary = false;
         _primary.revert(_primary_mark);
     }
+    void revert() {
+        get().revert(_use_primary ? _primary_mark : _secondary_mark);
+    }
 };
 
 } // namespace search::fef::<unnamed>
@@ -102,6 +107,18 @@ RankProgram::check_const(FeatureExecutor *executor, const std::vector<BlueprintR
     return true;    
 }
 
+LazyValue
+RankProgram::make_input(BlueprintResolver::FeatureRef ref) const
+{
+    FeatureExecutor *input_executor = _executors[ref.executor];
+    const NumberOrObject *input_value = input_executor->outputs().get_raw(ref.output);
+    if (check_const(input_value)) {
+        return LazyValue(input_value);
+    } else {
+        return LazyValue(input_value, input_executor);
+    }
+}
+
 void
 RankProgram::run_const(FeatureExecutor *executor)
 {
@@ -121,6 +138,7 @@ RankProgram::unbox(BlueprintResolver::FeatureRef seed, const MatchData &md)
     if (check_const(input_value)) {
         outputs[0].as_number = input_value->as_object.get().as_double();
         _unboxed_seeds.emplace(input_value, LazyValue(&outputs[0]));
+        _unboxings.emplace_back(seed, &outputs[0], vespalib::ArrayRef<LazyValue>(), nullptr);
     } else {
         vespalib::ArrayRef<LazyValue> inputs = _hot_stash.create_array<LazyValue>(1, input_value, input_executor);
         FeatureExecutor &unboxer = _hot_stash.create<UnboxingExecutor>();        
@@ -128,6 +146,7 @@ RankProgram::unbox(BlueprintResolver::FeatureRef seed, const MatchData &md)
         unboxer.bind_outputs(outputs);
         unboxer.bind_match_data(md);
         _unboxed_seeds.emplace(input_value, LazyValue(&outputs[0], &unboxer));
+        _unboxings.emplace_back(seed, &outputs[0], inputs, &unboxer);
     }
 }
 
@@ -159,9 +178,13 @@ RankProgram::RankProgram(BlueprintResolver::SP resolver)
     : _resolver(std::move(resolver)),
       _hot_stash(32768),
       _cold_stash(),
+      _query_stash(),
       _executors(),
+      _bindings(),
+      _unboxings(),
       _unboxed_seeds(),
-      _is_const()
+      _is_const(),
+      _can_rebind(false)
 {
 }
 
@@ -170,15 +193,18 @@ RankProgram::~RankProgram() = default;
 void
 RankProgram::setup(const MatchData &md,
                    const IQueryEnvironment &queryEnv,
-                   const Properties &featureOverrides)
+                   const Properties &featureOverrides,
+                   ProfiledFeatureExecutor::Profile *profile)
 {
     assert(_executors.empty());
     std::vector<Override> overrides = prepare_overrides(_resolver->getFeatureMap(), featureOverrides);
     auto override = overrides.begin();
     auto override_end = overrides.end();
+    _can_rebind = (overrides.empty() && (profile == nullptr));
 
     const auto &specs = _resolver->getExecutorSpecs();
     _executors.reserve(specs.size());
+    _bindings.reserve(specs.size());
     _is_const.resize(specs.size()*2); // Reserve space in hashmap for executors to be const
     for (uint32_t i = 0; i < specs.size(); ++i) {
         vespalib::ArrayRef<NumberOrObject> outputs = _hot_stash.create_array<NumberOrObject>(specs[i].output_types.size());
@@ -190,26 +216,30 @@ RankProgram::setup(const MatchData &md,
             executor = &(specs[i].blueprint->createExecutor(queryEnv, stash.get()));
             is_const = executor->isPure();
         }
+        // executors that cannot be rebound live in the query stash, to be replaced on rebind
+        bool per_query = (_can_rebind && !executor->rebind(queryEnv));
+        if (per_query) {
+            stash.revert();
+            executor = &(specs[i].blueprint->createExecutor(queryEnv, _query_stash));
+            is_const = (is_const && executor->isPure());
+        }
         size_t num_inputs = specs[i].inputs.size();
         vespalib::ArrayRef<LazyValue> inputs = stash.get().create_array<LazyValue>(num_inputs, nullptr);
         for (size_t input_idx = 0; input_idx < num_inputs; ++input_idx) {
-            auto ref = specs[i].inputs[input_idx];
-            FeatureExecutor *input_executor = _executors[ref.executor];
-            const NumberOrObject *input_value = input_executor->outputs().get_raw(ref.output);
-            if (check_const(input_value)) {
-                inputs[input_idx] = LazyValue(input_value);
-            } else {
-                inputs[input_idx] = LazyValue(input_value, input_executor);
-            }
+            inputs[input_idx] = make_input(specs[i].inputs[input_idx]);
         }
         for (; (override < override_end) && (override->ref.executor == i); ++override) {
             FeatureExecutor *tmp = executor;
             executor = &(stash.get().create<FeatureOverrider>(*tmp, override->ref.output, override->value));
         }
+        if ((profile != nullptr) && !is_const) {
+            executor = &(profile->wrap(*executor, specs[i].blueprint->getName(), stash.get()));
+        }
         executor->bind_inputs(inputs);
         executor->bind_outputs(outputs);
         executor->bind_match_data(md);
         _executors.push_back(executor);
+        _bindings.emplace_back(inputs, outputs, is_const, per_query);
         if (is_const) {
             run_const(executor);
         }
@@ -239,6 +269,61 @@ RankProgram::setup(const MatchData &md,
     }
 }
 
+bool
+RankProgram::rebind(const MatchData &md, const IQueryEnvironment &queryEnv)
+{
+    if (!_can_rebind || _executors.empty()) {
+        return false;
+    }
+    _query_stash.clear();
+    const auto &specs = _resolver->getExecutorSpecs();
+    for (uint32_t i = 0; i < specs.size(); ++i) {
+        Binding &binding = _bindings[i];
+        FeatureExecutor *executor = _executors[i];
+        if (binding.per_query) {
+            executor = &(specs[i].blueprint->createExecutor(queryEnv, _query_stash));
+            if (binding.is_const && !executor->isPure()) {
+                _can_rebind = false;
+                return false;
+            }
+            _executors[i] = executor;
+        } else if (!executor->rebind(queryEnv)) {
+            _can_rebind = false;
+            return false;
+        }
+        for (size_t input_idx = 0; input_idx < binding.inputs.size(); ++input_idx) {
+            binding.inputs[input_idx] = make_input(specs[i].inputs[input_idx]);
+        }
+        if (binding.per_query) {
+            executor->bind_inputs(binding.inputs);
+            executor->bind_outputs(binding.outputs);
+        }
+        executor->bind_match_data(md);
+        executor->clear_executed();
+        if (binding.is_const) {
+            executor->lazy_execute(1);
+        }
+    }
+    for (auto &unboxing: _unboxings) {
+        FeatureExecutor *input_executor = _executors[unboxing.seed.executor];
+        const NumberOrObject *input_value = input_executor->outputs().get_raw(unboxing.seed.output);
+        if (unboxing.unboxer == nullptr) {
+            unboxing.output->as_number = input_value->as_object.get().as_double();
+        } else {
+            unboxing.inputs[0] = LazyValue(input_value, input_executor);
+            unboxing.unboxer->bind_match_data(md);
+            unboxing.unboxer->clear_executed();
+        }
+    }
+    return true;
+}
+
+void
+RankProgram::unbind()
+{
+    _query_stash.clear();
+}
+
 FeatureResolver
 RankProgram::get_seeds(bool unbox_seeds) const
 {
@@ -251,4 +336,96 @@ RankProgram::get_all_features(bool unbox_seeds) const
     return resolve(_resolver->getFeatureMap(), unbox_seeds);
 }
 
+BatchEvaluator::UP
+RankProgram::make_batch_evaluator(size_t max_batch_size) const
+{
+    const auto &seeds = _resolver->getSeedMap();
+    if (seeds.size() != 1) {
+        return BatchEvaluator::UP();
+    }
+    const auto &specs = _resolver->getExecutorSpecs();
+    auto seed = seeds.begin()->second;
+    auto is_object = [&specs](BlueprintResolver::FeatureRef ref) {
+        return specs[ref.executor].output_types[ref.output].is_object();
+    };
+    auto get_raw = [this](BlueprintResolver::FeatureRef ref) {
+        return _executors[ref.executor]->outputs().get_raw(ref.output);
+    };
+    if (is_object(seed) || check_const(get_raw(seed))) {
+        return BatchEvaluator::UP();
+    }
+    // Executors always come after the executors producing their inputs.
+    std::vector<bool> needed(seed.executor + 1, false);
+    needed[seed.executor] = true;
+    for (size_t i = seed.executor + 1; i-- > 0; ) {
+        if (!needed[i]) {
+            continue;
+        }
+        if (_executors[i]->uses_match_data()) {
+            return BatchEvaluator::UP();
+        }
+        for (const auto &ref: specs[i].inputs) {
+            if (!check_const(get_raw(ref))) {
+                if (is_object(ref)) {
+                    return BatchEvaluator::UP();
+                }
+                needed[ref.executor] = true;
+            }
+        }
+    }
+    constexpr size_t no_column = -1;
+    auto evaluator = std::make_unique<BatchEvaluator>(max_batch_size);
+    // Resolve columns after all of them have been added, since adding may move the column space.
+    std::vector<size_t> first_output_column(needed.size(), 0);
+    std::vector<std::vector<size_t>> input_columns(needed.size());
+    for (size_t i = 0; i < needed.size(); ++i) {
+        if (!needed[i]) {
+            continue;
+        }
+        for (const auto &ref: specs[i].inputs) {
+            const NumberOrObject *raw = get_raw(ref);
+            if (check_const(raw)) {
+                if (is_object(ref)) {
+                    input_columns[i].push_back(no_column);
+                } else {
+                    input_columns[i].push_back(evaluator->add_column());
+                    std::fill_n(evaluator->resolve_column(input_columns[i].back()), max_batch_size, raw->as_number);
+                }
+            } else {
+                input_columns[i].push_back(first_output_column[ref.executor] + ref.output);
+            }
+        }
+        first_output_column[i] = evaluator->add_column();
+        for (size_t out_idx = 1; out_idx < specs[i].output_types.size(); ++out_idx) {
+            evaluator->add_column();
+        }
+    }
+    for (size_t i = 0; i < needed.size(); ++i) {
+        if (!needed[i]) {
+            continue;
+        }
+        FeatureExecutor *executor = _executors[i];
+        BatchEvaluator::Step step(*executor);
+        for (size_t input_idx = 0; input_idx < specs[i].inputs.size(); ++input_idx) {
+            auto ref = specs[i].inputs[input_idx];
+            size_t column = input_columns[i][input_idx];
+            step.inputs.push_back((column == no_column) ? nullptr : evaluator->resolve_column(column));
+            if (check_const(get_raw(ref))) {
+                step.input_slots.push_back(nullptr);
+                step.input_executors.push_back(nullptr);
+            } else {
+                step.input_slots.push_back(&_executors[ref.executor]->outputs().get_bound()[ref.output]);
+                step.input_executors.push_back(_executors[ref.executor]);
+            }
+        }
+        for (size_t out_idx = 0; out_idx < specs[i].output_types.size(); ++out_idx) {
+            bool is_object_output = specs[i].output_types[out_idx].is_object();
+            step.outputs.push_back(is_object_output ? nullptr : evaluator->resolve_column(first_output_column[i] + out_idx));
+        }
+        evaluator->add_step(std::move(step));
+    }
+    evaluator->set_result(evaluator->resolve_column(first_output_column[seed.executor] + seed.output));
+    return evaluator;
+}
+
 }
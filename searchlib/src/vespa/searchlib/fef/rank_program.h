@@ -2,11 +2,13 @@
 
 #pragma once
 
+#include "batch_evaluator.h"
 #include "blueprintresolver.h"
 #include "featureexecutor.h"
 #include "properties.h"
 #include "matchdata.h"
 #include "feature_resolver.h"
+#include "profiled_feature_executor.h"
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/array.h>
 #include <vespa/vespalib/util/stash.h>
@@ -23,6 +25,11 @@ namespace search::fef {
  * that you need unpack any relevant posting information into the
  * MatchData object passed to the setup function before trying to
  * resolve lazy values.
+ *
+ * A rank program set up without feature overrides or profiling can
+ * be rebound to later queries (see rebind), keeping the executor
+ * graph and the memory backing it. Only executors unable to rebind
+ * to the new query environment are created again.
  **/
 class RankProgram
 {
@@ -34,15 +41,41 @@ private:
     using ValueSet = vespalib::hash_set<const NumberOrObject *, vespalib::hash<const NumberOrObject *>,
                                         std::equal_to<>, vespalib::hashtable_base::and_modulator>;
 
+    // what is needed to bind an executor again for another query
+    struct Binding {
+        vespalib::ArrayRef<LazyValue>      inputs;
+        vespalib::ArrayRef<NumberOrObject> outputs;
+        bool                               is_const;
+        bool                               per_query;
+        Binding(vespalib::ArrayRef<LazyValue> inputs_in, vespalib::ArrayRef<NumberOrObject> outputs_in,
+                bool is_const_in, bool per_query_in)
+            : inputs(inputs_in), outputs(outputs_in), is_const(is_const_in), per_query(per_query_in) {}
+    };
+
+    struct Unboxing {
+        BlueprintResolver::FeatureRef seed;
+        NumberOrObject               *output;
+        vespalib::ArrayRef<LazyValue> inputs;
+        FeatureExecutor              *unboxer; // nullptr if seed is const
+        Unboxing(BlueprintResolver::FeatureRef seed_in, NumberOrObject *output_in,
+                 vespalib::ArrayRef<LazyValue> inputs_in, FeatureExecutor *unboxer_in)
+            : seed(seed_in), output(output_in), inputs(inputs_in), unboxer(unboxer_in) {}
+    };
+
     BlueprintResolver::SP            _resolver;
     vespalib::Stash                  _hot_stash;
     vespalib::Stash                  _cold_stash;
+    vespalib::Stash                  _query_stash;
     std::vector<FeatureExecutor *>   _executors;
+    std::vector<Binding>             _bindings;
+    std::vector<Unboxing>            _unboxings;
     MappedValues                     _unboxed_seeds;
     ValueSet                         _is_const;
+    bool                             _can_rebind;
 
     bool check_const(const NumberOrObject *value) const { return (_is_const.count(value) == 1); }
     bool check_const(FeatureExecutor *executor, const std::vector<BlueprintResolver::FeatureRef> &inputs) const;
+    LazyValue make_input(BlueprintResolver::FeatureRef ref) const;
     void run_const(FeatureExecutor *executor);
     void unbox(BlueprintResolver::FeatureRef seed, const MatchData &md);
     FeatureResolver resolve(const BlueprintResolver::FeatureMap &features, bool unbox_seeds) const;
@@ -58,17 +91,46 @@ public:
     RankProgram(BlueprintResolver::SP resolver);
     ~RankProgram();
 
+    const BlueprintResolver &resolver() const { return *_resolver; }
     size_t num_executors() const { return _executors.size(); }
     const FeatureExecutor &get_executor(size_t i) const { return *_executors[i]; }
 
     /**
      * Set up this rank program by creating the needed feature
      * executors and wiring them together. This function will also
-     * pre-calculate all constant features.
+     * pre-calculate all constant features. If a profile is given,
+     * all non-constant executors are wrapped to collect profiling
+     * information into it.
      **/
     void setup(const MatchData &md,
                const IQueryEnvironment &queryEnv,
-               const Properties &featureOverrides = Properties());
+               const Properties &featureOverrides = Properties(),
+               ProfiledFeatureExecutor::Profile *profile = nullptr);
+
+    /**
+     * Returns true if this rank program has been set up without
+     * feature overrides or profiling, making it possible to rebind
+     * it to other queries.
+     **/
+    bool can_rebind() const { return _can_rebind; }
+
+    /**
+     * Bind this rank program to another query, making it ready for
+     * use as if it was set up from scratch with the given match data
+     * and query environment. Executors able to rebind to the query
+     * environment are kept, the others are created again. All
+     * constant features are calculated again. If this function
+     * returns false, the rank program must be thrown away and a new
+     * one set up for the query.
+     **/
+    bool rebind(const MatchData &md, const IQueryEnvironment &queryEnv);
+
+    /**
+     * Release the executors created for the current query, keeping
+     * the rest of this rank program for a later rebind. The rank
+     * program may not be used again until it has been rebound.
+     **/
+    void unbind();
 
     /**
      * Obtain the names and storage locations of all seed features for
@@ -88,6 +150,17 @@ public:
      * @params unbox_seeds make sure seeds values are numbers
      **/
     FeatureResolver get_all_features(bool unbox_seeds = true) const;
+
+    /**
+     * Create an evaluator calculating the single seed of this rank
+     * program for a block of documents at a time. This is only
+     * possible when the seed is a number that does not depend on
+     * term match data, otherwise nullptr is returned and the seed
+     * must be calculated one document at a time after unpacking it.
+     *
+     * @param max_batch_size the max number of documents per block
+     **/
+    BatchEvaluator::UP make_batch_evaluator(size_t max_batch_size) const;
 };
 
 }
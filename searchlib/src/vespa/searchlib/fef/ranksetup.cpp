@@ -39,6 +39,7 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _termwise_limit(1.0),
       _numThreads(0),
       _minHitsPerThread(0),
+      _minTimePerThread(0.0),
       _numSearchPartitions(0),
       _heapSize(0),
       _arraySize(0),
@@ -85,6 +86,7 @@ RankSetup::configure()
     set_termwise_limit(matching::TermwiseLimit::lookup(_indexEnv.getProperties()));
     setNumThreadsPerSearch(matching::NumThreadsPerSearch::lookup(_indexEnv.getProperties()));
     setMinHitsPerThread(matching::MinHitsPerThread::lookup(_indexEnv.getProperties()));
+    setMinTimePerThread(matching::MinTimePerThread::lookup(_indexEnv.getProperties()));
     setNumSearchPartitions(matching::NumSearchPartitions::lookup(_indexEnv.getProperties()));
     setHeapSize(hitcollector::HeapSize::lookup(_indexEnv.getProperties()));
     setArraySize(hitcollector::ArraySize::lookup(_indexEnv.getProperties()));
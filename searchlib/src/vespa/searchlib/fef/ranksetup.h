@@ -36,6 +36,7 @@ private:
     double                   _termwise_limit;
     uint32_t                 _numThreads;
     uint32_t                 _minHitsPerThread;
+    double                   _minTimePerThread;
     uint32_t                 _numSearchPartitions;
     uint32_t                 _heapSize;
     uint32_t                 _arraySize;
@@ -160,6 +161,8 @@ public:
     uint32_t getNumThreadsPerSearch() const { return _numThreads; }
     uint32_t getMinHitsPerThread() const { return _minHitsPerThread; }
     void setMinHitsPerThread(uint32_t minHitsPerThread) { _minHitsPerThread = minHitsPerThread; }
+    double getMinTimePerThread() const { return _minTimePerThread; }
+    void setMinTimePerThread(double minTimePerThread) { _minTimePerThread = minTimePerThread; }
 
     void setNumSearchPartitions(uint32_t numSearchPartitions) { _numSearchPartitions = numSearchPartitions; }
 
@@ -16,6 +16,7 @@ namespace search::fef::test {
 struct ImpureValueExecutor : FeatureExecutor {
     double value;
     ImpureValueExecutor(double value_in) : value(value_in) {}
+    bool uses_match_data() override { return false; }
     void execute(uint32_t) override { outputs().set_number(0, value); }
 };
 
@@ -37,6 +38,7 @@ ImpureValueBlueprint::createExecutor(const IQueryEnvironment &, vespalib::Stash
 //-----------------------------------------------------------------------------
 
 struct DocidExecutor : FeatureExecutor {
+    bool uses_match_data() override { return false; }
     void execute(uint32_t docid) override { outputs().set_number(0, docid); }
 };
 
@@ -116,6 +116,14 @@ void OptimizedAndNotForBlackListing::initRange(uint32_t beginid, uint32_t endid)
     setDocId(internalSeek<false>(beginid));
 }
 
+void OptimizedAndNotForBlackListing::transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f)
+{
+    // the black list iterator is used directly (by type), only transform the positive child
+    AndNotSearch::transform_children([&f](SearchIterator::UP child, size_t index) {
+                                         return (index == 0) ? f(std::move(child), index) : std::move(child);
+                                     });
+}
+
 bool OptimizedAndNotForBlackListing::isBlackListIterator(const SearchIterator * iterator)
 {
     return dynamic_cast<const BlackListIterator *>(iterator) != 0;
@@ -67,6 +67,7 @@ public:
         return internalSeek<true>(docid);
     }
     void initRange(uint32_t beginid, uint32_t endid) override;
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override;
 private:
     SearchIterator * positive() { return getChildren()[0].get(); }
     BlackListIterator * blackList() { return static_cast<BlackListIterator *>(getChildren()[1].get()); }
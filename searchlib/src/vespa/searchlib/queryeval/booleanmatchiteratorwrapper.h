@@ -49,6 +49,9 @@ public:
     BooleanMatchIteratorWrapper(SearchIterator::UP search, const fef::TermFieldMatchDataArray &matchData);
 
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _search = f(std::move(_search), 0);
+    }
 };
 
 }
@@ -105,6 +105,9 @@ public:
     Trinary is_strict() const override { return Trinary::True; }
 
     void visitMembers(vespalib::ObjectVisitor &) const override {}
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _children.transform_children(f);
+    }
 };
 
 class SingleTermDotProductSearch : public DotProductSearch {
@@ -133,6 +136,9 @@ private:
         _child->initRange(beginId, endId);
         setDocId(_child->getDocId());
     }
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _child = f(std::move(_child), 0);
+    }
     SearchIterator::UP        _child;
     const TermFieldMatchData &_childTmd;
     TermFieldMatchData       &_tmd;
@@ -0,0 +1,30 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace search::queryeval {
+
+/**
+ * Interface implemented by search iterators over posting lists that
+ * are split into blocks with a known upper bound for the element
+ * weight of the documents in each block. Used by wand to reject
+ * candidates and skip blocks without unpacking features.
+ **/
+struct IBlockMaxWeight {
+    virtual ~IBlockMaxWeight() {}
+    /**
+     * The last document id in the block containing the current
+     * document of the iterator.
+     **/
+    virtual uint32_t get_block_end() const = 0;
+    /**
+     * Upper bound for the weight reported by the match data for any
+     * document in the block containing the current document of the
+     * iterator.
+     **/
+    virtual int32_t get_block_max_weight() const = 0;
+};
+
+}
@@ -20,11 +20,14 @@ SearchIteratorPack::SearchIteratorPack(const std::vector<SearchIterator*> &child
                                        MatchDataUP md)
     : _children(),
       _childMatch(childMatch),
+      _childBlockMax(),
       _md(std::move(md))
 {
     _children.reserve(children.size());
+    _childBlockMax.reserve(children.size());
     for (auto child: children) {
         _children.emplace_back(child);
+        _childBlockMax.push_back(dynamic_cast<const IBlockMaxWeight *>(child));
     }
     assert((_children.size() == _childMatch.size()) || _childMatch.empty());
 }
@@ -48,5 +51,13 @@ SearchIteratorPack::or_hits_into(BitVector &result, uint32_t begin_id) const {
     TermwiseHelper::orChildren(result, _children.begin(), _children.end(), begin_id);
 }
 
+void
+SearchIteratorPack::transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f)
+{
+    for (size_t i = 0; i < _children.size(); ++i) {
+        _children[i] = f(std::move(_children[i]), i);
+    }
+}
+
 
 }
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "searchiterator.h"
+#include "iblockmaxweight.h"
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <limits>
 
 namespace search::fef { class MatchData; }
 
@@ -15,6 +17,7 @@ private:
     using MatchDataUP = std::unique_ptr<fef::MatchData>;
     std::vector<SearchIterator::UP>        _children;
     std::vector<fef::TermFieldMatchData*>  _childMatch;
+    std::vector<const IBlockMaxWeight*>    _childBlockMax;
     MatchDataUP                            _md;
 
 public:
@@ -49,6 +52,16 @@ public:
         _children[ref]->doUnpack(docid);
     }
 
+    uint32_t get_block_end(uint32_t ref) const {
+        const IBlockMaxWeight *blockMax = _childBlockMax[ref];
+        return (blockMax != nullptr) ? blockMax->get_block_end() : _children[ref]->getDocId();
+    }
+
+    int32_t get_block_max_weight(uint32_t ref) const {
+        const IBlockMaxWeight *blockMax = _childBlockMax[ref];
+        return (blockMax != nullptr) ? blockMax->get_block_max_weight() : std::numeric_limits<int32_t>::max();
+    }
+
     size_t size() const {
         return _children.size();
     }
@@ -59,6 +72,8 @@ public:
     }
     std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id) const;
     void or_hits_into(BitVector &result, uint32_t begin_id) const;
+    // block max information is still taken from the original children (owned by their replacements)
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f);
 };
 
 }
@@ -13,6 +13,8 @@ class MultiBitVectorIteratorBase : public MultiSearch, protected BitWord
 public:
     ~MultiBitVectorIteratorBase() override;
     void initRange(uint32_t beginId, uint32_t endId) override;
+    // the bitvectors of the children are scanned directly, leave them as they are
+    void transform_children(const std::function<UP(UP, size_t)> &) override {}
     void addUnpackIndex(size_t index) { _unpackInfo.add(index); }
     /**
      * Will steal and optimize bitvectoriterators if it can
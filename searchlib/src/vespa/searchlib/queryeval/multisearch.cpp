@@ -55,6 +55,14 @@ MultiSearch::initRange(uint32_t beginid, uint32_t endid)
     }
 }
 
+void
+MultiSearch::transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f)
+{
+    for (size_t i = 0; i < _children.size(); ++i) {
+        _children[i] = f(std::move(_children[i]), i);
+    }
+}
+
 void
 MultiSearch::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
@@ -7,7 +7,7 @@
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/dense_tensor.h>
-#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
 #include <vespa/searchlib/tensor/distance_function_factory.h>
 #include <vespa/log/log.h>
 
@@ -42,16 +42,44 @@ template<>
 void
 convert_cells<double,double>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
 
+template<>
+void
+convert_cells<int8_t,int8_t>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
+
+template<>
+void
+convert_cells<vespalib::BFloat16,vespalib::BFloat16>(std::unique_ptr<DenseTensorView> &, vespalib::eval::ValueType) {}
+
 struct ConvertCellsSelector
 {
     template <typename LCT, typename RCT>
     static auto invoke() { return convert_cells<LCT, RCT>; }
 };
 
+// Estimated number of distance calculations per candidate explored when searching the index,
+// compared to a single distance calculation per document for a brute force scan.
+constexpr double index_cost_per_candidate = 10.0;
+
+// Upper bound for how much the number of candidates to explore is raised to compensate for a filter.
+constexpr double max_explore_k_adjustment_factor = 20.0;
+
+const char *
+to_string(NearestNeighborBlueprint::Algorithm algorithm)
+{
+    using Algorithm = NearestNeighborBlueprint::Algorithm;
+    switch (algorithm) {
+    case Algorithm::EXACT: return "exact";
+    case Algorithm::EXACT_FALLBACK: return "exact_fallback";
+    case Algorithm::INDEX_TOP_K: return "index_top_k";
+    case Algorithm::INDEX_TOP_K_WITH_FILTER: return "index_top_k_with_filter";
+    }
+    return "unknown";
+}
+
 } // namespace <unnamed>
 
 NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& field,
-                                                   const tensor::DenseTensorAttribute& attr_tensor,
+                                                   const tensor::TensorAttribute& attr_tensor,
                                                    std::unique_ptr<vespalib::tensor::DenseTensorView> query_tensor,
                                                    uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits)
     : ComplexLeafBlueprint(field),
@@ -60,6 +88,9 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
       _target_num_hits(target_num_hits),
       _approximate(approximate),
       _explore_additional_hits(explore_additional_hits),
+      _explore_k(target_num_hits + explore_additional_hits),
+      _algorithm(Algorithm::EXACT),
+      _global_filter_hit_ratio(),
       _fallback_dist_fun(),
       _distance_heap(target_num_hits),
       _found_hits(),
@@ -67,9 +98,9 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
 {
     auto lct = _query_tensor->cellsRef().type;
     auto rct = _attr_tensor.getTensorType().cell_type();
-    using MyTypify = vespalib::eval::TypifyCellType;
+    using MyTypify = vespalib::eval::TypifyAllCellTypes;
     auto fixup_fun = vespalib::typify_invoke<2,MyTypify,ConvertCellsSelector>(lct, rct);
-    fixup_fun(_query_tensor, _attr_tensor.getTensorType());
+    fixup_fun(_query_tensor, tensor::TensorAttribute::vector_type(_attr_tensor.getTensorType()));
     _fallback_dist_fun = search::tensor::make_distance_function(_attr_tensor.getConfig().distance_metric(), rct);
     _dist_fun = _fallback_dist_fun.get();
     auto nns_index = _attr_tensor.nearest_neighbor_index();
@@ -93,20 +124,56 @@ NearestNeighborBlueprint::set_global_filter(const GlobalFilter &global_filter)
         (nns_index ? "nns_index" : "no_index"),
         (_global_filter->has_filter() ? "has_filter" : "no_filter"));
     if (_approximate && nns_index) {
-        uint32_t est_hits = _attr_tensor.getNumDocs();
+        uint32_t num_docs = _attr_tensor.getNumDocs();
+        uint32_t est_hits = num_docs;
+        _explore_k = _target_num_hits + _explore_additional_hits;
         if (_global_filter->has_filter()) {
             uint32_t max_hits = _global_filter->filter()->countTrueBits();
-            LOG(debug, "set_global_filter getNumDocs: %u / max_hits %u", est_hits, max_hits);
-            if (max_hits * 10 < est_hits) {
-                LOG(debug, "too many hits filtered out, consider using brute force implementation");
+            double hit_ratio = (num_docs > 0) ? (double(max_hits) / num_docs) : 0.0;
+            _global_filter_hit_ratio = hit_ratio;
+            if (prefer_exact_search(max_hits, num_docs, _explore_k)) {
+                _algorithm = Algorithm::EXACT_FALLBACK;
+            } else {
+                _algorithm = Algorithm::INDEX_TOP_K_WITH_FILTER;
             }
+            _explore_k = adjust_explore_k(_explore_k, hit_ratio);
             est_hits = std::min(est_hits, max_hits);
+            LOG(debug, "set_global_filter getNumDocs: %u / max_hits %u / hit_ratio %f / explore_k %u",
+                num_docs, max_hits, hit_ratio, _explore_k);
+        } else {
+            _algorithm = Algorithm::INDEX_TOP_K;
         }
+        LOG(debug, "set_global_filter selected algorithm: %s", to_string(_algorithm));
         est_hits = std::min(est_hits, _target_num_hits);
         setEstimate(HitEstimate(est_hits, false));
-        perform_top_k();
-        LOG(debug, "perform_top_k found %zu hits", _found_hits.size());
+        if (_algorithm != Algorithm::EXACT_FALLBACK) {
+            perform_top_k();
+            LOG(debug, "perform_top_k found %zu hits", _found_hits.size());
+        }
+    }
+}
+
+uint32_t
+NearestNeighborBlueprint::adjust_explore_k(uint32_t explore_k, double hit_ratio)
+{
+    if (hit_ratio <= 0.0 || hit_ratio >= 1.0) {
+        return explore_k;
     }
+    double adjusted = std::min(explore_k / hit_ratio, explore_k * max_explore_k_adjustment_factor);
+    return static_cast<uint32_t>(adjusted);
+}
+
+bool
+NearestNeighborBlueprint::prefer_exact_search(uint32_t filter_hits, uint32_t num_docs, uint32_t explore_k)
+{
+    if (filter_hits == 0 || num_docs == 0) {
+        return true;
+    }
+    double hit_ratio = double(filter_hits) / num_docs;
+    // About explore_k / hit_ratio candidates are visited to find explore_k candidates passing the filter.
+    double index_cost = (explore_k / hit_ratio) * index_cost_per_candidate;
+    double exact_cost = filter_hits;
+    return (exact_cost <= index_cost);
 }
 
 void
@@ -115,16 +182,16 @@ NearestNeighborBlueprint::perform_top_k()
     auto nns_index = _attr_tensor.nearest_neighbor_index();
     if (_approximate && nns_index) {
         auto lhs_type = _query_tensor->fast_type();
-        auto rhs_type = _attr_tensor.getTensorType();
+        auto rhs_type = tensor::TensorAttribute::vector_type(_attr_tensor.getTensorType());
         // different cell types should be converted already
         if (lhs_type == rhs_type) {
             auto lhs = _query_tensor->cellsRef();
             uint32_t k = _target_num_hits;
             if (_global_filter->has_filter()) {
                 auto filter = _global_filter->filter();
-                _found_hits = nns_index->find_top_k_with_filter(k, lhs, *filter, k + _explore_additional_hits);
+                _found_hits = nns_index->find_top_k_with_filter(k, lhs, *filter, _explore_k);
             } else {
-                _found_hits = nns_index->find_top_k(k, lhs, k + _explore_additional_hits);
+                _found_hits = nns_index->find_top_k(k, lhs, _explore_k);
             }
         }
     }
@@ -152,6 +219,11 @@ NearestNeighborBlueprint::visitMembers(vespalib::ObjectVisitor& visitor) const
     visitor.visitInt("target_num_hits", _target_num_hits);
     visitor.visitBool("approximate", _approximate);
     visitor.visitInt("explore_additional_hits", _explore_additional_hits);
+    visitor.visitInt("explore_k", _explore_k);
+    visitor.visitString("algorithm", to_string(_algorithm));
+    if (_global_filter_hit_ratio.has_value()) {
+        visitor.visitFloat("global_filter_hit_ratio", _global_filter_hit_ratio.value());
+    }
 }
 
 bool
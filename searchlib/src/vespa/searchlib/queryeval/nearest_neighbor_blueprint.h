@@ -5,9 +5,10 @@
 #include "nearest_neighbor_distance_heap.h"
 #include <vespa/searchlib/tensor/distance_function.h>
 #include <vespa/searchlib/tensor/nearest_neighbor_index.h>
+#include <optional>
 
 namespace vespalib::tensor { class DenseTensorView; }
-namespace search::tensor { class DenseTensorAttribute; }
+namespace search::tensor { class TensorAttribute; }
 
 namespace search::queryeval {
 
@@ -15,15 +16,31 @@ namespace search::queryeval {
  * Blueprint for nearest neighbor search iterator.
  *
  * The search iterator matches the K nearest neighbors in a multi-dimensional vector space,
- * where the query point and document points are dense tensors of order 1.
+ * where the query point is a dense tensor of order 1. Each document point is either a dense tensor of order 1,
+ * or a set of such points given by the dense subspaces of a tensor with one mapped and one indexed dimension.
+ * In the latter case the distance to a document is the distance to its closest point.
+ *
+ * When a global filter is present, a simple cost model is used to select
+ * between searching the nearest neighbor index and a brute force scan of
+ * the documents passing the filter.
  */
 class NearestNeighborBlueprint : public ComplexLeafBlueprint {
+public:
+    enum class Algorithm {
+        EXACT,
+        EXACT_FALLBACK,
+        INDEX_TOP_K,
+        INDEX_TOP_K_WITH_FILTER
+    };
 private:
-    const tensor::DenseTensorAttribute& _attr_tensor;
+    const tensor::TensorAttribute& _attr_tensor;
     std::unique_ptr<vespalib::tensor::DenseTensorView> _query_tensor;
     uint32_t _target_num_hits;
     bool _approximate;
     uint32_t _explore_additional_hits;
+    uint32_t _explore_k;
+    Algorithm _algorithm;
+    std::optional<double> _global_filter_hit_ratio;
     search::tensor::DistanceFunction::UP _fallback_dist_fun;
     const search::tensor::DistanceFunction *_dist_fun;
     mutable NearestNeighborDistanceHeap _distance_heap;
@@ -33,17 +50,31 @@ private:
     void perform_top_k();
 public:
     NearestNeighborBlueprint(const queryeval::FieldSpec& field,
-                             const tensor::DenseTensorAttribute& attr_tensor,
+                             const tensor::TensorAttribute& attr_tensor,
                              std::unique_ptr<vespalib::tensor::DenseTensorView> query_tensor,
                              uint32_t target_num_hits, bool approximate, uint32_t explore_additional_hits);
     NearestNeighborBlueprint(const NearestNeighborBlueprint&) = delete;
     NearestNeighborBlueprint& operator=(const NearestNeighborBlueprint&) = delete;
     ~NearestNeighborBlueprint();
-    const tensor::DenseTensorAttribute& get_attribute_tensor() const { return _attr_tensor; }
+    const tensor::TensorAttribute& get_attribute_tensor() const { return _attr_tensor; }
     const vespalib::tensor::DenseTensorView& get_query_tensor() const { return *_query_tensor; }
     uint32_t get_target_num_hits() const { return _target_num_hits; }
     void set_global_filter(const GlobalFilter &global_filter) override;
     bool may_approximate() const { return _approximate; }
+    Algorithm get_algorithm() const { return _algorithm; }
+    uint32_t get_explore_k() const { return _explore_k; }
+    std::optional<double> get_global_filter_hit_ratio() const { return _global_filter_hit_ratio; }
+
+    /**
+     * Returns the number of candidates to explore in the index when the given ratio of the documents pass the filter.
+     */
+    static uint32_t adjust_explore_k(uint32_t explore_k, double hit_ratio);
+
+    /**
+     * Returns whether a brute force scan of the documents passing the filter is estimated to be cheaper than searching the index.
+     * The given explore_k is the number of candidates wanted before adjusting for the filter (see adjust_explore_k).
+     */
+    static bool prefer_exact_search(uint32_t filter_hits, uint32_t num_docs, uint32_t explore_k);
 
     std::unique_ptr<SearchIterator> createLeafSearch(const search::fef::TermFieldMatchDataArray& tfmda,
                                                      bool strict) const override;
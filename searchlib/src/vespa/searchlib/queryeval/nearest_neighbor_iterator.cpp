@@ -2,8 +2,10 @@
 
 #include "nearest_neighbor_iterator.h"
 #include <vespa/searchlib/common/bitvector.h>
+#include <algorithm>
+#include <limits>
 
-using search::tensor::DenseTensorAttribute;
+using search::tensor::TensorAttribute;
 using vespalib::ConstArrayRef;
 using vespalib::tensor::DenseTensorView;
 using vespalib::tensor::MutableDenseTensorView;
@@ -22,6 +24,50 @@ is_compatible(const vespalib::eval::ValueType& lhs,
     return (lhs == rhs);
 }
 
+/**
+ * Calculates the distance to the dense tensor of order 1 stored for a document.
+ */
+class DenseVectorDistance {
+private:
+    MutableDenseTensorView _fieldTensor;
+public:
+    DenseVectorDistance(const NearestNeighborIterator::Params &params)
+        : _fieldTensor(params.tensorAttribute.getTensorType())
+    {
+        assert(is_compatible(_fieldTensor.fast_type(), params.queryTensor.fast_type()));
+    }
+    double calc(const NearestNeighborIterator::Params &params, const TypedCells &lhs, uint32_t docId, double limit) {
+        params.tensorAttribute.getTensor(docId, _fieldTensor);
+        auto rhs = _fieldTensor.cellsRef();
+        return params.distanceFunction->calc_with_limit(lhs, rhs, limit);
+    }
+};
+
+/**
+ * Calculates the distance to the closest of the vectors stored for a document,
+ * given by the dense subspaces of a tensor with one mapped and one indexed dimension.
+ */
+class MultiVectorDistance {
+private:
+    std::vector<TypedCells> _vectors;
+public:
+    MultiVectorDistance(const NearestNeighborIterator::Params &params)
+        : _vectors()
+    {
+        assert(is_compatible(TensorAttribute::vector_type(params.tensorAttribute.getTensorType()),
+                             params.queryTensor.fast_type()));
+    }
+    double calc(const NearestNeighborIterator::Params &params, const TypedCells &lhs, uint32_t docId, double limit) {
+        params.tensorAttribute.get_vectors(docId, _vectors);
+        // Documents without vectors never match.
+        double result = std::numeric_limits<double>::infinity();
+        for (const auto &rhs : _vectors) {
+            result = std::min(result, params.distanceFunction->calc_with_limit(lhs, rhs, std::min(limit, result)));
+        }
+        return result;
+    }
+};
+
 }
 
 /**
@@ -29,8 +75,9 @@ is_compatible(const vespalib::eval::ValueType& lhs,
  * Uses unpack() as feedback mechanism to track which matches actually became hits.
  * Keeps a heap of the K best hit distances.
  * Currently always does brute-force scanning, which is very expensive.
+ * Documents with several vectors are matched once, using the distance to the closest vector.
  **/
-template <bool strict, bool has_filter>
+template <bool strict, bool has_filter, typename DistanceCalc>
 class NearestNeighborImpl : public NearestNeighborIterator
 {
 public:
@@ -38,10 +85,9 @@ public:
     NearestNeighborImpl(Params params_in)
         : NearestNeighborIterator(params_in),
           _lhs(params().queryTensor.cellsRef()),
-          _fieldTensor(params().tensorAttribute.getTensorType()),
+          _distanceCalc(params()),
           _lastScore(0.0)
     {
-        assert(is_compatible(_fieldTensor.fast_type(), params().queryTensor.fast_type()));
     }
 
     ~NearestNeighborImpl();
@@ -76,37 +122,161 @@ public:
 
 private:
     double computeDistance(uint32_t docId, double limit) {
-        params().tensorAttribute.getTensor(docId, _fieldTensor);
-        auto rhs = _fieldTensor.cellsRef();
-        return params().distanceFunction->calc_with_limit(_lhs, rhs, limit);
+        return _distanceCalc.calc(params(), _lhs, docId, limit);
     }
 
     TypedCells             _lhs;
-    MutableDenseTensorView _fieldTensor;
+    DistanceCalc           _distanceCalc;
     double                 _lastScore;
 };
 
-template <bool strict, bool has_filter>
-NearestNeighborImpl<strict, has_filter>::~NearestNeighborImpl() = default;
+template <bool strict, bool has_filter, typename DistanceCalc>
+NearestNeighborImpl<strict, has_filter, DistanceCalc>::~NearestNeighborImpl() = default;
 
-namespace {
+/**
+ * Strict search iterator for K nearest neighbor matching over dense tensors of order 1.
+ * Scans the documents a block at a time: the vectors of the next block of candidate documents
+ * are gathered first, and the distances to all of them are calculated in one batch,
+ * which lets the distance function use vectorized kernels and prefetch the vectors.
+ * The precalculated distances are pruned against the current distance limit of the heap when seeking.
+ **/
+template <bool has_filter>
+class NearestNeighborBlockImpl : public NearestNeighborIterator
+{
+public:
+    static constexpr uint32_t block_size = 64;
+
+    NearestNeighborBlockImpl(Params params_in)
+        : NearestNeighborIterator(params_in),
+          _lhs(params().queryTensor.cellsRef()),
+          _fieldTensor(params().tensorAttribute.getTensorType()),
+          _docIds(),
+          _vectors(),
+          _distances(),
+          _pos(0),
+          _lastScore(0.0)
+    {
+        assert(is_compatible(_fieldTensor.fast_type(), params().queryTensor.fast_type()));
+        _docIds.reserve(block_size);
+        _vectors.reserve(block_size);
+        _distances.reserve(block_size);
+    }
+
+    ~NearestNeighborBlockImpl();
+
+    void initRange(uint32_t beginId, uint32_t endId) override {
+        NearestNeighborIterator::initRange(beginId, endId);
+        _docIds.clear();
+        _pos = 0;
+    }
+
+    void doSeek(uint32_t docId) override {
+        double distanceLimit = params().distanceHeap.distanceLimit();
+        while (__builtin_expect((docId < getEndId()), true)) {
+            while ((_pos < _docIds.size()) && (_docIds[_pos] < docId)) {
+                ++_pos;
+            }
+            if (_pos == _docIds.size()) {
+                fillBlock(docId);
+                if (_docIds.empty()) {
+                    break;
+                }
+            }
+            for (; _pos < _docIds.size(); ++_pos) {
+                if (_distances[_pos] <= distanceLimit) {
+                    _lastScore = _distances[_pos];
+                    setDocId(_docIds[_pos]);
+                    return;
+                }
+            }
+            docId = _docIds.back() + 1;
+        }
+        setAtEnd();
+    }
+
+    void doUnpack(uint32_t docId) override {
+        double score = params().distanceFunction->to_rawscore(_lastScore);
+        params().tfmd.setRawScore(docId, score);
+        params().distanceHeap.used(_lastScore);
+    }
+
+    Trinary is_strict() const override { return Trinary::True; }
+
+private:
+    uint32_t nextCandidate(uint32_t docId) const {
+        if (has_filter) {
+            const BitVector &filter = *params().filter;
+            if (docId >= filter.size()) {
+                return getEndId();
+            }
+            return filter.getNextTrueBit(docId);
+        }
+        return docId;
+    }
+
+    void fillBlock(uint32_t docId) {
+        _docIds.clear();
+        _vectors.clear();
+        _pos = 0;
+        uint32_t endId = getEndId();
+        while (_docIds.size() < block_size) {
+            docId = nextCandidate(docId);
+            if (docId >= endId) {
+                break;
+            }
+            params().tensorAttribute.getTensor(docId, _fieldTensor);
+            _docIds.push_back(docId);
+            _vectors.push_back(_fieldTensor.cellsRef());
+            ++docId;
+        }
+        _distances.resize(_docIds.size());
+        params().distanceFunction->calc_many(_lhs, _vectors.data(), _vectors.size(), _distances.data());
+    }
+
+    TypedCells              _lhs;
+    MutableDenseTensorView  _fieldTensor;
+    std::vector<uint32_t>   _docIds;
+    std::vector<TypedCells> _vectors;
+    std::vector<double>     _distances;
+    size_t                  _pos;
+    double                  _lastScore;
+};
 
 template <bool has_filter>
+NearestNeighborBlockImpl<has_filter>::~NearestNeighborBlockImpl() = default;
+
+namespace {
+
+template <bool has_filter, typename DistanceCalc>
 std::unique_ptr<NearestNeighborIterator>
 resolve_strict(bool strict, const NearestNeighborIterator::Params &params)
 {
-    CellType lct = params.queryTensor.fast_type().cell_type();
-    CellType rct = params.tensorAttribute.getTensorType().cell_type();
-    if (lct != rct) abort();
     if (strict) {
-        using NNI = NearestNeighborImpl<true, has_filter>;
+        using NNI = NearestNeighborImpl<true, has_filter, DistanceCalc>;
         return std::make_unique<NNI>(params);
     } else {
-        using NNI = NearestNeighborImpl<false, has_filter>;
+        using NNI = NearestNeighborImpl<false, has_filter, DistanceCalc>;
         return std::make_unique<NNI>(params);
     }
 }
 
+template <bool has_filter>
+std::unique_ptr<NearestNeighborIterator>
+resolve_distance_calc(bool strict, const NearestNeighborIterator::Params &params)
+{
+    CellType lct = params.queryTensor.fast_type().cell_type();
+    CellType rct = params.tensorAttribute.getTensorType().cell_type();
+    if (lct != rct) abort();
+    if (params.tensorAttribute.getTensorType().is_dense()) {
+        if (strict) {
+            return std::make_unique<NearestNeighborBlockImpl<has_filter>>(params);
+        }
+        return resolve_strict<has_filter, DenseVectorDistance>(strict, params);
+    } else {
+        return resolve_strict<has_filter, MultiVectorDistance>(strict, params);
+    }
+}
+
 } // namespace <unnamed>
 
 std::unique_ptr<NearestNeighborIterator>
@@ -114,7 +284,7 @@ NearestNeighborIterator::create(
         bool strict,
         fef::TermFieldMatchData &tfmd,
         const vespalib::tensor::DenseTensorView &queryTensor,
-        const search::tensor::DenseTensorAttribute &tensorAttribute,
+        const search::tensor::TensorAttribute &tensorAttribute,
         NearestNeighborDistanceHeap &distanceHeap,
         const search::BitVector *filter,
         const search::tensor::DistanceFunction *dist_fun)
@@ -122,9 +292,9 @@ NearestNeighborIterator::create(
 {
     Params params(tfmd, queryTensor, tensorAttribute, distanceHeap, filter, dist_fun);
     if (filter) {
-        return resolve_strict<true>(strict, params);
+        return resolve_distance_calc<true>(strict, params);
     } else  {
-        return resolve_strict<false>(strict, params);
+        return resolve_distance_calc<false>(strict, params);
     }
 }
 
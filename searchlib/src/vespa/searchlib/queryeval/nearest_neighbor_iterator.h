@@ -7,7 +7,7 @@
 #include <vespa/eval/tensor/dense/dense_tensor_view.h>
 #include <vespa/eval/tensor/dense/mutable_dense_tensor_view.h>
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
-#include <vespa/searchlib/tensor/dense_tensor_attribute.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
 #include <vespa/searchlib/tensor/distance_function.h>
 #include <vespa/vespalib/util/priority_queue.h>
 #include <cmath>
@@ -17,20 +17,20 @@ namespace search::queryeval {
 class NearestNeighborIterator : public SearchIterator
 {
 public:
-    using DenseTensorAttribute = search::tensor::DenseTensorAttribute;
+    using TensorAttribute = search::tensor::TensorAttribute;
     using DenseTensorView = vespalib::tensor::DenseTensorView;
 
     struct Params {
         fef::TermFieldMatchData &tfmd;
         const DenseTensorView &queryTensor;
-        const DenseTensorAttribute &tensorAttribute;
+        const TensorAttribute &tensorAttribute;
         NearestNeighborDistanceHeap &distanceHeap;
         const search::BitVector *filter;
         const search::tensor::DistanceFunction *distanceFunction;
         
         Params(fef::TermFieldMatchData &tfmd_in,
                const DenseTensorView &queryTensor_in,
-               const DenseTensorAttribute &tensorAttribute_in,
+               const TensorAttribute &tensorAttribute_in,
                NearestNeighborDistanceHeap &distanceHeap_in,
                const search::BitVector *filter_in,
                const search::tensor::DistanceFunction *distanceFunction_in)
@@ -51,7 +51,7 @@ public:
             bool strict,
             fef::TermFieldMatchData &tfmd,
             const vespalib::tensor::DenseTensorView &queryTensor,
-            const search::tensor::DenseTensorAttribute &tensorAttribute,
+            const search::tensor::TensorAttribute &tensorAttribute,
             NearestNeighborDistanceHeap &distanceHeap,
             const search::BitVector *filter,
             const search::tensor::DistanceFunction *dist_fun);
@@ -0,0 +1,227 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "profiled_iterator.h"
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/objects/visit.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <cassert>
+
+using vespalib::make_string;
+using vespalib::slime::Cursor;
+
+namespace search::queryeval {
+
+namespace {
+
+constexpr size_t no_parent = -1;
+
+double estimate_ms(vespalib::duration time, uint64_t num_timed, uint64_t num_total) {
+    if (num_timed == 0) {
+        return 0.0;
+    }
+    return (vespalib::count_ns(time) * (double(num_total) / num_timed)) / 1000000.0;
+}
+
+} // namespace search::queryeval::<unnamed>
+
+ProfiledIterator::Stats::Stats()
+    : num_seeks(0),
+      num_hits(0),
+      num_unpacks(0),
+      num_timed_seeks(0),
+      num_timed_unpacks(0),
+      num_termwise(0),
+      seek_time(vespalib::duration::zero()),
+      unpack_time(vespalib::duration::zero()),
+      termwise_time(vespalib::duration::zero())
+{
+}
+
+double
+ProfiledIterator::Stats::estimate_seek_ms() const
+{
+    return estimate_ms(seek_time, num_timed_seeks, num_seeks);
+}
+
+double
+ProfiledIterator::Stats::estimate_unpack_ms() const
+{
+    return estimate_ms(unpack_time, num_timed_unpacks, num_unpacks);
+}
+
+size_t
+ProfiledIterator::Profile::resolve(const vespalib::string &path, const vespalib::string &type, size_t parent)
+{
+    vespalib::string key = path + ":" + type;
+    auto pos = _index.find(key);
+    if (pos != _index.end()) {
+        return pos->second;
+    }
+    size_t node_idx = _nodes.size();
+    _nodes.emplace_back(type);
+    _index[key] = node_idx;
+    if (parent == no_parent) {
+        _roots.push_back(node_idx);
+    } else {
+        _nodes[parent].children.push_back(node_idx);
+    }
+    return node_idx;
+}
+
+SearchIterator::UP
+ProfiledIterator::Profile::wrap(SearchIterator::UP search, const vespalib::string &path, size_t parent)
+{
+    size_t node_idx = resolve(path, search->getClassName(), parent);
+    search->transform_children([this,&path,node_idx](SearchIterator::UP child, size_t index) {
+                                   return wrap(std::move(child), make_string("%s/%zu", path.c_str(), index), node_idx);
+                               });
+    return std::make_unique<ProfiledIterator>(std::move(search), _nodes[node_idx].stats, _sample_interval);
+}
+
+void
+ProfiledIterator::Profile::report(size_t node_idx, Cursor &obj) const
+{
+    const Node &node = _nodes[node_idx];
+    obj.setString("type", node.type);
+    obj.setLong("seeks", node.stats.num_seeks);
+    obj.setLong("hits", node.stats.num_hits);
+    obj.setLong("unpacks", node.stats.num_unpacks);
+    obj.setDouble("seek_ms", node.stats.estimate_seek_ms());
+    obj.setDouble("unpack_ms", node.stats.estimate_unpack_ms());
+    if (node.stats.num_termwise > 0) {
+        obj.setLong("termwise", node.stats.num_termwise);
+        obj.setDouble("termwise_ms", vespalib::count_ns(node.stats.termwise_time) / 1000000.0);
+    }
+    if (!node.children.empty()) {
+        Cursor &children = obj.setArray("children");
+        for (size_t child_idx: node.children) {
+            report(child_idx, children.addObject());
+        }
+    }
+}
+
+ProfiledIterator::Profile::Profile(uint32_t sample_interval)
+    : _sample_interval(std::max(sample_interval, 1u)),
+      _nodes(),
+      _index(),
+      _roots()
+{
+}
+
+ProfiledIterator::Profile::~Profile() = default;
+
+SearchIterator::UP
+ProfiledIterator::Profile::profile(SearchIterator::UP root)
+{
+    return wrap(std::move(root), "", no_parent);
+}
+
+void
+ProfiledIterator::Profile::report(Cursor &obj) const
+{
+    obj.setLong("sample_interval", _sample_interval);
+    Cursor &roots = obj.setArray("roots");
+    for (size_t root_idx: _roots) {
+        report(root_idx, roots.addObject());
+    }
+}
+
+ProfiledIterator::ProfiledIterator(SearchIterator::UP search, Stats &stats, uint32_t sample_interval)
+    : _search(std::move(search)),
+      _stats(stats),
+      _sample_interval(sample_interval),
+      _seeks_until_sample(1),
+      _unpacks_until_sample(1)
+{
+    assert(_sample_interval > 0);
+    setDocId(_search->getDocId());
+}
+
+ProfiledIterator::~ProfiledIterator() = default;
+
+void
+ProfiledIterator::initRange(uint32_t begin_id, uint32_t end_id)
+{
+    _search->initRange(begin_id, end_id);
+    SearchIterator::initRange(_search->getDocId() + 1, _search->getEndId());
+    if ((_search->getDocId() >= begin_id) && !_search->isAtEnd()) {
+        ++_stats.num_hits; // strict iterators may position themselves at the first match
+    }
+}
+
+void
+ProfiledIterator::doSeek(uint32_t docid)
+{
+    ++_stats.num_seeks;
+    if (__builtin_expect(--_seeks_until_sample == 0, false)) {
+        _seeks_until_sample = _sample_interval;
+        ++_stats.num_timed_seeks;
+        vespalib::Timer timer;
+        _search->doSeek(docid);
+        _stats.seek_time += timer.elapsed();
+    } else {
+        _search->doSeek(docid);
+    }
+    uint32_t next = _search->getDocId();
+    if ((next >= docid) && !_search->isAtEnd()) {
+        ++_stats.num_hits; // positioned at a matching document
+    }
+    setDocId(next);
+}
+
+void
+ProfiledIterator::doUnpack(uint32_t docid)
+{
+    ++_stats.num_unpacks;
+    if (__builtin_expect(--_unpacks_until_sample == 0, false)) {
+        _unpacks_until_sample = _sample_interval;
+        ++_stats.num_timed_unpacks;
+        vespalib::Timer timer;
+        _search->doUnpack(docid);
+        _stats.unpack_time += timer.elapsed();
+    } else {
+        _search->doUnpack(docid);
+    }
+}
+
+std::unique_ptr<BitVector>
+ProfiledIterator::get_hits(uint32_t begin_id)
+{
+    ++_stats.num_termwise;
+    vespalib::Timer timer;
+    auto result = _search->get_hits(begin_id);
+    _stats.termwise_time += timer.elapsed();
+    setDocId(_search->getDocId());
+    return result;
+}
+
+void
+ProfiledIterator::or_hits_into(BitVector &result, uint32_t begin_id)
+{
+    ++_stats.num_termwise;
+    vespalib::Timer timer;
+    _search->or_hits_into(result, begin_id);
+    _stats.termwise_time += timer.elapsed();
+    setDocId(_search->getDocId());
+}
+
+void
+ProfiledIterator::and_hits_into(BitVector &result, uint32_t begin_id)
+{
+    ++_stats.num_termwise;
+    vespalib::Timer timer;
+    _search->and_hits_into(result, begin_id);
+    _stats.termwise_time += timer.elapsed();
+    setDocId(_search->getDocId());
+}
+
+void
+ProfiledIterator::visitMembers(vespalib::ObjectVisitor &visitor) const
+{
+    visit(visitor, "search", *_search);
+}
+
+}
@@ -0,0 +1,111 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "searchiterator.h"
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/time.h>
+#include <deque>
+
+namespace search::queryeval {
+
+/**
+ * Search iterator decorator counting seeks, hits (the number of times
+ * the iterator ends up at a matching document) and unpacks for the
+ * wrapped iterator and measuring the time spent doing them. Measuring
+ * time for every call would cost about as much as seeking a cheap
+ * iterator, so only every n'th call is timed and the total time is
+ * estimated from the timed calls. Time spent in an iterator includes
+ * the time spent in its children. Use a Profile to wrap all iterators
+ * in an iterator tree.
+ **/
+class ProfiledIterator : public SearchIterator
+{
+public:
+    struct Stats {
+        uint64_t           num_seeks;
+        uint64_t           num_hits;
+        uint64_t           num_unpacks;
+        uint64_t           num_timed_seeks;
+        uint64_t           num_timed_unpacks;
+        uint64_t           num_termwise;
+        vespalib::duration seek_time;
+        vespalib::duration unpack_time;
+        vespalib::duration termwise_time;
+        Stats();
+        double estimate_seek_ms() const;
+        double estimate_unpack_ms() const;
+    };
+
+    /**
+     * Profiling information for all iterators in an iterator tree,
+     * collected by a single thread. Iterator trees profiled more than
+     * once (re-created for another ranking phase) share the stats of
+     * nodes with the same position and type. Children are wrapped
+     * through SearchIterator::transform_children. Iterators that
+     * do not own their children as search iterators, or depend on
+     * their exact type, show up as leaves: SameElementSearch,
+     * MultiBitVectorIterator, the monitoring iterators, the black
+     * list child of OptimizedAndNotForBlackListing and the attribute
+     * based weighted set, dot product and parallel weak and iterators.
+     **/
+    class Profile {
+    private:
+        struct Node {
+            vespalib::string    type;
+            std::vector<size_t> children;
+            Stats               stats;
+            Node(const vespalib::string &type_in) : type(type_in), children(), stats() {}
+        };
+        uint32_t                                     _sample_interval;
+        std::deque<Node>                             _nodes; // stable references
+        vespalib::hash_map<vespalib::string, size_t> _index; // path and type -> node
+        std::vector<size_t>                          _roots;
+
+        size_t resolve(const vespalib::string &path, const vespalib::string &type, size_t parent);
+        SearchIterator::UP wrap(SearchIterator::UP search, const vespalib::string &path, size_t parent);
+        void report(size_t node_idx, vespalib::slime::Cursor &obj) const;
+    public:
+        /**
+         * @param sample_interval time every n'th seek and unpack of each iterator
+         **/
+        Profile(uint32_t sample_interval);
+        ~Profile();
+        /**
+         * Wrap all iterators in the given tree with profiled
+         * iterators. Must be called before the iterator tree is
+         * used for searching.
+         **/
+        SearchIterator::UP profile(SearchIterator::UP root);
+        /**
+         * Report the collected information as a tree of objects.
+         **/
+        void report(vespalib::slime::Cursor &obj) const;
+    };
+
+private:
+    SearchIterator::UP _search;
+    Stats             &_stats;
+    const uint32_t     _sample_interval;
+    uint32_t           _seeks_until_sample;
+    uint32_t           _unpacks_until_sample;
+
+public:
+    ProfiledIterator(SearchIterator::UP search, Stats &stats, uint32_t sample_interval);
+    ~ProfiledIterator() override;
+
+    void doSeek(uint32_t docid) override;
+    void doUnpack(uint32_t docid) override;
+    void initRange(uint32_t begin_id, uint32_t end_id) override;
+    std::unique_ptr<BitVector> get_hits(uint32_t begin_id) override;
+    void or_hits_into(BitVector &result, uint32_t begin_id) override;
+    void and_hits_into(BitVector &result, uint32_t begin_id) override;
+    UP andWith(UP filter, uint32_t estimate) override { return _search->andWith(std::move(filter), estimate); }
+    Trinary is_strict() const override { return _search->is_strict(); }
+    const PostingInfo *getPostingInfo() const override { return _search->getPostingInfo(); }
+    void visitMembers(vespalib::ObjectVisitor &visitor) const override;
+
+    const SearchIterator &getIterator() const { return *_search; }
+};
+
+}
@@ -33,6 +33,11 @@ SearchIterator::andWith(UP filter, uint32_t estimate)
     return filter;
 }
 
+void
+SearchIterator::transform_children(const std::function<UP(UP, size_t)> &)
+{
+}
+
 void
 SearchIterator::or_hits_into(BitVector &result, uint32_t begin_id)
 {
@@ -6,6 +6,7 @@
 #include "begin_and_end_id.h"
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/trinary.h>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -355,6 +356,17 @@ public:
 
     virtual Trinary is_strict() const { return Trinary::Undefined; }
 
+    /**
+     * Replace each child of this iterator with the result of calling
+     * the given function with the child and its index. Iterators
+     * without children (or that depend on the exact type of their
+     * children) leave them as they are. Must be called before the
+     * iterator is used for searching.
+     *
+     * @param f function taking ownership of a child and returning its replacement.
+     **/
+    virtual void transform_children(const std::function<UP(UP, size_t)> &f);
+
 };
 
 }
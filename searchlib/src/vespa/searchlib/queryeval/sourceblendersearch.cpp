@@ -166,6 +166,14 @@ SourceBlenderSearch::setChild(size_t index, SearchIterator::UP child) {
     _sources[_children[index]] = child.release();
 }
 
+void
+SourceBlenderSearch::transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f)
+{
+    for (size_t i = 0; i < _children.size(); ++i) {
+        setChild(i, f(steal(i), i));
+    }
+}
+
 SearchIterator::UP
 SourceBlenderSearch::create(std::unique_ptr<sourceselector::Iterator> sourceSelector,
                             const Children &children, bool strict)
@@ -80,6 +80,7 @@ public:
     }
     void setChild(size_t index, SearchIterator::UP child);
     void initRange(uint32_t beginId, uint32_t endId) override;
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override;
 };
 
 }
@@ -47,6 +47,9 @@ struct TermwiseSearch : public SearchIterator {
         }
     }
     void doUnpack(uint32_t) override {}
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        search = f(std::move(search), 0);
+    }
     void visitMembers(vespalib::ObjectVisitor &visitor) const override {
         visit(visitor, "search", *search);
         visit(visitor, "strict", IS_STRICT);
@@ -44,7 +44,10 @@ private:
     void seek_strict(uint32_t docid) {
         _algo.set_candidate(_terms, _heaps, docid);
         while (_algo.solve_wand_constraint(_terms, _heaps, GreaterThan(_boostedThreshold))) {
-            if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
+            docid_t next = _algo.check_block_max_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold));
+            if (next != _algo.get_candidate()) {
+                _algo.set_candidate(_terms, _heaps, next); // skip rest of block(s)
+            } else if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
                 setDocId(_algo.get_candidate());
                 return;
             } else {
@@ -58,7 +61,9 @@ private:
         if (docid > _algo.get_candidate()) {
             _algo.set_candidate(_terms, _heaps, docid);
             if (_algo.check_wand_constraint(_terms, _heaps, GreaterThan(_boostedThreshold))) {
-                if (_algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold))) {
+                if ((_algo.check_block_max_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold)) == _algo.get_candidate()) &&
+                    _algo.check_score(_terms, _heaps, DotProductScorer(), GreaterThan(_threshold)))
+                {
                     setDocId(_algo.get_candidate());
                 }
             }
@@ -109,6 +114,9 @@ public:
         _algo.init_range(_terms, _heaps, begin, end);
     }
     Trinary is_strict() const override { return IS_STRICT ? Trinary::True : Trinary::False; }
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _terms.transform_children(f);
+    }
 };
 
 namespace {
@@ -10,6 +10,16 @@ VectorizedIteratorTerms::visit_members(vespalib::ObjectVisitor &visitor) const {
     visit(visitor, "children", _terms);
 }
 
+void
+VectorizedIteratorTerms::transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f)
+{
+    iteratorPack().transform_children([this,&f](SearchIterator::UP child, size_t index) {
+                                          SearchIterator::UP replacement = f(std::move(child), index);
+                                          _terms[index].search = replacement.get();
+                                          return replacement;
+                                      });
+}
+
 VectorizedIteratorTerms::VectorizedIteratorTerms(VectorizedIteratorTerms &&) noexcept = default;
 VectorizedIteratorTerms & VectorizedIteratorTerms::operator=(VectorizedIteratorTerms &&) noexcept = default;
 VectorizedIteratorTerms::~VectorizedIteratorTerms() = default;
@@ -179,7 +179,11 @@ public:
 
     uint32_t seek(uint16_t ref, uint32_t docid) { return _iteratorPack.seek(ref, docid); }
     int32_t get_weight(uint16_t ref, uint32_t docid) { return _iteratorPack.get_weight(ref, docid); }
-    
+    uint32_t get_block_end(uint16_t ref) const { return _iteratorPack.get_block_end(ref); }
+    int32_t get_block_max_weight(uint16_t ref) const { return _iteratorPack.get_block_max_weight(ref); }
+    template <typename F>
+    void transform_children(const F &f) { _iteratorPack.transform_children(f); }
+
     vespalib::string stringify_docid() const;
 };
 
@@ -247,6 +251,7 @@ public:
     ~VectorizedIteratorTerms();
     void unpack(uint16_t ref, uint32_t docid) { iteratorPack().unpack(ref, docid); }
     void visit_members(vespalib::ObjectVisitor &visitor) const;
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f);
     const Terms &input_terms() const { return _terms; }
 };
 
@@ -447,6 +452,15 @@ struct DotProductScorer
     static score_t calculateScore(VectorizedTerms &terms, ref_t ref, docid_t docId) {
         return terms.weight(ref) * (score_t)terms.get_weight(ref, docId);
     }
+
+    // upper bound for the term score of any document in the current posting block of the term
+    template <typename VectorizedTerms>
+    static score_t calculate_block_max_score(const VectorizedTerms &terms, ref_t ref) {
+        if (terms.weight(ref) < 0) {
+            return terms.maxScore(ref);
+        }
+        return std::min(terms.maxScore(ref), terms.weight(ref) * (score_t)terms.get_block_max_weight(ref));
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -618,6 +632,32 @@ public:
         return true;
     }
 
+    /**
+     * Use the block max weights of the present terms to get a tighter
+     * upper bound for the score of the current candidate. Returns the
+     * candidate if it may still be above the threshold. Otherwise, no
+     * document before the end of the first present block ending (or
+     * the next future term) can be above the threshold, and the next
+     * document that needs to be considered is returned.
+     **/
+    template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
+    docid_t check_block_max_score(VectorizedTerms &terms, Heaps &heaps, const Scorer &, AboveThreshold &&aboveThreshold) {
+        score_t max_score = _maxUpperBound;
+        docid_t block_end = search::endDocId;
+        ref_t *end = heaps.present_end();
+        for (ref_t *ref = heaps.present_begin(); ref != end; ++ref) {
+            max_score -= (terms.maxScore(*ref) - Scorer::calculate_block_max_score(terms, *ref));
+            block_end = std::min(block_end, terms.get_block_end(*ref));
+        }
+        if (aboveThreshold(max_score)) {
+            return _candidate;
+        }
+        if (heaps.has_future()) {
+            block_end = std::min(block_end, terms.docId(heaps.future()) - 1);
+        }
+        return std::max(block_end, _candidate) + 1;
+    }
+
     template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
     bool check_score(VectorizedTerms &terms, Heaps &heaps, Scorer &&scorer, AboveThreshold &&aboveThreshold) {
         _partial_score = 0;
@@ -89,6 +89,9 @@ public:
         }
     }
     Trinary is_strict() const override { return IS_STRICT ? Trinary::True : Trinary::False; }
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _terms.transform_children(f);
+    }
 };
 
 //-----------------------------------------------------------------------------
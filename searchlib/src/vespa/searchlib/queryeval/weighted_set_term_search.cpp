@@ -127,6 +127,9 @@ public:
     void and_hits_into(BitVector &result, uint32_t begin_id) override {
         result.andWith(*get_hits(begin_id));
     }
+    void transform_children(const std::function<SearchIterator::UP(SearchIterator::UP, size_t)> &f) override {
+        _children.transform_children(f);
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -9,6 +9,7 @@
 
 namespace search::tensor {
 
+using search::attribute::VectorQuantization;
 using vespalib::eval::ValueType;
 
 namespace {
@@ -23,24 +24,51 @@ make_random_level_generator(uint32_t m)
     return std::make_unique<InvLogLevelGenerator>(m);
 }
 
-} // namespace <unnamed>
-
 std::unique_ptr<NearestNeighborIndex>
-DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
-                                         size_t vector_size,
-                                         vespalib::eval::ValueType::CellType cell_type,
-                                         const search::attribute::HnswIndexParams& params) const
+make_hnsw_index(const DocVectorAccess& vectors,
+                const HnswNodeidMapping* nodeid_mapping,
+                size_t vector_size,
+                vespalib::eval::ValueType::CellType cell_type,
+                const search::attribute::HnswIndexParams& params)
 {
-    (void) vector_size;
     uint32_t m = params.max_links_per_node();
     HnswIndex::Config cfg(m * 2,
                           m,
                           params.neighbors_to_explore_at_insert(),
                           true);
+    std::unique_ptr<QuantizedVectorStore> quantized_vectors;
+    if ((params.quantization() == VectorQuantization::Int8) &&
+        QuantizedVectorStore::is_supported(params.distance_metric(), cell_type))
+    {
+        quantized_vectors = std::make_unique<QuantizedVectorStore>(vector_size, params.distance_metric());
+    }
     return std::make_unique<HnswIndex>(vectors,
                                        make_distance_function(params.distance_metric(), cell_type),
                                        make_random_level_generator(m),
-                                       cfg);
+                                       cfg,
+                                       std::move(quantized_vectors),
+                                       nodeid_mapping);
+}
+
+} // namespace <unnamed>
+
+std::unique_ptr<NearestNeighborIndex>
+DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
+                                         size_t vector_size,
+                                         vespalib::eval::ValueType::CellType cell_type,
+                                         const search::attribute::HnswIndexParams& params) const
+{
+    return make_hnsw_index(vectors, nullptr, vector_size, cell_type, params);
+}
+
+std::unique_ptr<NearestNeighborIndex>
+DefaultNearestNeighborIndexFactory::make_multi_vector(const DocVectorAccess& node_vectors,
+                                                      const HnswNodeidMapping& nodeid_mapping,
+                                                      size_t vector_size,
+                                                      vespalib::eval::ValueType::CellType cell_type,
+                                                      const search::attribute::HnswIndexParams& params) const
+{
+    return make_hnsw_index(node_vectors, &nodeid_mapping, vector_size, cell_type, params);
 }
 
 }
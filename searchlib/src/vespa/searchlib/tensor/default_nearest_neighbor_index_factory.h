@@ -15,6 +15,11 @@ public:
                                                size_t vector_size,
                                                vespalib::eval::ValueType::CellType cell_type,
                                                const search::attribute::HnswIndexParams& params) const override;
+    std::unique_ptr<NearestNeighborIndex> make_multi_vector(const DocVectorAccess& node_vectors,
+                                                            const HnswNodeidMapping& nodeid_mapping,
+                                                            size_t vector_size,
+                                                            vespalib::eval::ValueType::CellType cell_type,
+                                                            const search::attribute::HnswIndexParams& params) const override;
 };
 
 }
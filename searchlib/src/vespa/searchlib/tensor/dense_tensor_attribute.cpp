@@ -11,6 +11,9 @@
 #include <vespa/searchlib/attribute/load_utils.h>
 #include <vespa/searchlib/attribute/readerbase.h>
 #include <vespa/vespalib/data/slime/inserter.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/threadexecutor.h>
+#include <deque>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.tensor.dense_tensor_attribute");
@@ -27,6 +30,14 @@ namespace {
 
 constexpr uint32_t DENSE_TENSOR_ATTRIBUTE_VERSION = 1;
 const vespalib::string tensorTypeTag("tensortype");
+// Max number of prepared (but not completed) adds per executor thread when building the index in bulk.
+constexpr size_t max_pending_prepares_per_thread = 4;
+// Number of documents added in the foreground before the prepare step is moved to the executor.
+// This ensures that the first nodes are not prepared against an (almost) empty graph.
+constexpr uint32_t min_foreground_adds = 1024;
+// Number of completed adds between each generation change when building the index in bulk.
+// This makes it possible to free memory held on behalf of the prepare steps during the build.
+constexpr uint32_t adds_per_generation = 1024;
 
 class TensorReader : public ReaderBase
 {
@@ -59,6 +70,143 @@ TensorReader::is_present() {
     return true;
 }
 
+/**
+ * Interface used to add a sequence of documents (in docid order) to a nearest neighbor index.
+ */
+class IndexBuilder {
+public:
+    virtual ~IndexBuilder() {}
+    virtual void add(uint32_t docid) = 0;
+    virtual void wait_complete() = 0;
+};
+
+/**
+ * Adds documents to the nearest neighbor index one at a time, using the calling thread only.
+ */
+class ForegroundIndexBuilder : public IndexBuilder {
+private:
+    NearestNeighborIndex &_index;
+public:
+    ForegroundIndexBuilder(NearestNeighborIndex &index)
+        : _index(index)
+    {
+    }
+    void add(uint32_t docid) override { _index.add_document(docid); }
+    void wait_complete() override {}
+};
+
+/**
+ * Adds documents to the nearest neighbor index using the two-phase prepare / complete operation.
+ *
+ * The prepare step is run by the executor threads, each holding a read guard on the attribute.
+ * The complete step is run by the calling thread in the same order as the documents were added.
+ * The number of pending prepare steps is bounded to limit memory usage and loss of graph quality
+ * caused by preparing against a graph that lacks the most recently added documents.
+ */
+class ThreadedIndexBuilder : public IndexBuilder {
+private:
+    using PrepareResultUP = std::unique_ptr<PrepareResult>;
+    using PendingAdd = std::pair<uint32_t, std::future<PrepareResultUP>>;
+
+    DenseTensorAttribute &_attr;
+    vespalib::GenerationHandler &_generation_handler;
+    NearestNeighborIndex &_index;
+    vespalib::ThreadExecutor &_executor;
+    std::deque<PendingAdd> _pending;
+    const size_t _max_pending;
+    uint32_t _foreground_adds;
+    uint32_t _adds_since_generation_change;
+
+    void complete_oldest();
+    void consider_generation_change();
+public:
+    ThreadedIndexBuilder(DenseTensorAttribute &attr, vespalib::GenerationHandler &generation_handler,
+                         NearestNeighborIndex &index, vespalib::ThreadExecutor &executor);
+    ~ThreadedIndexBuilder() override;
+    void add(uint32_t docid) override;
+    void wait_complete() override;
+};
+
+ThreadedIndexBuilder::ThreadedIndexBuilder(DenseTensorAttribute &attr, vespalib::GenerationHandler &generation_handler,
+                                           NearestNeighborIndex &index, vespalib::ThreadExecutor &executor)
+    : _attr(attr),
+      _generation_handler(generation_handler),
+      _index(index),
+      _executor(executor),
+      _pending(),
+      _max_pending(std::max(size_t(1), executor.getNumThreads()) * max_pending_prepares_per_thread),
+      _foreground_adds(0),
+      _adds_since_generation_change(0)
+{
+}
+
+ThreadedIndexBuilder::~ThreadedIndexBuilder()
+{
+    wait_complete();
+}
+
+void
+ThreadedIndexBuilder::complete_oldest()
+{
+    auto &oldest = _pending.front();
+    uint32_t docid = oldest.first;
+    _index.complete_add_document(docid, oldest.second.get());
+    _pending.pop_front();
+    consider_generation_change();
+}
+
+void
+ThreadedIndexBuilder::consider_generation_change()
+{
+    if (++_adds_since_generation_change >= adds_per_generation) {
+        _attr.incGeneration();
+        _adds_since_generation_change = 0;
+    }
+}
+
+void
+ThreadedIndexBuilder::add(uint32_t docid)
+{
+    if (_foreground_adds < min_foreground_adds) {
+        _index.add_document(docid);
+        ++_foreground_adds;
+        consider_generation_change();
+        return;
+    }
+    while (_pending.size() >= _max_pending) {
+        complete_oldest();
+    }
+    std::promise<PrepareResultUP> promise;
+    _pending.emplace_back(docid, promise.get_future());
+    auto task = vespalib::makeLambdaTask([this, docid, guard = _generation_handler.takeGuard(),
+                                          promise = std::move(promise)]() mutable
+                                         {
+                                             promise.set_value(_index.prepare_add_document(docid, _attr.get_vector(docid), std::move(guard)));
+                                         });
+    auto rejected = _executor.execute(std::move(task));
+    if (rejected) {
+        rejected->run();
+    }
+}
+
+void
+ThreadedIndexBuilder::wait_complete()
+{
+    while (!_pending.empty()) {
+        complete_oldest();
+    }
+}
+
+std::unique_ptr<IndexBuilder>
+make_index_builder(DenseTensorAttribute &attr, vespalib::GenerationHandler &generation_handler,
+                   NearestNeighborIndex &index, vespalib::ThreadExecutor *executor)
+{
+    if (executor != nullptr) {
+        return std::make_unique<ThreadedIndexBuilder>(attr, generation_handler, index, *executor);
+    }
+    return std::make_unique<ForegroundIndexBuilder>(index);
+}
+
 bool
 can_use_index_save_file(const search::attribute::Config &config, const search::attribute::AttributeHeader &header)
 {
@@ -79,8 +227,30 @@ can_use_index_save_file(const search::attribute::Config &config, const search::a
 void
 DenseTensorAttribute::consider_remove_from_index(DocId docid)
 {
-    if (_index && _refVector[docid].valid()) {
-        _index->remove_document(docid);
+    if (!_index || !_refVector[docid].valid()) {
+        return;
+    }
+    if (docid < _pending_index_docs.size() && _pending_index_docs[docid]) {
+        // Document is not yet added to the index
+        _pending_index_docs[docid] = false;
+        return;
+    }
+    _index->remove_document(docid);
+}
+
+void
+DenseTensorAttribute::consider_add_to_index(DocId docid)
+{
+    if (!_index) {
+        return;
+    }
+    if (_bulk_index_build) {
+        if (docid >= _pending_index_docs.size()) {
+            _pending_index_docs.resize(docid + 1, false);
+        }
+        _pending_index_docs[docid] = true;
+    } else {
+        _index->add_document(docid);
     }
 }
 
@@ -98,7 +268,9 @@ DenseTensorAttribute::DenseTensorAttribute(vespalib::stringref baseFileName, con
                                            const NearestNeighborIndexFactory& index_factory)
     : TensorAttribute(baseFileName, cfg, _denseTensorStore),
       _denseTensorStore(cfg.tensorType()),
-      _index()
+      _index(),
+      _bulk_index_build(false),
+      _pending_index_docs()
 {
     if (cfg.hnsw_index_params().has_value()) {
         auto tensor_type = cfg.tensorType();
@@ -130,9 +302,7 @@ DenseTensorAttribute::setTensor(DocId docId, const Tensor &tensor)
     consider_remove_from_index(docId);
     EntryRef ref = _denseTensorStore.setTensor(tensor);
     setTensorRef(docId, ref);
-    if (_index) {
-        _index->add_document(docId);
-    }
+    consider_add_to_index(docId);
 }
 
 
@@ -161,6 +331,12 @@ DenseTensorAttribute::getTensor(DocId docId, MutableDenseTensorView &tensor) con
 
 bool
 DenseTensorAttribute::onLoad()
+{
+    return onLoad(nullptr);
+}
+
+bool
+DenseTensorAttribute::onLoad(vespalib::ThreadExecutor *executor)
 {
     TensorReader tensorReader(*this);
     if (!tensorReader.hasData()) {
@@ -181,27 +357,32 @@ DenseTensorAttribute::onLoad()
             auto raw = _denseTensorStore.allocRawBuffer();
             tensorReader.readTensor(raw.data, _denseTensorStore.getBufSize());
             _refVector.push_back(raw.ref);
-            if (_index && !use_index_file) {
-                // This ensures that get_vector() (via getTensor()) is able to find the newly added tensor.
-                setCommittedDocIdLimit(lid + 1);
-                _index->add_document(lid);
-            }
         } else {
             _refVector.push_back(EntryRef());
         }
     }
     setNumDocs(numDocs);
     setCommittedDocIdLimit(numDocs);
-    if (_index && use_index_file) {
-        auto buffer = LoadUtils::loadFile(*this, DenseTensorAttributeSaver::index_file_suffix());
-        if (!_index->load(*buffer)) {
-            return false;
+    if (_index) {
+        if (use_index_file) {
+            auto buffer = LoadUtils::loadFile(*this, DenseTensorAttributeSaver::index_file_suffix());
+            if (!_index->load_mapped(std::move(buffer))) {
+                return false;
+            }
+        } else {
+            // All tensors are loaded at this point, making get_vector() able to find them.
+            auto builder = make_index_builder(*this, getGenerationHandler(), *_index, executor);
+            for (uint32_t lid = 0; lid < numDocs; ++lid) {
+                if (_refVector[lid].valid()) {
+                    builder->add(lid);
+                }
+            }
+            builder->wait_complete();
         }
     }
     return true;
 }
 
-
 std::unique_ptr<AttributeSaver>
 DenseTensorAttribute::onInitSave(vespalib::stringref fileName)
 {
@@ -259,6 +440,41 @@ DenseTensorAttribute::get_state(const vespalib::slime::Inserter& inserter) const
     }
 }
 
+bool
+DenseTensorAttribute::maintain_nearest_neighbor_index()
+{
+    if (!_index) {
+        return false;
+    }
+    bool more_to_do = _index->maintain();
+    commit();
+    return more_to_do;
+}
+
+void
+DenseTensorAttribute::start_bulk_index_build()
+{
+    _bulk_index_build = true;
+}
+
+void
+DenseTensorAttribute::complete_bulk_index_build(vespalib::ThreadExecutor *executor)
+{
+    _bulk_index_build = false;
+    if (!_index) {
+        return;
+    }
+    std::vector<bool> pending_docs;
+    pending_docs.swap(_pending_index_docs);
+    auto builder = make_index_builder(*this, getGenerationHandler(), *_index, executor);
+    for (DocId docid = 0; docid < pending_docs.size(); ++docid) {
+        if (pending_docs[docid]) {
+            builder->add(docid);
+        }
+    }
+    builder->wait_complete();
+}
+
 vespalib::tensor::TypedCells
 DenseTensorAttribute::get_vector(uint32_t docid) const
 {
@@ -8,6 +8,7 @@
 #include "tensor_attribute.h"
 #include <memory>
 
+namespace vespalib { class ThreadExecutor; }
 namespace vespalib::tensor { class MutableDenseTensorView; }
 
 namespace search::tensor {
@@ -22,8 +23,11 @@ class DenseTensorAttribute : public TensorAttribute, public DocVectorAccess {
 private:
     DenseTensorStore _denseTensorStore;
     std::unique_ptr<NearestNeighborIndex> _index;
+    bool _bulk_index_build;
+    std::vector<bool> _pending_index_docs;
 
     void consider_remove_from_index(DocId docid);
+    void consider_add_to_index(DocId docid);
     vespalib::MemoryUsage memory_usage() const override;
 
 public:
@@ -36,6 +40,7 @@ public:
     std::unique_ptr<Tensor> getTensor(DocId docId) const override;
     void getTensor(DocId docId, vespalib::tensor::MutableDenseTensorView &tensor) const override;
     bool onLoad() override;
+    bool onLoad(vespalib::ThreadExecutor *executor) override;
     std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
     void compactWorst() override;
     uint32_t getVersion() const override;
@@ -46,7 +51,25 @@ public:
     // Implements DocVectorAccess
     vespalib::tensor::TypedCells get_vector(uint32_t docid) const override;
 
-    const NearestNeighborIndex* nearest_neighbor_index() const { return _index.get(); }
+    const NearestNeighborIndex* nearest_neighbor_index() const override { return _index.get(); }
+    bool maintain_nearest_neighbor_index() override;
+
+    /**
+     * Starts bulk population of this attribute.
+     *
+     * Documents that are set while in bulk mode are not added to the nearest neighbor index
+     * before complete_bulk_index_build() is called.
+     * This function is only called by the attribute writer thread.
+     */
+    void start_bulk_index_build();
+
+    /**
+     * Adds all documents set since start_bulk_index_build() to the nearest neighbor index.
+     *
+     * The prepare step of adding each document is run by the given executor (if not nullptr),
+     * while the complete step is run by the calling attribute writer thread in docid order.
+     */
+    void complete_bulk_index_build(vespalib::ThreadExecutor *executor);
 };
 
 }
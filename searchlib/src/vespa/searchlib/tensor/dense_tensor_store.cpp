@@ -26,6 +26,8 @@ size_t size_of(CellType type) {
     switch (type) {
     case CellType::DOUBLE: return sizeof(double);
     case CellType::FLOAT: return sizeof(float);
+    case CellType::INT8: return sizeof(int8_t);
+    case CellType::BFLOAT16: return sizeof(vespalib::BFloat16);
     }
     abort();
 }
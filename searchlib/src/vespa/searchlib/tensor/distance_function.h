@@ -2,10 +2,9 @@
 
 #pragma once
 
+#include <vespa/eval/tensor/dense/typed_cells.h>
 #include <memory>
 
-namespace vespalib::tensor { struct TypedCells; }
-
 namespace search::tensor {
 
 /**
@@ -23,6 +22,20 @@ public:
     virtual double calc_with_limit(const vespalib::tensor::TypedCells& lhs,
                                    const vespalib::tensor::TypedCells& rhs,
                                    double limit) const = 0;
+
+    /**
+     * Calculates the distance between lhs and each of the num_rhs vectors in rhs, written to result.
+     * Implementations may prefetch the vectors in rhs to hide the memory latency of fetching them.
+     */
+    virtual void calc_many(const vespalib::tensor::TypedCells& lhs,
+                           const vespalib::tensor::TypedCells* rhs,
+                           size_t num_rhs,
+                           double* result) const
+    {
+        for (size_t i = 0; i < num_rhs; ++i) {
+            result[i] = calc(lhs, rhs[i]);
+        }
+    }
 };
 
 }
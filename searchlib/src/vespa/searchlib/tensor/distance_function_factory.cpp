@@ -8,31 +8,38 @@ using vespalib::eval::ValueType;
 
 namespace search::tensor {
 
+namespace {
+
+template <template <typename> class DistanceFunctionType>
+DistanceFunction::UP
+make_typed_distance_function(ValueType::CellType cell_type)
+{
+    switch (cell_type) {
+    case ValueType::CellType::FLOAT:
+        return std::make_unique<DistanceFunctionType<float>>();
+    case ValueType::CellType::DOUBLE:
+        return std::make_unique<DistanceFunctionType<double>>();
+    case ValueType::CellType::INT8:
+        return std::make_unique<DistanceFunctionType<int8_t>>();
+    case ValueType::CellType::BFLOAT16:
+        return std::make_unique<DistanceFunctionType<vespalib::BFloat16>>();
+    }
+    // not reached:
+    return DistanceFunction::UP();
+}
+
+}
+
 DistanceFunction::UP
 make_distance_function(DistanceMetric variant, ValueType::CellType cell_type)
 {
     switch (variant) {
         case DistanceMetric::Euclidean:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<SquaredEuclideanDistance<float>>();
-            } else {
-                return std::make_unique<SquaredEuclideanDistance<double>>();
-            }
-            break;
+            return make_typed_distance_function<SquaredEuclideanDistance>(cell_type);
         case DistanceMetric::Angular:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<AngularDistance<float>>();
-            } else {
-                return std::make_unique<AngularDistance<double>>();
-            }
-            break;
+            return make_typed_distance_function<AngularDistance>(cell_type);
         case DistanceMetric::GeoDegrees:
-            if (cell_type == ValueType::CellType::FLOAT) {
-                return std::make_unique<GeoDegreesDistance<float>>();
-            } else {
-                return std::make_unique<GeoDegreesDistance<double>>();
-            }
-            break;
+            return make_typed_distance_function<GeoDegreesDistance>(cell_type);
     }
     // not reached:
     return DistanceFunction::UP();
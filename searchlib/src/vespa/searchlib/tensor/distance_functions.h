@@ -5,10 +5,41 @@
 #include "distance_function.h"
 #include <vespa/eval/tensor/dense/typed_cells.h>
 #include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <vespa/vespalib/util/bfloat16.h>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <type_traits>
 
 namespace search::tensor {
 
+/**
+ * Calls batch_calc with the cells of lhs and pointers to the cells of up to
+ * max_batch_size vectors in rhs at a time.
+ */
+template <typename FloatType, typename BatchCalc>
+void
+calc_many_in_batches(const vespalib::tensor::TypedCells& lhs,
+                     const vespalib::tensor::TypedCells* rhs,
+                     size_t num_rhs,
+                     double* result,
+                     BatchCalc batch_calc)
+{
+    constexpr size_t max_batch_size = 32;
+    auto lhs_vector = lhs.typify<FloatType>();
+    size_t sz = lhs_vector.size();
+    const FloatType* rhs_cells[max_batch_size];
+    for (size_t offset = 0; offset < num_rhs; offset += max_batch_size) {
+        size_t batch_size = std::min(max_batch_size, num_rhs - offset);
+        for (size_t i = 0; i < batch_size; ++i) {
+            auto rhs_vector = rhs[offset + i].typify<FloatType>();
+            assert(sz == rhs_vector.size());
+            rhs_cells[i] = &rhs_vector[0];
+        }
+        batch_calc(&lhs_vector[0], rhs_cells, batch_size, sz, result + offset);
+    }
+}
+
 /**
  * Calculates the square of the standard Euclidean distance.
  * Will use instruction optimal for the cpu it is running on.
@@ -26,6 +57,22 @@ public:
         assert(sz == rhs_vector.size());
         return _computer.squaredEuclideanDistance(&lhs_vector[0], &rhs_vector[0], sz);
     }
+    void calc_many(const vespalib::tensor::TypedCells& lhs,
+                   const vespalib::tensor::TypedCells* rhs,
+                   size_t num_rhs,
+                   double* result) const override
+    {
+        if constexpr (std::is_same_v<FloatType, float> || std::is_same_v<FloatType, double>) {
+            calc_many_in_batches<FloatType>(lhs, rhs, num_rhs, result,
+                                            [this](const FloatType* a, const FloatType* const* b,
+                                                   size_t num_b, size_t sz, double* out)
+                                            {
+                                                _computer.squaredEuclideanDistances(a, b, num_b, sz, out);
+                                            });
+        } else {
+            DistanceFunction::calc_many(lhs, rhs, num_rhs, result);
+        }
+    }
     double to_rawscore(double distance) const override {
         double d = sqrt(distance);
         double score = 1.0 / (1.0 + d);
@@ -52,12 +99,28 @@ public:
 
 template class SquaredEuclideanDistance<float>;
 template class SquaredEuclideanDistance<double>;
+template class SquaredEuclideanDistance<int8_t>;
+template class SquaredEuclideanDistance<vespalib::BFloat16>;
 
 /**
  * Calculates angular distance between vectors with assumed norm 1.
+ * Vectors with int8 cells can not be normalized, so for those the
+ * cosine is calculated using the actual norms of the vectors.
  */
 template <typename FloatType>
 class AngularDistance : public DistanceFunction {
+private:
+    double cosine(const FloatType *a, const FloatType *b, size_t sz) const {
+        if constexpr (std::is_same_v<FloatType, int8_t>) {
+            double a_b = _computer.dotProduct(a, b, sz);
+            double a_a = _computer.dotProduct(a, a, sz);
+            double b_b = _computer.dotProduct(b, b, sz);
+            double norm_product = sqrt(a_a * b_b);
+            return (norm_product > 0.0) ? (a_b / norm_product) : 0.0;
+        } else {
+            return _computer.dotProduct(a, b, sz);
+        }
+    }
 public:
     AngularDistance()
         : _computer(vespalib::hwaccelrated::IAccelrated::getAccelerator())
@@ -67,9 +130,28 @@ public:
         auto rhs_vector = rhs.typify<FloatType>();
         size_t sz = lhs_vector.size();
         assert(sz == rhs_vector.size());
-        double score = 1.0 - _computer.dotProduct(&lhs_vector[0], &rhs_vector[0], sz);
+        double score = 1.0 - cosine(&lhs_vector[0], &rhs_vector[0], sz);
         return std::max(0.0, score);
     }
+    void calc_many(const vespalib::tensor::TypedCells& lhs,
+                   const vespalib::tensor::TypedCells* rhs,
+                   size_t num_rhs,
+                   double* result) const override
+    {
+        if constexpr (std::is_same_v<FloatType, float> || std::is_same_v<FloatType, double>) {
+            calc_many_in_batches<FloatType>(lhs, rhs, num_rhs, result,
+                                            [this](const FloatType* a, const FloatType* const* b,
+                                                   size_t num_b, size_t sz, double* out)
+                                            {
+                                                _computer.dotProducts(a, b, num_b, sz, out);
+                                                for (size_t i = 0; i < num_b; ++i) {
+                                                    out[i] = std::max(0.0, 1.0 - out[i]);
+                                                }
+                                            });
+        } else {
+            DistanceFunction::calc_many(lhs, rhs, num_rhs, result);
+        }
+    }
     double to_rawscore(double distance) const override {
         double score = 1.0 / (1.0 + distance);
         return score;
@@ -86,6 +168,8 @@ public:
 
 template class AngularDistance<float>;
 template class AngularDistance<double>;
+template class AngularDistance<int8_t>;
+template class AngularDistance<vespalib::BFloat16>;
 
 /**
  * Calculates great-circle distance between Latitude/Longitude pairs,
@@ -141,5 +225,7 @@ public:
 
 template class GeoDegreesDistance<float>;
 template class GeoDegreesDistance<double>;
+template class GeoDegreesDistance<int8_t>;
+template class GeoDegreesDistance<vespalib::BFloat16>;
 
 }
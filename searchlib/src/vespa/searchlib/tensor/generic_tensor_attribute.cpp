@@ -2,14 +2,22 @@
 
 #include "generic_tensor_attribute.h"
 #include "generic_tensor_attribute_saver.h"
+#include "hnsw_nodeid_mapping.h"
+#include "nearest_neighbor_index.h"
+#include "node_vector_store.h"
 #include "tensor_attribute.hpp"
+#include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <vespa/searchlib/attribute/readerbase.h>
 #include <vespa/searchlib/util/fileutil.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/data/slime/inserter.h>
 #include <vespa/vespalib/util/rcuvector.hpp>
+#include <map>
 
 using vespalib::eval::ValueType;
+using vespalib::slime::ObjectInserter;
 using vespalib::tensor::Tensor;
 
 namespace search::tensor {
@@ -31,11 +39,59 @@ public:
     void readTensor(void *buf, size_t len) { _datFile->ReadBuf(buf, len); }
 };
 
+/**
+ * Returns the dense subspaces of a tensor with one mapped and one indexed dimension,
+ * ordered by the label in the mapped dimension.
+ */
+std::vector<std::vector<double>>
+extract_subspaces(const Tensor &tensor, size_t vector_size)
+{
+    std::map<vespalib::string, std::vector<double>> subspaces;
+    auto spec = tensor.toSpec();
+    for (const auto &cell : spec.cells()) {
+        vespalib::string label;
+        size_t index = 0;
+        for (const auto &dim_label : cell.first) {
+            if (dim_label.second.is_mapped()) {
+                label = dim_label.second.name;
+            } else {
+                index = dim_label.second.index;
+            }
+        }
+        auto &subspace = subspaces[label];
+        subspace.resize(vector_size, 0.0);
+        if (index < vector_size) {
+            subspace[index] = cell.second.value;
+        }
+    }
+    std::vector<std::vector<double>> result;
+    result.reserve(subspaces.size());
+    for (auto &subspace : subspaces) {
+        result.push_back(std::move(subspace.second));
+    }
+    return result;
+}
+
 }
 
-GenericTensorAttribute::GenericTensorAttribute(stringref name, const Config &cfg)
-    : TensorAttribute(name, cfg, _genericTensorStore)
+GenericTensorAttribute::GenericTensorAttribute(stringref name, const Config &cfg,
+                                               const NearestNeighborIndexFactory &index_factory)
+    : TensorAttribute(name, cfg, _genericTensorStore),
+      _nodeid_mapping(),
+      _node_vectors(),
+      _index()
 {
+    if (cfg.hnsw_index_params().has_value()) {
+        auto tensor_type = cfg.tensorType();
+        auto vector_type = TensorAttribute::vector_type(tensor_type);
+        if (!tensor_type.is_dense() && !vector_type.is_error()) {
+            size_t vector_size = vector_type.dimensions()[0].size;
+            _nodeid_mapping = std::make_unique<HnswNodeidMapping>();
+            _node_vectors = std::make_unique<NodeVectorStore>(vector_type);
+            _index = index_factory.make_multi_vector(*_node_vectors, *_nodeid_mapping, vector_size,
+                                                     vector_type.cell_type(), cfg.hnsw_index_params().value());
+        }
+    }
 }
 
 
@@ -45,12 +101,60 @@ GenericTensorAttribute::~GenericTensorAttribute()
     _tensorStore.clearHoldLists();
 }
 
+void
+GenericTensorAttribute::remove_from_index(DocId docId)
+{
+    for (uint32_t nodeid : _nodeid_mapping->get_ids(docId)) {
+        _index->remove_document(nodeid);
+        _node_vectors->remove_vector(nodeid);
+    }
+    _nodeid_mapping->free_ids(docId);
+}
+
+void
+GenericTensorAttribute::add_to_index(DocId docId, const Tensor &tensor)
+{
+    auto subspaces = extract_subspaces(tensor, _node_vectors->vector_type().dimensions()[0].size);
+    auto nodeids = _nodeid_mapping->allocate_ids(docId, subspaces.size());
+    for (size_t i = 0; i < subspaces.size(); ++i) {
+        _node_vectors->set_vector(nodeids[i], subspaces[i]);
+        _index->add_document(nodeids[i]);
+    }
+}
+
+vespalib::MemoryUsage
+GenericTensorAttribute::memory_usage() const
+{
+    vespalib::MemoryUsage result = TensorAttribute::memory_usage();
+    if (_index) {
+        result.merge(_index->memory_usage());
+        result.merge(_nodeid_mapping->memory_usage());
+        result.merge(_node_vectors->memory_usage());
+    }
+    return result;
+}
+
+uint32_t
+GenericTensorAttribute::clearDoc(DocId docId)
+{
+    if (_index) {
+        remove_from_index(docId);
+    }
+    return TensorAttribute::clearDoc(docId);
+}
+
 void
 GenericTensorAttribute::setTensor(DocId docId, const Tensor &tensor)
 {
     checkTensorType(tensor);
+    if (_index) {
+        remove_from_index(docId);
+    }
     EntryRef ref = _genericTensorStore.setTensor(tensor);
     setTensorRef(docId, ref);
+    if (_index) {
+        add_to_index(docId, tensor);
+    }
 }
 
 
@@ -95,6 +199,14 @@ GenericTensorAttribute::onLoad()
     }
     setNumDocs(numDocs);
     setCommittedDocIdLimit(numDocs);
+    if (_index) {
+        for (uint32_t lid = 0; lid < numDocs; ++lid) {
+            auto tensor = getTensor(lid);
+            if (tensor) {
+                add_to_index(lid, *tensor);
+            }
+        }
+    }
     return true;
 }
 
@@ -117,4 +229,67 @@ GenericTensorAttribute::compactWorst()
     doCompactWorst<GenericTensorStore::RefType>();
 }
 
+void
+GenericTensorAttribute::onGenerationChange(generation_t next_gen)
+{
+    TensorAttribute::onGenerationChange(next_gen);
+    if (_index) {
+        _index->transfer_hold_lists(next_gen - 1);
+        _node_vectors->transfer_hold_lists(next_gen - 1);
+        _nodeid_mapping->transfer_hold_lists(next_gen - 1);
+    }
+}
+
+void
+GenericTensorAttribute::removeOldGenerations(generation_t first_used_gen)
+{
+    TensorAttribute::removeOldGenerations(first_used_gen);
+    if (_index) {
+        _index->trim_hold_lists(first_used_gen);
+        _node_vectors->trim_hold_lists(first_used_gen);
+        _nodeid_mapping->trim_hold_lists(first_used_gen);
+    }
+}
+
+void
+GenericTensorAttribute::get_state(const vespalib::slime::Inserter& inserter) const
+{
+    auto& object = inserter.insertObject();
+    populate_state(object);
+    if (_index) {
+        object.setLong("nodeid_limit", _nodeid_mapping->nodeid_limit());
+        ObjectInserter index_inserter(object, "nearest_neighbor_index");
+        _index->get_state(index_inserter);
+    }
+}
+
+const NearestNeighborIndex*
+GenericTensorAttribute::nearest_neighbor_index() const
+{
+    return _index.get();
+}
+
+bool
+GenericTensorAttribute::maintain_nearest_neighbor_index()
+{
+    if (!_index) {
+        return false;
+    }
+    bool more_to_do = _index->maintain();
+    commit();
+    return more_to_do;
+}
+
+void
+GenericTensorAttribute::get_vectors(DocId docId, std::vector<vespalib::tensor::TypedCells>& vectors) const
+{
+    if (!_index) {
+        notImplemented();
+    }
+    vectors.clear();
+    for (uint32_t nodeid : _nodeid_mapping->get_ids(docId)) {
+        vectors.push_back(_node_vectors->get_vector(nodeid));
+    }
+}
+
 }
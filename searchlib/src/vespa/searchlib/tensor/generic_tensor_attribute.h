@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "default_nearest_neighbor_index_factory.h"
 #include "tensor_attribute.h"
 #include "generic_tensor_store.h"
 
@@ -9,21 +10,44 @@ namespace search {
 
 namespace tensor {
 
+class HnswNodeidMapping;
+class NearestNeighborIndex;
+class NodeVectorStore;
+
 /**
  * Attribute vector class used to store tensors for all documents in memory.
+ *
+ * Tensors with one mapped and one indexed dimension can have a nearest neighbor index,
+ * where each dense subspace of a tensor is a separate node in the index.
+ * The index is not saved, but rebuilt when the attribute is loaded.
  */
 class GenericTensorAttribute : public TensorAttribute
 {
     GenericTensorStore _genericTensorStore; // data store for serialized tensors
+    std::unique_ptr<HnswNodeidMapping> _nodeid_mapping;
+    std::unique_ptr<NodeVectorStore> _node_vectors;
+    std::unique_ptr<NearestNeighborIndex> _index;
+
+    void remove_from_index(DocId docId);
+    void add_to_index(DocId docId, const Tensor &tensor);
+    vespalib::MemoryUsage memory_usage() const override;
 public:
-    GenericTensorAttribute(vespalib::stringref baseFileName, const Config &cfg);
+    GenericTensorAttribute(vespalib::stringref baseFileName, const Config &cfg,
+                           const NearestNeighborIndexFactory &index_factory = DefaultNearestNeighborIndexFactory());
     virtual ~GenericTensorAttribute();
+    virtual uint32_t clearDoc(DocId docId) override;
     virtual void setTensor(DocId docId, const Tensor &tensor) override;
     virtual std::unique_ptr<Tensor> getTensor(DocId docId) const override;
     virtual void getTensor(DocId docId, vespalib::tensor::MutableDenseTensorView &tensor) const override;
     virtual bool onLoad() override;
     virtual std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
     virtual void compactWorst() override;
+    virtual void onGenerationChange(generation_t next_gen) override;
+    virtual void removeOldGenerations(generation_t first_used_gen) override;
+    virtual void get_state(const vespalib::slime::Inserter& inserter) const override;
+    virtual const NearestNeighborIndex* nearest_neighbor_index() const override;
+    virtual bool maintain_nearest_neighbor_index() override;
+    virtual void get_vectors(DocId docId, std::vector<vespalib::tensor::TypedCells>& vectors) const override;
 };
 
 
@@ -11,6 +11,8 @@ HnswGraph::HnswGraph()
   : node_refs(),
     nodes(HnswIndex::make_default_node_store_config()),
     links(HnswIndex::make_default_link_store_config()),
+    mapped(),
+    mapped_overridden(),
     entry_docid_and_level()
 {
     EntryNode entry;
@@ -24,7 +26,7 @@ HnswGraph::make_node_for_document(uint32_t docid, uint32_t num_levels)
 {
     node_refs.ensure_size(docid + 1, AtomicEntryRef());
     // A document cannot be added twice.
-    assert(!node_refs[docid].load_acquire().valid());
+    assert(!has_node(docid));
     // Note: The level array instance lives as long as the document is present in the index.
     vespalib::Array<AtomicEntryRef> levels(num_levels, AtomicEntryRef());
     auto node_ref = nodes.add(levels);
@@ -38,11 +40,43 @@ HnswGraph::remove_node_for_document(uint32_t docid)
     nodes.remove(node_ref);
     vespalib::datastore::EntryRef invalid;
     node_refs[docid].store_release(invalid);
+    if (docid < mapped_overridden.size()) {
+        mapped_overridden[docid].store(true, std::memory_order_release);
+    }
+}
+
+void
+HnswGraph::set_mapped(std::shared_ptr<const MappedHnswGraph> mapped_in)
+{
+    assert(size() == 0 && !mapped);
+    assert(mapped_in->valid());
+    mapped_overridden = std::vector<std::atomic<bool>>(mapped_in->size());
+    mapped = std::move(mapped_in);
+    node_refs.ensure_size(mapped->size());
+    set_entry_node({mapped->entry_docid(), mapped->entry_level()});
 }
 
-void     
+void
+HnswGraph::copy_mapped_node(uint32_t docid)
+{
+    assert(is_mapped_node(docid));
+    uint32_t num_levels = mapped->num_levels(docid);
+    vespalib::Array<AtomicEntryRef> levels;
+    levels.reserve(num_levels);
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        levels.push_back(AtomicEntryRef(links.add(mapped->get_link_array(docid, level))));
+    }
+    auto node_ref = nodes.add(levels);
+    node_refs[docid].store_release(node_ref);
+    mapped_overridden[docid].store(true, std::memory_order_release);
+}
+
+void
 HnswGraph::set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& new_links)
 {
+    if (is_mapped_node(docid)) {
+        copy_mapped_node(docid);
+    }
     auto new_links_ref = links.add(new_links);
     auto node_ref = node_refs[docid].load_acquire();
     assert(node_ref.valid());
@@ -52,22 +86,55 @@ HnswGraph::set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& ne
     links.remove(old_links_ref);
 }
 
+void
+HnswGraph::compact_level_arrays()
+{
+    auto context = nodes.compactWorst(true, true);
+    size_t num_nodes = node_refs.size();
+    for (size_t docid = 0; docid < num_nodes; ++docid) {
+        vespalib::datastore::EntryRef node_ref = node_refs[docid].load_acquire();
+        if (node_ref.valid()) {
+            auto old_node_ref = node_ref;
+            context->compact(vespalib::ArrayRef<vespalib::datastore::EntryRef>(&node_ref, 1));
+            if (node_ref != old_node_ref) {
+                node_refs[docid].store_release(node_ref);
+            }
+        }
+    }
+}
+
+void
+HnswGraph::compact_link_arrays()
+{
+    auto context = links.compactWorst(true, true);
+    size_t num_nodes = node_refs.size();
+    for (size_t docid = 0; docid < num_nodes; ++docid) {
+        auto node_ref = node_refs[docid].load_acquire();
+        if (node_ref.valid()) {
+            auto levels = nodes.get_writable(node_ref);
+            for (auto& level : levels) {
+                vespalib::datastore::EntryRef links_ref = level.load_acquire();
+                auto old_links_ref = links_ref;
+                context->compact(vespalib::ArrayRef<vespalib::datastore::EntryRef>(&links_ref, 1));
+                if (links_ref != old_links_ref) {
+                    level.store_release(links_ref);
+                }
+            }
+        }
+    }
+}
+
 HnswGraph::Histograms
 HnswGraph::histograms() const
 {
     Histograms result;
     size_t num_nodes = node_refs.size();
     for (size_t i = 0; i < num_nodes; ++i) {
-        auto node_ref = node_refs[i].load_acquire();
-        if (node_ref.valid()) {
-            uint32_t levels = 0;
+        if (has_node(i)) {
+            uint32_t levels = num_levels(i);
             uint32_t l0links = 0;
-            auto level_array = nodes.get(node_ref);
-            levels = level_array.size();
             if (levels > 0) {
-                auto links_ref = level_array[0].load_acquire();
-                auto link_array = links.get(links_ref);
-                l0links = link_array.size();
+                l0links = get_link_array(i, 0).size();
             }
             while (result.level_histogram.size() <= levels) {
                 result.level_histogram.push_back(0);
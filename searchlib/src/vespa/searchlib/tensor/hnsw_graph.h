@@ -2,16 +2,24 @@
 
 #pragma once
 
+#include "mapped_hnsw_graph.h"
 #include <vespa/vespalib/datastore/array_store.h>
 #include <vespa/vespalib/datastore/atomic_entry_ref.h>
 #include <vespa/vespalib/datastore/entryref.h>
 #include <vespa/vespalib/util/rcuvector.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace search::tensor {
 
 /**
  * Stroage of a hierarchical navigable small world graph (HNSW)
  * that is used for approximate K-nearest neighbor search.
+ *
+ * Nodes can also be served read-only from a mapped graph file.
+ * Such a node is copied into the data stores the first time it is changed,
+ * after which the mapped version is no longer used.
  */
 struct HnswGraph {
     using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
@@ -39,6 +47,10 @@ struct HnswGraph {
     NodeStore     nodes;
     LinkStore     links;
 
+    std::shared_ptr<const MappedHnswGraph> mapped;
+    // Tells which nodes in the mapped graph have been copied to the data stores or removed.
+    std::vector<std::atomic<bool>> mapped_overridden;
+
     std::atomic<uint64_t> entry_docid_and_level;
 
     HnswGraph();
@@ -49,6 +61,29 @@ struct HnswGraph {
 
     void remove_node_for_document(uint32_t docid);
 
+    /**
+     * Starts serving the nodes in the given mapped graph. Must be called on an empty graph.
+     */
+    void set_mapped(std::shared_ptr<const MappedHnswGraph> mapped_in);
+
+    bool is_mapped_node(uint32_t docid) const {
+        return mapped && (docid < mapped_overridden.size()) &&
+               !mapped_overridden[docid].load(std::memory_order_acquire) &&
+               (mapped->num_levels(docid) > 0);
+    }
+
+    bool has_node(uint32_t docid) const {
+        return node_refs[docid].load_acquire().valid() || is_mapped_node(docid);
+    }
+
+    uint32_t num_levels(uint32_t docid) const {
+        auto node_ref = node_refs[docid].load_acquire();
+        if (node_ref.valid()) {
+            return nodes.get(node_ref).size();
+        }
+        return is_mapped_node(docid) ? mapped->num_levels(docid) : 0;
+    }
+
     LevelArrayRef get_level_array(uint32_t docid) const {
         auto node_ref = node_refs[docid].load_acquire();
         assert(node_ref.valid());
@@ -56,6 +91,11 @@ struct HnswGraph {
     }
 
     LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const {
+        auto node_ref = node_refs[docid].load_acquire();
+        if (!node_ref.valid() && is_mapped_node(docid)) {
+            assert(level < mapped->num_levels(docid));
+            return mapped->get_link_array(docid, level);
+        }
         auto levels = get_level_array(docid);
         assert(level < levels.size());
         return links.get(levels[level].load_acquire());
@@ -63,6 +103,23 @@ struct HnswGraph {
     
     void set_link_array(uint32_t docid, uint32_t level, const LinkArrayRef& new_links);
 
+    /**
+     * Copies a node served from the mapped graph into the data stores.
+     */
+    void copy_mapped_node(uint32_t docid);
+
+    /**
+     * Moves the level arrays in the node store buffers with most dead elements to new buffers.
+     * The old buffers are freed when the hold lists are trimmed.
+     */
+    void compact_level_arrays();
+
+    /**
+     * Moves the link arrays in the link store buffers with most dead elements to new buffers.
+     * The old buffers are freed when the hold lists are trimmed.
+     */
+    void compact_link_arrays();
+
     struct EntryNode {
         uint32_t docid;
         int32_t level;
@@ -4,7 +4,9 @@
 #include "hnsw_index.h"
 #include "hnsw_index_loader.h"
 #include "hnsw_index_saver.h"
+#include "mapped_hnsw_graph.h"
 #include "random_level_generator.h"
+#include <vespa/searchlib/util/fileutil.h>
 #include <vespa/searchlib/util/state_explorer_utils.h>
 #include <vespa/eval/tensor/dense/typed_cells.h>
 #include <vespa/vespalib/data/slime/cursor.h>
@@ -30,6 +32,19 @@ constexpr float alloc_grow_factor = 0.2;
 constexpr size_t max_level_array_size = 16;
 constexpr size_t max_link_array_size = 64;
 
+// Limits the work done by each background maintenance step.
+constexpr uint32_t max_nodes_to_repair_check = 10000;
+// The graph stores are compacted when they have at least this many dead bytes, and dead bytes are more than 20% of used bytes.
+constexpr size_t dead_bytes_slack = 0x10000u;
+
+bool should_compact(const vespalib::MemoryUsage& usage) {
+    return (usage.deadBytes() >= dead_bytes_slack) && (usage.deadBytes() * 5 > usage.usedBytes());
+}
+
+size_t dead_bytes_reduction(const vespalib::MemoryUsage& before, const vespalib::MemoryUsage& after) {
+    return (before.deadBytes() > after.deadBytes()) ? (before.deadBytes() - after.deadBytes()) : 0;
+}
+
 bool has_link_to(vespalib::ConstArrayRef<uint32_t> links, uint32_t id) {
     for (uint32_t link : links) {
         if (link == id) return true;
@@ -71,6 +86,12 @@ HnswIndex::max_links_for_level(uint32_t level) const
     return (level == 0) ? _cfg.max_links_at_level_0() : _cfg.max_links_on_inserts();
 }
 
+uint32_t
+HnswIndex::min_links_before_repair() const
+{
+    return std::max(1u, _cfg.max_links_on_inserts() / 2);
+}
+
 bool
 HnswIndex::have_closer_distance(HnswCandidate candidate, const LinkArrayRef& result) const
 {
@@ -195,7 +216,7 @@ HnswIndex::calc_distance(const TypedCells& lhs, uint32_t rhs_docid) const
 }
 
 HnswCandidate
-HnswIndex::find_nearest_in_layer(const TypedCells& input, const HnswCandidate& entry_point, uint32_t level) const
+HnswIndex::find_nearest_in_layer(const SearchVector& input, const HnswCandidate& entry_point, uint32_t level) const
 {
     HnswCandidate nearest = entry_point;
     bool keep_searching = true;
@@ -213,12 +234,12 @@ HnswIndex::find_nearest_in_layer(const TypedCells& input, const HnswCandidate& e
 }
 
 void
-HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
+HnswIndex::search_layer(const SearchVector& input, uint32_t neighbors_to_find,
                         FurthestPriQ& best_neighbors, uint32_t level, const search::BitVector *filter) const
 {
     NearestPriQ candidates;
     uint32_t doc_id_limit = _graph.node_refs.size();
-    if (filter) {
+    if (filter && (_nodeid_mapping == nullptr)) {
         assert(filter->size() >= doc_id_limit);
     }
     auto visited = _visited_set_pool.get(doc_id_limit);
@@ -226,12 +247,13 @@ HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
         assert(entry.docid < doc_id_limit);
         candidates.push(entry);
         visited.mark(entry.docid);
-        if (filter && !filter->testBit(entry.docid)) {
+        if (filter && !filter_allows(*filter, entry.docid)) {
             assert(best_neighbors.size() == 1);
             best_neighbors.pop();
         }
     }
     double limit_dist = std::numeric_limits<double>::max();
+    DistanceBatch batch(max_links_for_level(level));
 
     while (!candidates.empty()) {
         auto cand = candidates.top();
@@ -239,15 +261,21 @@ HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
             break;
         }
         candidates.pop();
+        batch.docids.clear();
         for (uint32_t neighbor_docid : _graph.get_link_array(cand.docid, level)) {
             if ((neighbor_docid >= doc_id_limit) || visited.is_marked(neighbor_docid)) {
                 continue;
             }
             visited.mark(neighbor_docid);
-            double dist_to_input = calc_distance(input, neighbor_docid);
+            batch.docids.push_back(neighbor_docid);
+        }
+        calc_distances(input, batch);
+        for (size_t i = 0; i < batch.docids.size(); ++i) {
+            uint32_t neighbor_docid = batch.docids[i];
+            double dist_to_input = batch.distances[i];
             if (dist_to_input < limit_dist) {
                 candidates.emplace(neighbor_docid, dist_to_input);
-                if ((!filter) || filter->testBit(neighbor_docid)) {
+                if ((!filter) || filter_allows(*filter, neighbor_docid)) {
                     best_neighbors.emplace(neighbor_docid, dist_to_input);
                     if (best_neighbors.size() > neighbors_to_find) {
                         best_neighbors.pop();
@@ -259,14 +287,51 @@ HnswIndex::search_layer(const TypedCells& input, uint32_t neighbors_to_find,
     }
 }
 
+HnswIndex::DistanceBatch::DistanceBatch(size_t capacity)
+    : docids(),
+      vectors(),
+      distances()
+{
+    docids.reserve(capacity);
+    vectors.reserve(capacity);
+    distances.reserve(capacity);
+}
+
+HnswIndex::DistanceBatch::~DistanceBatch() = default;
+
+void
+HnswIndex::calc_distances(const SearchVector& lhs, DistanceBatch& batch) const
+{
+    size_t num_docids = batch.docids.size();
+    batch.distances.resize(num_docids);
+    if (lhs.quantized != nullptr) {
+        _quantized_vectors->calc_distances(*lhs.quantized, batch.docids.data(), num_docids, batch.distances.data());
+        return;
+    }
+    batch.vectors.clear();
+    for (uint32_t docid : batch.docids) {
+        batch.vectors.push_back(get_vector(docid));
+    }
+    _distance_func->calc_many(lhs.cells, batch.vectors.data(), num_docids, batch.distances.data());
+}
+
 HnswIndex::HnswIndex(const DocVectorAccess& vectors, DistanceFunction::UP distance_func,
-                     RandomLevelGenerator::UP level_generator, const Config& cfg)
+                     RandomLevelGenerator::UP level_generator, const Config& cfg,
+                     std::unique_ptr<QuantizedVectorStore> quantized_vectors,
+                     const HnswNodeidMapping* nodeid_mapping)
     :
       _graph(),
       _vectors(vectors),
       _distance_func(std::move(distance_func)),
       _level_generator(std::move(level_generator)),
-      _cfg(cfg)
+      _cfg(cfg),
+      _quantized_vectors(std::move(quantized_vectors)),
+      _nodeid_mapping(nodeid_mapping),
+      _visited_set_pool(),
+      _maintenance_stats(),
+      _compaction_pending(false),
+      _compaction_on_hold(false),
+      _compaction_gen(0)
 {
 }
 
@@ -318,8 +383,7 @@ HnswIndex::filter_valid_docids(const LinkArrayRef &docids)
     LinkArray valid;
     valid.reserve(docids.size());
     for (uint32_t docid : docids) {
-        auto node_ref = _graph.node_refs[docid].load_acquire();
-        if (node_ref.valid()) {
+        if (_graph.has_node(docid)) {
             valid.push_back(docid);
         }
     }
@@ -329,6 +393,9 @@ HnswIndex::filter_valid_docids(const LinkArrayRef &docids)
 void
 HnswIndex::internal_complete_add(uint32_t docid, PreparedAddDoc &op)
 {
+    if (_quantized_vectors) {
+        _quantized_vectors->set_vector(docid, get_vector(docid));
+    }
     _graph.make_node_for_document(docid, op.max_level + 1);
     for (int level = 0; level <= op.max_level; ++level) {
         auto neighbors = filter_valid_docids(op.connections[level]);
@@ -393,8 +460,8 @@ HnswIndex::remove_document(uint32_t docid)
 {
     bool need_new_entrypoint = (docid == get_entry_docid());
     LinkArray empty;
-    LevelArrayRef node_levels = _graph.get_level_array(docid);
-    for (int level = node_levels.size(); level-- > 0; ) {
+    uint32_t num_levels = _graph.num_levels(docid);
+    for (int level = num_levels; level-- > 0; ) {
         LinkArrayRef my_links = _graph.get_link_array(docid, level);
         for (uint32_t neighbor_id : my_links) {
             if (need_new_entrypoint) {
@@ -411,6 +478,9 @@ HnswIndex::remove_document(uint32_t docid)
         _graph.set_entry_node(entry);
     }
     _graph.remove_node_for_document(docid);
+    if (_quantized_vectors) {
+        _quantized_vectors->remove_vector(docid);
+    }
 }
 
 void
@@ -421,6 +491,13 @@ HnswIndex::transfer_hold_lists(generation_t current_gen)
     _graph.node_refs.setGeneration(current_gen + 1);
     _graph.nodes.transferHoldLists(current_gen);
     _graph.links.transferHoldLists(current_gen);
+    if (_quantized_vectors) {
+        _quantized_vectors->transfer_hold_lists(current_gen);
+    }
+    if (_compaction_pending && !_compaction_on_hold) {
+        _compaction_gen = current_gen;
+        _compaction_on_hold = true;
+    }
 }
 
 void
@@ -429,6 +506,13 @@ HnswIndex::trim_hold_lists(generation_t first_used_gen)
     _graph.node_refs.removeOldGenerations(first_used_gen);
     _graph.nodes.trimHoldLists(first_used_gen);
     _graph.links.trimHoldLists(first_used_gen);
+    if (_quantized_vectors) {
+        _quantized_vectors->trim_hold_lists(first_used_gen);
+    }
+    if (_compaction_on_hold && (first_used_gen > _compaction_gen)) {
+        _compaction_pending = false;
+        _compaction_on_hold = false;
+    }
 }
 
 vespalib::MemoryUsage
@@ -439,6 +523,9 @@ HnswIndex::memory_usage() const
     result.merge(_graph.nodes.getMemoryUsage());
     result.merge(_graph.links.getMemoryUsage());
     result.merge(_visited_set_pool.memory_usage());
+    if (_quantized_vectors) {
+        result.merge(_quantized_vectors->memory_usage());
+    }
     return result;
 }
 
@@ -448,6 +535,7 @@ HnswIndex::get_state(const vespalib::slime::Inserter& inserter) const
     auto& object = inserter.insertObject();
     StateExplorerUtils::memory_usage_to_slime(memory_usage(), object.setObject("memory_usage"));
     object.setLong("nodes", _graph.size());
+    object.setBool("mapped", static_cast<bool>(_graph.mapped));
     auto& histogram_array = object.setArray("level_histogram");
     auto& links_hst_array = object.setArray("level_0_links_histogram");
     auto histograms = _graph.histograms();
@@ -471,6 +559,125 @@ HnswIndex::get_state(const vespalib::slime::Inserter& inserter) const
     cfgObj.setLong("max_links_on_inserts", _cfg.max_links_on_inserts());
     cfgObj.setLong("neighbors_to_explore_at_construction",
                    _cfg.neighbors_to_explore_at_construction());
+    cfgObj.setBool("quantized_vectors", static_cast<bool>(_quantized_vectors));
+    auto& maintenanceObj = object.setObject("maintenance");
+    maintenanceObj.setLong("repair_cursor", _maintenance_stats.repair_cursor);
+    maintenanceObj.setLong("repair_passes", _maintenance_stats.repair_passes);
+    maintenanceObj.setLong("nodes_checked", _maintenance_stats.nodes_checked);
+    maintenanceObj.setLong("nodes_repaired", _maintenance_stats.nodes_repaired);
+    maintenanceObj.setLong("compactions", _maintenance_stats.compactions);
+    maintenanceObj.setLong("memory_reclaimed", _maintenance_stats.memory_reclaimed);
+}
+
+bool
+HnswIndex::repair_node(uint32_t docid)
+{
+    uint32_t min_links = min_links_before_repair();
+    uint32_t num_levels = _graph.num_levels(docid);
+    bool poorly_connected = false;
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        if (_graph.get_link_array(docid, level).size() < min_links) {
+            poorly_connected = true;
+        }
+    }
+    auto entry = _graph.get_entry_node();
+    if (!poorly_connected || (entry.docid == 0) || (entry.docid == docid)) {
+        return false;
+    }
+    SearchVector input(get_vector(docid));
+    int search_level = entry.level;
+    HnswCandidate entry_point(entry.docid, calc_distance(input, entry.docid));
+    while (search_level >= int(num_levels)) {
+        entry_point = find_nearest_in_layer(input, entry_point, search_level);
+        --search_level;
+    }
+    FurthestPriQ best_neighbors;
+    best_neighbors.push(entry_point);
+    bool repaired = false;
+    for (; search_level >= 0; --search_level) {
+        search_layer(input, _cfg.neighbors_to_explore_at_construction(), best_neighbors, search_level);
+        auto old_links = _graph.get_link_array(docid, search_level);
+        if (old_links.size() >= min_links) {
+            continue;
+        }
+        HnswCandidateVector candidates;
+        for (const auto& candidate : best_neighbors.peek()) {
+            if ((candidate.docid != docid) && !has_link_to(old_links, candidate.docid)) {
+                candidates.push_back(candidate);
+            }
+        }
+        auto neighbors = select_neighbors(candidates, _cfg.max_links_on_inserts() - old_links.size());
+        for (uint32_t neighbor_docid : neighbors.used) {
+            add_link_to(docid, search_level, _graph.get_link_array(docid, search_level), neighbor_docid);
+            add_link_to(neighbor_docid, search_level, _graph.get_link_array(neighbor_docid, search_level), docid);
+        }
+        for (uint32_t neighbor_docid : neighbors.used) {
+            shrink_if_needed(neighbor_docid, search_level);
+        }
+        repaired = repaired || !neighbors.used.empty();
+    }
+    return repaired;
+}
+
+bool
+HnswIndex::repair_graph(uint32_t max_nodes)
+{
+    auto& stats = _maintenance_stats;
+    uint32_t doc_id_limit = _graph.size();
+    uint32_t checked = 0;
+    while ((checked < max_nodes) && (stats.repair_cursor < doc_id_limit)) {
+        uint32_t docid = stats.repair_cursor++;
+        if (!_graph.has_node(docid)) {
+            continue;
+        }
+        ++checked;
+        if (repair_node(docid)) {
+            ++stats.nodes_repaired;
+        }
+    }
+    stats.nodes_checked += checked;
+    if (stats.repair_cursor < doc_id_limit) {
+        return true;
+    }
+    if (doc_id_limit > 0) {
+        ++stats.repair_passes;
+    }
+    stats.repair_cursor = 0;
+    return false;
+}
+
+bool
+HnswIndex::consider_compact_graph()
+{
+    if (_compaction_pending) {
+        return false;
+    }
+    bool compacted = false;
+    auto nodes_usage = _graph.nodes.getMemoryUsage();
+    if (should_compact(nodes_usage)) {
+        _graph.compact_level_arrays();
+        _maintenance_stats.memory_reclaimed += dead_bytes_reduction(nodes_usage, _graph.nodes.getMemoryUsage());
+        compacted = true;
+    }
+    auto links_usage = _graph.links.getMemoryUsage();
+    if (should_compact(links_usage)) {
+        _graph.compact_link_arrays();
+        _maintenance_stats.memory_reclaimed += dead_bytes_reduction(links_usage, _graph.links.getMemoryUsage());
+        compacted = true;
+    }
+    if (compacted) {
+        ++_maintenance_stats.compactions;
+        _compaction_pending = true;
+    }
+    return compacted;
+}
+
+bool
+HnswIndex::maintain()
+{
+    bool more_to_repair = repair_graph(max_nodes_to_repair_check);
+    consider_compact_graph();
+    return more_to_repair;
 }
 
 std::unique_ptr<NearestNeighborIndexSaver>
@@ -484,7 +691,39 @@ HnswIndex::load(const fileutil::LoadedBuffer& buf)
 {
     assert(get_entry_docid() == 0); // cannot load after index has data
     HnswIndexLoader loader(_graph);
-    return loader.load(buf);
+    if (!loader.load(buf)) {
+        return false;
+    }
+    set_loaded_quantized_vectors();
+    return true;
+}
+
+bool
+HnswIndex::load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf)
+{
+    assert(get_entry_docid() == 0); // cannot load after index has data
+    if (!MappedHnswGraph::is_flat_format(*buf)) {
+        return load(*buf);
+    }
+    auto mapped = std::make_shared<MappedHnswGraph>(std::move(buf));
+    if (!mapped->valid()) {
+        return false;
+    }
+    _graph.set_mapped(std::move(mapped));
+    set_loaded_quantized_vectors();
+    return true;
+}
+
+void
+HnswIndex::set_loaded_quantized_vectors()
+{
+    if (_quantized_vectors) {
+        for (uint32_t docid = 0; docid < _graph.size(); ++docid) {
+            if (_graph.has_node(docid)) {
+                _quantized_vectors->set_vector(docid, get_vector(docid));
+            }
+        }
+    }
 }
 
 struct NeighborsByDocId {
@@ -500,7 +739,20 @@ HnswIndex::top_k_by_docid(uint32_t k, TypedCells vector,
                           const BitVector *filter, uint32_t explore_k) const
 {
     std::vector<Neighbor> result;
-    FurthestPriQ candidates = top_k_candidates(vector, std::max(k, explore_k), filter);
+    FurthestPriQ candidates;
+    if (_quantized_vectors) {
+        // Re-rank the candidates found using approximate distances.
+        auto quantized = _quantized_vectors->quantize(vector);
+        auto approximate = find_candidates(SearchVector(vector, quantized), std::max(k, explore_k), filter);
+        for (const HnswCandidate & hit : approximate.peek()) {
+            candidates.emplace(hit.docid, calc_distance(vector, hit.docid));
+        }
+    } else {
+        candidates = find_candidates(vector, std::max(k, explore_k), filter);
+    }
+    if (_nodeid_mapping != nullptr) {
+        return top_k_documents(k, candidates);
+    }
     while (candidates.size() > k) {
         candidates.pop();
     }
@@ -512,6 +764,35 @@ HnswIndex::top_k_by_docid(uint32_t k, TypedCells vector,
     return result;
 }
 
+std::vector<NearestNeighborIndex::Neighbor>
+HnswIndex::top_k_documents(uint32_t k, const FurthestPriQ& candidates) const
+{
+    std::vector<Neighbor> result;
+    result.reserve(candidates.size());
+    for (const HnswCandidate & hit : candidates.peek()) {
+        uint32_t docid = _nodeid_mapping->get_docid(hit.docid);
+        if (docid != 0) {
+            result.emplace_back(docid, hit.distance);
+        }
+    }
+    // Keep the closest node of each document.
+    std::sort(result.begin(), result.end(), [](const Neighbor& lhs, const Neighbor& rhs) {
+        return (lhs.docid < rhs.docid) || ((lhs.docid == rhs.docid) && (lhs.distance < rhs.distance));
+    });
+    auto end = std::unique(result.begin(), result.end(), [](const Neighbor& lhs, const Neighbor& rhs) {
+        return (lhs.docid == rhs.docid);
+    });
+    result.erase(end, result.end());
+    if (result.size() > k) {
+        std::nth_element(result.begin(), result.begin() + k, result.end(), [](const Neighbor& lhs, const Neighbor& rhs) {
+            return (lhs.distance < rhs.distance);
+        });
+        result.resize(k);
+        std::sort(result.begin(), result.end(), NeighborsByDocId());
+    }
+    return result;
+}
+
 std::vector<NearestNeighborIndex::Neighbor>
 HnswIndex::find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const
 {
@@ -527,6 +808,12 @@ HnswIndex::find_top_k_with_filter(uint32_t k, TypedCells vector,
 
 FurthestPriQ
 HnswIndex::top_k_candidates(const TypedCells &vector, uint32_t k, const BitVector *filter) const
+{
+    return find_candidates(vector, k, filter);
+}
+
+FurthestPriQ
+HnswIndex::find_candidates(const SearchVector &vector, uint32_t k, const BitVector *filter) const
 {
     FurthestPriQ best_neighbors;
     auto entry = _graph.get_entry_node();
@@ -548,14 +835,13 @@ HnswIndex::top_k_candidates(const TypedCells &vector, uint32_t k, const BitVecto
 HnswNode
 HnswIndex::get_node(uint32_t docid) const
 {
-    auto node_ref = _graph.node_refs[docid].load_acquire();
-    if (!node_ref.valid()) {
+    if (!_graph.has_node(docid)) {
         return HnswNode();
     }
-    auto levels = _graph.nodes.get(node_ref);
+    uint32_t num_levels = _graph.num_levels(docid);
     HnswNode::LevelArray result;
-    for (const auto& links_ref : levels) {
-        auto links = _graph.links.get(links_ref.load_acquire());
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        auto links = _graph.get_link_array(docid, level);
         HnswNode::LinkArray result_links(links.begin(), links.end());
         std::sort(result_links.begin(), result_links.end());
         result.push_back(result_links);
@@ -568,6 +854,9 @@ HnswIndex::set_node(uint32_t docid, const HnswNode &node)
 {
     size_t num_levels = node.size();
     assert(num_levels > 0);
+    if (_quantized_vectors) {
+        _quantized_vectors->set_vector(docid, get_vector(docid));
+    }
     _graph.make_node_for_document(docid, num_levels);
     for (size_t level = 0; level < num_levels; ++level) {
         connect_new_node(docid, node.level(level), level);
@@ -583,19 +872,16 @@ HnswIndex::check_link_symmetry() const
 {
     bool all_sym = true;
     for (size_t docid = 0; docid < _graph.node_refs.size(); ++docid) {
-        auto node_ref = _graph.node_refs[docid].load_acquire();
-        if (node_ref.valid()) {
-            auto levels = _graph.nodes.get(node_ref);
-            uint32_t level = 0;
-            for (const auto& links_ref : levels) {
-                auto links = _graph.links.get(links_ref.load_acquire());
+        if (_graph.has_node(docid)) {
+            uint32_t num_levels = _graph.num_levels(docid);
+            for (uint32_t level = 0; level < num_levels; ++level) {
+                auto links = _graph.get_link_array(docid, level);
                 for (auto neighbor_docid : links) {
                     auto neighbor_links = _graph.get_link_array(neighbor_docid, level);
                     if (! has_link_to(neighbor_links, docid)) {
                         all_sym = false;
                     }
                 }
-                ++level;
             }
         }
     }
@@ -5,8 +5,10 @@
 #include "distance_function.h"
 #include "doc_vector_access.h"
 #include "hnsw_index_utils.h"
+#include "hnsw_nodeid_mapping.h"
 #include "hnsw_node.h"
 #include "nearest_neighbor_index.h"
+#include "quantized_vector_store.h"
 #include "random_level_generator.h"
 #include "hnsw_graph.h"
 #include <vespa/eval/tensor/dense/typed_cells.h>
@@ -30,6 +32,14 @@ namespace search::tensor {
  * "Efficient and robust approximate nearest neighbor search using Hierarchical Navigable Small World graphs" (Yu. A. Malkov, D. A. Yashunin),
  * but some adjustments are made to support proper removes.
  *
+ * Optionally, scalar quantized versions of the vectors are used to calculate approximate distances
+ * when traversing the graph during search. The best candidates found are then re-ranked using the original vectors.
+ *
+ * Optionally, the index is built over tensors with several vectors per document.
+ * Each vector is then a separate node in the graph, and the given nodeid mapping tells which document a node belongs to.
+ * The ids used by the add and remove functions are node ids, while filters and search results use document ids.
+ * A document is only returned once, with the distance of its closest node.
+ *
  * TODO: Add details on how to handle removes.
  */
 class HnswIndex : public NearestNeighborIndex {
@@ -57,6 +67,26 @@ public:
         bool heuristic_select_neighbors() const { return _heuristic_select_neighbors; }
     };
 
+    /**
+     * Progress of the background maintenance of the graph.
+     */
+    struct MaintenanceStats {
+        uint32_t repair_cursor;
+        uint64_t repair_passes;
+        uint64_t nodes_checked;
+        uint64_t nodes_repaired;
+        uint64_t compactions;
+        uint64_t memory_reclaimed;
+        MaintenanceStats()
+            : repair_cursor(0),
+              repair_passes(0),
+              nodes_checked(0),
+              nodes_repaired(0),
+              compactions(0),
+              memory_reclaimed(0)
+        {}
+    };
+
 protected:
     using AtomicEntryRef = HnswGraph::AtomicEntryRef;
     using NodeStore = HnswGraph::NodeStore;
@@ -70,14 +100,34 @@ protected:
 
     using TypedCells = vespalib::tensor::TypedCells;
 
+    /**
+     * The vector to search for, with an optional quantized version
+     * that is used to calculate approximate distances.
+     */
+    struct SearchVector {
+        TypedCells cells;
+        const QuantizedVectorStore::Vector* quantized;
+        SearchVector(const TypedCells& cells_in) : cells(cells_in), quantized(nullptr) {}
+        SearchVector(const TypedCells& cells_in, const QuantizedVectorStore::Vector& quantized_in)
+            : cells(cells_in), quantized(&quantized_in) {}
+    };
+
     HnswGraph _graph;
     const DocVectorAccess& _vectors;
     DistanceFunction::UP _distance_func;
     RandomLevelGenerator::UP _level_generator;
     Config _cfg;
+    std::unique_ptr<QuantizedVectorStore> _quantized_vectors;
+    const HnswNodeidMapping* _nodeid_mapping;
     mutable vespalib::ReusableSetPool _visited_set_pool;
+    MaintenanceStats _maintenance_stats;
+    // Tracks the buffers of the last compaction until they are freed.
+    bool _compaction_pending;
+    bool _compaction_on_hold;
+    generation_t _compaction_gen;
 
     uint32_t max_links_for_level(uint32_t level) const;
+    uint32_t min_links_before_repair() const;
     void add_link_to(uint32_t docid, uint32_t level, const LinkArrayRef& old_links, uint32_t new_link) {
         LinkArray new_links(old_links.begin(), old_links.end());
         new_links.push_back(new_link);
@@ -108,17 +158,48 @@ protected:
         return _vectors.get_vector(docid);
     }
 
+    uint32_t get_docid(uint32_t nodeid) const {
+        return (_nodeid_mapping != nullptr) ? _nodeid_mapping->get_docid(nodeid) : nodeid;
+    }
+    bool filter_allows(const BitVector& filter, uint32_t nodeid) const {
+        uint32_t docid = get_docid(nodeid);
+        return (docid < filter.size()) && filter.testBit(docid);
+    }
+
     double calc_distance(uint32_t lhs_docid, uint32_t rhs_docid) const;
     double calc_distance(const TypedCells& lhs, uint32_t rhs_docid) const;
+    double calc_distance(const SearchVector& lhs, uint32_t rhs_docid) const {
+        if (lhs.quantized != nullptr) {
+            return _quantized_vectors->calc_distance(*lhs.quantized, rhs_docid);
+        }
+        return calc_distance(lhs.cells, rhs_docid);
+    }
+
+    /**
+     * Buffers used to calculate the distances to the neighbors of a candidate as one batch.
+     */
+    struct DistanceBatch {
+        std::vector<uint32_t> docids;
+        std::vector<TypedCells> vectors;
+        std::vector<double> distances;
+        DistanceBatch(size_t capacity);
+        ~DistanceBatch();
+    };
+    void calc_distances(const SearchVector& lhs, DistanceBatch& batch) const;
 
     /**
      * Performs a greedy search in the given layer to find the candidate that is nearest the input vector.
      */
-    HnswCandidate find_nearest_in_layer(const TypedCells& input, const HnswCandidate& entry_point, uint32_t level) const;
-    void search_layer(const TypedCells& input, uint32_t neighbors_to_find, FurthestPriQ& found_neighbors,
+    HnswCandidate find_nearest_in_layer(const SearchVector& input, const HnswCandidate& entry_point, uint32_t level) const;
+    void search_layer(const SearchVector& input, uint32_t neighbors_to_find, FurthestPriQ& found_neighbors,
                       uint32_t level, const search::BitVector *filter = nullptr) const;
+    FurthestPriQ find_candidates(const SearchVector& vector, uint32_t k, const BitVector *filter) const;
     std::vector<Neighbor> top_k_by_docid(uint32_t k, TypedCells vector,
                                          const BitVector *filter, uint32_t explore_k) const;
+    /**
+     * Maps the given node candidates to the k closest documents, using the closest node of each document.
+     */
+    std::vector<Neighbor> top_k_documents(uint32_t k, const FurthestPriQ& candidates) const;
 
     struct PreparedAddDoc : public PrepareResult {
         uint32_t docid;
@@ -132,13 +213,24 @@ protected:
     };
     PreparedAddDoc internal_prepare_add(uint32_t docid, TypedCells input_vector) const;
     LinkArray filter_valid_docids(const LinkArrayRef &docids);
+    void set_loaded_quantized_vectors();
     void internal_complete_add(uint32_t docid, PreparedAddDoc &op);
+
+    /**
+     * Links a node having too few links at some level to more of its nearest neighbors at that level.
+     * Returns true if any links were added.
+     */
+    bool repair_node(uint32_t docid);
 public:
     HnswIndex(const DocVectorAccess& vectors, DistanceFunction::UP distance_func,
-              RandomLevelGenerator::UP level_generator, const Config& cfg);
+              RandomLevelGenerator::UP level_generator, const Config& cfg,
+              std::unique_ptr<QuantizedVectorStore> quantized_vectors = std::unique_ptr<QuantizedVectorStore>(),
+              const HnswNodeidMapping* nodeid_mapping = nullptr);
     ~HnswIndex() override;
 
     const Config& config() const { return _cfg; }
+    const QuantizedVectorStore* quantized_vectors() const { return _quantized_vectors.get(); }
+    const HnswNodeidMapping* nodeid_mapping() const { return _nodeid_mapping; }
 
     // Implements NearestNeighborIndex
     void add_document(uint32_t docid) override;
@@ -154,11 +246,29 @@ public:
 
     std::unique_ptr<NearestNeighborIndexSaver> make_saver() const override;
     bool load(const fileutil::LoadedBuffer& buf) override;
+    bool load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf) override;
 
     std::vector<Neighbor> find_top_k(uint32_t k, TypedCells vector, uint32_t explore_k) const override;
     std::vector<Neighbor> find_top_k_with_filter(uint32_t k, TypedCells vector,
                                                  const BitVector &filter, uint32_t explore_k) const override;
     const DistanceFunction *distance_function() const override { return _distance_func.get(); }
+    bool maintain() override;
+
+    /**
+     * Checks the connectivity of up to max_nodes nodes, continuing after the node checked last time,
+     * and repairs the nodes that are poorly connected, e.g. after their neighbors have been removed.
+     * Returns true if the current pass over the graph is not completed.
+     */
+    bool repair_graph(uint32_t max_nodes);
+
+    /**
+     * Compacts the node and link stores of the graph if they have too many dead elements,
+     * and no earlier compaction is waiting for its buffers to be freed.
+     * Returns true if a compaction was started.
+     */
+    bool consider_compact_graph();
+
+    const MaintenanceStats& maintenance_stats() const { return _maintenance_stats; }
 
     FurthestPriQ top_k_candidates(const TypedCells &vector, uint32_t k, const BitVector *filter) const;
 
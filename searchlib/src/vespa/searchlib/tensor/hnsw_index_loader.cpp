@@ -2,6 +2,7 @@
 
 #include "hnsw_index_loader.h"
 #include "hnsw_graph.h"
+#include "mapped_hnsw_graph.h"
 #include <vespa/searchlib/util/fileutil.h>
 
 namespace search::tensor {
@@ -13,9 +14,34 @@ HnswIndexLoader::HnswIndexLoader(HnswGraph &graph)
 {
 }
 
+bool
+HnswIndexLoader::load_flat(const fileutil::LoadedBuffer& buf)
+{
+    MappedHnswGraph mapped(buf);
+    if (!mapped.valid()) {
+        return false;
+    }
+    uint32_t num_nodes = mapped.size();
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t num_levels = mapped.num_levels(docid);
+        if (num_levels > 0) {
+            _graph.make_node_for_document(docid, num_levels);
+            for (uint32_t level = 0; level < num_levels; ++level) {
+                _graph.set_link_array(docid, level, mapped.get_link_array(docid, level));
+            }
+        }
+    }
+    _graph.node_refs.ensure_size(num_nodes);
+    _graph.set_entry_node({mapped.entry_docid(), mapped.entry_level()});
+    return true;
+}
+
 bool
 HnswIndexLoader::load(const fileutil::LoadedBuffer& buf)
 {
+    if (MappedHnswGraph::is_flat_format(buf)) {
+        return load_flat(buf);
+    }
     size_t num_readable = buf.size(sizeof(uint32_t));
     _ptr = static_cast<const uint32_t *>(buf.buffer());
     _end = _ptr + num_readable;
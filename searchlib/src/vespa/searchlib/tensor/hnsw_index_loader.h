@@ -11,7 +11,9 @@ namespace search::tensor {
 struct HnswGraph;
 
 /**
- * Implements loading of HNSW graph structure from binary format.
+ * Implements loading of HNSW graph structure from binary format,
+ * copying it into the data stores of the graph.
+ * Both the flat format (see MappedHnswGraph) and the legacy format are supported.
  **/
 class HnswIndexLoader {
 public:
@@ -23,6 +25,7 @@ private:
     const uint32_t *_ptr;
     const uint32_t *_end;
     bool _failed;
+    bool load_flat(const fileutil::LoadedBuffer& buf);
     uint32_t next_int() {
         if (__builtin_expect((_ptr == _end), false)) {
             _failed = true;
@@ -2,10 +2,21 @@
 
 #include "hnsw_index_saver.h"
 #include "hnsw_graph.h"
+#include "mapped_hnsw_graph.h"
 #include <vespa/searchlib/util/bufferwriter.h>
+#include <cassert>
+#include <limits>
 
 namespace search::tensor {
 
+namespace {
+
+void write_int(BufferWriter& writer, uint32_t value) {
+    writer.write(&value, sizeof(uint32_t));
+}
+
+}
+
 HnswIndexSaver::~HnswIndexSaver() {}
 
 HnswIndexSaver::HnswIndexSaver(const HnswGraph &graph)
@@ -14,8 +25,10 @@ HnswIndexSaver::HnswIndexSaver(const HnswGraph &graph)
     auto entry = graph.get_entry_node();
     _meta_data.entry_docid = entry.docid;
     _meta_data.entry_level = entry.level;
+    _meta_data.mapped = graph.mapped;
     size_t num_nodes = graph.node_refs.size();
     _meta_data.nodes.reserve(num_nodes);
+    _meta_data.mapped_nodes.reserve(num_nodes);
     for (size_t i = 0; i < num_nodes; ++i) {
         LevelVector node;
         auto node_ref = graph.node_refs[i].load_acquire();
@@ -27,29 +40,75 @@ HnswIndexSaver::HnswIndexSaver(const HnswGraph &graph)
             }
         }
         _meta_data.nodes.emplace_back(std::move(node));
+        _meta_data.mapped_nodes.push_back(!node_ref.valid() && graph.is_mapped_node(i));
+    }
+}
+
+uint32_t
+HnswIndexSaver::num_levels(uint32_t docid) const
+{
+    if (_meta_data.mapped_nodes[docid]) {
+        return _meta_data.mapped->num_levels(docid);
+    }
+    return _meta_data.nodes[docid].size();
+}
+
+HnswGraph::LinkArrayRef
+HnswIndexSaver::get_link_array(uint32_t docid, uint32_t level) const
+{
+    if (_meta_data.mapped_nodes[docid]) {
+        return _meta_data.mapped->get_link_array(docid, level);
     }
+    auto links_ref = _meta_data.nodes[docid][level];
+    if (!links_ref.valid()) {
+        return HnswGraph::LinkArrayRef();
+    }
+    return _graph_links.get(links_ref);
 }
 
 void
 HnswIndexSaver::save(BufferWriter& writer) const
 {
-    writer.write(&_meta_data.entry_docid, sizeof(uint32_t));
-    writer.write(&_meta_data.entry_level, sizeof(int32_t));
     uint32_t num_nodes = _meta_data.nodes.size();
-    writer.write(&num_nodes, sizeof(uint32_t));
-    for (const auto &node : _meta_data.nodes) {
-        uint32_t num_levels = node.size();
-        writer.write(&num_levels, sizeof(uint32_t));
-        for (auto links_ref : node) {
-            if (links_ref.valid()) {
-                vespalib::ConstArrayRef<uint32_t> link_array = _graph_links.get(links_ref);
-                uint32_t num_links = link_array.size();
-                writer.write(&num_links, sizeof(uint32_t));
-                writer.write(link_array.cbegin(), sizeof(uint32_t)*num_links);
-            } else {
-                uint32_t num_links = 0;
-                writer.write(&num_links, sizeof(uint32_t));
-            }
+    uint64_t total_levels = 0;
+    uint64_t total_links = 0;
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t levels = num_levels(docid);
+        total_levels += levels;
+        for (uint32_t level = 0; level < levels; ++level) {
+            total_links += get_link_array(docid, level).size();
+        }
+    }
+    assert(total_levels < std::numeric_limits<uint32_t>::max());
+    assert(total_links < std::numeric_limits<uint32_t>::max());
+    write_int(writer, MappedHnswGraph::magic);
+    write_int(writer, MappedHnswGraph::version);
+    write_int(writer, _meta_data.entry_docid);
+    write_int(writer, _meta_data.entry_level);
+    write_int(writer, num_nodes);
+    write_int(writer, total_levels);
+    write_int(writer, total_links);
+    write_int(writer, 0);
+    uint32_t level_offset = 0;
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        write_int(writer, level_offset);
+        level_offset += num_levels(docid);
+    }
+    write_int(writer, level_offset);
+    uint32_t link_offset = 0;
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t levels = num_levels(docid);
+        for (uint32_t level = 0; level < levels; ++level) {
+            write_int(writer, link_offset);
+            link_offset += get_link_array(docid, level).size();
+        }
+    }
+    write_int(writer, link_offset);
+    for (uint32_t docid = 0; docid < num_nodes; ++docid) {
+        uint32_t levels = num_levels(docid);
+        for (uint32_t level = 0; level < levels; ++level) {
+            auto link_array = get_link_array(docid, level);
+            writer.write(link_array.cbegin(), sizeof(uint32_t) * link_array.size());
         }
     }
     writer.flush();
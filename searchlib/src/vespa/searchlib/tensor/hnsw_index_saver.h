@@ -5,12 +5,14 @@
 #include "nearest_neighbor_index_saver.h"
 #include "hnsw_graph.h"
 #include <vespa/vespalib/datastore/entryref.h>
+#include <memory>
 #include <vector>
 
 namespace search::tensor {
 
 /**
- * Implements saving of HNSW graph structure in binary format.
+ * Implements saving of HNSW graph structure in the flat binary format
+ * described in MappedHnswGraph.
  * The constructor takes a snapshot of all meta-data, but
  * the links will be fetched from the graph in the save()
  * method.
@@ -28,10 +30,16 @@ private:
         uint32_t entry_docid;
         int32_t  entry_level;
         std::vector<LevelVector> nodes;
-        MetaData() : entry_docid(0), entry_level(-1), nodes() {}
+        // Nodes that are still served from the mapped graph
+        std::vector<bool> mapped_nodes;
+        std::shared_ptr<const MappedHnswGraph> mapped;
+        MetaData() : entry_docid(0), entry_level(-1), nodes(), mapped_nodes(), mapped() {}
     };
     const HnswGraph::LinkStore &_graph_links;
     MetaData _meta_data;
+
+    uint32_t num_levels(uint32_t docid) const;
+    HnswGraph::LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const;
 };
 
 }
@@ -0,0 +1,134 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hnsw_nodeid_mapping.h"
+#include <vespa/vespalib/datastore/array_store.hpp>
+#include <vespa/vespalib/util/rcuvector.hpp>
+
+namespace search::tensor {
+
+using vespalib::datastore::EntryRef;
+
+namespace {
+
+constexpr size_t small_page_size = 4 * 1024;
+constexpr size_t min_num_arrays_for_new_buffer = 8 * 1024;
+constexpr float alloc_grow_factor = 0.2;
+// Documents with more subspaces than this get their node ids stored as large arrays.
+constexpr size_t max_small_array_size = 32;
+
+vespalib::datastore::ArrayStoreConfig
+make_nodeid_store_config()
+{
+    using NodeidStore = vespalib::datastore::ArrayStore<uint32_t, vespalib::datastore::EntryRefT<22>>;
+    return NodeidStore::optimizedConfigForHugePage(max_small_array_size, vespalib::alloc::MemoryAllocator::HUGEPAGE_SIZE,
+                                                   small_page_size, min_num_arrays_for_new_buffer, alloc_grow_factor).enable_free_lists(true);
+}
+
+}
+
+HnswNodeidMapping::HnswNodeidMapping()
+    : _refs(),
+      _nodeids(make_nodeid_store_config()),
+      _docids(),
+      _free_list(),
+      _pending_free(),
+      _hold_list()
+{
+    // Node id 0 is reserved.
+    _docids.push_back(0);
+}
+
+HnswNodeidMapping::~HnswNodeidMapping() = default;
+
+uint32_t
+HnswNodeidMapping::alloc_nodeid()
+{
+    if (!_free_list.empty()) {
+        uint32_t nodeid = _free_list.back();
+        _free_list.pop_back();
+        return nodeid;
+    }
+    uint32_t nodeid = _docids.size();
+    _docids.push_back(0);
+    return nodeid;
+}
+
+HnswNodeidMapping::NodeidArrayRef
+HnswNodeidMapping::allocate_ids(uint32_t docid, uint32_t num_ids)
+{
+    _refs.ensure_size(docid + 1, AtomicEntryRef());
+    assert(!_refs[docid].load_acquire().valid());
+    if (num_ids == 0) {
+        return NodeidArrayRef();
+    }
+    std::vector<uint32_t> nodeids;
+    nodeids.reserve(num_ids);
+    for (uint32_t i = 0; i < num_ids; ++i) {
+        uint32_t nodeid = alloc_nodeid();
+        _docids[nodeid] = docid;
+        nodeids.push_back(nodeid);
+    }
+    auto ref = _nodeids.add(NodeidArrayRef(nodeids));
+    _refs[docid].store_release(ref);
+    return _nodeids.get(ref);
+}
+
+void
+HnswNodeidMapping::free_ids(uint32_t docid)
+{
+    if (docid >= _refs.size()) {
+        return;
+    }
+    auto ref = _refs[docid].load_acquire();
+    if (!ref.valid()) {
+        return;
+    }
+    for (uint32_t nodeid : _nodeids.get(ref)) {
+        _docids[nodeid] = 0;
+        _pending_free.push_back(nodeid);
+    }
+    _refs[docid].store_release(EntryRef());
+    _nodeids.remove(ref);
+}
+
+void
+HnswNodeidMapping::transfer_hold_lists(generation_t current_gen)
+{
+    // Note: RcuVector transfers hold lists as part of reallocation based on current generation.
+    //       We need to set the next generation here, as it is incremented on a higher level right after this call.
+    _refs.setGeneration(current_gen + 1);
+    _docids.setGeneration(current_gen + 1);
+    _nodeids.transferHoldLists(current_gen);
+    for (uint32_t nodeid : _pending_free) {
+        _hold_list.emplace_back(nodeid, current_gen);
+    }
+    _pending_free.clear();
+}
+
+void
+HnswNodeidMapping::trim_hold_lists(generation_t first_used_gen)
+{
+    _refs.removeOldGenerations(first_used_gen);
+    _docids.removeOldGenerations(first_used_gen);
+    _nodeids.trimHoldLists(first_used_gen);
+    while (!_hold_list.empty() && (_hold_list.front().second < first_used_gen)) {
+        _free_list.push_back(_hold_list.front().first);
+        _hold_list.pop_front();
+    }
+}
+
+vespalib::MemoryUsage
+HnswNodeidMapping::memory_usage() const
+{
+    vespalib::MemoryUsage result;
+    result.merge(_refs.getMemoryUsage());
+    result.merge(_nodeids.getMemoryUsage());
+    result.merge(_docids.getMemoryUsage());
+    size_t free_list_bytes = (_free_list.capacity() + _pending_free.capacity()) * sizeof(uint32_t) +
+                             _hold_list.size() * sizeof(std::pair<uint32_t, generation_t>);
+    result.incAllocatedBytes(free_list_bytes);
+    result.incUsedBytes(free_list_bytes);
+    return result;
+}
+
+}
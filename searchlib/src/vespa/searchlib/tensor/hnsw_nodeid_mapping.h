@@ -0,0 +1,79 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/datastore/array_store.h>
+#include <vespa/vespalib/datastore/atomic_entry_ref.h>
+#include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <deque>
+#include <vector>
+
+namespace search::tensor {
+
+/**
+ * Maps between document ids and the ids of the nodes in a hnsw index
+ * that is built over tensors with several vectors (dense subspaces) per document.
+ *
+ * Each document gets one node id per subspace. Node id 0 is reserved and never used.
+ * The node ids of a removed document are put on hold until no reader can see them,
+ * before they are reused for other documents.
+ *
+ * Supports 1 write thread and multiple read threads.
+ */
+class HnswNodeidMapping {
+public:
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    using NodeidArrayRef = vespalib::ConstArrayRef<uint32_t>;
+
+private:
+    using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
+    using EntryRefType = vespalib::datastore::EntryRefT<22>;
+    using NodeidStore = vespalib::datastore::ArrayStore<uint32_t, EntryRefType>;
+
+    // Provides mapping from document id -> reference to the node ids of the document in NodeidStore.
+    vespalib::RcuVector<AtomicEntryRef> _refs;
+    NodeidStore _nodeids;
+    // Provides mapping from node id -> document id. Free node ids map to document id 0.
+    vespalib::RcuVector<uint32_t> _docids;
+    std::vector<uint32_t> _free_list;
+    std::vector<uint32_t> _pending_free;
+    std::deque<std::pair<uint32_t, generation_t>> _hold_list;
+
+    uint32_t alloc_nodeid();
+
+public:
+    HnswNodeidMapping();
+    ~HnswNodeidMapping();
+
+    /**
+     * Allocates the given number of node ids for the given document, which must not already have node ids.
+     */
+    NodeidArrayRef allocate_ids(uint32_t docid, uint32_t num_ids);
+
+    /**
+     * Frees the node ids of the given document. The ids are reused when the hold lists are trimmed.
+     */
+    void free_ids(uint32_t docid);
+
+    NodeidArrayRef get_ids(uint32_t docid) const {
+        if (docid >= _refs.size()) {
+            return NodeidArrayRef();
+        }
+        return _nodeids.get(_refs[docid].load_acquire());
+    }
+
+    uint32_t get_docid(uint32_t nodeid) const {
+        return (nodeid < _docids.size()) ? _docids[nodeid] : 0;
+    }
+
+    uint32_t nodeid_limit() const { return _docids.size(); }
+
+    void transfer_hold_lists(generation_t current_gen);
+    void trim_hold_lists(generation_t first_used_gen);
+    vespalib::MemoryUsage memory_usage() const;
+};
+
+}
@@ -0,0 +1,94 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mapped_hnsw_graph.h"
+#include <vespa/searchlib/util/fileutil.h>
+
+namespace search::tensor {
+
+namespace {
+
+bool is_increasing(const uint32_t* offsets, size_t num_offsets, uint32_t limit) {
+    uint32_t prev = 0;
+    for (size_t i = 0; i < num_offsets; ++i) {
+        if (offsets[i] < prev || offsets[i] > limit) {
+            return false;
+        }
+        prev = offsets[i];
+    }
+    return true;
+}
+
+}
+
+MappedHnswGraph::MappedHnswGraph(const fileutil::LoadedBuffer& buf)
+    : _owned_buffer(),
+      _node_offsets(nullptr),
+      _level_offsets(nullptr),
+      _links(nullptr),
+      _num_nodes(0),
+      _entry_docid(0),
+      _entry_level(-1),
+      _valid(false)
+{
+    init(buf.buffer(), buf.size());
+}
+
+MappedHnswGraph::MappedHnswGraph(std::unique_ptr<fileutil::LoadedBuffer> buf)
+    : MappedHnswGraph(*buf)
+{
+    _owned_buffer = std::move(buf);
+}
+
+MappedHnswGraph::~MappedHnswGraph() = default;
+
+bool
+MappedHnswGraph::is_flat_format(const fileutil::LoadedBuffer& buf)
+{
+    if (buf.size(sizeof(uint32_t)) < header_size) {
+        return false;
+    }
+    return (static_cast<const uint32_t *>(buf.buffer())[0] == magic);
+}
+
+void
+MappedHnswGraph::init(const void* data, size_t size)
+{
+    if ((reinterpret_cast<uintptr_t>(data) % alignof(uint32_t)) != 0) {
+        return;
+    }
+    size_t num_words = size / sizeof(uint32_t);
+    if (num_words < header_size) {
+        return;
+    }
+    auto words = static_cast<const uint32_t *>(data);
+    if (words[0] != magic || words[1] != version) {
+        return;
+    }
+    uint32_t num_nodes = words[4];
+    uint32_t num_levels = words[5];
+    uint32_t num_links = words[6];
+    size_t exp_words = size_t(header_size) + (size_t(num_nodes) + 1) + (size_t(num_levels) + 1) + num_links;
+    if (num_words != exp_words) {
+        return;
+    }
+    const uint32_t* node_offsets = words + header_size;
+    const uint32_t* level_offsets = node_offsets + num_nodes + 1;
+    const uint32_t* links = level_offsets + num_levels + 1;
+    if (node_offsets[num_nodes] != num_levels || level_offsets[num_levels] != num_links) {
+        return;
+    }
+    if (!is_increasing(node_offsets, num_nodes + 1, num_levels) ||
+        !is_increasing(level_offsets, num_levels + 1, num_links))
+    {
+        return;
+    }
+    _node_offsets = node_offsets;
+    _level_offsets = level_offsets;
+    _links = links;
+    _num_nodes = num_nodes;
+    _entry_docid = words[2];
+    _entry_level = static_cast<int32_t>(words[3]);
+    _valid = true;
+}
+
+}
@@ -0,0 +1,81 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <cstdint>
+#include <memory>
+
+namespace search::fileutil { class LoadedBuffer; }
+
+namespace search::tensor {
+
+/**
+ * Read-only view of a HNSW graph saved in the flat binary format.
+ * The level and link arrays are used directly from the file buffer,
+ * which is typically memory mapped, making loading the graph close to free.
+ *
+ * Layout (all values are uint32_t):
+ *   header:        magic, version, entry docid, entry level, num nodes, num levels, num links, 0
+ *   node offsets:  num nodes + 1 entries, index in level offsets of the first level of each node
+ *   level offsets: num levels + 1 entries, index in links of the first link of each level
+ *   links:         num links entries
+ */
+class MappedHnswGraph {
+public:
+    using LinkArrayRef = vespalib::ConstArrayRef<uint32_t>;
+
+    // Larger than any valid docid, used to tell this format apart from the legacy format starting with the entry docid.
+    static constexpr uint32_t magic = 0xf1a7e4a1;
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t header_size = 8;
+
+private:
+    std::unique_ptr<fileutil::LoadedBuffer> _owned_buffer;
+    const uint32_t* _node_offsets;
+    const uint32_t* _level_offsets;
+    const uint32_t* _links;
+    uint32_t _num_nodes;
+    uint32_t _entry_docid;
+    int32_t _entry_level;
+    bool _valid;
+
+    void init(const void* data, size_t size);
+
+public:
+    /**
+     * Creates a view of the given buffer, which must outlive this instance.
+     */
+    MappedHnswGraph(const fileutil::LoadedBuffer& buf);
+
+    /**
+     * Creates a view of the given buffer, taking ownership of it.
+     */
+    MappedHnswGraph(std::unique_ptr<fileutil::LoadedBuffer> buf);
+    ~MappedHnswGraph();
+
+    static bool is_flat_format(const fileutil::LoadedBuffer& buf);
+
+    /**
+     * Returns whether the buffer contained a consistent graph in the flat format.
+     */
+    bool valid() const { return _valid; }
+    uint32_t size() const { return _num_nodes; }
+    uint32_t entry_docid() const { return _entry_docid; }
+    int32_t entry_level() const { return _entry_level; }
+
+    uint32_t num_levels(uint32_t docid) const {
+        if (docid >= _num_nodes) {
+            return 0;
+        }
+        return _node_offsets[docid + 1] - _node_offsets[docid];
+    }
+    LinkArrayRef get_link_array(uint32_t docid, uint32_t level) const {
+        uint32_t level_idx = _node_offsets[docid] + level;
+        uint32_t begin = _level_offsets[level_idx];
+        uint32_t end = _level_offsets[level_idx + 1];
+        return LinkArrayRef(_links + begin, end - begin);
+    }
+};
+
+}
@@ -63,6 +63,15 @@ public:
     virtual vespalib::MemoryUsage memory_usage() const = 0;
     virtual void get_state(const vespalib::slime::Inserter& inserter) const = 0;
 
+    /**
+     * Performs one incremental step of background maintenance of the index,
+     * e.g. repairing parts of the index degraded by removals and compacting its data stores.
+     *
+     * This function is only called by the attribute writer thread.
+     * Returns true if there is more maintenance work to do.
+     */
+    virtual bool maintain() { return false; }
+
     /**
      * Creates a saver that is used to save the index to binary form.
      *
@@ -72,6 +81,16 @@ public:
     virtual std::unique_ptr<NearestNeighborIndexSaver> make_saver() const = 0;
     virtual bool load(const fileutil::LoadedBuffer& buf) = 0;
 
+    /**
+     * Loads the index from the given buffer, taking ownership of it.
+     *
+     * An implementation may serve the index directly from the (memory mapped) buffer
+     * instead of copying it. The default implementation uses load().
+     */
+    virtual bool load_mapped(std::unique_ptr<fileutil::LoadedBuffer> buf) {
+        return load(*buf);
+    }
+
     virtual std::vector<Neighbor> find_top_k(uint32_t k,
                                              vespalib::tensor::TypedCells vector,
                                              uint32_t explore_k) const = 0;
@@ -10,6 +10,7 @@ namespace search::attribute { class HnswIndexParams; }
 namespace search::tensor {
 
 class DocVectorAccess;
+class HnswNodeidMapping;
 class NearestNeighborIndex;
 
 /**
@@ -22,6 +23,16 @@ public:
                                                        size_t vector_size,
                                                        vespalib::eval::ValueType::CellType cell_type,
                                                        const search::attribute::HnswIndexParams& params) const = 0;
+
+    /**
+     * Makes an index over tensors with several vectors per document, where each vector is a node in the index.
+     * The vectors are accessed by node id, and the given mapping tells which document a node belongs to.
+     */
+    virtual std::unique_ptr<NearestNeighborIndex> make_multi_vector(const DocVectorAccess& node_vectors,
+                                                                    const HnswNodeidMapping& nodeid_mapping,
+                                                                    size_t vector_size,
+                                                                    vespalib::eval::ValueType::CellType cell_type,
+                                                                    const search::attribute::HnswIndexParams& params) const = 0;
 };
 
 }
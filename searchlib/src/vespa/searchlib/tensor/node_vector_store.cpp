@@ -0,0 +1,91 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "node_vector_store.h"
+#include <vespa/vespalib/util/rcuvector.hpp>
+
+namespace search::tensor {
+
+using vespalib::ConstArrayRef;
+using vespalib::datastore::EntryRef;
+
+namespace {
+
+struct ConvertCells {
+    template <typename CT>
+    static void call(ConstArrayRef<double> cells, void* dst) {
+        CT* typed_dst = static_cast<CT*>(dst);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            typed_dst[i] = CT(cells[i]);
+        }
+    }
+};
+
+}
+
+NodeVectorStore::NodeVectorStore(const vespalib::eval::ValueType& vector_type)
+    : _refs(),
+      _store(vector_type)
+{
+    assert(vector_type.is_dense());
+}
+
+NodeVectorStore::~NodeVectorStore()
+{
+    _store.clearHoldLists();
+}
+
+void
+NodeVectorStore::set_vector(uint32_t nodeid, ConstArrayRef<double> cells)
+{
+    assert(cells.size() == _store.getNumCells());
+    auto raw = _store.allocRawBuffer();
+    vespalib::tensor::dispatch_0<ConvertCells>(_store.type().cell_type(), cells, raw.data);
+    _refs.ensure_size(nodeid + 1, AtomicEntryRef());
+    auto old_ref = _refs[nodeid].load_acquire();
+    _refs[nodeid].store_release(raw.ref);
+    _store.holdTensor(old_ref);
+}
+
+void
+NodeVectorStore::remove_vector(uint32_t nodeid)
+{
+    if (nodeid >= _refs.size()) {
+        return;
+    }
+    auto old_ref = _refs[nodeid].load_acquire();
+    _refs[nodeid].store_release(EntryRef());
+    _store.holdTensor(old_ref);
+}
+
+vespalib::tensor::TypedCells
+NodeVectorStore::get_vector(uint32_t nodeid) const
+{
+    auto ref = (nodeid < _refs.size()) ? _refs[nodeid].load_acquire() : EntryRef();
+    return _store.get_typed_cells(ref);
+}
+
+void
+NodeVectorStore::transfer_hold_lists(generation_t current_gen)
+{
+    // Note: RcuVector transfers hold lists as part of reallocation based on current generation.
+    //       We need to set the next generation here, as it is incremented on a higher level right after this call.
+    _refs.setGeneration(current_gen + 1);
+    _store.transferHoldLists(current_gen);
+}
+
+void
+NodeVectorStore::trim_hold_lists(generation_t first_used_gen)
+{
+    _refs.removeOldGenerations(first_used_gen);
+    _store.trimHoldLists(first_used_gen);
+}
+
+vespalib::MemoryUsage
+NodeVectorStore::memory_usage() const
+{
+    vespalib::MemoryUsage result = _refs.getMemoryUsage();
+    result.merge(_store.getMemoryUsage());
+    return result;
+}
+
+}
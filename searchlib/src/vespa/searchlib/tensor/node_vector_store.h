@@ -0,0 +1,51 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "dense_tensor_store.h"
+#include "doc_vector_access.h"
+#include <vespa/vespalib/datastore/atomic_entry_ref.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/rcuvector.h>
+
+namespace search::tensor {
+
+/**
+ * Stores the vectors of the nodes in a hnsw index that is built over tensors
+ * with several vectors (dense subspaces) per document, see HnswNodeidMapping.
+ *
+ * Supports 1 write thread and multiple read threads.
+ */
+class NodeVectorStore : public DocVectorAccess {
+public:
+    using generation_t = vespalib::GenerationHandler::generation_t;
+
+private:
+    using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
+
+    // Provides mapping from node id -> reference to the vector in DenseTensorStore.
+    vespalib::RcuVector<AtomicEntryRef> _refs;
+    DenseTensorStore _store;
+
+public:
+    NodeVectorStore(const vespalib::eval::ValueType& vector_type);
+    ~NodeVectorStore() override;
+
+    const vespalib::eval::ValueType& vector_type() const { return _store.type(); }
+
+    /**
+     * Sets the vector of the given node from the given cells, converting them to the cell type of this store.
+     */
+    void set_vector(uint32_t nodeid, vespalib::ConstArrayRef<double> cells);
+    void remove_vector(uint32_t nodeid);
+
+    // Implements DocVectorAccess, where the given id is a node id.
+    vespalib::tensor::TypedCells get_vector(uint32_t nodeid) const override;
+
+    void transfer_hold_lists(generation_t current_gen);
+    void trim_hold_lists(generation_t first_used_gen);
+    vespalib::MemoryUsage memory_usage() const;
+};
+
+}
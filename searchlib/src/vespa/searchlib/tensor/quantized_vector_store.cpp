@@ -0,0 +1,190 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "quantized_vector_store.h"
+#include <vespa/vespalib/datastore/datastore.hpp>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <vespa/vespalib/util/rcuvector.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace search::tensor {
+
+using vespalib::ConstArrayRef;
+using vespalib::datastore::EntryRef;
+
+namespace {
+
+constexpr size_t MIN_BUFFER_ARRAYS = 1024;
+constexpr size_t ENTRY_ALIGNMENT = 16;
+constexpr double MAX_CODE = 127.0;
+
+size_t my_align(size_t size, size_t alignment) {
+    size += alignment - 1;
+    return (size - (size % alignment));
+}
+
+struct QuantizeCells {
+    template <typename CT>
+    static QuantizedVectorStore::Vector call(ConstArrayRef<CT> cells) {
+        double max_abs = 0.0;
+        double sq_norm = 0.0;
+        for (CT cell : cells) {
+            double value = cell;
+            max_abs = std::max(max_abs, std::abs(value));
+            sq_norm += value * value;
+        }
+        QuantizedVectorStore::Vector result;
+        result.scale = max_abs / MAX_CODE;
+        result.sq_norm = sq_norm;
+        result.codes.reserve(cells.size());
+        double factor = (max_abs > 0.0) ? (MAX_CODE / max_abs) : 0.0;
+        for (CT cell : cells) {
+            double value = cell;
+            result.codes.push_back(static_cast<int8_t>(std::lround(value * factor)));
+        }
+        return result;
+    }
+};
+
+}
+
+QuantizedVectorStore::QuantizedVectorStore(size_t vector_size, DistanceMetric distance_metric)
+    : _vector_size(vector_size),
+      _entry_size(my_align(sizeof(Header) + vector_size, ENTRY_ALIGNMENT)),
+      _distance_metric(distance_metric),
+      _computer(vespalib::hwaccelrated::IAccelrated::getAccelerator()),
+      _refs(),
+      _store(),
+      _buffer_type(_entry_size, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
+      _type_id(0)
+{
+    assert(distance_metric != DistanceMetric::GeoDegrees);
+    _type_id = _store.addType(&_buffer_type);
+    _store.initActiveBuffers();
+    _store.enableFreeLists();
+}
+
+QuantizedVectorStore::~QuantizedVectorStore()
+{
+    _store.dropBuffers();
+}
+
+bool
+QuantizedVectorStore::is_supported(DistanceMetric distance_metric, CellType cell_type)
+{
+    return (distance_metric != DistanceMetric::GeoDegrees) && (cell_type != CellType::INT8);
+}
+
+QuantizedVectorStore::Vector
+QuantizedVectorStore::quantize(const TypedCells& vector) const
+{
+    assert(vector.size == _vector_size);
+    return vespalib::tensor::dispatch_1<QuantizeCells>(vector);
+}
+
+void
+QuantizedVectorStore::set_vector(uint32_t docid, const TypedCells& vector)
+{
+    auto quantized = quantize(vector);
+    auto entry = _store.freeListRawAllocator<char>(_type_id).alloc(_entry_size);
+    Header header{quantized.scale, quantized.sq_norm};
+    memcpy(entry.data, &header, sizeof(Header));
+    memcpy(entry.data + sizeof(Header), quantized.codes.data(), _vector_size);
+    memset(entry.data + sizeof(Header) + _vector_size, 0, _entry_size - sizeof(Header) - _vector_size);
+    _refs.ensure_size(docid + 1, AtomicEntryRef());
+    auto old_ref = _refs[docid].load_acquire();
+    _refs[docid].store_release(entry.ref);
+    if (old_ref.valid()) {
+        _store.holdElem(old_ref, _entry_size);
+    }
+}
+
+void
+QuantizedVectorStore::remove_vector(uint32_t docid)
+{
+    if (docid >= _refs.size()) {
+        return;
+    }
+    auto old_ref = _refs[docid].load_acquire();
+    _refs[docid].store_release(EntryRef());
+    if (old_ref.valid()) {
+        _store.holdElem(old_ref, _entry_size);
+    }
+}
+
+double
+QuantizedVectorStore::calc_distance(const Vector& lhs, uint32_t rhs_docid) const
+{
+    return calc_distance(lhs, get_entry(rhs_docid));
+}
+
+void
+QuantizedVectorStore::calc_distances(const Vector& lhs, const uint32_t* rhs_docids, size_t num_rhs, double* result) const
+{
+    constexpr size_t max_batch_size = 32;
+    const char* entries[max_batch_size];
+    for (size_t offset = 0; offset < num_rhs; offset += max_batch_size) {
+        size_t batch_size = std::min(max_batch_size, num_rhs - offset);
+        for (size_t i = 0; i < batch_size; ++i) {
+            entries[i] = get_entry(rhs_docids[offset + i]);
+            if (entries[i] != nullptr) {
+                for (size_t pos = 0; pos < _entry_size; pos += 64) {
+                    __builtin_prefetch(entries[i] + pos);
+                }
+            }
+        }
+        for (size_t i = 0; i < batch_size; ++i) {
+            result[offset + i] = calc_distance(lhs, entries[i]);
+        }
+    }
+}
+
+double
+QuantizedVectorStore::calc_distance(const Vector& lhs, const char* entry) const
+{
+    if (entry == nullptr) {
+        return std::numeric_limits<double>::max();
+    }
+    Header rhs;
+    memcpy(&rhs, entry, sizeof(Header));
+    auto rhs_codes = reinterpret_cast<const int8_t*>(entry + sizeof(Header));
+    double dot_product = _computer.dotProduct(lhs.codes.data(), rhs_codes, _vector_size);
+    dot_product *= double(lhs.scale) * double(rhs.scale);
+    switch (_distance_metric) {
+    case DistanceMetric::Euclidean:
+        return std::max(0.0, double(lhs.sq_norm) + double(rhs.sq_norm) - 2.0 * dot_product);
+    case DistanceMetric::Angular:
+        return std::max(0.0, 1.0 - dot_product);
+    case DistanceMetric::GeoDegrees:
+        break;
+    }
+    abort();
+}
+
+void
+QuantizedVectorStore::transfer_hold_lists(generation_t current_gen)
+{
+    // Note: RcuVector transfers hold lists as part of reallocation based on current generation.
+    //       We need to set the next generation here, as it is incremented on a higher level right after this call.
+    _refs.setGeneration(current_gen + 1);
+    _store.transferHoldLists(current_gen);
+}
+
+void
+QuantizedVectorStore::trim_hold_lists(generation_t first_used_gen)
+{
+    _refs.removeOldGenerations(first_used_gen);
+    _store.trimHoldLists(first_used_gen);
+}
+
+vespalib::MemoryUsage
+QuantizedVectorStore::memory_usage() const
+{
+    vespalib::MemoryUsage result;
+    result.merge(_refs.getMemoryUsage());
+    result.merge(_store.getMemoryUsage());
+    return result;
+}
+
+}
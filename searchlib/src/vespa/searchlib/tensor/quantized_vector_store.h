@@ -0,0 +1,108 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/value_type.h>
+#include <vespa/eval/tensor/dense/typed_cells.h>
+#include <vespa/searchcommon/attribute/distance_metric.h>
+#include <vespa/vespalib/datastore/atomic_entry_ref.h>
+#include <vespa/vespalib/datastore/datastore.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/rcuvector.h>
+
+namespace vespalib::hwaccelrated { class IAccelrated; }
+
+namespace search::tensor {
+
+/**
+ * Stores scalar quantized versions of the vectors in a hnsw index,
+ * used to calculate approximate distances when traversing the graph.
+ *
+ * A vector v is represented by int8 codes c and a scale s where v ~= s * c,
+ * together with the squared norm of v. Approximate distances are
+ * calculated using the dot product of the int8 codes.
+ *
+ * Supports 1 write thread and multiple read threads. The codes of a
+ * document must be set before the document is linked into the graph.
+ */
+class QuantizedVectorStore {
+public:
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    using CellType = vespalib::eval::ValueType::CellType;
+    using DistanceMetric = search::attribute::DistanceMetric;
+    using TypedCells = vespalib::tensor::TypedCells;
+
+    /**
+     * A quantized vector owned by the caller, e.g. the query vector.
+     */
+    struct Vector {
+        float scale;
+        float sq_norm;
+        std::vector<int8_t> codes;
+        Vector() : scale(0.0), sq_norm(0.0), codes() {}
+    };
+
+private:
+    using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
+    using RefType = vespalib::datastore::EntryRefT<22>;
+    using DataStoreType = vespalib::datastore::DataStoreT<RefType>;
+    using RefVector = vespalib::RcuVector<AtomicEntryRef>;
+
+    // Stored in front of the codes of each entry.
+    struct Header {
+        float scale;
+        float sq_norm;
+    };
+
+    size_t _vector_size;
+    size_t _entry_size;
+    DistanceMetric _distance_metric;
+    const vespalib::hwaccelrated::IAccelrated& _computer;
+    RefVector _refs;
+    DataStoreType _store;
+    vespalib::datastore::BufferType<char> _buffer_type;
+    uint32_t _type_id;
+
+    const char* get_entry(uint32_t docid) const {
+        if (docid >= _refs.size()) {
+            return nullptr;
+        }
+        auto ref = _refs[docid].load_acquire();
+        return ref.valid() ? _store.getEntryArray<char>(RefType(ref), _entry_size) : nullptr;
+    }
+    double calc_distance(const Vector& lhs, const char* rhs_entry) const;
+
+public:
+    QuantizedVectorStore(size_t vector_size, DistanceMetric distance_metric);
+    ~QuantizedVectorStore();
+
+    /**
+     * Returns whether quantization is supported for the given distance metric and cell type.
+     * Vectors with int8 cells are not quantized further.
+     */
+    static bool is_supported(DistanceMetric distance_metric, CellType cell_type);
+
+    Vector quantize(const TypedCells& vector) const;
+    void set_vector(uint32_t docid, const TypedCells& vector);
+    void remove_vector(uint32_t docid);
+
+    /**
+     * Calculates the approximate distance between the given quantized vector and the vector of the given document.
+     * The result is on the same scale as the distance function for the distance metric.
+     * Documents without a quantized vector (e.g. removed documents) are infinitely far away.
+     */
+    double calc_distance(const Vector& lhs, uint32_t rhs_docid) const;
+
+    /**
+     * Calculates the approximate distance between the given quantized vector and the vectors of the given documents,
+     * written to result. The entries of all documents are prefetched before the distances are calculated.
+     */
+    void calc_distances(const Vector& lhs, const uint32_t* rhs_docids, size_t num_rhs, double* result) const;
+
+    void transfer_hold_lists(generation_t current_gen);
+    void trim_hold_lists(generation_t first_used_gen);
+    vespalib::MemoryUsage memory_usage() const;
+};
+
+}
@@ -45,7 +45,7 @@ createEmptyTensor(const ValueType &type)
     if (type.is_sparse()) {
         return std::make_unique<SparseTensor>(type, SparseTensor::Cells());
     } else if (type.is_dense()) {
-        using MyTypify = vespalib::eval::TypifyCellType;
+        using MyTypify = vespalib::eval::TypifyAllCellTypes;
         return vespalib::typify_invoke<1,MyTypify,CallMakeEmptyTensor>(type.cell_type(), type);
     } else {
         return std::make_unique<WrappedSimpleTensor>(std::make_unique<SimpleTensor>(type, SimpleTensor::Cells()));
@@ -270,6 +270,39 @@ TensorAttribute::complete_set_tensor(DocId docid, const Tensor& tensor,
     (void) prepare_result;
 }
 
+const NearestNeighborIndex*
+TensorAttribute::nearest_neighbor_index() const
+{
+    return nullptr;
+}
+
+bool
+TensorAttribute::maintain_nearest_neighbor_index()
+{
+    return false;
+}
+
+void
+TensorAttribute::get_vectors(DocId, std::vector<vespalib::tensor::TypedCells>&) const
+{
+    notImplemented();
+}
+
+ValueType
+TensorAttribute::vector_type(const ValueType& tensor_type)
+{
+    const auto& dims = tensor_type.dimensions();
+    if ((dims.size() == 1) && dims[0].is_indexed()) {
+        return tensor_type;
+    }
+    if ((dims.size() == 2) && (dims[0].is_mapped() != dims[1].is_mapped())) {
+        // keeps the stored cell type, unlike reduce
+        const auto& indexed_dim = dims[0].is_mapped() ? dims[1] : dims[0];
+        return ValueType::tensor_type({indexed_dim}, tensor_type.cell_type());
+    }
+    return ValueType::error_type();
+}
+
 IMPLEMENT_IDENTIFIABLE_ABSTRACT(TensorAttribute, AttributeVector);
 
 }
@@ -5,12 +5,15 @@
 #include "i_tensor_attribute.h"
 #include "prepare_result.h"
 #include "tensor_store.h"
+#include <vespa/eval/tensor/dense/typed_cells.h>
 #include <vespa/searchlib/attribute/not_implemented_attribute.h>
 #include <vespa/vespalib/util/rcuvector.h>
 #include <future>
 
 namespace search::tensor {
 
+class NearestNeighborIndex;
+
 /**
  * Attribute vector class used to store tensors for all documents in memory.
  */
@@ -71,6 +74,29 @@ public:
     virtual void complete_set_tensor(DocId docid, const Tensor& tensor, std::future<std::unique_ptr<PrepareResult>> prepare_result);
 
     virtual void compactWorst() = 0;
+
+    virtual const NearestNeighborIndex* nearest_neighbor_index() const;
+
+    /**
+     * Performs one step of background maintenance of the nearest neighbor index (if any),
+     * and commits the changes. This function is only called by the attribute writer thread.
+     * Returns true if the index has more maintenance work to do.
+     */
+    virtual bool maintain_nearest_neighbor_index();
+
+    /**
+     * Gets the vectors of the tensor for the given document, used for brute force nearest neighbor search.
+     * Only implemented by attributes storing tensors with one mapped and one indexed dimension,
+     * where each dense subspace is a vector with the type given by vector_type().
+     */
+    virtual void get_vectors(DocId docid, std::vector<vespalib::tensor::TypedCells>& vectors) const;
+
+    /**
+     * Returns the type of the vectors used for nearest neighbor search in tensors of the given type:
+     * The type itself for dense tensors of order 1, and the type of the dense subspaces for
+     * tensors with one mapped and one indexed dimension. Returns the error type for other tensor types.
+     */
+    static vespalib::eval::ValueType vector_type(const vespalib::eval::ValueType& tensor_type);
 };
 
 }
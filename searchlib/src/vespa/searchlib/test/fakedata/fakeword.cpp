@@ -8,6 +8,7 @@
 #include <vespa/searchlib/bitcompression/compression.h>
 #include <vespa/searchlib/bitcompression/posocccompression.h>
 #include <vespa/searchlib/bitcompression/posocc_fields_params.h>
+#include <vespa/searchlib/queryeval/iblockmaxweight.h>
 
 using search::fef::TermFieldMatchData;
 using search::fef::TermFieldMatchDataPosition;
@@ -20,6 +21,7 @@ using search::index::PostingListCounts;
 using search::index::PostingListFileSeqRead;
 using search::diskindex::FieldReader;
 using search::diskindex::FieldWriter;
+using search::queryeval::IBlockMaxWeight;
 
 namespace search
 {
@@ -27,6 +29,23 @@ namespace search
 namespace fakedata
 {
 
+static void
+validateBlockMaxWeight(const search::queryeval::SearchIterator *iterator,
+                       const fef::TermFieldMatchDataArray &matchData,
+                       uint32_t docId)
+{
+    const IBlockMaxWeight *blockMax = dynamic_cast<const IBlockMaxWeight *>(iterator);
+    if (blockMax == nullptr) {
+        return;
+    }
+    assert(docId <= blockMax->get_block_end());
+    for (size_t lfi = 0; lfi < matchData.size(); ++lfi) {
+        if (matchData[lfi]->getDocId() == docId) {
+            assert(matchData[lfi]->getWeight() <= blockMax->get_block_max_weight());
+        }
+    }
+}
+
 
 static void
 fillbitset(search::BitVector *bitvector,
@@ -432,6 +451,7 @@ FakeWord::validate(search::queryeval::SearchIterator *iterator,
             assert(d != de);
             unsigned int positions = d->_positions;
             iterator->unpack(docId);
+            validateBlockMaxWeight(iterator, matchData, docId);
             for (size_t lfi = 0; lfi < matchData.size(); ++lfi) {
                 if (matchData[lfi]->getDocId() != docId)
                     continue;
@@ -499,6 +519,7 @@ FakeWord::validate(search::queryeval::SearchIterator *iterator,
             assert(d != de);
             assert(d->_docId == docId);
             iterator->unpack(docId);
+            validateBlockMaxWeight(iterator, matchData, docId);
             unsigned int positions = d->_positions;
             for (size_t lfi = 0; lfi < matchData.size(); ++lfi) {
                 if (matchData[lfi]->getDocId() != docId)
@@ -172,6 +172,7 @@ FakeZcFilterOcc::setupT(const FakeWord &fw)
     params.set("minChunkDocs", _posting_params._min_chunk_docs); // Control chunking
     params.set("minSkipDocs", _posting_params._min_skip_docs);   // Control skip info
     params.set("interleaved_features", _posting_params._encode_interleaved_features);
+    params.set("block_max_weight", _posting_params._encode_block_max_weight);
     writer.set_posting_list_params(params);
     auto &writeContext = writer.get_write_context();
     search::ComprBuffer &cb = writeContext;
@@ -790,7 +791,7 @@ class FakeZc4SkipPosOccCf : public FakeZc4SkipPosOcc<bigEndian>
 {
 public:
     FakeZc4SkipPosOccCf(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                        (bigEndian ? ".zc4skipposoccbe.cf" : ".zc4skipposoccle.cf"))
     {
     }
@@ -800,7 +801,7 @@ class FakeZc4SkipPosOccCfNoNormalUnpack : public FakeZc4SkipPosOcc<true>
 {
 public:
     FakeZc4SkipPosOccCfNoNormalUnpack(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                   ".zc4skipposoccbe.cf.nnu")
     {
         _unpack_normal_features = false;
@@ -811,7 +812,7 @@ class FakeZc4SkipPosOccCfNoCheapUnpack : public FakeZc4SkipPosOcc<true>
 {
 public:
     FakeZc4SkipPosOccCfNoCheapUnpack(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                   ".zc4skipposoccbe.cf.ncu")
     {
         _unpack_interleaved_features = false;
@@ -823,7 +824,7 @@ class FakeZc4NoSkipPosOccCf : public FakeZc4SkipPosOcc<bigEndian>
 {
 public:
     FakeZc4NoSkipPosOccCf(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                        (bigEndian ? ".zc4noskipposoccbe.cf" : "zc4noskipposoccle.cf"))
     {
     }
@@ -833,7 +834,7 @@ class FakeZc4NoSkipPosOccCfNoNormalUnpack : public FakeZc4SkipPosOcc<true>
 {
 public:
     FakeZc4NoSkipPosOccCfNoNormalUnpack(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                   ".zc4noskipposoccbe.cf.nnu")
     {
         _unpack_normal_features = false;
@@ -844,7 +845,7 @@ class FakeZc4NoSkipPosOccCfNoCheapUnpack : public FakeZc4SkipPosOcc<true>
 {
 public:
     FakeZc4NoSkipPosOccCfNoCheapUnpack(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true),
+        : FakeZc4SkipPosOcc<true>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, false, true, true, true),
                                   ".zc4noskipposoccbe.cf.ncu")
     {
         _unpack_interleaved_features = false;
@@ -856,7 +857,7 @@ class FakeZc5NoSkipPosOccCf : public FakeZc4SkipPosOcc<bigEndian>
 {
 public:
     FakeZc5NoSkipPosOccCf(const FakeWord &fw)
-        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, true, true, true),
+        : FakeZc4SkipPosOcc<bigEndian>(fw, Zc4PostingParams(disable_skip, disable_chunking, fw._docIdLimit, true, true, true, true),
                                        (bigEndian ? ".zc5noskipposoccbe.cf" : ".zc5noskipposoccle.cf"))
     {
     }
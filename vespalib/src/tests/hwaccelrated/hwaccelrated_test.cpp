@@ -3,6 +3,9 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <vespa/vespalib/hwaccelrated/generic.h>
+#include <vespa/vespalib/util/bfloat16.h>
+#include <cmath>
+#include <limits>
 
 using namespace vespalib;
 
@@ -37,4 +40,138 @@ TEST("test euclidean distance") {
     verifyEuclideanDistance<double >(genericAccelrator);
 }
 
+void verifyInt8EuclideanDistance(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<int8_t> a(testLength);
+    std::vector<int8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%256 - 128;
+        b[i] = rand()%256 - 128;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        int64_t sum(0);
+        for (size_t i(j); i < testLength; i++) {
+            sum += (int64_t(a[i]) - b[i]) * (int64_t(a[i]) - b[i]);
+        }
+        EXPECT_EQUAL(double(sum), accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+    }
+}
+
+void verifyBFloat16(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<BFloat16> a(testLength);
+    std::vector<BFloat16> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = float(rand()%100);
+        b[i] = float(rand()%100);
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        double dot(0);
+        double dist(0);
+        for (size_t i(j); i < testLength; i++) {
+            dot += a[i].to_float() * b[i].to_float();
+            dist += (a[i].to_float() - b[i].to_float()) * (a[i].to_float() - b[i].to_float());
+        }
+        EXPECT_EQUAL(dot, accel.dotProduct(&a[j], &b[j], testLength - j));
+        EXPECT_EQUAL(dist, accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+    }
+}
+
+TEST("test int8 euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    TEST_DO(verifyInt8EuclideanDistance(genericAccelrator));
+    TEST_DO(verifyInt8EuclideanDistance(hwaccelrated::IAccelrated::getAccelerator()));
+}
+
+TEST("test bfloat16 dot product and euclidean distance") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    TEST_DO(verifyBFloat16(genericAccelrator));
+    TEST_DO(verifyBFloat16(hwaccelrated::IAccelrated::getAccelerator()));
+}
+
+template<typename T>
+void verifyBatchedDistances(const hwaccelrated::IAccelrated & accel) {
+    const size_t testLength(77);
+    const size_t numVectors(9);
+    srand(1);
+    std::vector<T> a = createAndFill<T>(testLength);
+    std::vector<std::vector<T>> vectors;
+    std::vector<const T *> b;
+    for (size_t i(0); i < numVectors; i++) {
+        vectors.push_back(createAndFill<T>(testLength));
+    }
+    for (const auto & v : vectors) {
+        b.push_back(&v[0]);
+    }
+    std::vector<double> dots(numVectors);
+    std::vector<double> dists(numVectors);
+    accel.dotProducts(&a[0], &b[0], numVectors, testLength, &dots[0]);
+    accel.squaredEuclideanDistances(&a[0], &b[0], numVectors, testLength, &dists[0]);
+    for (size_t i(0); i < numVectors; i++) {
+        EXPECT_EQUAL(double(accel.dotProduct(&a[0], b[i], testLength)), dots[i]);
+        EXPECT_EQUAL(accel.squaredEuclideanDistance(&a[0], b[i], testLength), dists[i]);
+    }
+}
+
+TEST("test batched dot products and euclidean distances") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    TEST_DO(verifyBatchedDistances<float>(genericAccelrator));
+    TEST_DO(verifyBatchedDistances<double>(genericAccelrator));
+    TEST_DO(verifyBatchedDistances<float>(hwaccelrated::IAccelrated::getAccelerator()));
+    TEST_DO(verifyBatchedDistances<double>(hwaccelrated::IAccelrated::getAccelerator()));
+}
+
+template<typename T>
+void verifyMatMul(const hwaccelrated::IAccelrated & accel, size_t m, size_t k, size_t n) {
+    // small values keep all sums exact regardless of summation order
+    srand(1);
+    std::vector<T> a(m*k);
+    std::vector<T> b(k*n);
+    for (auto & v : a) { v = rand()%10; }
+    for (auto & v : b) { v = rand()%10; }
+    for (bool aCommonInner : {false, true}) {
+        for (bool bCommonInner : {false, true}) {
+            std::vector<T> c(m*n, T(-1));
+            accel.matMul(a.data(), b.data(), c.data(), m, k, n, aCommonInner, bCommonInner);
+            for (size_t i(0); i < m; i++) {
+                for (size_t j(0); j < n; j++) {
+                    T sum(0);
+                    for (size_t l(0); l < k; l++) {
+                        sum += a[aCommonInner ? (i*k + l) : (l*m + i)] * b[bCommonInner ? (j*k + l) : (l*n + j)];
+                    }
+                    EXPECT_EQUAL(sum, c[i*n + j]);
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+void verifyMatMul(const hwaccelrated::IAccelrated & accel) {
+    TEST_DO(verifyMatMul<T>(accel, 1, 17, 33));
+    TEST_DO(verifyMatMul<T>(accel, 3, 5, 7));
+    TEST_DO(verifyMatMul<T>(accel, 16, 32, 64));
+    TEST_DO(verifyMatMul<T>(accel, 13, 300, 37));
+    TEST_DO(verifyMatMul<T>(accel, 5, 0, 3));
+}
+
+TEST("test matrix multiplication") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    TEST_DO(verifyMatMul<float>(genericAccelrator));
+    TEST_DO(verifyMatMul<double>(genericAccelrator));
+    TEST_DO(verifyMatMul<float>(hwaccelrated::IAccelrated::getAccelerator()));
+    TEST_DO(verifyMatMul<double>(hwaccelrated::IAccelrated::getAccelerator()));
+}
+
+TEST("require that bfloat16 rounds to nearest even and converts back exactly") {
+    EXPECT_EQUAL(1.0f, BFloat16(1.0f).to_float());
+    EXPECT_EQUAL(-2.5f, BFloat16(-2.5f).to_float());
+    EXPECT_EQUAL(256.0f, BFloat16(257.0f).to_float());
+    EXPECT_EQUAL(260.0f, BFloat16(259.0f).to_float());
+    EXPECT_EQUAL(uint16_t(0x3f80), BFloat16(1.0f).get_bits());
+    EXPECT_TRUE(std::isnan(BFloat16(std::numeric_limits<float>::quiet_NaN()).to_float()));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
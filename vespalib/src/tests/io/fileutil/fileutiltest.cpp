@@ -5,6 +5,7 @@
 #include <vector>
 #include <regex>
 #include <vespa/vespalib/util/exceptions.h>
+#include <utime.h>
 
 namespace vespalib {
 
@@ -618,6 +619,49 @@ TEST("require that vespalib::getOpenErrorString works")
     rmdir(dirName, true);
 }
 
+void writeFileWithTime(const vespalib::string & name, size_t size, time_t mtime)
+{
+    std::vector<char> data(size, 'x');
+    File f(name);
+    f.open(File::CREATE);
+    f.write(data.data(), data.size(), 0);
+    f.close();
+    struct utimbuf times;
+    times.actime = mtime;
+    times.modtime = mtime;
+    ASSERT_EQUAL(0, utime(name.c_str(), &times));
+}
+
+TEST("require that vespalib::pruneDirectory removes least recently modified files")
+{
+    rmdir("mydir", true);
+    mkdir("mydir");
+    writeFileWithTime("mydir/a.cache", 100, 1000);
+    writeFileWithTime("mydir/b.cache", 100, 3000);
+    writeFileWithTime("mydir/c.cache", 100, 2000);
+    writeFileWithTime("mydir/d.other", 1000, 500);
+    EXPECT_EQUAL(0u, pruneDirectory("mydir", ".cache", 300));
+    EXPECT_EQUAL(1u, pruneDirectory("mydir", ".cache", 250));
+    EXPECT_FALSE(fileExists("mydir/a.cache"));
+    EXPECT_TRUE(fileExists("mydir/b.cache"));
+    EXPECT_TRUE(fileExists("mydir/c.cache"));
+    EXPECT_TRUE(fileExists("mydir/d.other"));
+    EXPECT_EQUAL(2u, pruneDirectory("mydir", ".cache", 0));
+    EXPECT_FALSE(fileExists("mydir/b.cache"));
+    EXPECT_FALSE(fileExists("mydir/c.cache"));
+    EXPECT_TRUE(fileExists("mydir/d.other"));
+    rmdir("mydir", true);
+}
+
+TEST("require that vespalib::getUniqueTempFileName gives a new name next to the file for each call")
+{
+    string first = getUniqueTempFileName("mydir/a.cache");
+    string second = getUniqueTempFileName("mydir/a.cache");
+    EXPECT_NOT_EQUAL(first, second);
+    EXPECT_EQUAL(0u, first.find("mydir/a.cache."));
+    EXPECT_EQUAL(0u, second.find("mydir/a.cache."));
+}
+
 } // vespalib
 
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -20,6 +20,31 @@ Avx2Accelrator::squaredEuclideanDistance(const double * a, const double * b, siz
     return avx::euclideanDistanceSelectAlignment<double, 32>(a, b, sz);
 }
 
+float
+Avx2Accelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return avx::dotProductBFloat16<32>(a, b, sz);
+}
+
+double
+Avx2Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceInt8<32>(a, b, sz);
+}
+
+double
+Avx2Accelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return avx::euclideanDistanceBFloat16<32>(a, b, sz);
+}
+
+void
+Avx2Accelrator::matMul(const float * a, const float * b, float * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<float, 32, 6, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
+void
+Avx2Accelrator::matMul(const double * a, const double * b, double * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<double, 32, 6, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
 void
 Avx2Accelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<32u, 2u>(offset, src, dest);
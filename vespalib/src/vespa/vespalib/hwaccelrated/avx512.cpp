@@ -32,6 +32,31 @@ Avx512Accelrator::squaredEuclideanDistance(const double * a, const double * b, s
     return avx::euclideanDistanceSelectAlignment<double, 64>(a, b, sz);
 }
 
+float
+Avx512Accelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return avx::dotProductBFloat16<64>(a, b, sz);
+}
+
+double
+Avx512Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return avx::euclideanDistanceInt8<64>(a, b, sz);
+}
+
+double
+Avx512Accelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return avx::euclideanDistanceBFloat16<64>(a, b, sz);
+}
+
+void
+Avx512Accelrator::matMul(const float * a, const float * b, float * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<float, 64, 8, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
+void
+Avx512Accelrator::matMul(const double * a, const double * b, double * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<double, 64, 8, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
 void
 Avx512Accelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<64, 1>(offset, src, dest);
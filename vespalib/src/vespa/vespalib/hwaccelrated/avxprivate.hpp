@@ -3,7 +3,9 @@
 #pragma once
 
 #include "private_helpers.hpp"
+#include <vespa/vespalib/util/bfloat16.h>
 #include <vespa/fastos/dynamiclibrary.h>
+#include <algorithm>
 
 namespace vespalib::hwaccelrated::avx {
 
@@ -134,4 +136,131 @@ double euclideanDistanceSelectAlignment(const T * af, const T * bf, size_t sz)
     }
 }
 
+template <typename T, size_t VLEN>
+struct Vector {
+    typedef T type __attribute__ ((vector_size (VLEN)));
+};
+
+template <size_t VLEN>
+double
+euclideanDistanceInt8(const int8_t * af, const int8_t * bf, size_t sz)
+{
+    constexpr size_t VectorsPerChunk = 4;
+    constexpr size_t Lanes = VLEN/sizeof(int32_t);
+    constexpr size_t ChunkSize = Lanes*VectorsPerChunk;
+    // Each 32 bit lane grows by at most 255*255 per chunk; drain to 64 bit before it can overflow
+    constexpr size_t ChunksPerDrain = 16384;
+    using N = typename Vector<int8_t, Lanes>::type;
+    using V = typename Vector<int32_t, VLEN>::type;
+    V partial[VectorsPerChunk];
+    int64_t sum(0);
+    const size_t numChunks(sz/ChunkSize);
+    for (size_t i(0); i < numChunks; ) {
+        memset(partial, 0, sizeof(partial));
+        const size_t end(std::min(numChunks, i + ChunksPerDrain));
+        for (; i < end; i++) {
+            for (size_t j(0); j < VectorsPerChunk; j++) {
+                N a, b;
+                memcpy(&a, af + (VectorsPerChunk*i+j)*Lanes, sizeof(N));
+                memcpy(&b, bf + (VectorsPerChunk*i+j)*Lanes, sizeof(N));
+                V diff = __builtin_convertvector(a, V) - __builtin_convertvector(b, V);
+                partial[j] += diff * diff;
+            }
+        }
+        for (size_t j(0); j < VectorsPerChunk; j++) {
+            for (size_t k(0); k < Lanes; k++) {
+                sum += partial[j][k];
+            }
+        }
+    }
+    for (size_t i(numChunks*ChunkSize); i < sz; i++) {
+        int32_t diff = int32_t(af[i]) - int32_t(bf[i]);
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+namespace {
+
+/**
+ * Loads VLEN bytes of bfloat16 values as two float vectors; the low
+ * half of each 32 bit word goes into 'even' and the high half into
+ * 'odd'. Element order does not matter for the reductions below.
+ **/
+template <size_t VLEN>
+void
+loadBFloat16(const BFloat16 * src, typename Vector<float, VLEN>::type & even, typename Vector<float, VLEN>::type & odd) {
+    using U = typename Vector<uint32_t, VLEN>::type;
+    using V = typename Vector<float, VLEN>::type;
+    U bits;
+    memcpy(&bits, src, sizeof(U));
+    even = (V)(bits << 16);
+    odd = (V)(bits & 0xffff0000u);
+}
+
+}
+
+template <size_t VLEN>
+float
+dotProductBFloat16(const BFloat16 * af, const BFloat16 * bf, size_t sz)
+{
+    constexpr size_t VectorsPerChunk = 2;
+    constexpr size_t ValuesPerVector = VLEN/sizeof(BFloat16);
+    constexpr size_t ChunkSize = ValuesPerVector*VectorsPerChunk;
+    using V = typename Vector<float, VLEN>::type;
+    V partial[2*VectorsPerChunk];
+    memset(partial, 0, sizeof(partial));
+    const size_t numChunks(sz/ChunkSize);
+    for (size_t i(0); i < numChunks; i++) {
+        for (size_t j(0); j < VectorsPerChunk; j++) {
+            size_t offset = (VectorsPerChunk*i+j)*ValuesPerVector;
+            V a_even, a_odd, b_even, b_odd;
+            loadBFloat16<VLEN>(af + offset, a_even, a_odd);
+            loadBFloat16<VLEN>(bf + offset, b_even, b_odd);
+            partial[2*j] += a_even * b_even;
+            partial[2*j+1] += a_odd * b_odd;
+        }
+    }
+    float sum(0);
+    for (size_t i(numChunks*ChunkSize); i < sz; i++) {
+        sum += af[i].to_float() * bf[i].to_float();
+    }
+    partial[0] = sumR<V, 2*VectorsPerChunk>(partial);
+
+    return sum + sumT<float, V>(partial[0]);
+}
+
+template <size_t VLEN>
+double
+euclideanDistanceBFloat16(const BFloat16 * af, const BFloat16 * bf, size_t sz)
+{
+    constexpr size_t VectorsPerChunk = 2;
+    constexpr size_t ValuesPerVector = VLEN/sizeof(BFloat16);
+    constexpr size_t ChunkSize = ValuesPerVector*VectorsPerChunk;
+    using V = typename Vector<float, VLEN>::type;
+    V partial[2*VectorsPerChunk];
+    memset(partial, 0, sizeof(partial));
+    const size_t numChunks(sz/ChunkSize);
+    for (size_t i(0); i < numChunks; i++) {
+        for (size_t j(0); j < VectorsPerChunk; j++) {
+            size_t offset = (VectorsPerChunk*i+j)*ValuesPerVector;
+            V a_even, a_odd, b_even, b_odd;
+            loadBFloat16<VLEN>(af + offset, a_even, a_odd);
+            loadBFloat16<VLEN>(bf + offset, b_even, b_odd);
+            V diff_even = a_even - b_even;
+            V diff_odd = a_odd - b_odd;
+            partial[2*j] += diff_even * diff_even;
+            partial[2*j+1] += diff_odd * diff_odd;
+        }
+    }
+    double sum(0);
+    for (size_t i(numChunks*ChunkSize); i < sz; i++) {
+        float diff = af[i].to_float() - bf[i].to_float();
+        sum += diff * diff;
+    }
+    partial[0] = sumR<V, 2*VectorsPerChunk>(partial);
+
+    return sum + sumT<float, V>(partial[0]);
+}
+
 }
@@ -2,7 +2,9 @@
 
 #include "generic.h"
 #include "private_helpers.hpp"
+#include <vespa/vespalib/util/bfloat16.h>
 #include <cblas.h>
+#include <algorithm>
 
 namespace vespalib::hwaccelrated {
 
@@ -56,6 +58,62 @@ euclideanDistanceT(const T * a, const T * b, size_t sz)
     return sum;
 }
 
+template <typename ACCUM, typename T, size_t UNROLL>
+double
+euclideanDistanceWithAccumT(const T * a, const T * b, size_t sz)
+{
+    ACCUM partial[UNROLL];
+    for (size_t i(0); i < UNROLL; i++) {
+        partial[i] = 0;
+    }
+    size_t i(0);
+    for (; i + UNROLL <= sz; i += UNROLL) {
+        for (size_t j(0); j < UNROLL; j++) {
+            ACCUM diff = ACCUM(a[i+j]) - ACCUM(b[i+j]);
+            partial[j] += diff * diff;
+        }
+    }
+    for (;i < sz; i++) {
+        ACCUM diff = ACCUM(a[i]) - ACCUM(b[i]);
+        partial[i%UNROLL] += diff * diff;
+    }
+    double sum(0);
+    for (size_t j(0); j < UNROLL; j++) {
+        sum += partial[j];
+    }
+    return sum;
+}
+
+template <typename T>
+void
+prefetchVector(const T * v, size_t sz)
+{
+    constexpr size_t CacheLineSize = 64;
+    const char * p = reinterpret_cast<const char *>(v);
+    for (size_t offset(0); offset < sz * sizeof(T); offset += CacheLineSize) {
+        __builtin_prefetch(p + offset);
+    }
+}
+
+/**
+ * Calls compute for each vector in b while the vectors PREFETCH_AHEAD
+ * positions further out are being fetched into the cache.
+ **/
+template <typename T, size_t PREFETCH_AHEAD, typename Compute>
+void
+computeMany(const T * a, const T * const * b, size_t num_b, size_t sz, double * result, Compute compute)
+{
+    for (size_t i(0); i < std::min(num_b, PREFETCH_AHEAD); i++) {
+        prefetchVector(b[i], sz);
+    }
+    for (size_t i(0); i < num_b; i++) {
+        if (i + PREFETCH_AHEAD < num_b) {
+            prefetchVector(b[i + PREFETCH_AHEAD], sz);
+        }
+        result[i] = compute(a, b[i], sz);
+    }
+}
+
 template<size_t UNROLL, typename Operation>
 void
 bitOperation(Operation operation, void * aOrg, const void * bOrg, size_t bytes) {
@@ -119,6 +177,12 @@ GenericAccelrator::dotProduct(const int64_t * a, const int64_t * b, size_t sz) c
     return multiplyAdd<long long, int64_t, 8>(a, b, sz);
 }
 
+float
+GenericAccelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const
+{
+    return multiplyAdd<float, BFloat16, 8>(a, b, sz);
+}
+
 void
 GenericAccelrator::orBit(void * aOrg, const void * bOrg, size_t bytes) const
 {
@@ -165,6 +229,50 @@ GenericAccelrator::squaredEuclideanDistance(const double * a, const double * b,
     return euclideanDistanceT<double, 4>(a, b, sz);
 }
 
+double
+GenericAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const {
+    return euclideanDistanceWithAccumT<int64_t, int8_t, 8>(a, b, sz);
+}
+
+double
+GenericAccelrator::squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return euclideanDistanceWithAccumT<float, BFloat16, 8>(a, b, sz);
+}
+
+void
+GenericAccelrator::dotProducts(const float * a, const float * const * b, size_t num_b, size_t sz, double * result) const {
+    computeMany<float, 2>(a, b, num_b, sz, result,
+                          [this](const float * x, const float * y, size_t n) { return dotProduct(x, y, n); });
+}
+
+void
+GenericAccelrator::dotProducts(const double * a, const double * const * b, size_t num_b, size_t sz, double * result) const {
+    computeMany<double, 2>(a, b, num_b, sz, result,
+                           [this](const double * x, const double * y, size_t n) { return dotProduct(x, y, n); });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistances(const float * a, const float * const * b, size_t num_b, size_t sz, double * result) const {
+    computeMany<float, 2>(a, b, num_b, sz, result,
+                          [this](const float * x, const float * y, size_t n) { return squaredEuclideanDistance(x, y, n); });
+}
+
+void
+GenericAccelrator::squaredEuclideanDistances(const double * a, const double * const * b, size_t num_b, size_t sz, double * result) const {
+    computeMany<double, 2>(a, b, num_b, sz, result,
+                           [this](const double * x, const double * y, size_t n) { return squaredEuclideanDistance(x, y, n); });
+}
+
+void
+GenericAccelrator::matMul(const float * a, const float * b, float * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<float, 16, 4, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
+void
+GenericAccelrator::matMul(const double * a, const double * b, double * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const {
+    helper::MatMul<double, 16, 4, 2>::run(a, b, c, m, k, n, a_common_inner, b_common_inner);
+}
+
 void
 GenericAccelrator::and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const {
     helper::andChunks<16, 4>(offset, src, dest);
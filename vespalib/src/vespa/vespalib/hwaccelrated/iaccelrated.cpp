@@ -4,6 +4,7 @@
 #include "generic.h"
 #include "avx2.h"
 #include "avx512.h"
+#include <vespa/vespalib/util/bfloat16.h>
 #include <vespa/vespalib/util/memory.h>
 #include <cstdio>
 #include <vector>
@@ -86,6 +87,86 @@ verifyEuclideanDistance(const IAccelrated & accel) {
     }
 }
 
+void
+verifyInt8EuclideanDistance(const IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<int8_t> a(testLength);
+    std::vector<int8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%256 - 128;
+        b[i] = rand()%256 - 128;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        int64_t sum(0);
+        for (size_t i(j); i < testLength; i++) {
+            int64_t diff = int64_t(a[i]) - int64_t(b[i]);
+            sum += diff * diff;
+        }
+        double hwComputedSum(accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+        if (double(sum) != hwComputedSum) {
+            fprintf(stderr, "Accelrator is not computing int8 euclidean distance correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
+void
+verifyBFloat16(const IAccelrated & accel) {
+    const size_t testLength(255);
+    srand(1);
+    std::vector<BFloat16> a(testLength);
+    std::vector<BFloat16> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = float(rand()%100);
+        b[i] = float(rand()%100);
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        float dotSum(0);
+        double distSum(0);
+        for (size_t i(j); i < testLength; i++) {
+            dotSum += a[i].to_float() * b[i].to_float();
+            float diff = a[i].to_float() - b[i].to_float();
+            distSum += diff * diff;
+        }
+        if (dotSum != accel.dotProduct(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing bfloat16 dotproduct correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+        if (distSum != accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j)) {
+            fprintf(stderr, "Accelrator is not computing bfloat16 euclidean distance correctly.\n");
+            LOG_ABORT("should not be reached");
+        }
+    }
+}
+
+template<typename T>
+void
+verifyMatMul(const IAccelrated & accel) {
+    const size_t m(13), k(300), n(37);
+    srand(1);
+    std::vector<T> a = createAndFill<T>(m*k);
+    std::vector<T> b = createAndFill<T>(k*n);
+    for (bool aCommonInner : {false, true}) {
+        for (bool bCommonInner : {false, true}) {
+            std::vector<T> c(m*n);
+            accel.matMul(&a[0], &b[0], &c[0], m, k, n, aCommonInner, bCommonInner);
+            for (size_t i(0); i < m; i++) {
+                for (size_t j(0); j < n; j++) {
+                    T sum(0);
+                    for (size_t l(0); l < k; l++) {
+                        sum += a[aCommonInner ? (i*k + l) : (l*m + i)] * b[bCommonInner ? (j*k + l) : (l*n + j)];
+                    }
+                    if (sum != c[i*n + j]) {
+                        fprintf(stderr, "Accelrator is not computing matrix multiplication correctly.\n");
+                        LOG_ABORT("should not be reached");
+                    }
+                }
+            }
+        }
+    }
+}
+
 void
 verifyPopulationCount(const IAccelrated & accel)
 {
@@ -228,6 +309,10 @@ private:
         verifyDotproduct<int64_t>(accelrated);
         verifyEuclideanDistance<float>(accelrated);
         verifyEuclideanDistance<double>(accelrated);
+        verifyInt8EuclideanDistance(accelrated);
+        verifyBFloat16(accelrated);
+        verifyMatMul<float>(accelrated);
+        verifyMatMul<double>(accelrated);
         verifyPopulationCount(accelrated);
         verifyAnd64(accelrated);
         verifyOr64(accelrated);
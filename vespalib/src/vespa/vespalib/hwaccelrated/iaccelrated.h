@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <vector>
 
+namespace vespalib { class BFloat16; }
+
 namespace vespalib::hwaccelrated {
 
 /**
@@ -23,6 +25,7 @@ public:
     virtual int64_t dotProduct(const int16_t * a, const int16_t * b, size_t sz) const = 0;
     virtual int64_t dotProduct(const int32_t * a, const int32_t * b, size_t sz) const = 0;
     virtual long long dotProduct(const int64_t * a, const int64_t * b, size_t sz) const = 0;
+    virtual float dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const = 0;
     virtual void orBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andNotBit(void * a, const void * b, size_t bytes) const = 0;
@@ -30,6 +33,17 @@ public:
     virtual size_t populationCount(const uint64_t *a, size_t sz) const = 0;
     virtual double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const = 0;
     virtual double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const = 0;
+    virtual double squaredEuclideanDistance(const BFloat16 * a, const BFloat16 * b, size_t sz) const = 0;
+    // Compute between a and each of the num_b vectors in b, prefetching the vectors in b ahead of use
+    virtual void dotProducts(const float * a, const float * const * b, size_t num_b, size_t sz, double * result) const = 0;
+    virtual void dotProducts(const double * a, const double * const * b, size_t num_b, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistances(const float * a, const float * const * b, size_t num_b, size_t sz, double * result) const = 0;
+    virtual void squaredEuclideanDistances(const double * a, const double * const * b, size_t num_b, size_t sz, double * result) const = 0;
+    // Multiply the m x k matrix a with the k x n matrix b into the row-major m x n matrix c.
+    // a is stored as m x k if a_common_inner, otherwise as k x m. b is stored as n x k if b_common_inner, otherwise as k x n.
+    virtual void matMul(const float * a, const float * b, float * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const = 0;
+    virtual void matMul(const double * a, const double * b, double * c, size_t m, size_t k, size_t n, bool a_common_inner, bool b_common_inner) const = 0;
     // AND 64 bytes from multiple, optionally inverted sources
     virtual void and64(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const = 0;
     // OR 64 bytes from multiple, optionally inverted sources
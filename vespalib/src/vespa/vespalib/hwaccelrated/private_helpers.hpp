@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/optimized.h>
+#include <algorithm>
 #include <cstring>
 
 namespace vespalib::hwaccelrated::helper {
@@ -74,5 +75,159 @@ orChunks(size_t offset, const std::vector<std::pair<const void *, bool>> & src,
     }
 }
 
+/**
+ * Matrix multiplication using vectors of VLEN bytes. The result is
+ * calculated in tiles of MR rows and NV vectors, keeping the tile in
+ * registers while stepping through the common dimension. The common
+ * dimension is split in blocks of KC and each block of b is handled
+ * as panels of NR columns; a panel is used for all rows of a before
+ * moving on to the next, so that it stays in the L1 cache. Panels
+ * that are not already laid out as rows of NR consecutive values are
+ * copied into a local buffer first.
+ **/
+template <typename T, size_t VLEN, size_t MR, size_t NV>
+struct MatMul {
+    typedef T V __attribute__ ((vector_size (VLEN)));
+    static constexpr size_t Lanes = VLEN/sizeof(T);
+    static constexpr size_t NR = NV*Lanes;
+    static constexpr size_t KC = 128;
+
+    static V load(const T *src) {
+        V v;
+        memcpy(&v, src, sizeof(V));
+        return v;
+    }
+
+    template <size_t ROWS>
+    static void kernel(const T * const *a_rows, size_t a_step, const T *b, size_t b_stride, size_t kc, V (&acc)[ROWS][NV]) {
+        for (size_t r(0); r < ROWS; r++) {
+            for (size_t v(0); v < NV; v++) {
+                acc[r][v] = V{};
+            }
+        }
+        for (size_t l(0); l < kc; l++) {
+            V bv[NV];
+            for (size_t v(0); v < NV; v++) {
+                bv[v] = load(b + l*b_stride + v*Lanes);
+            }
+            for (size_t r(0); r < ROWS; r++) {
+                V av = V{} + a_rows[r][l*a_step];
+                for (size_t v(0); v < NV; v++) {
+                    acc[r][v] += av * bv[v];
+                }
+            }
+        }
+    }
+
+    template <size_t ROWS>
+    static void store(const V (&acc)[ROWS][NV], T *c, size_t ldc, size_t nr, bool accumulate) {
+        if (nr == NR) {
+            for (size_t r(0); r < ROWS; r++) {
+                for (size_t v(0); v < NV; v++) {
+                    T *dst = c + r*ldc + v*Lanes;
+                    V value = accumulate ? (acc[r][v] + load(dst)) : acc[r][v];
+                    memcpy(dst, &value, sizeof(V));
+                }
+            }
+        } else {
+            T tmp[ROWS][NR];
+            memcpy(tmp, acc, sizeof(tmp));
+            for (size_t r(0); r < ROWS; r++) {
+                for (size_t j(0); j < nr; j++) {
+                    c[r*ldc + j] = accumulate ? (c[r*ldc + j] + tmp[r][j]) : tmp[r][j];
+                }
+            }
+        }
+    }
+
+    template <size_t ROWS>
+    static void tile(const T *a, size_t a_row_step, size_t a_step, const T *b, size_t b_stride,
+                     size_t kc, T *c, size_t ldc, size_t nr, bool accumulate)
+    {
+        const T *a_rows[ROWS];
+        for (size_t r(0); r < ROWS; r++) {
+            a_rows[r] = a + r*a_row_step;
+        }
+        V acc[ROWS][NV];
+        kernel<ROWS>(a_rows, a_step, b, b_stride, kc, acc);
+        store<ROWS>(acc, c, ldc, nr, accumulate);
+    }
+
+    static T dot(const T *a, const T *b, size_t sz) {
+        V acc[NV];
+        for (size_t v(0); v < NV; v++) {
+            acc[v] = V{};
+        }
+        size_t i(0);
+        for (; i + NR <= sz; i += NR) {
+            for (size_t v(0); v < NV; v++) {
+                acc[v] += load(a + i + v*Lanes) * load(b + i + v*Lanes);
+            }
+        }
+        T sum(0);
+        for (; i < sz; i++) {
+            sum += a[i] * b[i];
+        }
+        for (size_t v(0); v < NV; v++) {
+            for (size_t j(0); j < Lanes; j++) {
+                sum += acc[v][j];
+            }
+        }
+        return sum;
+    }
+
+    static void run(const T *a, const T *b, T *c, size_t m, size_t k, size_t n,
+                    bool a_common_inner, bool b_common_inner)
+    {
+        if (k == 0) {
+            std::fill(c, c + m*n, T(0));
+            return;
+        }
+        if (a_common_inner && b_common_inner && (m < MR)) {
+            // too few rows to pay for transposing b; use dot products
+            for (size_t i(0); i < m; i++) {
+                for (size_t j(0); j < n; j++) {
+                    c[i*n + j] = dot(a + i*k, b + j*k, k);
+                }
+            }
+            return;
+        }
+        const size_t a_row_step = a_common_inner ? k : 1;
+        const size_t a_step = a_common_inner ? 1 : m;
+        T packed[KC*NR];
+        for (size_t pc(0); pc < k; pc += KC) {
+            const size_t kc = std::min(KC, k - pc);
+            const bool accumulate = (pc > 0);
+            for (size_t jc(0); jc < n; jc += NR) {
+                const size_t nr = std::min(NR, n - jc);
+                const T *panel = packed;
+                size_t panel_stride = NR;
+                if (!b_common_inner && (nr == NR)) {
+                    panel = b + pc*n + jc;
+                    panel_stride = n;
+                } else {
+                    for (size_t l(0); l < kc; l++) {
+                        for (size_t j(0); j < NR; j++) {
+                            packed[l*NR + j] = (j < nr)
+                                ? (b_common_inner ? b[(jc + j)*k + pc + l] : b[(pc + l)*n + jc + j])
+                                : T(0);
+                        }
+                    }
+                }
+                const T *a_block = a + pc*a_step;
+                size_t ic(0);
+                for (; ic + MR <= m; ic += MR) {
+                    tile<MR>(a_block + ic*a_row_step, a_row_step, a_step, panel, panel_stride,
+                             kc, c + ic*n + jc, n, nr, accumulate);
+                }
+                for (; ic < m; ic++) {
+                    tile<1>(a_block + ic*a_row_step, a_row_step, a_step, panel, panel_stride,
+                            kc, c + ic*n + jc, n, nr, accumulate);
+                }
+            }
+        }
+    }
+};
+
 }
 }
@@ -6,6 +6,8 @@
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/fastos/file.h>
 #include <ostream>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <unistd.h>
 #include <fcntl.h>
@@ -764,6 +766,45 @@ listDirectory(const string & path)
     return result;
 }
 
+size_t
+pruneDirectory(const string & path, const string & suffix, size_t maxBytes)
+{
+    struct Entry {
+        string name;
+        time_t mtime;
+        size_t size;
+    };
+    std::vector<Entry> entries;
+    for (const auto & name : listDirectory(path)) {
+        struct stat info;
+        string fileName = path + "/" + name;
+        if ((name.size() > suffix.size()) &&
+            (name.substr(name.size() - suffix.size()) == suffix) &&
+            (::stat(fileName.c_str(), &info) == 0) && S_ISREG(info.st_mode))
+        {
+            entries.push_back(Entry{fileName, info.st_mtime, size_t(info.st_size)});
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto & a, const auto & b) { return (a.mtime > b.mtime); });
+    size_t total = 0;
+    size_t removed = 0;
+    for (const auto & entry : entries) {
+        total += entry.size;
+        if ((total > maxBytes) && unlink(entry.name)) {
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+string
+getUniqueTempFileName(const string & fileName)
+{
+    static std::atomic<uint64_t> nextId(0);
+    return make_string("%s.%d.%" PRIu64 ".tmp", fileName.c_str(), getpid(), nextId++);
+}
+
 MallocAutoPtr
 getAlignedBuffer(size_t size)
 {
@@ -391,6 +391,23 @@ extern void copy(const vespalib::string & frompath,
 typedef std::vector<vespalib::string> DirectoryList;
 extern DirectoryList listDirectory(const vespalib::string & path);
 
+/**
+ * Remove the least recently modified regular files with the given
+ * suffix in the given directory until the total size of the remaining
+ * ones is at most maxBytes. Used to bound the size of on-disk caches.
+ *
+ * @return The number of files removed.
+ */
+extern size_t pruneDirectory(const vespalib::string & path, const vespalib::string & suffix, size_t maxBytes);
+
+/**
+ * Get a name for a temporary file next to the given file, unique for
+ * each call in this process and across processes. Used when writing
+ * files that are renamed into place, where several threads or
+ * processes may write the same file at the same time.
+ */
+extern string getUniqueTempFileName(const string & fileName);
+
 extern MallocAutoPtr getAlignedBuffer(size_t size);
 
 string dirname(stringref name);
@@ -0,0 +1,57 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace vespalib {
+
+/**
+ * Class holding 16-bit floating-point numbers in the "brain float"
+ * format; the 16 most significant bits of an IEEE 754 single
+ * precision float (sign bit, 8 bit exponent and 7 bit mantissa).
+ * Conversion from float rounds to nearest even, conversion to float
+ * is exact.
+ **/
+class BFloat16 {
+private:
+    uint16_t _bits;
+    static uint32_t float_to_bits(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+public:
+    constexpr BFloat16() noexcept : _bits(0) {}
+    BFloat16(float value) noexcept : _bits(float_to_bfloat16_bits(value)) {}
+    BFloat16(const BFloat16 &other) noexcept = default;
+    BFloat16 &operator=(const BFloat16 &other) noexcept = default;
+    BFloat16 &operator=(float value) noexcept {
+        _bits = float_to_bfloat16_bits(value);
+        return *this;
+    }
+    operator float() const noexcept { return to_float(); }
+    float to_float() const noexcept {
+        uint32_t bits = uint32_t(_bits) << 16;
+        float result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    uint16_t get_bits() const noexcept { return _bits; }
+    void assign_bits(uint16_t value) noexcept { _bits = value; }
+
+    static uint16_t float_to_bfloat16_bits(float value) noexcept {
+        uint32_t bits = float_to_bits(value);
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            // NaN; keep it quiet and make sure it stays NaN after truncation
+            return uint16_t((bits >> 16) | 0x0040u);
+        }
+        uint32_t rounding_bias = 0x7fffu + ((bits >> 16) & 1u);
+        return uint16_t((bits + rounding_bias) >> 16);
+    }
+};
+
+static_assert(sizeof(BFloat16) == sizeof(uint16_t), "BFloat16 must be 16 bits");
+
+}